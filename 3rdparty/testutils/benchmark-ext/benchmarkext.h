@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BENCHMARKEXT_H
+#define BENCHMARKEXT_H
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+
+#include <utility>
+
+/*
+ * 性能对比测试默认不运行。
+ * 单元测试以 -O0 和覆盖率插桩编译，耗时数据只作参考，需要时手动运行：
+ *   DFM_BENCHMARK_SCALE=10 ./test-xxx --gtest_filter='*Benchmark*' --gtest_also_run_disabled_tests
+ * DFM_BENCHMARK_SCALE 按倍数放大每个性能测试的默认规模。
+ */
+#define DFM_BENCHMARK(test_suite_name, test_name) \
+    TEST(test_suite_name, DISABLED_Benchmark_##test_name)
+
+#define DFM_BENCHMARK_F(test_fixture, test_name) \
+    TEST_F(test_fixture, DISABLED_Benchmark_##test_name)
+
+namespace benchmark_ext {
+
+inline int size(int defaultSize)
+{
+    const int scale = qEnvironmentVariableIntValue("DFM_BENCHMARK_SCALE");
+    return scale > 1 ? defaultSize * scale : defaultSize;
+}
+
+// 返回 fn 的耗时，单位纳秒
+template<class Fn>
+qint64 elapsedNs(Fn &&fn)
+{
+    QElapsedTimer timer;
+    timer.start();
+    fn();
+    return timer.nsecsElapsed();
+}
+
+template<class Fn>
+qint64 elapsedMs(Fn &&fn)
+{
+    return elapsedNs(std::forward<Fn>(fn)) / 1000000;
+}
+
+// 读取 /proc/self/status 中以 kB 为单位的字段
+inline qint64 statusKb(const QByteArray &field)
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly))
+        return -1;
+    for (const auto &line : status.readAll().split('\n')) {
+        if (line.startsWith(field))
+            return line.mid(field.length()).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+
+// 当前进程的常驻内存
+inline qint64 residentKb()
+{
+    return statusKb("VmRSS:");
+}
+
+// 常驻内存的峰值，resetPeakResident() 后重新统计
+inline qint64 peakResidentKb()
+{
+    return statusKb("VmHWM:");
+}
+
+inline bool resetPeakResident()
+{
+    QFile refs("/proc/self/clear_refs");
+    return refs.open(QIODevice::WriteOnly) && refs.write("5") == 1;
+}
+
+inline QDebug report()
+{
+    return qInfo().noquote() << "[benchmark]";
+}
+
+}
+
+#endif   // BENCHMARKEXT_H
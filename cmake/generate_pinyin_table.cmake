@@ -0,0 +1,21 @@
+# Generate pinyintable.h from src/dfm-base/qrc/chinese2pinyin/pinyin.dict for the target
+# that builds dfm-base/utils/chinese2pinyin.cpp, the header is put in a per target
+# directory of the current binary dir and added to the private include path.
+function(GENERATE_PINYIN_TABLE TARGET_NAME)
+    set(DictFile ${CMAKE_SOURCE_DIR}/src/dfm-base/qrc/chinese2pinyin/pinyin.dict)
+    set(Generator ${CMAKE_SOURCE_DIR}/cmake/pinyin_table_generator.cmake)
+    set(TableDir ${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}-pinyin)
+    set(TableHeader ${TableDir}/pinyintable.h)
+
+    add_custom_command(
+        OUTPUT ${TableHeader}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${TableDir}
+        COMMAND ${CMAKE_COMMAND} -DDICT_FILE=${DictFile} -DOUTPUT_FILE=${TableHeader} -P ${Generator}
+        DEPENDS ${DictFile} ${Generator}
+        COMMENT "Generating pinyin table for ${TARGET_NAME}"
+        VERBATIM
+    )
+
+    target_sources(${TARGET_NAME} PRIVATE ${TableHeader})
+    target_include_directories(${TARGET_NAME} PRIVATE ${TableDir})
+endfunction()
@@ -0,0 +1,96 @@
+# Convert pinyin.dict ("0x3400:qiu1" per line) to a C++ header with a sorted
+# code point table and a shared syllable pool, run with:
+#   cmake -DDICT_FILE=<pinyin.dict> -DOUTPUT_FILE=<pinyintable.h> -P pinyin_table_generator.cmake
+
+if (NOT DICT_FILE OR NOT OUTPUT_FILE)
+    message(FATAL_ERROR "DICT_FILE and OUTPUT_FILE are required")
+endif()
+
+file(STRINGS ${DICT_FILE} DICT_LINES REGEX "^0x[0-9a-fA-F]+:[a-z]+[0-9]?$")
+# the dict is sorted by code point and every code point is 4 hex digits,
+# sort again so the table stays valid for binary search if it is edited by hand
+string(TOLOWER "${DICT_LINES}" DICT_LINES)
+list(SORT DICT_LINES)
+
+set(SYLLABLE_COUNT 0)
+set(MAX_SYLLABLE_LENGTH 0)
+set(POOL_SIZE 0)
+set(POOL "")
+set(OFFSETS "")
+set(ENTRIES "")
+set(ENTRY_COUNT 0)
+foreach(line ${DICT_LINES})
+    string(FIND "${line}" ":" sep)
+    string(SUBSTRING "${line}" 0 ${sep} code)
+    math(EXPR start "${sep} + 1")
+    string(SUBSTRING "${line}" ${start} -1 syllable)
+
+    if (NOT DEFINED SYLLABLE_ID_${syllable})
+        set(SYLLABLE_ID_${syllable} ${SYLLABLE_COUNT})
+        string(APPEND POOL "\n    \"${syllable}\"")
+        string(APPEND OFFSETS "${POOL_SIZE}, ")
+        string(LENGTH "${syllable}" len)
+        if (len GREATER MAX_SYLLABLE_LENGTH)
+            set(MAX_SYLLABLE_LENGTH ${len})
+        endif()
+        math(EXPR POOL_SIZE "${POOL_SIZE} + ${len}")
+        math(EXPR SYLLABLE_COUNT "${SYLLABLE_COUNT} + 1")
+        math(EXPR wrap "${SYLLABLE_COUNT} % 16")
+        if (wrap EQUAL 0)
+            string(APPEND OFFSETS "\n    ")
+        endif()
+    endif()
+
+    string(APPEND ENTRIES "{ ${code}, ${SYLLABLE_ID_${syllable}} }, ")
+    math(EXPR ENTRY_COUNT "${ENTRY_COUNT} + 1")
+    math(EXPR wrap "${ENTRY_COUNT} % 8")
+    if (wrap EQUAL 0)
+        string(APPEND ENTRIES "\n    ")
+    endif()
+endforeach()
+
+if (ENTRY_COUNT EQUAL 0)
+    message(FATAL_ERROR "no entry found in ${DICT_FILE}")
+endif()
+
+get_filename_component(DICT_NAME ${DICT_FILE} NAME)
+file(WRITE ${OUTPUT_FILE}.tmp "// Generated from ${DICT_NAME} by pinyin_table_generator.cmake, do not edit.
+
+#ifndef PINYIN_TABLE_H
+#define PINYIN_TABLE_H
+
+#include <cstdint>
+
+namespace Pinyin {
+namespace Table {
+
+struct Entry
+{
+    char16_t code;
+    uint16_t syllable;
+};
+
+// 所有读音首尾相连，kSyllableOffsets[i] 到 kSyllableOffsets[i + 1] 是第 i 个读音
+static constexpr char kSyllablePool[] =${POOL};
+
+static constexpr uint16_t kSyllableOffsets[] = {
+    ${OFFSETS}${POOL_SIZE}
+};
+
+// 按码位排序
+static constexpr Entry kEntries[] = {
+    ${ENTRIES}
+};
+
+static constexpr int kSyllableCount = ${SYLLABLE_COUNT};
+static constexpr int kMaxSyllableLength = ${MAX_SYLLABLE_LENGTH};
+static constexpr int kEntryCount = ${ENTRY_COUNT};
+
+}   // namespace Table
+}   // namespace Pinyin
+
+#endif   // PINYIN_TABLE_H
+")
+# only touch the header when it changes, avoid rebuilding everything that includes it
+configure_file(${OUTPUT_FILE}.tmp ${OUTPUT_FILE} COPYONLY)
+file(REMOVE ${OUTPUT_FILE}.tmp)
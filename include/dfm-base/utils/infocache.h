@@ -19,6 +19,15 @@ namespace dfmbase {
 class InfoCachePrivate;
 class InfoCache;
 
+// 文件信息缓存的统计数据，用于评估缓存容量是否合适
+struct InfoCacheStatistics
+{
+    quint64 hits { 0 };
+    quint64 misses { 0 };
+    quint64 evictions { 0 };
+    int count { 0 };
+};
+
 // 异步缓存和移除
 class CacheWorker : public QObject
 {
@@ -77,6 +86,7 @@ private:
     bool cacheDisable(const QString &scheme);
     void setCacheDisbale(const QString &scheme, bool disable = true);
     FileInfoPointer getCacheInfo(const QUrl &url);
+    InfoCacheStatistics statistics();
     void stop();
     void cacheInfo(const QUrl url, const FileInfoPointer info);
     void disconnectWatcher(const QMap<QUrl, FileInfoPointer> infos);
@@ -110,6 +120,7 @@ public:
     bool cacheDisable(const QString &scheme);
     void setCacheDisbale(const QString &scheme, bool disable = true);
     FileInfoPointer getCacheInfo(const QUrl &url);
+    InfoCacheStatistics statistics();
 Q_SIGNALS:
     void cacheFileInfo(const QUrl url, const FileInfoPointer info);
     void removeCacheFileInfo(const QList<QUrl> &urls);
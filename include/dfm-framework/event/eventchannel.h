@@ -11,6 +11,9 @@
 
 #include <QFuture>
 #include <QReadWriteLock>
+#include <QHash>
+
+#include <memory>
 
 DPF_BEGIN_NAMESPACE
 
@@ -43,9 +46,17 @@ public:
     template<class T, class... Args>
     inline QVariant send(T param, Args &&... args)
     {
+        const auto &receiver = std::atomic_load(&curReceiver);
+        if (!receiver)
+            return QVariant();
+
+        // 参数类型与接收函数一致时直接调用，不转换为QVariantList
+        if (receiver->typed.template matches<QVariant, T, Args...>())
+            return receiver->typed.template invoke<QVariant, T, Args...>(param, args...);
+
         QVariantList ret;
         makeVariantList(&ret, param, std::forward<Args>(args)...);
-        return send(ret);
+        return receiver->conn(ret);
     }
 
     EventChannelFuture asyncSend();
@@ -65,14 +76,22 @@ public:
         static_assert(!std::is_pointer<T>::value, "Receiver::bind's template type T must not be a pointer type");
 
         QMutexLocker guard(&receiverMutex);
-        conn = [obj, method](const QVariantList &args) -> QVariant {
+        Connector conn = [obj, method](const QVariantList &args) -> QVariant {
             EventHelper<decltype(method)> helper = (EventHelper<decltype(method)>(obj, method));
             return helper.invoke(args);
         };
+        std::atomic_store(&curReceiver,
+                          std::shared_ptr<const Receiver>(new Receiver { conn, TypedInvoker::create<QVariant>(obj, method) }));
     }
 
 private:
-    Connector conn;
+    struct Receiver
+    {
+        Connector conn;
+        TypedInvoker typed;
+    };
+
+    std::shared_ptr<const Receiver> curReceiver;
     QMutex receiverMutex;
 };
 
@@ -105,6 +124,7 @@ public:
             ChannelPtr Channel { new EventChannel };
             Channel->setReceiver(obj, method);
             channelMap.insert(type, Channel);
+            updateChannelSnapshot();
         }
         return true;
     }
@@ -124,12 +144,8 @@ public:
     [[gnu::hot]] inline QVariant push(EventType type, T param, Args &&... args)
     {
         threadEventAlert(type);
-        QReadLocker guard(&rwLock);
-        if (Q_LIKELY(channelMap.contains(type))) {
-            auto channel = channelMap.value(type);
-            guard.unlock();
+        if (auto channel = findChannel(type))
             return channel->send(param, std::forward<Args>(args)...);
-        }
         return QVariant();
     }
 
@@ -143,13 +159,8 @@ public:
     inline QVariant push(const EventType &type)
     {
         threadEventAlert(type);
-        QReadLocker guard(&rwLock);
-        if (Q_LIKELY(channelMap.contains(type))) {
-            auto channel = channelMap.value(type);
-            guard.unlock();
-            if (channel)
-                return channel->send();
-        }
+        if (auto channel = findChannel(type))
+            return channel->send();
 
         return QVariant();
     }
@@ -164,12 +175,8 @@ public:
     template<class T, class... Args>
     inline EventChannelFuture post(EventType type, T param, Args &&... args)
     {
-        QReadLocker guard(&rwLock);
-        if (Q_LIKELY(channelMap.contains(type))) {
-            auto channel { channelMap[type] };
-            guard.unlock();
+        if (auto channel = findChannel(type))
             return channel->asyncSend(param, std::forward<Args>(args)...);
-        }
         return EventChannelFuture(QFuture<QVariant>());
     }
 
@@ -181,22 +188,29 @@ public:
 
     inline EventChannelFuture post(const EventType &type)
     {
-        QReadLocker guard(&rwLock);
-        if (Q_LIKELY(channelMap.contains(type))) {
-            auto channel { channelMap[type] };
-            guard.unlock();
+        if (auto channel = findChannel(type))
             return channel->asyncSend();
-        }
         return EventChannelFuture(QFuture<QVariant>());
     }
 
 private:
     using ChannelPtr = QSharedPointer<EventChannel>;
     using EventChannelMap = QMap<EventType, ChannelPtr>;
+    using ChannelSnapshot = QHash<EventType, ChannelPtr>;
+
+    inline ChannelPtr findChannel(EventType type) const
+    {
+        const auto &snapshot = std::atomic_load(&channelSnapshot);
+        return snapshot ? snapshot->value(type) : ChannelPtr();
+    }
+
+    void updateChannelSnapshot();
 
 private:
+    // 写操作在 rwLock 保护下修改 map，然后发布只读快照；push/post 只读取快照，不加锁
     EventChannelMap channelMap;
     QReadWriteLock rwLock;
+    std::shared_ptr<const ChannelSnapshot> channelSnapshot;
 };
 
 DPF_END_NAMESPACE
@@ -13,6 +13,9 @@
 #include <QFuture>
 #include <QSharedPointer>
 #include <QReadWriteLock>
+#include <QHash>
+
+#include <memory>
 
 DPF_BEGIN_NAMESPACE
 
@@ -28,9 +31,34 @@ public:
     template<class T, class... Args>
     inline bool dispatch(T param, Args &&... args)
     {
-        QVariantList ret;
-        makeVariantList(&ret, param, std::forward<Args>(args)...);
-        return dispatch(ret);
+        const auto &tables = std::atomic_load(&handlerTables);
+        if (!tables)
+            return true;
+
+        // 参数类型与处理函数一致时直接调用，否则才转换为QVariantList（只转换一次）
+        QVariantList params;
+        auto variantParams = [&]() -> const QVariantList & {
+            if (params.isEmpty())
+                makeVariantList(&params, param, args...);
+            return params;
+        };
+
+        for (const auto &filter : tables->filters) {
+            const bool filtered = filter.typed.template matches<bool, T, Args...>()
+                    ? filter.typed.template invoke<bool, T, Args...>(param, args...)
+                    : filter.handler(variantParams()).toBool();
+            if (filtered)
+                return false;
+        }
+
+        for (const auto &handler : tables->handlers) {
+            if (handler.typed.template matches<void, T, Args...>())
+                handler.typed.template invoke<void, T, Args...>(param, args...);
+            else
+                handler.handler(variantParams());
+        }
+
+        return true;
     }
 
     QFuture<bool> asyncDispatch();
@@ -54,7 +82,9 @@ public:
             return helper.invoke(args);
         };
 
-        handlerList.push_back(EventHandler<Listener> { obj, memberFunctionVoidCast(method), func });
+        handlerList.push_back(EventHandler<Listener> { obj, memberFunctionVoidCast(method), func,
+                                                       TypedInvoker::create<void>(obj, method) });
+        updateTables();
     }
 
     template<class T, class Func>
@@ -72,6 +102,7 @@ public:
                 }
             }
         }
+        updateTables();
 
         return ret;
     }
@@ -90,7 +121,9 @@ public:
             EventHelper<decltype(method)> helper = (EventHelper<decltype(method)>(obj, method));
             return helper.invoke(args).toBool();
         };
-        filterList.push_back(EventHandler<Listener> { obj, memberFunctionVoidCast(method), func });
+        filterList.push_back(EventHandler<Listener> { obj, memberFunctionVoidCast(method), func,
+                                                      TypedInvoker::create<bool>(obj, method) });
+        updateTables();
     }
 
     template<class T, class Func>
@@ -112,13 +145,24 @@ public:
                 }
             }
         }
+        updateTables();
 
         return ret;
     }
 
+private:
+    // 分发时使用的只读快照，修改列表后整体替换，分发过程不需要加锁
+    struct HandlerTables
+    {
+        HandlerList handlers;
+        FilterList filters;
+    };
+    void updateTables();
+
 private:
     HandlerList handlerList {};
     FilterList filterList {};
+    std::shared_ptr<const HandlerTables> handlerTables;
 };
 
 class EventDispatcherManager
@@ -152,6 +196,7 @@ public:
             DispatcherPtr dispatcher { new EventDispatcher };
             dispatcher->append(obj, method);
             dispatcherMap.insert(type, dispatcher);
+            updateDispatcherSnapshot();
         }
         return true;
     }
@@ -188,20 +233,15 @@ public:
     [[gnu::hot]] inline bool publish(EventType type, T param, Args &&... args)
     {
         threadEventAlert(type);
-        if (!globalFilterMap.isEmpty()) {
+        if (hasGlobalFilter()) {
             QVariantList ret;
-            makeVariantList(&ret, param, std::forward<Args>(args)...);
+            makeVariantList(&ret, param, args...);
             if (globalFiltered(type, ret))
                 return false;
         }
 
-        QReadLocker lk(&rwLock);
-        if (Q_LIKELY(dispatcherMap.contains(type))) {
-            auto dispatcher = dispatcherMap.value(type);
-            lk.unlock();
-            if (dispatcher)
-                return dispatcher->dispatch(param, std::forward<Args>(args)...);
-        }
+        if (auto dispatcher = findDispatcher(type))
+            return dispatcher->dispatch(param, std::forward<Args>(args)...);
         return false;
     }
 
@@ -215,16 +255,11 @@ public:
     inline bool publish(EventType type)
     {
         threadEventAlert(type);
-        if (!globalFilterMap.isEmpty() && globalFiltered(type, QVariantList()))
+        if (hasGlobalFilter() && globalFiltered(type, QVariantList()))
             return false;
 
-        QReadLocker lk(&rwLock);
-        if (Q_LIKELY(dispatcherMap.contains(type))) {
-            auto dispatcher = dispatcherMap.value(type);
-            lk.unlock();
-            if (dispatcher)
-                return dispatcher->dispatch();
-        }
+        if (auto dispatcher = findDispatcher(type))
+            return dispatcher->dispatch();
         return false;
     }
 
@@ -238,20 +273,15 @@ public:
     template<class T, class... Args>
     inline QFuture<bool> asyncPublish(EventType type, T param, Args &&... args)
     {
-        if (!globalFilterMap.isEmpty()) {
+        if (hasGlobalFilter()) {
             QVariantList ret;
             makeVariantList(&ret, param, std::forward<Args>(args)...);
             if (globalFiltered(type, ret))
                 return QFuture<bool>();
         }
 
-        QReadLocker lk(&rwLock);
-        if (Q_LIKELY(dispatcherMap.contains(type))) {
-            auto dispatcher { dispatcherMap[type] };
-            Q_ASSERT(dispatcher);
-            lk.unlock();
+        if (auto dispatcher = findDispatcher(type))
             return dispatcher->asyncDispatch(param, std::forward<Args>(args)...);
-        }
         return QFuture<bool>();
     }
 
@@ -263,16 +293,11 @@ public:
 
     inline QFuture<bool> asyncPublish(EventType type)
     {
-        if (!globalFilterMap.isEmpty() && globalFiltered(type, QVariantList()))
+        if (hasGlobalFilter() && globalFiltered(type, QVariantList()))
             return QFuture<bool>();
 
-        QReadLocker lk(&rwLock);
-        if (Q_LIKELY(dispatcherMap.contains(type))) {
-            auto dispatcher { dispatcherMap[type] };
-            Q_ASSERT(dispatcher);
-            lk.unlock();
+        if (auto dispatcher = findDispatcher(type))
             return dispatcher->asyncDispatch();
-        }
         return QFuture<bool>();
     }
 
@@ -306,6 +331,7 @@ public:
             DispatcherPtr dispatcher { new EventDispatcher };
             dispatcher->appendFilter(obj, method);
             dispatcherMap.insert(type, dispatcher);
+            updateDispatcherSnapshot();
         }
         return true;
     }
@@ -338,11 +364,30 @@ private:
     using DispatcherPtr = QSharedPointer<EventDispatcher>;
     using EventDispatcherMap = QMap<EventType, DispatcherPtr>;
     using GlobalEventFilterMap = QMap<QObject *, GlobalFilter>;
+    using DispatcherSnapshot = QHash<EventType, DispatcherPtr>;
+
+    inline DispatcherPtr findDispatcher(EventType type) const
+    {
+        const auto &snapshot = std::atomic_load(&dispatcherSnapshot);
+        return snapshot ? snapshot->value(type) : DispatcherPtr();
+    }
+
+    inline bool hasGlobalFilter() const
+    {
+        const auto &filters = std::atomic_load(&globalFilterSnapshot);
+        return filters && !filters->isEmpty();
+    }
+
+    void updateDispatcherSnapshot();
+    void updateGlobalFilterSnapshot();
 
 private:
+    // 写操作在 rwLock 保护下修改 map，然后发布只读快照；发布事件时只读取快照，不加锁
     EventDispatcherMap dispatcherMap;
     GlobalEventFilterMap globalFilterMap;
     QReadWriteLock rwLock;
+    std::shared_ptr<const DispatcherSnapshot> dispatcherSnapshot;
+    std::shared_ptr<const GlobalEventFilterMap> globalFilterSnapshot;
 };
 
 DPF_END_NAMESPACE
@@ -15,6 +15,9 @@
 #include <QCoreApplication>
 
 #include <mutex>
+#include <memory>
+#include <typeinfo>
+#include <functional>
 
 DPF_BEGIN_NAMESPACE
 
@@ -623,6 +626,53 @@ void *memberFunctionVoidCast(R (T::*f)(Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7,
     return p;
 }
 
+/*
+ * typed invoker: call the handler with the sender's arguments directly
+ * when both sides use the same (decayed) argument types, no QVariant boxing
+ */
+class TypedInvoker
+{
+public:
+    template<class Result, class... Args>
+    using Function = std::function<Result(const std::decay_t<Args> &...)>;
+
+    template<class Result, class... Args>
+    inline bool matches() const
+    {
+        return signature && *signature == typeid(Result(std::decay_t<Args>...));
+    }
+
+    template<class Result, class... Args>
+    inline Result invoke(const Args &... args) const
+    {
+        return (*static_cast<const Function<Result, Args...> *>(func.get()))(args...);
+    }
+
+    template<class Result, class T, class C, class R, class... Args>
+    static inline TypedInvoker create(T *obj, R (C::*method)(Args...))
+    {
+        TypedInvoker invoker;
+        invoker.signature = &typeid(Result(std::decay_t<Args>...));
+        invoker.func = std::make_shared<Function<Result, Args...>>([obj, method](const std::decay_t<Args> &... args) -> Result {
+            if constexpr (std::is_void_v<R>) {
+                (obj->*method)(args...);
+                return Result();
+            } else if constexpr (std::is_void_v<Result>) {
+                (obj->*method)(args...);
+            } else if constexpr (std::is_same_v<Result, QVariant>) {
+                return QVariant::fromValue((obj->*method)(args...));
+            } else {
+                return (obj->*method)(args...);
+            }
+        });
+        return invoker;
+    }
+
+private:
+    const std::type_info *signature { nullptr };
+    std::shared_ptr<const void> func;
+};
+
 /*
  * index to the event handler
  */
@@ -637,11 +687,13 @@ struct EventHandler
     // See: https://stackoverflow.com/questions/1307278/casting-between-void-and-a-pointer-to-member-function
     void *funcIndex;
     Method handler;
+    TypedInvoker typed;
 
-    inline EventHandler(QObject *obj, void *func, Method method)
+    inline EventHandler(QObject *obj, void *func, Method method, TypedInvoker invoker = TypedInvoker())
         : objectIndex(obj),
           funcIndex(func),
-          handler(method)
+          handler(method),
+          typed(std::move(invoker))
     {
     }
 
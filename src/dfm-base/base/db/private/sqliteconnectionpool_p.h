@@ -8,6 +8,8 @@
 #include <dfm-base/dfm_base_global.h>
 
 #include <QString>
+#include <QHash>
+#include <QMutex>
 #include <QtSql>
 
 DFMBASE_BEGIN_NAMESPACE
@@ -18,9 +20,13 @@ public:
     SqliteConnectionPoolPrivate();
     QString makeConnectionName(const QString &databaseName);
     QSqlDatabase createConnection(const QString &databaseName, const QString &connectionName);
+    void clearPreparedQueries(const QString &connectionName);
 
 public:
     QString connectionName;
+    // 每个连接缓存的预编译语句，key: 连接名 -> (sql -> query)
+    QMutex preparedMutex;
+    QHash<QString, QHash<QString, QSqlQuery>> preparedQueries;
 };
 
 DFMBASE_END_NAMESPACE
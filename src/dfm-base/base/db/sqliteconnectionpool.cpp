@@ -15,6 +15,7 @@ DFMBASE_USE_NAMESPACE
 
 static constexpr char kDatabaseType[] { "QSQLITE" };
 static constexpr char kTestSql[] { "SELECT 1" };
+static constexpr int kMaxPreparedQueries { 64 };
 
 SqliteConnectionPoolPrivate::SqliteConnectionPoolPrivate()
 {
@@ -36,6 +37,10 @@ QSqlDatabase SqliteConnectionPoolPrivate::createConnection(const QString &databa
 
     if (db.open()) {
         qCInfo(logDFMBase).noquote() << QString("Connection created: %1, sn: %2").arg(connectionName).arg(++sn);
+        // WAL 模式下读写互不阻塞，写事务提交时也不需要每次都同步整个数据库文件
+        QSqlQuery pragma { db };
+        if (!pragma.exec("PRAGMA journal_mode=WAL") || !pragma.exec("PRAGMA synchronous=NORMAL"))
+            qCWarning(logDFMBase).noquote() << "Set journal mode failed:" << pragma.lastError().text();
         return db;
     } else {
         qCWarning(logDFMBase).noquote() << "Create connection error:" << db.lastError().text();
@@ -43,6 +48,12 @@ QSqlDatabase SqliteConnectionPoolPrivate::createConnection(const QString &databa
     }
 }
 
+void SqliteConnectionPoolPrivate::clearPreparedQueries(const QString &connectionName)
+{
+    QMutexLocker locker(&preparedMutex);
+    preparedQueries.remove(connectionName);
+}
+
 SqliteConnectionPool::SqliteConnectionPool(QObject *parent)
     : QObject(parent), d(new SqliteConnectionPoolPrivate)
 {
@@ -72,14 +83,19 @@ QSqlDatabase SqliteConnectionPool::openConnection(const QString &databaseName)
                                                  .arg(kTestSql)
                                                  .arg(fullConnectionName);
         QSqlQuery query(kTestSql, existingDb);
-        if (query.lastError().type() != QSqlError::NoError && !existingDb.open()) {
-            qCCritical(logDFMBase).noquote() << "Open datatabase error:" << existingDb.lastError().text();
-            return QSqlDatabase();
+        if (query.lastError().type() != QSqlError::NoError) {
+            // 连接已经失效，缓存的预编译语句也不再可用
+            d->clearPreparedQueries(fullConnectionName);
+            if (!existingDb.open()) {
+                qCCritical(logDFMBase).noquote() << "Open datatabase error:" << existingDb.lastError().text();
+                return QSqlDatabase();
+            }
         }
         return existingDb;
     } else {
         if (qApp != nullptr) {
-            QObject::connect(QThread::currentThread(), &QThread::finished, qApp, [fullConnectionName] {
+            QObject::connect(QThread::currentThread(), &QThread::finished, qApp, [this, fullConnectionName] {
+                d->clearPreparedQueries(fullConnectionName);
                 if (QSqlDatabase::contains(fullConnectionName)) {
                     QSqlDatabase::removeDatabase(fullConnectionName);
                     qCInfo(logDFMBase).noquote() << QString("Connection deleted: %1").arg(fullConnectionName);
@@ -90,3 +106,32 @@ QSqlDatabase SqliteConnectionPool::openConnection(const QString &databaseName)
         return d->createConnection(databaseName, fullConnectionName);
     }
 }
+
+/*!
+ * \brief 获取当前线程连接上已经预编译的 sql 语句，相同的 sql 只会预编译一次
+ * \param databaseName
+ * \param sql 使用 ? 作为占位符的语句
+ * \return 预编译失败时返回的 query 处于非活动状态，可通过 lastError 获取错误
+ */
+QSqlQuery SqliteConnectionPool::preparedQuery(const QString &databaseName, const QString &sql)
+{
+    QSqlDatabase db { openConnection(databaseName) };
+    const QString &connectionName { db.connectionName() };
+
+    QMutexLocker locker(&d->preparedMutex);
+    auto &queries = d->preparedQueries[connectionName];
+    auto it = queries.find(sql);
+    if (it != queries.end())
+        return it.value();
+
+    QSqlQuery query { db };
+    if (!query.prepare(sql)) {
+        qCWarning(logDFMBase).noquote() << "SQL prepare error:" << query.lastError().text().trimmed() << sql;
+        return query;
+    }
+
+    if (queries.size() >= kMaxPreparedQueries)
+        queries.clear();
+    queries.insert(sql, query);
+    return query;
+}
@@ -21,6 +21,7 @@ class SqliteConnectionPool : public QObject
 public:
     static SqliteConnectionPool &instance();
     QSqlDatabase openConnection(const QString &databaseName);
+    QSqlQuery preparedQuery(const QString &databaseName, const QString &sql);
 
 private:
     explicit SqliteConnectionPool(QObject *parent = nullptr);
@@ -29,7 +29,9 @@ public:
         if (func())
             return db.commit();
 
-        return db.rollback();
+        // 回滚成功也表示事务中的操作失败了
+        db.rollback();
+        return false;
     }
 
     // Create table
@@ -73,6 +75,16 @@ public:
         return excute("DROP TABLE " + SqliteHelper::tableName<T>() + ";");
     }
 
+    // Create index
+    template<typename T>
+    bool createIndex(const QString &indexName, const QStringList &fields)
+    {
+        static_assert(std::is_base_of<QObject, T>::value, "Template type T must be derived QObject");
+        Q_ASSERT(!indexName.isEmpty() && !fields.isEmpty());
+        return excute("CREATE INDEX IF NOT EXISTS " + indexName + " ON " + SqliteHelper::tableName<T>()
+                      + "(" + fields.join(",") + ");");
+    }
+
     // Insert
     template<typename T>
     int insert(const T &entity, bool customPK = false)
@@ -170,6 +182,18 @@ public:
         return SqliteHelper::excute(databaseName, sql, &lastExcutedSql, fn);
     }
 
+    // 使用缓存的预编译语句执行，values 按顺序绑定到 sql 中的 ? 占位符
+    inline bool excutePrepared(const QString &sql, const QVariantList &values, std::function<void(QSqlQuery *)> fn = nullptr)
+    {
+        return SqliteHelper::excutePrepared(databaseName, sql, values, &lastExcutedSql, fn);
+    }
+
+    // 批量执行，columns 中每一项为一个占位符对应的一列值，建议在 transaction 中调用
+    inline bool excuteBatch(const QString &sql, const QList<QVariantList> &columns)
+    {
+        return SqliteHelper::excuteBatch(databaseName, sql, columns, &lastExcutedSql);
+    }
+
     inline QString lastQuery() const
     {
         return lastExcutedSql;
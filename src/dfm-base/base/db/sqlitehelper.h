@@ -465,6 +465,64 @@ public:
 
         return ret;
     }
+
+    // 生成 count 个以逗号分隔的占位符，用于 IN (...) 和多值绑定
+    static inline QString placeholders(int count)
+    {
+        if (count <= 0)
+            return {};
+
+        QString out;
+        out.reserve(count * 2);
+        for (int i = 0; i != count; ++i)
+            out += (i == 0 ? "?" : ",?");
+        return out;
+    }
+
+    // 使用缓存的预编译语句执行 sql，values 按顺序绑定到占位符
+    static inline bool excutePrepared(const QString &databaseName, const QString &sql, const QVariantList &values,
+                                      QString *lastQuery = nullptr, std::function<void(QSqlQuery *)> fn = nullptr)
+    {
+        QSqlQuery query { SqliteConnectionPool::instance().preparedQuery(databaseName, sql) };
+        for (int i = 0; i != values.size(); ++i)
+            query.bindValue(i, values.at(i));
+
+        bool ret { query.exec() };
+        if (lastQuery)
+            *lastQuery = sql;
+        if (!ret)
+            qCWarning(logDFMBase).noquote() << "SQL Error: " << query.lastError().text().trimmed() << sql;
+
+        if (ret && fn)
+            fn(&query);
+
+        // 释放语句持有的读锁，语句本身保留在缓存中复用
+        query.finish();
+        return ret;
+    }
+
+    // 批量执行同一条预编译语句，columns 中每一项是一个占位符对应的一列绑定值
+    static inline bool excuteBatch(const QString &databaseName, const QString &sql, const QList<QVariantList> &columns,
+                                   QString *lastQuery = nullptr)
+    {
+        if (columns.isEmpty() || columns.first().isEmpty())
+            return true;
+
+        QSqlQuery query { SqliteConnectionPool::instance().preparedQuery(databaseName, sql) };
+        for (int i = 0; i != columns.size(); ++i)
+            query.bindValue(i, columns.at(i));
+
+        bool ret { query.execBatch() };
+        if (lastQuery) {
+            *lastQuery = sql;
+            qCInfo(logDFMBase).noquote() << "SQL Batch:" << sql << "rows:" << columns.first().size();
+        }
+        if (!ret)
+            qCWarning(logDFMBase).noquote() << "SQL Error: " << query.lastError().text().trimmed() << sql;
+
+        query.finish();
+        return ret;
+    }
 };
 
 DFMBASE_END_NAMESPACE
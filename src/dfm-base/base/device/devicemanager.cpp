@@ -867,6 +867,11 @@ void DeviceManager::stopPollingDeviceUsage()
     d->watcher->stopPollingUsage();
 }
 
+void DeviceManager::requestDeviceUsageUpdate(const QStringList &ids)
+{
+    d->watcher->requestUsageUpdate(ids);
+}
+
 void DeviceManager::startMonitor()
 {
     if (isMonitoring())
@@ -85,6 +85,7 @@ public:
 
     void startPollingDeviceUsage();
     void stopPollingDeviceUsage();
+    void requestDeviceUsageUpdate(const QStringList &ids);
     void enableBlockAutoMount();
 
     void startMonitor();
@@ -88,6 +88,45 @@ void DeviceProxyManager::reloadOpticalInfo(const QString &id)
         DevMngIns->getBlockDevInfo(id, true);
 }
 
+/*!
+ * \brief DeviceProxyManager::requestUsageUpdate
+ * \param urls: files that are written or removed.
+ * ask the device watcher to refresh usage of devices which these files belong to.
+ */
+void DeviceProxyManager::requestUsageUpdate(const QList<QUrl> &urls)
+{
+    d->initMounts();
+    QStringList ids;
+    {
+        QReadLocker lk(&d->lock);
+        for (const QUrl &url : urls) {
+            if (!url.isLocalFile())
+                continue;
+
+            // files belong to the device with the longest matched mount point.
+            const QString &path = url.path().endsWith("/") ? url.path() : url.path() + "/";
+            QString id;
+            int matched = 0;
+            for (auto iter = d->allMounts.cbegin(); iter != d->allMounts.cend(); ++iter) {
+                if (iter.value().length() > matched && path.startsWith(iter.value())) {
+                    id = iter.key();
+                    matched = iter.value().length();
+                }
+            }
+            if (!id.isEmpty() && !ids.contains(id))
+                ids.append(id);
+        }
+    }
+
+    if (ids.isEmpty())
+        return;
+
+    if (d->isDBusRuning() && d->devMngDBus)
+        d->devMngDBus->RequestUsageUpdate(ids);
+    else
+        DevMngIns->requestDeviceUsageUpdate(ids);
+}
+
 bool DeviceProxyManager::initService()
 {
     d->initConnection();
@@ -9,6 +9,7 @@
 #include <dfm-base/dbusservice/global_server_defines.h>
 
 #include <QObject>
+#include <QUrl>
 
 #define DevProxyMng DFMBASE_NAMESPACE::DeviceProxyManager::instance()
 
@@ -41,6 +42,7 @@ public:
 
     // device operation
     void reloadOpticalInfo(const QString &id);
+    void requestUsageUpdate(const QList<QUrl> &urls);
 
     bool initService();
     bool isDBusRuning();
@@ -14,6 +14,8 @@
 
 #include <QVariantMap>
 #include <QDebug>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QStorageInfo>
 #include <QtConcurrent>
 
@@ -27,6 +29,10 @@ using namespace dfmbase;
 DFM_MOUNT_USE_NS
 using namespace GlobalServerDefines;
 
+// usage changes smaller than this are invisible in views, do not notify them.
+static constexpr quint64 kMinUsageDelta { 1024 * 1024 };
+static constexpr quint64 kUsageDeltaRatio { 10000 };
+
 DeviceWatcher::DeviceWatcher(QObject *parent)
     : QObject(parent), d(new DeviceWatcherPrivate(this))
 {
@@ -42,7 +48,7 @@ void DeviceWatcher::startPollingUsage()
         return;
     d->queryUsageAsync();
     connect(&d->pollingTimer, &QTimer::timeout, d.data(), &DeviceWatcherPrivate::queryUsageAsync);
-    d->pollingTimer.start(d->kPollingInterval);
+    d->pollingTimer.start(d->kFastPollingInterval);
 }
 
 void DeviceWatcher::stopPollingUsage()
@@ -51,16 +57,98 @@ void DeviceWatcher::stopPollingUsage()
     disconnect(&d->pollingTimer);
 }
 
+/*!
+ * \brief DeviceWatcher::requestUsageUpdate
+ * \param ids
+ * files are written to these devices, query their usage at next polling and keep polling fast for a while.
+ */
+void DeviceWatcher::requestUsageUpdate(const QStringList &ids)
+{
+    d->requestUsageUpdate(ids);
+}
+
+QHash<QString, DeviceWatcher::UsageStatistics> DeviceWatcher::usageStatistics() const
+{
+    QMutexLocker lk(&d->usageMutex);
+    return d->usageStatistics;
+}
+
 void DeviceWatcherPrivate::queryUsageAsync()
 {
-    QtConcurrent::run([this] {
-        auto blocks = allBlockInfos;
-        auto protocols = allProtocolInfos;
-        std::for_each(blocks.cbegin(), blocks.cend(),
-                      [this](const QVariantMap &item) { queryUsageOfItem(item, DeviceType::kBlockDevice); });
-        std::for_each(protocols.cbegin(), protocols.cend(),
-                      [this](const QVariantMap &item) { queryUsageOfItem(item, DeviceType::kProtocolDevice); });
-    });
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto query = [this, now](const QHash<QString, QVariantMap> &infos, DeviceType type, QThreadPool *pool) {
+        for (auto iter = infos.cbegin(); iter != infos.cend(); ++iter) {
+            const QString &mpt = iter.value().value(DeviceProperty::kMountPoint).toString();
+            if (mpt.isEmpty())
+                continue;
+            if (!isUsageQueryDue(iter.key(), mpt, type, now))
+                continue;
+
+            const QVariantMap item = iter.value();
+            QtConcurrent::run(pool, [this, item, type] { queryUsageOfItem(item, type); });
+        }
+    };
+
+    query(allBlockInfos, DeviceType::kBlockDevice, &blockUsagePool);
+    query(allProtocolInfos, DeviceType::kProtocolDevice, &protocolUsagePool);
+}
+
+bool DeviceWatcherPrivate::isUsageQueryDue(const QString &id, const QString &mpt, dfmmount::DeviceType type, qint64 now)
+{
+    QMutexLocker lk(&usageMutex);
+    DevUsageState &state = usageStates[id];
+    if (state.queryStartTime > 0) {
+        // the last query is not finished, do not stack another one on an unresponsive mount.
+        if (!state.runningTimedOut && now - state.queryStartTime > kQueryTimeout) {
+            state.timedOut = true;
+            state.runningTimedOut = true;
+            ++usageStatistics[mpt].timeouts;
+            qCWarning(logDFMBase) << "query usage timeout:" << id;
+        }
+        return false;
+    }
+
+    int interval = kPollingInterval;
+    if (state.timedOut)
+        interval = kSlowPollingInterval;
+    else if (now < state.fastUntil)
+        interval = kFastPollingInterval;
+    else if (type == DeviceType::kProtocolDevice || state.idleRounds >= kIdleRounds)
+        interval = kSlowPollingInterval;
+
+    if (now - state.lastQueryTime < interval)
+        return false;
+
+    state.queryStartTime = now;
+    state.runningTimedOut = false;
+    return true;
+}
+
+void DeviceWatcherPrivate::requestUsageUpdate(const QStringList &ids)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker lk(&usageMutex);
+    for (const QString &id : ids) {
+        DevUsageState &state = usageStates[id];
+        state.lastQueryTime = 0;
+        state.fastUntil = now + kFastPollingPeriod;
+        state.idleRounds = 0;
+    }
+}
+
+void DeviceWatcherPrivate::removeUsageState(const QString &id)
+{
+    QMutexLocker lk(&usageMutex);
+    usageStates.remove(id);
+}
+
+bool DeviceWatcherPrivate::isUsageChanged(const DevStorage &old, const DevStorage &now)
+{
+    if (old.total != now.total)
+        return true;
+
+    const quint64 delta = old.avai > now.avai ? old.avai - now.avai : now.avai - old.avai;
+    return delta >= qMax(kMinUsageDelta, now.total / kUsageDeltaRatio);
 }
 
 void DeviceWatcherPrivate::updateStorage(const QString &id, quint64 total, quint64 avai)
@@ -89,19 +177,50 @@ void DeviceWatcherPrivate::queryUsageOfItem(const QVariantMap &itemData, dfmmoun
     if (mpt.isEmpty())
         return;
 
-    DevStorage old { itemData.value(DeviceProperty::kSizeTotal).toULongLong(),
-                     itemData.value(DeviceProperty::kSizeFree).toULongLong(),
-                     itemData.value(DeviceProperty::kSizeUsed).toULongLong() };
-
     if (type == DFMMOUNT::DeviceType::kAllDevice)
         return;
 
+    QElapsedTimer timer;
+    timer.start();
     DevStorage newStorage = (type == dfmmount::DeviceType::kBlockDevice)
             ? queryUsageOfBlock(itemData)
             : queryUsageOfProtocol(itemData);
+    const qint64 cost = timer.elapsed();
+
+    const QString &devId = itemData.value(DeviceProperty::kId).toString();
+    bool changed = false;
+    {
+        QMutexLocker lk(&usageMutex);
+        auto &statistics = usageStatistics[mpt];
+        ++statistics.queries;
+        statistics.lastCost = cost;
+        statistics.maxCost = qMax(statistics.maxCost, cost);
+        statistics.totalCost += cost;
+
+        DevUsageState &state = usageStates[devId];
+        const bool slow = cost > kQueryTimeout;
+        if (slow) {
+            if (!state.runningTimedOut)
+                ++statistics.timeouts;
+            qCWarning(logDFMBase) << "query usage of" << mpt << "takes" << cost << "ms";
+        }
+        state.timedOut = slow;
+        state.runningTimedOut = false;
+        state.queryStartTime = 0;
+        state.lastQueryTime = QDateTime::currentMSecsSinceEpoch();
+
+        if (newStorage.isValid()) {
+            changed = isUsageChanged(state.storage, newStorage);
+            if (changed) {
+                state.storage = newStorage;
+                state.idleRounds = 0;
+            } else {
+                ++state.idleRounds;
+            }
+        }
+    }
 
-    if (/*old != newStorage && */ newStorage.isValid()) {
-        const QString &devId = itemData.value(DeviceProperty::kId).toString();
+    if (changed) {
         emit DevMngIns->devSizeChanged(devId,
                                        newStorage.total,
                                        newStorage.avai);
@@ -324,6 +443,7 @@ void DeviceWatcher::onBlkDevAdded(const QString &id)
 void DeviceWatcher::onBlkDevRemoved(const QString &id)
 {
     qCDebug(logDFMBase) << "block device removed: " << id;
+    d->removeUsageState(id);
     QString oldMpt = d->allBlockInfos.value(id).value(DeviceProperty::kMountPoint).toString();
     d->allBlockInfos.remove(id);
     emit DevMngIns->blockDevRemoved(id, oldMpt);
@@ -332,6 +452,7 @@ void DeviceWatcher::onBlkDevRemoved(const QString &id)
 void DeviceWatcher::onBlkDevMounted(const QString &id, const QString &mpt)
 {
     const QVariantMap &info = d->allBlockInfos.value(id);
+    d->removeUsageState(id);
     // query info async avoid blocking main thread when disks' IO load is too high.
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     QtConcurrent::run(&DeviceWatcherPrivate::queryUsageOfItem, d.data(), info, DFMMOUNT::DeviceType::kBlockDevice);
@@ -344,6 +465,7 @@ void DeviceWatcher::onBlkDevMounted(const QString &id, const QString &mpt)
 void DeviceWatcher::onBlkDevUnmounted(const QString &id)
 {
     QString oldMpt = d->allBlockInfos.value(id).value(DeviceProperty::kMountPoint).toString();
+    d->removeUsageState(id);
     d->allBlockInfos[id][DeviceProperty::kMountPoint] = QString();
     d->allBlockInfos[id].remove(DeviceProperty::kSizeFree);
     d->allBlockInfos[id].remove(DeviceProperty::kSizeUsed);
@@ -432,6 +554,7 @@ void DeviceWatcher::onProtoDevRemoved(const QString &id)
     qCDebug(logDFMBase) << "protocol device removed: " << id;
     QString oldMpt = d->allProtocolInfos.value(id).value(DeviceProperty::kMountPoint).toString();
     d->allProtocolInfos.remove(id);
+    d->removeUsageState(id);
 
     emit DevMngIns->protocolDevRemoved(id, oldMpt);
 }
@@ -439,6 +562,7 @@ void DeviceWatcher::onProtoDevRemoved(const QString &id)
 void DeviceWatcher::onProtoDevMounted(const QString &id, const QString &mpt)
 {
     d->allProtocolInfos.insert(id, DeviceHelper::loadProtocolInfo(id));
+    d->removeUsageState(id);
 
     emit DevMngIns->protocolDevMounted(id, mpt);
 }
@@ -451,6 +575,7 @@ void DeviceWatcher::onProtoDevUnmounted(const QString &id)
     //    else
     QString oldMpt = d->allProtocolInfos.value(id).value(DeviceProperty::kMountPoint).toString();
     d->allProtocolInfos.remove(id);
+    d->removeUsageState(id);
 
     emit DevMngIns->protocolDevUnmounted(id, oldMpt);
 }
@@ -521,4 +646,6 @@ DeviceWatcherPrivate::DeviceWatcherPrivate(DeviceWatcher *qq)
 {
     connect(DevProxyMng, &DeviceProxyManager::devSizeChanged, this, &DeviceWatcherPrivate::updateStorage, Qt::QueuedConnection);
     DConfigManager::instance()->addConfig("org.deepin.dde.file-manager.mount");
+    blockUsagePool.setMaxThreadCount(4);
+    protocolUsagePool.setMaxThreadCount(4);
 }
@@ -8,6 +8,7 @@
 #include <dfm-base/dfm_base_global.h>
 
 #include <QObject>
+#include <QHash>
 
 #include <dfm-mount/base/dmount_global.h>
 
@@ -25,6 +26,16 @@ class DeviceWatcher : public QObject
     friend class DeviceManager;
 
 public:
+    // latency of usage queries of a mount point, in milliseconds
+    struct UsageStatistics
+    {
+        int queries { 0 };
+        int timeouts { 0 };
+        qint64 lastCost { 0 };
+        qint64 maxCost { 0 };
+        qint64 totalCost { 0 };
+    };
+
     explicit DeviceWatcher(QObject *parent = nullptr);
     virtual ~DeviceWatcher() override;
 
@@ -34,6 +45,8 @@ public:
 
     void startPollingUsage();
     void stopPollingUsage();
+    void requestUsageUpdate(const QStringList &ids);
+    QHash<QString, UsageStatistics> usageStatistics() const;
 
     void startWatch();
     void stopWatch();
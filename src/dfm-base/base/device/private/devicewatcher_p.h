@@ -5,9 +5,12 @@
 #ifndef DEVICEWATCHER_P_H
 #define DEVICEWATCHER_P_H
 
+#include "devicewatcher.h"
+
 #include <QTimer>
 #include <QMutex>
 #include <QHash>
+#include <QThreadPool>
 #include <QtCore/qobjectdefs.h>
 
 #include <dfm-mount/base/dmount_global.h>
@@ -20,21 +23,32 @@ struct DevStorage
     quint64 avai { 0 };
     quint64 used { 0 };
 
-    inline bool operator==(const DevStorage &other)
+    inline bool operator==(const DevStorage &other) const
     {
         return total == other.total && avai == other.avai && used == other.used;
     }
-    inline bool operator!=(const DevStorage &other)
+    inline bool operator!=(const DevStorage &other) const
     {
         return !(this->operator==(other));
     }
-    inline bool isValid()
+    inline bool isValid() const
     {
         return this->operator!=({});
     }
 };
 
-class DeviceWatcher;
+// the polling state of a mounted device, guarded by DeviceWatcherPrivate::usageMutex
+struct DevUsageState
+{
+    qint64 lastQueryTime { 0 };
+    qint64 queryStartTime { 0 };   // not 0 means a query is running
+    qint64 fastUntil { 0 };   // poll fast until then after files are written to the device
+    int idleRounds { 0 };   // continuous queries that usage is not changed
+    bool timedOut { false };
+    bool runningTimedOut { false };   // the running query is already counted as timed out
+    DevStorage storage;   // the last emitted usage
+};
+
 class DeviceWatcherPrivate : public QObject
 {
     Q_OBJECT
@@ -48,15 +62,32 @@ private Q_SLOTS:
     void updateStorage(const QString &id, quint64 total, quint64 avai);
 
 private:
+    bool isUsageQueryDue(const QString &id, const QString &mpt, DFMMOUNT::DeviceType type, qint64 now);
+    void requestUsageUpdate(const QStringList &ids);
+    void removeUsageState(const QString &id);
     void queryUsageOfItem(const QVariantMap &itemData, DFMMOUNT::DeviceType type);
     DevStorage queryUsageOfBlock(const QVariantMap &itemData);
     DevStorage queryUsageOfProtocol(const QVariantMap &itemData);
+    static bool isUsageChanged(const DevStorage &old, const DevStorage &now);
 
 private:
     DeviceWatcher *q { nullptr };
 
     QTimer pollingTimer;
     const int kPollingInterval = 10000;
+    const int kFastPollingInterval = 2000;   // also the interval of pollingTimer
+    const int kSlowPollingInterval = 60000;   // for network, idle and unresponsive devices
+    const int kFastPollingPeriod = 30000;
+    const int kQueryTimeout = 5000;
+    const int kIdleRounds = 3;
+
+    // a slow mount only blocks its own thread, do not use the global pool.
+    // network mounts hang more often, keep them from starving the queries of block devices.
+    QThreadPool blockUsagePool;
+    QThreadPool protocolUsagePool;
+    QMutex usageMutex;
+    QHash<QString, DevUsageState> usageStates;
+    QHash<QString, DeviceWatcher::UsageStatistics> usageStatistics;
 
     QHash<QString, QVariantMap> allBlockInfos;
     QHash<QString, QVariantMap> allProtocolInfos;
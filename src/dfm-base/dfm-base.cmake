@@ -69,6 +69,9 @@ add_library(${BIN_NAME}
     ${SRCS}
 )
 
+# pinyin table for Pinyin::Chinese2Pinyin, compiled from qrc/chinese2pinyin/pinyin.dict
+GENERATE_PINYIN_TABLE(${BIN_NAME})
+
 if(${QT_VERSION_MAJOR} EQUAL "6")
     qt6_add_dbus_interface(Qt6App_dbus
         ${DFM_DBUS_XML_DIR}/org.deepin.Filemanager.Daemon.DeviceManager.xml
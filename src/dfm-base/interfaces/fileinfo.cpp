@@ -310,7 +310,7 @@ QString dfmbase::FileInfo::displayOf(const DisPlayInfoType type) const
     case DisPlayInfoType::kFileDisplayPinyinName:
         if (pinyinName.isEmpty()) {
             const QString &displayName = this->displayOf(DisplayInfoType::kFileDisplayName);
-            const_cast<FileInfo *>(this)->pinyinName = Pinyin::Chinese2Pinyin(displayName);
+            Pinyin::Chinese2Pinyin(displayName, &const_cast<FileInfo *>(this)->pinyinName);
         }
 
         return pinyinName;
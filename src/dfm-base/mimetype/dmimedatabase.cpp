@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "dmimedatabase.h"
+#include "mimetypecache.h"
 
 #include <dfm-base/utils/fileutils.h>
 #include <dfm-base/base/schemefactory.h>
@@ -27,6 +28,25 @@ DMimeDatabase::DMimeDatabase()
 {
 }
 
+bool DMimeDatabase::onlyMatchExtension(const QString &filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    const QString &path = fileInfo.path();
+    if (ProtocolUtils::isRemoteFile(QUrl::fromLocalFile(path)))
+        return true;
+
+    const QString &fileName = fileInfo.fileName();
+    if (fileName.endsWith(".pid") || path.endsWith("msg.lock")
+        || fileName.endsWith(".lock") || fileName.endsWith("lockfile")) {
+        static const QRegularExpression regExp("^/run/user/\\d+/gvfs/(?<scheme>\\w+(-?)\\w+):\\S*",
+                                               QRegularExpression::DotMatchesEverythingOption
+                                                       | QRegularExpression::DontCaptureOption);
+        return regExp.match(path).hasMatch();
+    }
+
+    return blackList.contains(fileInfo.isSymLink() ? fileInfo.symLinkTarget() : fileInfo.absoluteFilePath());
+}
+
 QMimeType DMimeDatabase::mimeTypeForFile(const QUrl &url, QMimeDatabase::MatchMode mode) const
 {
     const FileInfoPointer &fileInfo = InfoFactory::create<FileInfo>(url);
@@ -75,7 +95,7 @@ QMimeType DMimeDatabase::mimeTypeForFile(const FileInfoPointer &fileInfo, QMimeD
     if (isMatchExtension || ProtocolUtils::isRemoteFile(QUrl::fromLocalFile(path))) {
         result = QMimeDatabase::mimeTypeForFile(fileInfo->pathOf(PathInfoType::kFilePath), QMimeDatabase::MatchExtension);
     } else {
-        result = QMimeDatabase::mimeTypeForFile(fileInfo->pathOf(PathInfoType::kFilePath), mode);
+        result = MimeTypeCache::instance()->mimeTypeForFile(fileInfo->pathOf(PathInfoType::kFilePath), mode);
     }
 
     // temporary dirty fix, once WPS get installed, the whole mimetype database thing get fscked up.
@@ -151,7 +171,7 @@ QMimeType DMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, QMimeDatabas
     if (isMatchExtension || ProtocolUtils::isRemoteFile(QUrl::fromLocalFile(path))) {
         result = QMimeDatabase::mimeTypeForFile(fileInfo, QMimeDatabase::MatchExtension);
     } else {
-        result = QMimeDatabase::mimeTypeForFile(fileInfo, mode);
+        result = MimeTypeCache::instance()->mimeTypeForFile(fileInfo.absoluteFilePath(), mode);
     }
 
     // temporary dirty fix, once WPS get installed, the whole mimetype database thing get fscked up.
@@ -24,6 +24,9 @@ public:
     QMimeType mimeTypeForFile(const QString &fileName, MatchMode mode, const QString &inod, const bool isGvfs = false) const;
     QMimeType mimeTypeForUrl(const QUrl &url) const;
 
+    // 远程文件、gvfs 下的锁文件和黑名单中的系统文件读取内容可能卡死，只能按扩展名识别
+    static bool onlyMatchExtension(const QString &filePath);
+
 private:
     QMimeType mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mode, const QString &inod, const bool isGvfs = false) const;
 
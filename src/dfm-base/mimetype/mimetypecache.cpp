@@ -0,0 +1,365 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mimetypecache.h"
+
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QThread>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#include <cstring>
+
+namespace dfmbase {
+
+// 与 QMimeDatabase 识别文件内容时读取的长度一致
+static constexpr int kSniffSize { 16384 };
+static constexpr char kCacheMagic[8] = { 'D', 'F', 'M', 'M', 'I', 'M', 'E', '1' };
+static constexpr qint64 kMaxCacheFileSize { 32 * 1024 * 1024 };
+static constexpr int kMaxPendingSize { 4096 };
+static constexpr qint64 kFlushInterval { 2000 };
+static constexpr qint64 kRefreshInterval { 1000 };
+// 少量文件时直接在调用线程中识别
+static constexpr int kMinParallelSniff { 16 };
+static constexpr int kMaxCachedFiles { 200000 };
+
+// 缓存记录：dev, inode, mtime, size, mode, 名称长度, 名称
+static constexpr int kRecordHeaderSize { 8 * 4 + 4 + 2 };
+
+uint qHash(const MimeTypeCache::Key &key, uint seed)
+{
+    return ::qHash(key.dev, seed) ^ ::qHash(key.inode, seed) ^ ::qHash(key.mtime, seed)
+            ^ ::qHash(key.size, seed) ^ key.mode;
+}
+
+MimeTypeCache *MimeTypeCache::instance()
+{
+    static MimeTypeCache ins(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                             + "/deepin/dde-file-manager/mimetype.cache");
+    return &ins;
+}
+
+MimeTypeCache::MimeTypeCache(const QString &cacheFile)
+    : cacheFile(cacheFile)
+{
+    loadRecords();
+}
+
+MimeTypeCache::~MimeTypeCache()
+{
+    flush();
+}
+
+QMimeType MimeTypeCache::mimeTypeForFile(const QString &filePath, QMimeDatabase::MatchMode mode)
+{
+    ++lookupCount;
+
+    Key key;
+    if (!makeKey(filePath, mode, &key))
+        return db.mimeTypeForFile(filePath, mode);
+
+    QMimeType result;
+    if (fastPath(filePath, mode, &result) || find(key, &result))
+        return result;
+
+    return sniff(filePath, mode, key);
+}
+
+QList<QMimeType> MimeTypeCache::mimeTypesForFiles(const QStringList &filePaths, QMimeDatabase::MatchMode mode)
+{
+    QList<QMimeType> results;
+    results.reserve(filePaths.count());
+    QVector<int> sniffIndexes;
+    QVector<Key> sniffKeys;
+    for (const QString &filePath : filePaths) {
+        ++lookupCount;
+
+        Key key;
+        QMimeType result;
+        if (!makeKey(filePath, mode, &key)) {
+            results.append(db.mimeTypeForFile(filePath, mode));
+        } else if (fastPath(filePath, mode, &result) || find(key, &result)) {
+            results.append(result);
+        } else {
+            sniffIndexes.append(results.count());
+            sniffKeys.append(key);
+            results.append(QMimeType());
+        }
+    }
+
+    if (sniffIndexes.count() < kMinParallelSniff) {
+        for (int i = 0; i < sniffIndexes.count(); ++i)
+            results[sniffIndexes.at(i)] = sniff(filePaths.at(sniffIndexes.at(i)), mode, sniffKeys.at(i));
+        return results;
+    }
+
+    // 识别只读取文件头部，瓶颈在 IO，线程数不需要太多
+    QVector<QMimeType> sniffed(sniffIndexes.count());
+    QAtomicInt next { 0 };
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 4));
+    for (int i = 0; i < pool.maxThreadCount(); ++i) {
+        pool.start(QRunnable::create([&]() {
+            for (int index = next.fetchAndAddOrdered(1); index < sniffIndexes.count(); index = next.fetchAndAddOrdered(1))
+                sniffed[index] = sniff(filePaths.at(sniffIndexes.at(index)), mode, sniffKeys.at(index));
+        }));
+    }
+    pool.waitForDone();
+
+    for (int i = 0; i < sniffIndexes.count(); ++i)
+        results[sniffIndexes.at(i)] = sniffed.at(i);
+    return results;
+}
+
+MimeTypeCache::Statistics MimeTypeCache::statistics() const
+{
+    Statistics s;
+    s.lookups = lookupCount;
+    s.fastPaths = fastPathCount;
+    s.cacheHits = hitCount;
+    s.sniffs = sniffCount;
+    return s;
+}
+
+void MimeTypeCache::flush()
+{
+    QMutexLocker lk(&fileMutex);
+    lastFlushTime = QDateTime::currentMSecsSinceEpoch();
+    if (pendingRecords.isEmpty() || cacheFile.isEmpty())
+        return;
+
+    QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+    int fd = ::open(QFile::encodeName(cacheFile).constData(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        pendingRecords.clear();
+        return;
+    }
+
+    // 多个进程同时追加，加锁保证文件头和每批记录完整
+    ::flock(fd, LOCK_EX);
+    struct stat st;
+    QByteArray data;
+    if (::fstat(fd, &st) == 0 && st.st_size == 0)
+        data.append(kCacheMagic, sizeof(kCacheMagic));
+    data.append(pendingRecords);
+    if (::write(fd, data.constData(), static_cast<size_t>(data.size())) != static_cast<ssize_t>(data.size()))
+        qCWarning(logDFMBase) << "Failed to write mimetype cache:" << cacheFile;
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+    pendingRecords.clear();
+}
+
+bool MimeTypeCache::makeKey(const QString &filePath, QMimeDatabase::MatchMode mode, Key *key) const
+{
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+
+    key->dev = static_cast<quint64>(st.st_dev);
+    key->inode = static_cast<quint64>(st.st_ino);
+    key->mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    key->size = static_cast<qint64>(st.st_size);
+    key->mode = static_cast<quint32>(mode);
+    return true;
+}
+
+bool MimeTypeCache::fastPath(const QString &filePath, QMimeDatabase::MatchMode mode, QMimeType *result)
+{
+    if (mode != QMimeDatabase::MatchDefault)
+        return false;
+
+    // 与 QMimeDatabase 的规则一致，文件名只匹配到一种类型时不读取内容
+    const QList<QMimeType> &types = db.mimeTypesForFileName(filePath);
+    if (types.count() != 1)
+        return false;
+
+    ++fastPathCount;
+    *result = types.first();
+    return true;
+}
+
+bool MimeTypeCache::find(const Key &key, QMimeType *result)
+{
+    QString name;
+    {
+        QReadLocker lk(&lock);
+        name = mimeNames.value(key);
+    }
+
+    // 其他进程可能已经识别过，读取缓存文件中新追加的记录
+    if (name.isEmpty() && QDateTime::currentMSecsSinceEpoch() - lastRefreshTime > kRefreshInterval) {
+        loadRecords();
+        QReadLocker lk(&lock);
+        name = mimeNames.value(key);
+    }
+
+    if (name.isEmpty())
+        return false;
+
+    *result = mimeTypeForName(name);
+    if (!result->isValid())
+        return false;
+
+    ++hitCount;
+    return true;
+}
+
+QMimeType MimeTypeCache::sniff(const QString &filePath, QMimeDatabase::MatchMode mode, const Key &key)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return db.mimeTypeForFile(filePath, mode);
+
+    ++sniffCount;
+    const QByteArray &data = file.read(kSniffSize);
+    file.close();
+
+    const QMimeType &result = mode == QMimeDatabase::MatchContent
+            ? db.mimeTypeForData(data)
+            : db.mimeTypeForFileNameAndData(filePath, data);
+    if (!result.isValid())
+        return result;
+
+    {
+        QWriteLocker lk(&lock);
+        if (mimeNames.size() >= kMaxCachedFiles)
+            mimeNames.clear();
+        mimeNames.insert(key, result.name());
+    }
+    appendRecord(key, result.name());
+    return result;
+}
+
+QMimeType MimeTypeCache::mimeTypeForName(const QString &name)
+{
+    {
+        QReadLocker lk(&lock);
+        auto it = mimeTypes.constFind(name);
+        if (it != mimeTypes.constEnd())
+            return it.value();
+    }
+
+    const QMimeType &type = db.mimeTypeForName(name);
+    QWriteLocker lk(&lock);
+    mimeTypes.insert(name, type);
+    return type;
+}
+
+void MimeTypeCache::loadRecords()
+{
+    QMutexLocker lk(&fileMutex);
+    lastRefreshTime = QDateTime::currentMSecsSinceEpoch();
+    if (cacheFile.isEmpty())
+        return;
+
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    // 缓存文件过大时清空重建，其他进程发现文件变小后从头读取
+    if (file.size() > kMaxCacheFileSize) {
+        file.close();
+        resetCacheFile();
+        return;
+    }
+
+    if (file.size() < fileOffset)
+        fileOffset = 0;
+    if (file.size() == fileOffset)
+        return;
+
+    if (fileOffset == 0) {
+        if (file.read(sizeof(kCacheMagic)) != QByteArray(kCacheMagic, sizeof(kCacheMagic)))
+            return;
+        fileOffset = sizeof(kCacheMagic);
+    }
+
+    file.seek(fileOffset);
+    const QByteArray &data = file.readAll();
+    file.close();
+
+    QHash<Key, QString> records;
+    int pos = 0;
+    while (pos + kRecordHeaderSize <= data.size()) {
+        Key key;
+        quint16 length = 0;
+        const char *p = data.constData() + pos;
+        memcpy(&key.dev, p, 8);
+        memcpy(&key.inode, p + 8, 8);
+        memcpy(&key.mtime, p + 16, 8);
+        memcpy(&key.size, p + 24, 8);
+        memcpy(&key.mode, p + 32, 4);
+        memcpy(&length, p + 36, 2);
+        if (length == 0 || length > 255 || pos + kRecordHeaderSize + length > data.size())
+            break;
+
+        records.insert(key, QString::fromLatin1(p + kRecordHeaderSize, length));
+        pos += kRecordHeaderSize + length;
+    }
+    fileOffset += pos;
+
+    if (records.isEmpty())
+        return;
+
+    QWriteLocker wlk(&lock);
+    if (mimeNames.size() + records.size() > kMaxCachedFiles)
+        mimeNames.clear();
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it)
+        mimeNames.insert(it.key(), it.value());
+}
+
+void MimeTypeCache::resetCacheFile()
+{
+    int fd = ::open(QFile::encodeName(cacheFile).constData(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    // 与 flush 使用同一把锁，避免其他进程在截断前后追加记录，导致文件头丢失
+    ::flock(fd, LOCK_EX);
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > kMaxCacheFileSize) {
+        if (::ftruncate(fd, 0) != 0
+            || ::pwrite(fd, kCacheMagic, sizeof(kCacheMagic), 0) != static_cast<ssize_t>(sizeof(kCacheMagic)))
+            qCWarning(logDFMBase) << "Failed to reset mimetype cache:" << cacheFile;
+    }
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+    fileOffset = 0;
+}
+
+void MimeTypeCache::appendRecord(const Key &key, const QString &name)
+{
+    const QByteArray &latin1 = name.toLatin1();
+    const quint16 length = static_cast<quint16>(latin1.size());
+    char header[kRecordHeaderSize];
+    memcpy(header, &key.dev, 8);
+    memcpy(header + 8, &key.inode, 8);
+    memcpy(header + 16, &key.mtime, 8);
+    memcpy(header + 24, &key.size, 8);
+    memcpy(header + 32, &key.mode, 4);
+    memcpy(header + 36, &length, 2);
+
+    bool needFlush = false;
+    {
+        QMutexLocker lk(&fileMutex);
+        pendingRecords.append(header, kRecordHeaderSize);
+        pendingRecords.append(latin1);
+        needFlush = pendingRecords.size() > kMaxPendingSize
+                || QDateTime::currentMSecsSinceEpoch() - lastFlushTime > kFlushInterval;
+    }
+
+    if (needFlush)
+        flush();
+}
+
+}
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MIMETYPECACHE_H
+#define MIMETYPECACHE_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QMimeDatabase>
+#include <QReadWriteLock>
+#include <QMutex>
+#include <QHash>
+#include <QAtomicInteger>
+
+namespace dfmbase {
+
+/*!
+ * \brief 本地文件的 mimetype 解析
+ * 扩展名能唯一确定类型时直接返回，否则读取一次文件头部识别，
+ * 识别结果按 (dev, inode, mtime, size) 缓存，并追加到缓存文件中与其他进程共享。
+ */
+class MimeTypeCache
+{
+    Q_DISABLE_COPY(MimeTypeCache)
+
+public:
+    struct Statistics
+    {
+        quint64 lookups { 0 };     // 查询次数
+        quint64 fastPaths { 0 };   // 按扩展名确定的次数
+        quint64 cacheHits { 0 };   // 命中缓存的次数
+        quint64 sniffs { 0 };      // 读取文件内容识别的次数
+
+        double hitRate() const { return cacheHits + sniffs > 0 ? double(cacheHits) / (cacheHits + sniffs) : 0; }
+    };
+
+    static MimeTypeCache *instance();
+
+    QMimeType mimeTypeForFile(const QString &filePath, QMimeDatabase::MatchMode mode = QMimeDatabase::MatchDefault);
+    QList<QMimeType> mimeTypesForFiles(const QStringList &filePaths, QMimeDatabase::MatchMode mode = QMimeDatabase::MatchDefault);
+
+    Statistics statistics() const;
+    void flush();
+
+private:
+    explicit MimeTypeCache(const QString &cacheFile);
+    ~MimeTypeCache();
+
+    struct Key
+    {
+        quint64 dev { 0 };
+        quint64 inode { 0 };
+        qint64 mtime { 0 };
+        qint64 size { 0 };
+        quint32 mode { 0 };
+
+        bool operator==(const Key &other) const
+        {
+            return dev == other.dev && inode == other.inode && mtime == other.mtime
+                    && size == other.size && mode == other.mode;
+        }
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+    bool makeKey(const QString &filePath, QMimeDatabase::MatchMode mode, Key *key) const;
+    bool fastPath(const QString &filePath, QMimeDatabase::MatchMode mode, QMimeType *result);
+    bool find(const Key &key, QMimeType *result);
+    QMimeType sniff(const QString &filePath, QMimeDatabase::MatchMode mode, const Key &key);
+    QMimeType mimeTypeForName(const QString &name);
+
+    void loadRecords();
+    void resetCacheFile();
+    void appendRecord(const Key &key, const QString &name);
+
+private:
+    QMimeDatabase db;
+    QString cacheFile;
+
+    mutable QReadWriteLock lock;
+    QHash<Key, QString> mimeNames;
+    QHash<QString, QMimeType> mimeTypes;
+
+    QMutex fileMutex;
+    qint64 fileOffset { 0 };   // 已读取到的缓存文件位置，其他进程追加的记录从这里开始读
+    QAtomicInteger<qint64> lastRefreshTime { 0 };
+    qint64 lastFlushTime { 0 };
+    QByteArray pendingRecords;
+
+    QAtomicInteger<quint64> lookupCount { 0 };
+    QAtomicInteger<quint64> fastPathCount { 0 };
+    QAtomicInteger<quint64> hitCount { 0 };
+    QAtomicInteger<quint64> sniffCount { 0 };
+};
+
+}
+
+#endif   // MIMETYPECACHE_H
@@ -4,58 +4,97 @@
 
 #include "chinese2pinyin.h"
 
-#include <QHash>
-#include <QTextStream>
-#include <QFile>
+// 由 qrc/chinese2pinyin/pinyin.dict 在编译时生成
+#include "pinyintable.h"
 
-namespace Pinyin {
-
-static QHash<uint, QString> dict = {};
-
-const char kDictFile[] = ":/misc/pinyin.dict";
-
-void InitDict() {
-    if (!dict.isEmpty()) {
-        return;
-    }
-
-    dict.reserve(25333);
+#include <QVarLengthArray>
 
-    QFile file(kDictFile);
+#include <algorithm>
 
-    if (!file.open(QIODevice::ReadOnly))
-        return;
-
-    QByteArray content = file.readAll();
-
-    file.close();
+namespace Pinyin {
 
-    QTextStream stream(&content, QIODevice::ReadOnly);
+// 字典中最小的码位，小于它的字符（包括全部 ASCII）不需要查表
+static constexpr char16_t kFirstCode = Table::kEntries[0].code;
+static constexpr char16_t kLastCode = Table::kEntries[Table::kEntryCount - 1].code;
+
+// 查找字符的读音，返回在 kSyllablePool 中的起止位置，没有读音时返回 false
+static inline bool findSyllable(char16_t code, int *begin, int *end)
+{
+    if (code < kFirstCode || code > kLastCode)
+        return false;
+
+    const Table::Entry *last = Table::kEntries + Table::kEntryCount;
+    const Table::Entry *it = std::lower_bound(Table::kEntries, last, code,
+                                              [](const Table::Entry &entry, char16_t c) { return entry.code < c; });
+    if (it == last || it->code != code)
+        return false;
+
+    *begin = Table::kSyllableOffsets[it->syllable];
+    *end = Table::kSyllableOffsets[it->syllable + 1];
+    return true;
+}
 
-    while (!stream.atEnd()) {
-        const QString line = stream.readLine();
-        const QStringList items = line.split(QChar(':'));
+static inline bool hasChinese(const QString &words)
+{
+    const QChar *data = words.constData();
+    for (int i = 0; i < words.length(); ++i) {
+        if (data[i].unicode() >= kFirstCode)
+            return true;
+    }
+    return false;
+}
 
-        if (items.size() == 2) {
-            dict.insert(static_cast<uint>(items[0].toInt(nullptr, 16)), items[1]);
+// 转换到 buffer 中，buffer 至少要有 words.length() * kMaxSyllableLength 的空间，返回写入的长度
+static int convert(const QString &words, QChar *buffer)
+{
+    const QChar *data = words.constData();
+    QChar *out = buffer;
+    int begin = 0;
+    int end = 0;
+    for (int i = 0; i < words.length(); ++i) {
+        if (!findSyllable(data[i].unicode(), &begin, &end)) {
+            *out++ = data[i];
+            continue;
         }
+
+        for (int j = begin; j < end; ++j)
+            *out++ = QLatin1Char(Table::kSyllablePool[j]);
     }
+    return static_cast<int>(out - buffer);
 }
 
 QString Chinese2Pinyin(const QString& words) {
-    InitDict();
-
     QString result;
+    Chinese2Pinyin(words, &result);
+    return result;
+}
 
-    for (int i = 0; i < words.length(); ++i) {
-        const uint key = words.at(i).unicode();
-        auto find_result = dict.find(key);
+void Chinese2Pinyin(const QString& words, QString *result) {
+    Q_ASSERT(result);
 
-        if (find_result != dict.end()) {
-            result.append(find_result.value());
-        } else {
-            result.append(words.at(i));
+    // 不含汉字时直接共享原字符串，不分配内存
+    if (!hasChinese(words)) {
+        *result = words;
+        return;
+    }
+
+    result->resize(words.length() * Table::kMaxSyllableLength);
+    result->resize(convert(words, result->data()));
+}
+
+QStringList Chinese2Pinyin(const QStringList& words) {
+    QStringList result;
+    result.reserve(words.size());
+
+    QVarLengthArray<QChar, 1024> buffer;
+    for (const QString &word : words) {
+        if (!hasChinese(word)) {
+            result.append(word);
+            continue;
         }
+
+        buffer.resize(word.length() * Table::kMaxSyllableLength);
+        result.append(QString(buffer.constData(), convert(word, buffer.data())));
     }
 
     return result;
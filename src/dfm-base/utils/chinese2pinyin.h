@@ -6,9 +6,14 @@
 #define CHINESE_2_PINYIN_H
 
 #include <QString>
+#include <QStringList>
 
 namespace Pinyin {
 QString Chinese2Pinyin(const QString& words);
+// 转换结果写入 result，复用其中已分配的空间
+void Chinese2Pinyin(const QString& words, QString *result);
+// 批量转换，所有名称共用一个转换缓冲区
+QStringList Chinese2Pinyin(const QStringList& words);
 };
 
 #endif  // CHINESE_2_PINYIN_H
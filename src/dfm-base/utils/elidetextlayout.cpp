@@ -46,6 +46,121 @@ QString ElideTextLayout::text() const
 }
 
 QList<QRectF> ElideTextLayout::layout(const QRectF &rect, Qt::TextElideMode elideMode, QPainter *painter, const QBrush &background, QStringList *textLines)
+{
+    const int textLineHeight = attribute<int>(kLineHeight);
+    if (!cacheEnabled || documentModified || textLineHeight <= 0)
+        return layoutDocument(rect, elideMode, painter, background, textLines);
+
+    // 与 layoutDocument 的判断一致：第 n 行之后放不下下一行时在第 n 行省略
+    int maxLines = 1;
+    while ((maxLines + 1) * textLineHeight <= rect.height())
+        ++maxLines;
+
+    TextLayoutCache::Key key;
+    key.text = text();
+    key.font = attribute<QFont>(kFont).key();
+    key.width = rect.width();
+    key.lineHeight = textLineHeight;
+    key.maxLines = maxLines;
+    key.elideMode = elideMode;
+    key.wrapMode = attribute<uint>(kWrapMode);
+    key.alignment = attribute<uint>(kAlignment);
+    key.direction = attribute<int>(kTextDirection);
+
+    auto cache = TextLayoutCache::instance();
+    auto lines = cache->find(key);
+    if (!lines) {
+        lines = layoutLines(rect.size(), maxLines, elideMode);
+        cache->insert(key, lines);
+    }
+
+    QList<QRectF> ret;
+    QRectF lastLineRect;
+    const QPointF offset = rect.topLeft();
+    for (int i = 0; i < lines->rects.count(); ++i) {
+        const QRectF &lRect = lines->rects.at(i).translated(offset);
+        ret.append(lRect);
+        if (!painter)
+            continue;
+
+        if (background.style() != Qt::NoBrush)
+            lastLineRect = drawLineBackground(painter, lRect, lastLineRect, background);
+
+        if (i < lines->bodyLines)
+            lines->body->lineAt(i).draw(painter, offset);
+        else
+            lines->elided->lineAt(0).draw(painter, offset);
+    }
+
+    if (textLines)
+        textLines->append(lines->texts);
+
+    return ret;
+}
+
+TextLayoutCache::LinesPointer ElideTextLayout::layoutLines(const QSizeF &size, int maxLines, Qt::TextElideMode elideMode)
+{
+    QSharedPointer<TextLayoutCache::Lines> lines(new TextLayoutCache::Lines);
+    const int textLineHeight = attribute<int>(kLineHeight);
+    const QString curText = text();
+    QPointF offset;
+
+    auto appendLine = [&lines, textLineHeight](const QTextLine &line, const QString &lineText) {
+        QRectF lRect = line.naturalTextRect();
+        lRect.setHeight(textLineHeight);
+        lines->rects.append(lRect);
+        lines->texts.append(lineText.mid(line.textStart(), line.textLength()));
+    };
+
+    QString elideText;
+    lines->body.reset(new QTextLayout(curText));
+    QTextLayout *lay = lines->body.data();
+    initLayoutOption(lay);
+    lay->beginLayout();
+    QTextLine line = lay->createLine();
+    while (line.isValid()) {
+        line.setLineWidth(size.width());
+        line.setPosition(offset);
+
+        if (lines->bodyLines + 1 == maxLines) {
+            auto nextLine = lay->createLine();
+            if (nextLine.isValid()) {
+                QFontMetrics fm(lay->font());
+                elideText = fm.elidedText(curText.mid(line.textStart()), elideMode, qRound(size.width()));
+                break;
+            }
+        }
+
+        appendLine(line, curText);
+        ++lines->bodyLines;
+
+        line = lay->createLine();
+        offset.setY(offset.y() + textLineHeight);
+    }
+    lay->endLayout();
+
+    if (!elideText.isEmpty()) {
+        lines->elided.reset(new QTextLayout(elideText));
+        QTextLayout *newlay = lines->elided.data();
+        {
+            auto oldWrap = attribute<uint>(kWrapMode);
+            setAttribute(kWrapMode, static_cast<uint>(QTextOption::NoWrap));
+            initLayoutOption(newlay);
+            setAttribute(kWrapMode, oldWrap);
+        }
+
+        newlay->beginLayout();
+        auto elidedLine = newlay->createLine();
+        elidedLine.setLineWidth(size.width() - 1);
+        elidedLine.setPosition(offset);
+        appendLine(elidedLine, elideText);
+        newlay->endLayout();
+    }
+
+    return lines;
+}
+
+QList<QRectF> ElideTextLayout::layoutDocument(const QRectF &rect, Qt::TextElideMode elideMode, QPainter *painter, const QBrush &background, QStringList *textLines)
 {
     QList<QRectF> ret;
     QTextLayout *lay = document->firstBlock().layout();
@@ -5,6 +5,8 @@
 #ifndef ELIDETEXTLAYOUT_H
 #define ELIDETEXTLAYOUT_H
 
+#include <dfm-base/utils/textlayoutcache.h>
+
 #include <QString>
 #include <QBrush>
 #include <QVariant>
@@ -32,8 +34,14 @@ public:
     void setText(const QString &text);
     QString text() const;
     QList<QRectF> layout(const QRectF &rect, Qt::TextElideMode elideMode, QPainter *painter = nullptr, const QBrush &background = Qt::NoBrush, QStringList *textLines = nullptr);
+    // 使用 TextLayoutCache 中的排版结果，文档被外部修改后不再使用缓存
+    inline void setCacheEnabled(bool enable) {
+        cacheEnabled = enable;
+    }
+
 public:
     inline QTextDocument *documentHandle() {
+        documentModified = true;
         return document;
     }
 
@@ -49,9 +57,13 @@ public:
 protected:
     QRectF drawLineBackground(QPainter *painter, const QRectF &curLineRect, QRectF lastLineRect, const QBrush &brush) const;
     virtual void initLayoutOption(QTextLayout *lay);
+    QList<QRectF> layoutDocument(const QRectF &rect, Qt::TextElideMode elideMode, QPainter *painter, const QBrush &background, QStringList *textLines);
+    TextLayoutCache::LinesPointer layoutLines(const QSizeF &size, int maxLines, Qt::TextElideMode elideMode);
 protected:
     QTextDocument *document = nullptr;
     QMap<Attribute, QVariant> attributes;
+    bool cacheEnabled = false;
+    bool documentModified = false;
 };
 }
 
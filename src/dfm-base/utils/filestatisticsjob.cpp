@@ -19,16 +19,141 @@
 #include <QWaitCondition>
 #include <QStorageInfo>
 #include <QElapsedTimer>
+#include <QThreadPool>
+#include <QDateTime>
+#include <QFile>
 #include <QDebug>
 
 #include <fts.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <dirent.h>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace dfmbase {
 
 static constexpr uint16_t kSizeChangeinterval { 200 };
 
+namespace {
+using InodeKey = QPair<quint64, quint64>;   // (dev, inode)
+
+// 目录大小缓存的有效期：目录的 mtime 只反映目录项的增删和重命名，
+// 文件被原地修改引起的大小变化要等缓存过期后才能统计到
+static constexpr qint64 kDirCacheTimeout { 5 * 60 * 1000 };
+static constexpr int kMaxCachedDirs { 500000 };
+// 影响统计结果的选项，缓存只在这些选项相同时复用
+static constexpr int kCacheHintsMask { FileStatisticsJob::kNoFollowSymlink | FileStatisticsJob::kDontSkipCharDeviceFile
+                                       | FileStatisticsJob::kDontSkipBlockDeviceFile | FileStatisticsJob::kDontSkipFIFOFile
+                                       | FileStatisticsJob::kDontSkipSocketFile | FileStatisticsJob::kDontSkipAVFSDStorage
+                                       | FileStatisticsJob::kDontSkipPROCStorage };
+
+struct Statistics
+{
+    qint64 totalSize { 0 };
+    qint64 totalProgressSize { 0 };
+    int filesCount { 0 };
+    int directoryCount { 0 };
+};
+
+// 一个目录直接包含的内容，按 (dev, inode, mtime) 缓存
+struct DirCacheEntry
+{
+    qint64 mtime { 0 };
+    qint64 cachedTime { 0 };
+    int hints { 0 };
+    Statistics statistics;   // 不包含多硬链接的文件
+    QVector<QByteArray> subdirs;
+    QVector<QPair<InodeKey, qint64>> hardLinks;   // 多硬链接的文件在统计时去重
+};
+
+/*!
+ * \brief 进程内的目录大小缓存
+ * 每个目录在使用缓存前都会重新 fstat，(dev, inode, mtime) 不一致时重新读取目录项。
+ * 缓存不写入磁盘：目录的 mtime 无法反映文件的原地修改，跨会话保存的结果无法校验，
+ * 只在进程内保存并设置有效期，限制统计结果滞后的时间。
+ */
+class DirSizeCache
+{
+public:
+    static DirSizeCache &instance()
+    {
+        static DirSizeCache cache;
+        return cache;
+    }
+
+    bool find(const InodeKey &key, qint64 mtime, int hints, DirCacheEntry *entry)
+    {
+        QMutexLocker lk(&mutex);
+        auto it = entries.constFind(key);
+        if (it == entries.constEnd() || it->mtime != mtime || it->hints != hints
+            || QDateTime::currentMSecsSinceEpoch() - it->cachedTime > kDirCacheTimeout)
+            return false;
+        *entry = it.value();
+        return true;
+    }
+
+    void insert(const InodeKey &key, DirCacheEntry &&entry)
+    {
+        entry.cachedTime = QDateTime::currentMSecsSinceEpoch();
+        QMutexLocker lk(&mutex);
+        if (entries.size() >= kMaxCachedDirs && !entries.contains(key))
+            entries.clear();
+        entries.insert(key, std::move(entry));
+    }
+
+private:
+    QMutex mutex;
+    QHash<InodeKey, DirCacheEntry> entries;
+};
+
+// 本地目录统计中的一个目录，需要文件列表时按广度优先的顺序组织
+struct DirNode
+{
+    QByteArray path;
+    QVector<QByteArray> entries;
+    std::vector<std::unique_ptr<DirNode>> children;
+};
+
+struct DirTask
+{
+    QByteArray path;
+    quint64 parentDev { 0 };
+    DirNode *node { nullptr };
+};
+
+struct LocalStatisticsContext
+{
+    QMutex mutex;
+    QWaitCondition condition;
+    QVector<DirTask> tasks;
+    int busyWorkers { 0 };
+    bool aborted { false };
+
+    QMutex visitedMutex;
+    QSet<InodeKey> visitedDirs;
+    QSet<QByteArray> sourcePaths;
+
+    bool followLink { true };
+    bool collectFileList { false };
+    int cacheHints { 0 };
+};
+
+InodeKey inodeKey(const struct stat &st)
+{
+    return { static_cast<quint64>(st.st_dev), static_cast<quint64>(st.st_ino) };
+}
+
+qint64 mtimeOf(const struct stat &st)
+{
+    return static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+}
+
 FileStatisticsJobPrivate::FileStatisticsJobPrivate(FileStatisticsJob *qq)
     : QObject(nullptr), q(qq), notifyDataTimer(nullptr)
 {
@@ -278,7 +403,16 @@ bool FileStatisticsJobPrivate::checkInode(const FileInfoPointer info)
 {
     auto fileInode = info->extendAttributes(ExtInfoType::kInode).toULongLong();
     if (fileInode > 0) {
-        if (inodelist.contains(fileInode)) {
+        // 不同设备上的 inode 会重复，本地文件同时用设备号区分
+        quint64 dev { 0 };
+        const QUrl &url = info->urlOf(UrlInfoType::kUrl);
+        struct stat st;
+        if (url.isLocalFile() && ::lstat(QFile::encodeName(url.toLocalFile()).constData(), &st) == 0) {
+            dev = static_cast<quint64>(st.st_dev);
+            fileInode = static_cast<quint64>(st.st_ino);
+        }
+
+        if (!insertInode(dev, fileInode)) {
             if (info->isAttributes(OptInfoType::kIsFile)) {
                 filesCount++;
             } else {
@@ -286,11 +420,315 @@ bool FileStatisticsJobPrivate::checkInode(const FileInfoPointer info)
             }
             return false;
         }
-        inodelist.insert(fileInode);
     }
     return true;
 }
 
+bool FileStatisticsJobPrivate::insertInode(quint64 dev, quint64 ino)
+{
+    QMutexLocker lk(&inodeMutex);
+    if (inodelist.contains({ dev, ino }))
+        return false;
+    inodelist.insert({ dev, ino });
+    return true;
+}
+
+bool FileStatisticsJobPrivate::canStatisticsLocally(const QList<QUrl> &directories) const
+{
+    if (directories.isEmpty())
+        return false;
+
+    return std::all_of(directories.begin(), directories.end(), [](const QUrl &url) {
+        return url.scheme() == Global::Scheme::kFile;
+    });
+}
+
+/*!
+ * \brief 多线程统计本地目录
+ * 每个线程从共享的目录栈中取出目录，用 getdents64 读取目录项、fstatat 获取属性，
+ * 在线程内的累加器中汇总，每处理完一个目录再合并到总数中，用于进度通知。
+ * 目录的直接内容按 (dev, inode, mtime) 缓存，目录没有变化时不再读取目录项。
+ */
+void FileStatisticsJobPrivate::statisticsLocalDirectories(const QList<QUrl> &directories)
+{
+    LocalStatisticsContext context;
+    context.followLink = !fileHints.testFlag(FileStatisticsJob::kNoFollowSymlink);
+    context.collectFileList = fileHints.testFlag(FileStatisticsJob::kCollectFileList);
+    context.cacheHints = static_cast<int>(fileHints) & kCacheHintsMask;
+    for (const QUrl &url : allFiles)
+        if (url.isLocalFile())
+            context.sourcePaths.insert(QFile::encodeName(url.toLocalFile()));
+
+    std::vector<std::unique_ptr<DirNode>> roots;
+    for (const QUrl &url : directories) {
+        roots.emplace_back(new DirNode);
+        roots.back()->path = QFile::encodeName(url.toLocalFile());
+        context.tasks.append({ roots.back()->path, 0, roots.back().get() });
+    }
+
+    const quint16 pageSize = FileUtils::getMemoryPageSize();
+    const QByteArrayList skipFiles { QByteArrayLiteral("/proc/kcore"), QByteArrayLiteral("/dev/core") };
+
+    // 跨越挂载点时检查是否需要跳过 proc/avfsd 文件系统
+    auto skipMountPoint = [this](const QByteArray &path) {
+        if (fileHints & (FileStatisticsJob::kDontSkipAVFSDStorage | FileStatisticsJob::kDontSkipPROCStorage))
+            return false;
+        QStorageInfo si(QFile::decodeName(path));
+        if (si.rootPath() != QFile::decodeName(path))
+            return false;
+        return (!fileHints.testFlag(FileStatisticsJob::kDontSkipPROCStorage) && si.device() == "proc")
+                || (!fileHints.testFlag(FileStatisticsJob::kDontSkipAVFSDStorage) && si.device() == "avfsd");
+    };
+
+    auto skipFileType = [this](mode_t mode) {
+        return (S_ISCHR(mode) && !fileHints.testFlag(FileStatisticsJob::kDontSkipCharDeviceFile))
+                || (S_ISBLK(mode) && !fileHints.testFlag(FileStatisticsJob::kDontSkipBlockDeviceFile))
+                || (S_ISFIFO(mode) && !fileHints.testFlag(FileStatisticsJob::kDontSkipFIFOFile))
+                || (S_ISSOCK(mode) && !fileHints.testFlag(FileStatisticsJob::kDontSkipSocketFile));
+    };
+
+    auto publish = [this](Statistics &local) {
+        totalSize += local.totalSize;
+        totalProgressSize += local.totalProgressSize;
+        filesCount += local.filesCount;
+        directoryCount += local.directoryCount;
+        local = Statistics();
+    };
+
+    auto pushTask = [&context](DirTask &&task) {
+        QMutexLocker lk(&context.mutex);
+        context.tasks.append(std::move(task));
+        context.condition.wakeOne();
+    };
+
+    auto replayCache = [&](const DirTask &task, quint64 dev, const DirCacheEntry &entry, Statistics &local) {
+        local.totalSize += entry.statistics.totalSize;
+        local.totalProgressSize += entry.statistics.totalProgressSize;
+        local.filesCount += entry.statistics.filesCount;
+        local.directoryCount += entry.statistics.directoryCount;
+        for (const auto &link : entry.hardLinks) {
+            ++local.filesCount;
+            if (!insertInode(link.first.first, link.first.second))
+                continue;
+            local.totalSize += link.second;
+            local.totalProgressSize += link.second > 0 ? link.second : pageSize;
+        }
+        for (const auto &name : entry.subdirs) {
+            QByteArray path = task.path;
+            if (!path.endsWith('/'))
+                path.append('/');
+            // 子目录同样需要检查是否跨越了要跳过的挂载点
+            pushTask({ path.append(name), dev, nullptr });
+        }
+    };
+
+    auto visit = [&](const DirTask &task, Statistics &local) {
+        int fd = ::open(task.path.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        struct stat dirStat;
+        if (::fstat(fd, &dirStat) != 0) {
+            ::close(fd);
+            return;
+        }
+
+        const InodeKey dirKey = inodeKey(dirStat);
+        {
+            QMutexLocker lk(&context.visitedMutex);
+            if (context.visitedDirs.contains(dirKey)) {
+                ::close(fd);
+                return;
+            }
+            context.visitedDirs.insert(dirKey);
+        }
+
+        // 跨越挂载点的子目录在父目录中已经计数
+        if (task.parentDev != 0 && task.parentDev != static_cast<quint64>(dirStat.st_dev) && skipMountPoint(task.path)) {
+            ::close(fd);
+            return;
+        }
+
+        DirCacheEntry entry;
+        if (!context.collectFileList
+            && DirSizeCache::instance().find(dirKey, mtimeOf(dirStat), context.cacheHints, &entry)) {
+            ::close(fd);
+            replayCache(task, static_cast<quint64>(dirStat.st_dev), entry, local);
+            return;
+        }
+
+        entry.mtime = mtimeOf(dirStat);
+        entry.hints = context.cacheHints;
+        bool cacheable = true;
+        Statistics &direct = entry.statistics;
+        QByteArray prefix = task.path;
+        if (!prefix.endsWith('/'))
+            prefix.append('/');
+        char buffer[32 * 1024];
+        int batchCount = 0;
+        for (;;) {
+            const long n = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                cacheable = cacheable && n == 0;
+                break;
+            }
+
+            for (long offset = 0; offset < n;) {
+                auto *dirent = reinterpret_cast<struct dirent64 *>(buffer + offset);
+                offset += dirent->d_reclen;
+                const char *name = dirent->d_name;
+                if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+                    continue;
+
+                QByteArray path = prefix;
+                path.append(name);
+                // 同时被选中统计的文件不重复计数
+                if (!context.sourcePaths.isEmpty() && context.sourcePaths.contains(path)) {
+                    cacheable = false;
+                    continue;
+                }
+
+                struct stat st;
+                if (::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+
+                if (task.node)
+                    task.node->entries.append(path);
+
+                if (S_ISLNK(st.st_mode)) {
+                    // 链接目标的变化不会修改所在目录的 mtime
+                    cacheable = false;
+                    struct stat target;
+                    if (::fstatat(fd, name, &target, 0) != 0) {
+                        ++direct.filesCount;
+                        continue;
+                    }
+
+                    if (S_ISDIR(target.st_mode)) {
+                        ++direct.directoryCount;
+                        direct.totalProgressSize += pageSize;
+                        if (context.followLink) {
+                            DirTask child { path, static_cast<quint64>(dirStat.st_dev), nullptr };
+                            if (task.node) {
+                                task.node->children.emplace_back(new DirNode);
+                                child.node = task.node->children.back().get();
+                                child.node->path = path;
+                            }
+                            pushTask(std::move(child));
+                        }
+                        continue;
+                    }
+
+                    ++direct.filesCount;
+                    if (!insertInode(static_cast<quint64>(target.st_dev), static_cast<quint64>(target.st_ino)))
+                        continue;
+                    if (target.st_size > 0)
+                        direct.totalSize += target.st_size;
+                    direct.totalProgressSize += pageSize;
+                    continue;
+                }
+
+                if (S_ISDIR(st.st_mode)) {
+                    ++direct.directoryCount;
+                    direct.totalProgressSize += pageSize;
+                    DirTask child { path, static_cast<quint64>(dirStat.st_dev), nullptr };
+                    if (task.node) {
+                        task.node->children.emplace_back(new DirNode);
+                        child.node = task.node->children.back().get();
+                        child.node->path = path;
+                    }
+                    entry.subdirs.append(name);
+                    pushTask(std::move(child));
+                    continue;
+                }
+
+                ++direct.filesCount;
+                if (skipFiles.contains(path) || skipFileType(st.st_mode))
+                    continue;
+
+                if (st.st_nlink > 1) {
+                    --direct.filesCount;
+                    entry.hardLinks.append({ inodeKey(st), static_cast<qint64>(st.st_size) });
+                    continue;
+                }
+
+                if (st.st_size > 0)
+                    direct.totalSize += st.st_size;
+                direct.totalProgressSize += st.st_size > 0 ? st.st_size : pageSize;
+            }
+
+            if (++batchCount % 16 == 0 && !stateCheck()) {
+                cacheable = false;
+                break;
+            }
+        }
+        ::close(fd);
+
+        // 缓存中保留的是目录的直接内容，子目录展开和硬链接去重在统计时完成
+        DirCacheEntry cached;
+        if (cacheable)
+            cached = entry;
+        entry.subdirs.clear();
+        replayCache(task, static_cast<quint64>(dirStat.st_dev), entry, local);
+        if (cacheable)
+            DirSizeCache::instance().insert(dirKey, std::move(cached));
+    };
+
+    auto worker = [&]() {
+        Statistics local;
+        for (;;) {
+            DirTask task;
+            {
+                QMutexLocker lk(&context.mutex);
+                while (context.tasks.isEmpty() && context.busyWorkers > 0 && !context.aborted)
+                    context.condition.wait(&context.mutex);
+                if (context.tasks.isEmpty() || context.aborted) {
+                    context.condition.wakeAll();
+                    break;
+                }
+                task = context.tasks.takeLast();
+                ++context.busyWorkers;
+            }
+
+            if (stateCheck())
+                visit(task, local);
+            publish(local);
+
+            QMutexLocker lk(&context.mutex);
+            --context.busyWorkers;
+            if (state == FileStatisticsJob::kStoppedState)
+                context.aborted = true;
+            if (context.aborted || (context.tasks.isEmpty() && context.busyWorkers == 0))
+                context.condition.wakeAll();
+        }
+        publish(local);
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+    for (int i = 0; i < pool.maxThreadCount(); ++i)
+        pool.start(QRunnable::create(worker));
+
+    elapsedTimer.restart();
+    while (!pool.waitForDone(kSizeChangeinterval))
+        Q_EMIT q->sizeChanged(totalSize);
+
+    if (!context.collectFileList)
+        return;
+
+    // 按广度优先的顺序输出文件列表，与单线程遍历的顺序一致
+    QQueue<DirNode *> nodes;
+    for (const auto &root : roots)
+        nodes.enqueue(root.get());
+    while (!nodes.isEmpty()) {
+        DirNode *node = nodes.dequeue();
+        for (const auto &path : node->entries)
+            sizeInfo->allFiles << QUrl::fromLocalFile(QFile::decodeName(path));
+        for (const auto &child : node->children)
+            nodes.enqueue(child.get());
+    }
+}
+
 FileStatisticsJob::FileStatisticsJob(QObject *parent)
     : QThread(parent), d(new FileStatisticsJobPrivate(this))
 {
@@ -506,6 +944,13 @@ void FileStatisticsJob::statistcsOtherFileSystem()
         return;
     }
 
+    if (d->canStatisticsLocally(directory_queue)) {
+        d->statisticsLocalDirectories(directory_queue);
+        setSizeInfo();
+        d->setState(kStoppedState);
+        return;
+    }
+
     while (!directory_queue.isEmpty()) {
         const QUrl &directory_url = directory_queue.dequeue();
         d->iterator = DirIteratorFactory::create<AbstractDirIterator>(directory_url, QStringList(),
@@ -525,7 +970,8 @@ void FileStatisticsJob::statistcsOtherFileSystem()
                 continue;
 
             d->processFile(url, followLink, directory_queue);
-            d->sizeInfo->allFiles << url;
+            if (d->fileHints.testFlag(kCollectFileList))
+                d->sizeInfo->allFiles << url;
             d->allFiles.insert(url);
 
             if (!d->stateCheck()) {
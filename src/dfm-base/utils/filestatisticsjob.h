@@ -37,6 +37,7 @@ public:
         kNoFollowSymlink = 0x0001,
         kExcludeSourceFile = 0x0002,
         kSingleDepth = 0x0004,
+        kCollectFileList = 0x0008,   // fill FilesSizeInfo::allFiles with every file found
 
         kDontSkipAVFSDStorage = 0x0010,
         kDontSkipPROCStorage = 0x0020,
@@ -0,0 +1,387 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "filetagsnapshot.h"
+
+#include <QDebug>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/memfd.h>
+
+#include <cerrno>
+#include <cstring>
+
+using namespace dfmbase;
+
+namespace {
+constexpr quint32 kSnapshotMagic { 0x47415444 };   // "DTAG"
+constexpr quint32 kSnapshotVersion { 1 };
+
+struct SnapshotHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint64 sequence;
+    quint32 tagCount;
+    quint32 fileCount;
+    quint32 bucketCount;
+    quint32 reserved;
+    quint32 tagOffset;
+    quint32 bucketOffset;
+    quint32 entryOffset;
+    quint32 stringOffset;
+    quint32 idOffset;
+    quint32 totalSize;
+};
+
+struct TagRecord
+{
+    quint32 nameOffset;
+    quint32 nameLength;
+};
+
+struct FileEntry
+{
+    quint64 hash;
+    quint32 pathOffset;
+    quint32 pathLength;
+    quint32 idIndex;
+    quint32 idCount;
+};
+
+// 跨进程稳定的哈希，不能使用带随机种子的 qHash
+quint64 pathHash(const char *data, int length)
+{
+    quint64 hash { 14695981039346656037ULL };
+    for (int i = 0; i < length; ++i) {
+        hash ^= static_cast<uchar>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+quint32 alignUp(quint32 value, quint32 align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+template<typename T>
+const T *recordAt(const uchar *base, quint32 offset, quint32 index)
+{
+    return reinterpret_cast<const T *>(base + offset + index * sizeof(T));
+}
+}
+
+FileTagSnapshot::~FileTagSnapshot()
+{
+    detach();
+}
+
+/*!
+ * \brief 将文件到标签的映射序列化为快照数据
+ * \param sequence 生成快照时标签数据的变更序号
+ */
+QByteArray FileTagSnapshot::build(quint64 sequence, const QHash<QString, QStringList> &fileTags)
+{
+    QHash<QString, quint32> tagIndexes;
+    QVector<TagRecord> tags;
+    QVector<FileEntry> entries;
+    QVector<quint32> ids;
+    QByteArray strings;
+    entries.reserve(fileTags.size());
+
+    auto tagIdOf = [&](const QString &name) {
+        auto it = tagIndexes.constFind(name);
+        if (it != tagIndexes.constEnd())
+            return it.value();
+
+        const QByteArray &utf8 { name.toUtf8() };
+        tags.append({ static_cast<quint32>(strings.size()), static_cast<quint32>(utf8.size()) });
+        strings.append(utf8);
+        const quint32 id = static_cast<quint32>(tags.size() - 1);
+        tagIndexes.insert(name, id);
+        return id;
+    };
+
+    for (auto it = fileTags.cbegin(); it != fileTags.cend(); ++it) {
+        if (it.value().isEmpty())
+            continue;
+
+        const QByteArray &path { it.key().toUtf8() };
+        FileEntry entry;
+        entry.hash = pathHash(path.constData(), path.size());
+        entry.pathOffset = static_cast<quint32>(strings.size());
+        entry.pathLength = static_cast<quint32>(path.size());
+        entry.idIndex = static_cast<quint32>(ids.size());
+        entry.idCount = static_cast<quint32>(it.value().size());
+        strings.append(path);
+        for (const QString &tag : it.value())
+            ids.append(tagIdOf(tag));
+        entries.append(entry);
+    }
+
+    // 负载因子不超过 0.5
+    quint32 bucketCount { 2 };
+    while (bucketCount < static_cast<quint32>(entries.size()) * 2)
+        bucketCount <<= 1;
+    QVector<quint32> buckets(static_cast<int>(bucketCount), 0);
+    for (int i = 0; i < entries.size(); ++i) {
+        quint32 pos = static_cast<quint32>(entries.at(i).hash) & (bucketCount - 1);
+        while (buckets.at(static_cast<int>(pos)) != 0)
+            pos = (pos + 1) & (bucketCount - 1);
+        buckets[static_cast<int>(pos)] = static_cast<quint32>(i + 1);
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kSnapshotMagic;
+    header.version = kSnapshotVersion;
+    header.sequence = sequence;
+    header.tagCount = static_cast<quint32>(tags.size());
+    header.fileCount = static_cast<quint32>(entries.size());
+    header.bucketCount = bucketCount;
+    header.tagOffset = sizeof(SnapshotHeader);
+    header.bucketOffset = header.tagOffset + header.tagCount * sizeof(TagRecord);
+    header.entryOffset = alignUp(header.bucketOffset + bucketCount * sizeof(quint32), alignof(FileEntry));
+    header.stringOffset = header.entryOffset + header.fileCount * sizeof(FileEntry);
+    header.idOffset = alignUp(header.stringOffset + static_cast<quint32>(strings.size()), sizeof(quint32));
+    header.totalSize = header.idOffset + static_cast<quint32>(ids.size()) * sizeof(quint32);
+
+    QByteArray data(static_cast<int>(header.totalSize), '\0');
+    char *out = data.data();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + header.tagOffset, tags.constData(), tags.size() * sizeof(TagRecord));
+    std::memcpy(out + header.bucketOffset, buckets.constData(), buckets.size() * sizeof(quint32));
+    std::memcpy(out + header.entryOffset, entries.constData(), entries.size() * sizeof(FileEntry));
+    std::memcpy(out + header.stringOffset, strings.constData(), static_cast<size_t>(strings.size()));
+    std::memcpy(out + header.idOffset, ids.constData(), ids.size() * sizeof(quint32));
+    return data;
+}
+
+/*!
+ * \brief 将快照写入 memfd 并封印，之后任何进程都无法修改其内容
+ * \return 文件描述符，由调用者关闭，失败时返回 -1
+ */
+int FileTagSnapshot::createSealedFd(const QByteArray &data)
+{
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "dfm-file-tags", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd < 0) {
+        qCWarning(logDFMBase) << "memfd_create failed:" << strerror(errno);
+        return -1;
+    }
+
+    qint64 written { 0 };
+    while (written < data.size()) {
+        ssize_t ret = ::write(fd, data.constData() + written, static_cast<size_t>(data.size() - written));
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0) {
+            qCWarning(logDFMBase) << "write tag snapshot failed:" << strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        written += ret;
+    }
+
+    // 未封印的 fd 不能交给其他进程，attach 也会拒绝它
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+        qCWarning(logDFMBase) << "seal tag snapshot failed:" << strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*!
+ * \brief 只读映射 fd 中的快照，fd 可以在映射后关闭
+ * 只接受已封印写入和缩小的 fd，否则对方可以在校验之后修改或截断内容
+ */
+bool FileTagSnapshot::attach(int fd)
+{
+    detach();
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SnapshotHeader)))
+        return false;
+
+    const int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) != (F_SEAL_SHRINK | F_SEAL_WRITE)) {
+        qCWarning(logDFMBase) << "tag snapshot fd is not sealed";
+        return false;
+    }
+
+    void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        qCWarning(logDFMBase) << "mmap tag snapshot failed:" << strerror(errno);
+        return false;
+    }
+
+    mapped = addr;
+    base = static_cast<const uchar *>(addr);
+    size = st.st_size;
+    if (!validate()) {
+        qCWarning(logDFMBase) << "Invalid tag snapshot";
+        detach();
+        return false;
+    }
+    return true;
+}
+
+bool FileTagSnapshot::attach(const QByteArray &data)
+{
+    detach();
+    if (data.size() < static_cast<int>(sizeof(SnapshotHeader)))
+        return false;
+
+    owned = data;
+    base = reinterpret_cast<const uchar *>(owned.constData());
+    size = owned.size();
+    if (!validate()) {
+        detach();
+        return false;
+    }
+    return true;
+}
+
+void FileTagSnapshot::detach()
+{
+    if (mapped)
+        munmap(mapped, static_cast<size_t>(size));
+    mapped = nullptr;
+    owned.clear();
+    base = nullptr;
+    size = 0;
+}
+
+quint64 FileTagSnapshot::sequence() const
+{
+    return base ? reinterpret_cast<const SnapshotHeader *>(base)->sequence : 0;
+}
+
+int FileTagSnapshot::fileCount() const
+{
+    return base ? static_cast<int>(reinterpret_cast<const SnapshotHeader *>(base)->fileCount) : 0;
+}
+
+QStringList FileTagSnapshot::tagNames() const
+{
+    if (!base)
+        return {};
+
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base);
+    const char *strings = reinterpret_cast<const char *>(base + header->stringOffset);
+    QStringList names;
+    names.reserve(static_cast<int>(header->tagCount));
+    for (quint32 i = 0; i < header->tagCount; ++i) {
+        const TagRecord *tag = recordAt<TagRecord>(base, header->tagOffset, i);
+        names.append(QString::fromUtf8(strings + tag->nameOffset, static_cast<int>(tag->nameLength)));
+    }
+    return names;
+}
+
+bool FileTagSnapshot::contains(const QString &path) const
+{
+    return findEntry(path.toUtf8()) != nullptr;
+}
+
+QVector<quint32> FileTagSnapshot::tagIds(const QString &path) const
+{
+    const auto *entry = reinterpret_cast<const FileEntry *>(findEntry(path.toUtf8()));
+    if (!entry)
+        return {};
+
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base);
+    const quint32 *ids = recordAt<quint32>(base, header->idOffset, entry->idIndex);
+    return QVector<quint32>(ids, ids + entry->idCount);
+}
+
+void FileTagSnapshot::forEachFile(std::function<void(const QString &, const QVector<quint32> &)> func) const
+{
+    if (!base || !func)
+        return;
+
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base);
+    const char *strings = reinterpret_cast<const char *>(base + header->stringOffset);
+    for (quint32 i = 0; i < header->fileCount; ++i) {
+        const FileEntry *entry = recordAt<FileEntry>(base, header->entryOffset, i);
+        const quint32 *ids = recordAt<quint32>(base, header->idOffset, entry->idIndex);
+        func(QString::fromUtf8(strings + entry->pathOffset, static_cast<int>(entry->pathLength)),
+             QVector<quint32>(ids, ids + entry->idCount));
+    }
+}
+
+/*!
+ * \brief 校验头部和所有条目的范围，之后的查询不再做边界检查
+ */
+bool FileTagSnapshot::validate() const
+{
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base);
+    if (header->magic != kSnapshotMagic || header->version != kSnapshotVersion)
+        return false;
+    if (header->totalSize > size || header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0)
+        return false;
+
+    const quint64 tagEnd = header->tagOffset + quint64(header->tagCount) * sizeof(TagRecord);
+    const quint64 bucketEnd = header->bucketOffset + quint64(header->bucketCount) * sizeof(quint32);
+    const quint64 entryEnd = header->entryOffset + quint64(header->fileCount) * sizeof(FileEntry);
+    if (header->tagOffset < sizeof(SnapshotHeader) || tagEnd > header->bucketOffset
+        || bucketEnd > header->entryOffset || header->entryOffset % alignof(FileEntry) != 0
+        || entryEnd > header->stringOffset || header->stringOffset > header->idOffset
+        || header->idOffset % sizeof(quint32) != 0 || header->idOffset > header->totalSize)
+        return false;
+
+    const quint64 stringSize = header->idOffset - header->stringOffset;
+    const quint64 idCount = (header->totalSize - header->idOffset) / sizeof(quint32);
+    for (quint32 i = 0; i < header->tagCount; ++i) {
+        const TagRecord *tag = recordAt<TagRecord>(base, header->tagOffset, i);
+        if (quint64(tag->nameOffset) + tag->nameLength > stringSize)
+            return false;
+    }
+    for (quint32 i = 0; i < header->fileCount; ++i) {
+        const FileEntry *entry = recordAt<FileEntry>(base, header->entryOffset, i);
+        if (quint64(entry->pathOffset) + entry->pathLength > stringSize
+            || quint64(entry->idIndex) + entry->idCount > idCount)
+            return false;
+        const quint32 *ids = recordAt<quint32>(base, header->idOffset, entry->idIndex);
+        for (quint32 j = 0; j < entry->idCount; ++j) {
+            if (ids[j] >= header->tagCount)
+                return false;
+        }
+    }
+    for (quint32 i = 0; i < header->bucketCount; ++i) {
+        if (*recordAt<quint32>(base, header->bucketOffset, i) > header->fileCount)
+            return false;
+    }
+    return true;
+}
+
+const uchar *FileTagSnapshot::findEntry(const QByteArray &path) const
+{
+    if (!base)
+        return nullptr;
+
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base);
+    if (header->fileCount == 0)
+        return nullptr;
+
+    const char *strings = reinterpret_cast<const char *>(base + header->stringOffset);
+    const quint64 hash = pathHash(path.constData(), path.size());
+    const quint32 mask = header->bucketCount - 1;
+    // 负载因子不超过 0.5，一定能遇到空桶
+    for (quint32 pos = static_cast<quint32>(hash) & mask, probe = 0; probe < header->bucketCount; pos = (pos + 1) & mask, ++probe) {
+        const quint32 slot = *recordAt<quint32>(base, header->bucketOffset, pos);
+        if (slot == 0)
+            return nullptr;
+
+        const FileEntry *entry = recordAt<FileEntry>(base, header->entryOffset, slot - 1);
+        if (entry->hash == hash && entry->pathLength == static_cast<quint32>(path.size())
+            && std::memcmp(strings + entry->pathOffset, path.constData(), entry->pathLength) == 0)
+            return reinterpret_cast<const uchar *>(entry);
+    }
+    return nullptr;
+}
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FILETAGSNAPSHOT_H
+#define FILETAGSNAPSHOT_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+namespace dfmbase {
+
+/*!
+ * \brief 文件标签的只读快照，由标签服务生成，各进程通过 memfd 只读映射共享同一份数据
+ *
+ * 快照是一段连续的内存：
+ *   头部 | 标签名表 | 路径哈希桶 | 文件条目 | 字符串区 | 标签id区
+ * 文件按路径 utf8 的 FNV-1a 哈希放入开放寻址的哈希桶，按路径查询为 O(1)；
+ * 每个文件的标签以标签名表中的下标（标签id）存储。
+ */
+class FileTagSnapshot
+{
+    Q_DISABLE_COPY(FileTagSnapshot)
+
+public:
+    FileTagSnapshot() = default;
+    ~FileTagSnapshot();
+
+    static QByteArray build(quint64 sequence, const QHash<QString, QStringList> &fileTags);
+    static int createSealedFd(const QByteArray &data);
+
+    bool attach(int fd);
+    bool attach(const QByteArray &data);
+    void detach();
+
+    bool isValid() const { return base != nullptr; }
+    quint64 sequence() const;
+    int fileCount() const;
+    QStringList tagNames() const;
+    bool contains(const QString &path) const;
+    QVector<quint32> tagIds(const QString &path) const;
+    void forEachFile(std::function<void(const QString &, const QVector<quint32> &)> func) const;
+
+private:
+    bool validate() const;
+    const uchar *findEntry(const QByteArray &path) const;
+
+    const uchar *base { nullptr };
+    qint64 size { 0 };
+    void *mapped { nullptr };
+    QByteArray owned;
+};
+
+}
+
+#endif   // FILETAGSNAPSHOT_H
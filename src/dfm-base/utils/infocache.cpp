@@ -171,15 +171,16 @@ void InfoCache::cacheInfo(const QUrl url, const FileInfoPointer info)
     }
 
     // 插入到主和副的所有缓存中
+    InfoCacheEntryPointer entry(new InfoCacheEntry(info));
     d->status = kCacheCopy;
     {
         QWriteLocker wlk(&d->mianLock);
-        d->mainCache.insert(url, info);
+        d->mainCache.insert(url, entry);
     }
     d->status = kCacheMain;
     {
         QWriteLocker wlk(&d->copyLock);
-        d->copyCache.insert(url, info);
+        d->copyCache.insert(url, entry);
     }
     // 使用线程处理加入时间序列问题
     emit cacheUpdateInfoTime(url);
@@ -198,13 +199,14 @@ bool InfoCache::updateSortTimeWorker(const QUrl url)
     Q_D(InfoCache);
     if (d->cacheWorkerStoped)
         return false;
-    auto time = QDateTime::currentMSecsSinceEpoch();
-    auto key = QString::number(time) + QString("-") + url.toString();
-    if (d->urlTimeSortHash.contains(url))
-        d->timeToUrlMap.remove(d->urlTimeSortHash.value(url));
-    d->timeToUrlMap.insert(key, url);
-    d->urlTimeSortHash.insert(url, key);
-    return d->timeToUrlMap.count() > kCacheFileinfoCount;
+
+    InfoCacheEntryPointer entry;
+    {
+        QReadLocker rlk(&d->mianLock);
+        entry = d->mainCache.value(url);
+    }
+    d->infoTimeList.touch(url, QDateTime::currentMSecsSinceEpoch(), entry);
+    return d->infoTimeList.count() > kCacheFileinfoCount;
 }
 
 void InfoCache::stop()
@@ -233,9 +235,9 @@ void InfoCache::removeCaches(const QList<QUrl> urls)
     {
         QWriteLocker wlk(&d->mianLock);
         for (const auto &url : urls) {
-            auto info = d->mainCache.take(url);
-            if (info)
-                infos.insert(url, d->mainCache.take(url));
+            auto entry = d->mainCache.take(url);
+            if (entry && entry->info)
+                infos.insert(url, entry->info);
         }
     }
     if (d->cacheWorkerStoped)
@@ -263,22 +265,37 @@ void InfoCache::removeCaches(const QList<QUrl> urls)
 FileInfoPointer InfoCache::getCacheInfo(const QUrl &url)
 {
     Q_D(InfoCache);
-    // 要异步线程重置计时器 todo 开辟一个可控制的线程来处理时间排序的问题
     // 读取副缓存和临时缓存返回
-    FileInfoPointer info(nullptr);
+    InfoCacheEntryPointer entry(nullptr);
     if (d->status == kCacheMain) {   // 可以读取主缓存返回
         QReadLocker wlk(&d->mianLock);
-        info = d->mainCache.value(url);
+        entry = d->mainCache.value(url);
     } else {
         QReadLocker wlk(&d->copyLock);
-        info = d->copyCache.value(url);
+        entry = d->copyCache.value(url);
+    }
+
+    if (!entry) {
+        d->missCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
     }
-    // 异步线程或者信号更新时间
-    // 使用线程处理加入时间序列问题
-    if (info)
-        emit cacheUpdateInfoTime(url);
 
-    return info;
+    // 只记录访问时间，淘汰时由时间线程根据访问时间调整顺序，不用每次读取都发送信号
+    d->hitCount.fetch_add(1, std::memory_order_relaxed);
+    entry->lastAccess.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+    return entry->info;
+}
+
+InfoCacheStatistics InfoCache::statistics()
+{
+    Q_D(InfoCache);
+    InfoCacheStatistics stat;
+    stat.hits = d->hitCount.load(std::memory_order_relaxed);
+    stat.misses = d->missCount.load(std::memory_order_relaxed);
+    stat.evictions = d->evictionCount.load(std::memory_order_relaxed);
+    QReadLocker rlk(&d->mianLock);
+    stat.count = d->mainCache.count();
+    return stat;
 }
 /*!
  * \brief refreshFileInfo 刷新缓存fileinfo
@@ -303,26 +320,16 @@ void InfoCache::addWatcherTimeInfo(const QList<QUrl> &urls)
     for (const auto &url : urls) {
         if (d->cacheWorkerStoped)
             return;
-        auto key = QString::number(time) + QString("-") + url.toString();
-        if (d->urlTimeSortWatcherHash.contains(url))
-            d->timeToUrlWatcherMap.remove(d->urlTimeSortWatcherHash.value(url));
-        d->timeToUrlWatcherMap.insert(key, url);
-        d->urlTimeSortWatcherHash.insert(url, key);
+        d->watcherTimeList.touch(url, time);
     }
 
-    if (d->timeToUrlWatcherMap.count() <= kCacheFileWatcherCount)
-        return;
-
-             // 超出限制移除先进入的watcher
-    auto it = d->timeToUrlWatcherMap.begin();
-    while (d->urlTimeSortWatcherHash.size() > kCacheFileWatcherCount
-           && it != d->timeToUrlWatcherMap.end()) {
+    // 超出限制移除先进入的watcher
+    while (d->watcherTimeList.count() > kCacheFileWatcherCount) {
         if (d->cacheWorkerStoped)
             return;
-        auto url = it.value();
-        d->urlTimeSortWatcherHash.remove(url);
+        const QUrl url = d->watcherTimeList.oldest().url;
+        d->watcherTimeList.popOldest();
         WatcherCache::instance().removeCacheWatcher(url, false);
-        it = d->timeToUrlWatcherMap.erase(it);
     }
 }
 
@@ -331,9 +338,7 @@ void InfoCache::removeWatcherTimeInfo(const QList<QUrl> &urls)
     for (const auto &url : urls) {
         if (d->cacheWorkerStoped)
             return;
-        if (d->urlTimeSortWatcherHash.contains(url)) {
-            d->timeToUrlWatcherMap.remove(d->urlTimeSortWatcherHash.take(url));
-        }
+        d->watcherTimeList.remove(url);
     }
 }
 /*!
@@ -344,29 +349,31 @@ void InfoCache::removeWatcherTimeInfo(const QList<QUrl> &urls)
 void InfoCache::timeRemoveCache()
 {
     Q_D(InfoCache);
-    // 取出哪些url的时间超出了u
-    qint64 delCount = d->urlTimeSortHash.size() < kCacheFileinfoCount ? 0 : d->urlTimeSortHash.size() - kCacheFileinfoCount;
+    // 从最久没有使用的开始，移除超时的和超出数量的
+    const qint64 expireTime = QDateTime::currentMSecsSinceEpoch() - kCacheRemoveTime;
+    // 被访问过的会挪到链表尾部，最多检查两遍，保证循环能结束
+    int budget = d->infoTimeList.count() * 2;
     QList<QUrl> delList;
-    foreach (const auto time, d->timeToUrlMap.keys()) {
+    while (!d->infoTimeList.isEmpty() && budget-- > 0) {
         if (d->cacheWorkerStoped)
             return;
 
-        if (time < QString::number(QDateTime::currentDateTime().toMSecsSinceEpoch() - kCacheRemoveTime)) {
-            delList.append(d->timeToUrlMap.value(time));
+        const auto &node = d->infoTimeList.oldest();
+        const QUrl url = node.url;
+        const auto entry = node.entry.toStrongRef();
+        const qint64 accessTime = entry ? entry->lastAccess.load(std::memory_order_relaxed) : node.time;
+        if (accessTime > node.time) {
+            d->infoTimeList.touch(url, accessTime);
             continue;
         }
 
-        if (delList.size() >= delCount) {
+        if (node.time >= expireTime && d->infoTimeList.count() <= kCacheFileinfoCount)
             break;
-        }
 
-        delList.append(d->timeToUrlMap.value(time));
-    }
-    for (auto url : delList) {
-        if (d->urlTimeSortHash.contains(url)) {
-            d->timeToUrlMap.remove(d->urlTimeSortHash.take(url));
-        }
+        d->infoTimeList.popOldest();
+        delList.append(url);
     }
+    d->evictionCount.fetch_add(static_cast<quint64>(delList.size()), std::memory_order_relaxed);
     // 发送异步消息 告诉移除线程创建移除线程移除，考虑是否是使用线程一直还是使用临时线程（使用临时线程）
     if (delList.size() > 0 && !d->cacheWorkerStoped)
         emit cacheRemoveCaches(delList);
@@ -374,11 +381,8 @@ void InfoCache::timeRemoveCache()
 
 void InfoCache::removeInfosTimeWorker(const QList<QUrl> urls)
 {
-    for (auto url : urls) {
-        if (d->urlTimeSortHash.contains(url)) {
-            d->timeToUrlMap.remove(d->urlTimeSortHash.take(url));
-        }
-    }
+    for (const auto &url : urls)
+        d->infoTimeList.remove(url);
 }
 
 void InfoCache::updateSortTimeWatcherWorker(const QList<QUrl> &urls, const bool add)
@@ -455,6 +459,11 @@ FileInfoPointer InfoCacheController::getCacheInfo(const QUrl &url)
     return InfoCache::instance().getCacheInfo(url);
 }
 
+InfoCacheStatistics InfoCacheController::statistics()
+{
+    return InfoCache::instance().statistics();
+}
+
 InfoCacheController::InfoCacheController(QObject *parent)
     : QObject(parent), thread(new QThread), worker(new CacheWorker), removeTimer(new QTimer)
     , threadUpdate(new QThread)
@@ -9,6 +9,7 @@
 #include <dfm-base/interfaces/abstractdiriterator.h>
 
 #include <QObject>
+#include <QMutex>
 
 #include <fts.h>
 
@@ -30,6 +31,10 @@ public:
     int countFileCount(const char *name);
     bool checkFileType(const FileInfo::FileType &fileType);
     bool checkInode(const FileInfoPointer info);
+    bool insertInode(quint64 dev, quint64 ino);
+
+    bool canStatisticsLocally(const QList<QUrl> &directories) const;
+    void statisticsLocalDirectories(const QList<QUrl> &directories);
 
     FileStatisticsJob *q;
     QTimer *notifyDataTimer;
@@ -49,7 +54,8 @@ public:
     QSet<QUrl> fileStatistics;
     QSet<QUrl> allFiles;
     QSet<QString> skipPath;
-    QSet<quint64> inodelist;
+    QSet<QPair<quint64, quint64>> inodelist;   // (dev, inode)
+    QMutex inodeMutex;
     AbstractDirIteratorPointer iterator { nullptr };
     std::atomic_bool iteratorCanStop { false };
 };
@@ -11,12 +11,74 @@
 #include <QMutex>
 #include <QTimer>
 #include <QMap>
+#include <QDateTime>
+
+#include <list>
+#include <atomic>
 
 namespace dfmbase {
 enum CacheInfoStatus : uint8_t {
     kCacheMain = 0,   // 1.正常状态 插入(同时插入主和副缓存hash)， 读取主缓存hash， 删除主缓存hash
     kCacheCopy,
 };
+
+// 缓存项，读取时只更新访问时间，不再每次都通知时间线程
+struct InfoCacheEntry
+{
+    explicit InfoCacheEntry(const FileInfoPointer &fileInfo)
+        : info(fileInfo), lastAccess(QDateTime::currentMSecsSinceEpoch()) { }
+    FileInfoPointer info;
+    std::atomic<qint64> lastAccess;
+};
+typedef QSharedPointer<InfoCacheEntry> InfoCacheEntryPointer;
+
+// 按时间排序的url链表，链表头是最久没有使用的，移动和删除都是O(1)
+class CacheTimeList
+{
+public:
+    struct Node
+    {
+        QUrl url;
+        qint64 time { 0 };
+        QWeakPointer<InfoCacheEntry> entry;   // 缓存被移除后不再持有文件信息
+    };
+
+    void touch(const QUrl &url, const qint64 time, const InfoCacheEntryPointer &entry = nullptr)
+    {
+        auto it = index.find(url);
+        if (it != index.end()) {
+            it.value()->time = time;
+            if (entry)
+                it.value()->entry = entry;
+            nodes.splice(nodes.end(), nodes, it.value());
+            return;
+        }
+        index.insert(url, nodes.insert(nodes.end(), Node { url, time, entry }));
+    }
+    bool remove(const QUrl &url)
+    {
+        auto it = index.find(url);
+        if (it == index.end())
+            return false;
+        nodes.erase(it.value());
+        index.erase(it);
+        return true;
+    }
+    bool contains(const QUrl &url) const { return index.contains(url); }
+    int count() const { return index.count(); }
+    bool isEmpty() const { return nodes.empty(); }
+    const Node &oldest() const { return nodes.front(); }
+    void popOldest()
+    {
+        index.remove(nodes.front().url);
+        nodes.pop_front();
+    }
+
+private:
+    std::list<Node> nodes;
+    QHash<QUrl, std::list<Node>::iterator> index;
+};
+
 class InfoCachePrivate
 {
     friend class InfoCache;
@@ -25,20 +87,20 @@ class InfoCachePrivate
     DThreadList<QString> disableCahceSchemes;
 
     QAtomicInt status { kCacheMain };   // 当前状态缓存的状态
-    QHash<QUrl, FileInfoPointer> mainCache;   // 主信息缓存
-    QHash<QUrl, FileInfoPointer> copyCache;   // 副信息缓存
+    QHash<QUrl, InfoCacheEntryPointer> mainCache;   // 主信息缓存
+    QHash<QUrl, InfoCacheEntryPointer> copyCache;   // 副信息缓存
     QReadWriteLock mianLock;
     QReadWriteLock copyLock;
 
-    // 时间排序url,利用map的有序性，来处理时间到了要移除的url
-    QHash<QUrl, QString> urlTimeSortHash;
-    QMap<QString, QUrl> timeToUrlMap;
-
-    // 时间排序url,利用map的有序性，来处理时间到了要移除的url
-    QHash<QUrl, QString> urlTimeSortWatcherHash;
-    QMap<QString, QUrl> timeToUrlWatcherMap;
+    // 只在时间线程中访问，按最后使用时间排序，用于超时和超出数量时淘汰
+    CacheTimeList infoTimeList;
+    CacheTimeList watcherTimeList;
     std::atomic_bool cacheWorkerStoped { false };
 
+    std::atomic<quint64> hitCount { 0 };
+    std::atomic<quint64> missCount { 0 };
+    std::atomic<quint64> evictionCount { 0 };
+
 public:
     explicit InfoCachePrivate(InfoCache *qq);
     virtual ~InfoCachePrivate();
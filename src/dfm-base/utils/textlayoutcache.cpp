@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "textlayoutcache.h"
+
+#include <QGuiApplication>
+
+namespace dfmbase {
+
+// 覆盖多屏可见的文件数量即可，排版结果按条目计数
+static constexpr int kMaxEntries { 4096 };
+
+bool TextLayoutCache::Key::operator==(const Key &other) const
+{
+    return text == other.text && font == other.font && width == other.width
+            && lineHeight == other.lineHeight && maxLines == other.maxLines
+            && elideMode == other.elideMode && wrapMode == other.wrapMode
+            && alignment == other.alignment && direction == other.direction;
+}
+
+uint qHash(const TextLayoutCache::Key &key, uint seed)
+{
+    return ::qHash(key.text, seed) ^ ::qHash(key.font, seed) ^ ::qHash(qRound(key.width * 64), seed)
+            ^ ::qHash(key.lineHeight, seed) ^ ::qHash(key.maxLines << 8 | key.elideMode, seed)
+            ^ ::qHash(key.wrapMode << 16 | key.alignment, seed) ^ static_cast<uint>(key.direction);
+}
+
+TextLayoutCache *TextLayoutCache::instance()
+{
+    static TextLayoutCache ins(kMaxEntries);
+    return &ins;
+}
+
+TextLayoutCache::TextLayoutCache(int maxEntries)
+    : entries(maxEntries)
+{
+    // 系统字体变化后旧的排版结果都不会再命中
+    if (qGuiApp)
+        QObject::connect(qGuiApp, &QGuiApplication::fontChanged, qGuiApp, [this]() { clear(); });
+}
+
+TextLayoutCache::LinesPointer TextLayoutCache::find(const Key &key)
+{
+    ++lookupCount;
+
+    QMutexLocker lk(&mutex);
+    LinesPointer *lines = entries.object(key);
+    if (!lines)
+        return nullptr;
+
+    ++hitCount;
+    return *lines;
+}
+
+void TextLayoutCache::insert(const Key &key, const LinesPointer &lines)
+{
+    QMutexLocker lk(&mutex);
+    entries.insert(key, new LinesPointer(lines));
+}
+
+void TextLayoutCache::clear()
+{
+    QMutexLocker lk(&mutex);
+    entries.clear();
+}
+
+TextLayoutCache::Statistics TextLayoutCache::statistics() const
+{
+    Statistics s;
+    s.lookups = lookupCount;
+    s.hits = hitCount;
+    return s;
+}
+
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QCache>
+#include <QMutex>
+#include <QRectF>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QTextLayout>
+#include <QAtomicInteger>
+
+namespace dfmbase {
+
+/*!
+ * \brief 文件名排版结果的缓存
+ * 以 (文本, 字体, 宽度, 行高, 行数, 省略方式, 排版选项) 为键保存已经排版好的 QTextLayout，
+ * 滚动时相同的文件名不再重复断行和省略。字体变化时清空。
+ * 文本本身就是键的一部分，文件重命名后旧名称的结果不会再被命中，由 LRU 自然淘汰。
+ */
+class TextLayoutCache
+{
+    Q_DISABLE_COPY(TextLayoutCache)
+
+public:
+    struct Key
+    {
+        QString text;
+        QString font;
+        qreal width { 0 };
+        int lineHeight { 0 };
+        int maxLines { 0 };
+        int elideMode { 0 };
+        uint wrapMode { 0 };
+        uint alignment { 0 };
+        int direction { 0 };
+
+        bool operator==(const Key &other) const;
+    };
+
+    // 排版结果，坐标相对于文本区域的左上角
+    struct Lines
+    {
+        QSharedPointer<QTextLayout> body;
+        int bodyLines { 0 };
+        QSharedPointer<QTextLayout> elided;   // 最后一行被省略时单独排版
+        QList<QRectF> rects;
+        QStringList texts;
+    };
+    using LinesPointer = QSharedPointer<const Lines>;
+
+    struct Statistics
+    {
+        quint64 lookups { 0 };   // 查询次数
+        quint64 hits { 0 };      // 命中次数
+
+        double hitRate() const { return lookups > 0 ? double(hits) / lookups : 0; }
+    };
+
+    static TextLayoutCache *instance();
+
+    LinesPointer find(const Key &key);
+    void insert(const Key &key, const LinesPointer &lines);
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    explicit TextLayoutCache(int maxEntries);
+
+    QMutex mutex;
+    QCache<Key, LinesPointer> entries;
+    QAtomicInteger<quint64> lookupCount { 0 };
+    QAtomicInteger<quint64> hitCount { 0 };
+};
+
+uint qHash(const TextLayoutCache::Key &key, uint seed = 0);
+
+}
+
+#endif   // TEXTLAYOUTCACHE_H
@@ -13,29 +13,63 @@
 
 #include <QFuture>
 #include <QTimer>
+#include <QThreadPool>
+#include <QMutex>
+#include <QSet>
 
 namespace dfmbase {
 
 class ThumbnailWorkerPrivate
 {
 public:
+    // 不同类型的文件生成缩略图的开销差别很大，分别限制并发数量
+    enum TaskCategory {
+        kImageTask,
+        kMediaTask,   // 音视频，会调用ffmpeg或解码库
+        kDocumentTask,   // pdf、djvu等文档
+        kCategoryCount
+    };
+
+    struct ThumbnailTask
+    {
+        QUrl url;
+        DFMGLOBAL_NAMESPACE::ThumbnailSize size { DFMGLOBAL_NAMESPACE::ThumbnailSize::kLarge };
+        int checkCount { 0 };
+        TaskCategory category { kImageTask };
+    };
+
     explicit ThumbnailWorkerPrivate(ThumbnailWorker *qq);
     QString createThumbnail(const QUrl &url, DFMGLOBAL_NAMESPACE::ThumbnailSize size);
     bool checkFileStable(const QUrl &url);
     void startDelayWork();
+    void delayTask(const ThumbnailTask &task);
 
     QUrl setCheckCount(const QUrl &url, int count);
     int checkCount(const QUrl &url);
     QUrl clearCheckCount(const QUrl &url);
 
+    TaskCategory taskCategory(const QUrl &url);
+    int categoryLimit(TaskCategory category) const;
+    bool takeNextTask(ThumbnailTask *task);
+    void dispatchTasks();
+    void runTask(const ThumbnailTask &task);
+
     ThumbnailWorker *q { nullptr };
     DMimeDatabase mimeDb;
     QMap<QString, ThumbnailWorker::ThumbnailCreator> creators;
-    QUrl originalUrl;
     ThumbnailHelper thumbHelper;
     std::atomic_bool isStoped = false;
     QTimer *delayTimer { nullptr };
     ThumbnailWorker::ThumbnailTaskMap delayTaskMap;
+
+    QThreadPool threadPool;
+    QMutex taskMutex;
+    // 可见区域的任务优先处理，两个队列都是先进先出
+    QList<ThumbnailTask> visibleTasks;
+    QList<ThumbnailTask> normalTasks;
+    QSet<QUrl> pendingUrls;
+    int runningCount[kCategoryCount] {};
+    int runningTotal { 0 };
 };
 
 }   // namespace dfmbase
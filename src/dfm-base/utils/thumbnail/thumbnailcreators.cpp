@@ -59,8 +59,9 @@ QImage ThumbnailCreators::videoThumbnailCreator(const QString &filePath, Thumbna
 QImage ThumbnailCreators::videoThumbnailCreatorFfmpeg(const QString &filePath, ThumbnailSize size)
 {
     QProcess ffmpeg;
+    // 只需要一帧，输出后立即退出
     QStringList args { "-nostats", "-loglevel", "0", "-i", filePath,
-                       "-vf", QString("scale='min(%1, iw)':-1").arg(size), "-f",
+                       "-vf", QString("scale='min(%1, iw)':-1").arg(size), "-frames:v", "1", "-f",
                        "image2pipe", "-vcodec", "png", "-fs", "9000", "-" };
     ffmpeg.start("ffmpeg", args, QIODevice::ReadOnly);
 
@@ -156,7 +157,8 @@ QImage ThumbnailCreators::audioThumbnailCreator(const QString &filePath, Thumbna
 {
     QProcess ffmpeg;
     QStringList args { "-nostats", "-loglevel", "0", "-i", filePath,
-                       "-an", "-vf", QString("scale='min(%1, iw)':-1").arg(size), "-f", "image2pipe", "-fs", "9000", "-" };
+                       "-an", "-vf", QString("scale='min(%1, iw)':-1").arg(size), "-frames:v", "1",
+                       "-f", "image2pipe", "-fs", "9000", "-" };
     ffmpeg.start("ffmpeg", args, QIODevice::ReadOnly);
 
     QImage img;
@@ -180,8 +182,8 @@ QImage ThumbnailCreators::imageThumbnailCreator(const QString &filePath, Thumbna
     //! QImageReader构造时不传format参数，让其自行判断
     //! fix bug #53200 QImageReader构造时不传format参数，会造成没有读取不了真实的文件 类型比如将png图标后缀修改为jpg，读取的类型不对
 
-    QString mimeType = DMimeDatabase().mimeTypeForFile(QUrl::fromLocalFile(filePath), QMimeDatabase::MatchContent).name();
-    const QString &suffix = mimeType.replace("image/", "");
+    const QString &mimeType = DMimeDatabase().mimeTypeForFile(QUrl::fromLocalFile(filePath), QMimeDatabase::MatchContent).name();
+    const QString &suffix = QString(mimeType).replace("image/", "");
 
     QImageReader reader(filePath, suffix.toLatin1());
     if (!reader.canRead()) {
@@ -200,9 +202,9 @@ QImage ThumbnailCreators::imageThumbnailCreator(const QString &filePath, Thumbna
         return {};
     }
 
-    const QString &defaultMime = DMimeDatabase().mimeTypeForFile(QUrl::fromLocalFile(filePath)).name();
-    if (imageSize.width() > size || imageSize.height() > size || defaultMime == DFMGLOBAL_NAMESPACE::Mime::kTypeImageSvgXml)
-        reader.setScaledSize(reader.size().scaled(size, size, Qt::KeepAspectRatio));
+    // 在解码时缩放（jpeg可以直接按DCT系数缩小解码），不要解码完整图片后再缩放
+    if (imageSize.width() > size || imageSize.height() > size || mimeType == DFMGLOBAL_NAMESPACE::Mime::kTypeImageSvgXml)
+        reader.setScaledSize(imageSize.scaled(size, size, Qt::KeepAspectRatio));
 
     reader.setAutoTransform(true);
     QImage image;
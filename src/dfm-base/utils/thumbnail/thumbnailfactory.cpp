@@ -52,7 +52,8 @@ void ThumbnailFactory::init()
     connect(this, &ThumbnailFactory::thumbnailJob, this, &ThumbnailFactory::doJoinThumbnailJob, Qt::QueuedConnection);
     connect(qApp, &QGuiApplication::aboutToQuit, this, &ThumbnailFactory::onAboutToQuit);
 
-    connect(this, &ThumbnailFactory::addTask, worker.data(), &ThumbnailWorker::onTaskAdded, Qt::QueuedConnection);
+    // 任务入队是线程安全的且开销很小，直接调用，保证优先级和取消操作能立即作用到新加入的任务
+    connect(this, &ThumbnailFactory::addTask, worker.data(), &ThumbnailWorker::onTaskAdded, Qt::DirectConnection);
     connect(worker.data(), &ThumbnailWorker::thumbnailCreateFinished, this, &ThumbnailFactory::produceFinished, Qt::QueuedConnection);
     connect(worker.data(), &ThumbnailWorker::thumbnailCreateFailed, this, &ThumbnailFactory::produceFailed, Qt::QueuedConnection);
 
@@ -75,6 +76,34 @@ bool ThumbnailFactory::registerThumbnailCreator(const QString &mimeType, Thumbna
     return worker->registerCreator(mimeType, creator);
 }
 
+void ThumbnailFactory::prioritizeThumbnailJobs(const QList<QUrl> &urls)
+{
+    Q_ASSERT(qApp->thread() == QThread::currentThread());
+
+    if (urls.isEmpty())
+        return;
+
+    if (!taskMap.isEmpty()) {
+        taskPushTimer.stop();
+        pushTask();
+    }
+    worker->prioritizeTasks(urls);
+}
+
+QList<QUrl> ThumbnailFactory::cancelThumbnailJobs(const QList<QUrl> &urls)
+{
+    Q_ASSERT(qApp->thread() == QThread::currentThread());
+
+    QList<QUrl> canceled;
+    for (const auto &url : urls) {
+        if (taskMap.remove(url) > 0)
+            canceled.append(url);
+    }
+
+    canceled.append(worker->cancelTasks(urls));
+    return canceled;
+}
+
 void ThumbnailFactory::onAboutToQuit()
 {
     worker->stop();
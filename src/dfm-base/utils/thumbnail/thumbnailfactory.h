@@ -29,6 +29,10 @@ public:
     using ThumbnailCreator = std::function<QImage(const QString &, DFMGLOBAL_NAMESPACE::ThumbnailSize)>;
     bool registerThumbnailCreator(const QString &mimeType, ThumbnailCreator creator);
 
+    // 视图滚动后调用：可见项优先生成，移出可见区域且尚未开始的任务被取消，返回被取消的url
+    void prioritizeThumbnailJobs(const QList<QUrl> &urls);
+    QList<QUrl> cancelThumbnailJobs(const QList<QUrl> &urls);
+
 Q_SIGNALS:
     void produceFinished(const QUrl &src, const QString &thumb);
     void produceFailed(const QUrl &src);
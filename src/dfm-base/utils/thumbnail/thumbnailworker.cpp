@@ -11,6 +11,7 @@
 #include <dfm-base/base/urlroute.h>
 
 #include <QtConcurrent>
+#include <QRunnable>
 #include <QPainter>
 #include <QDebug>
 
@@ -20,6 +21,7 @@ ThumbnailWorkerPrivate::ThumbnailWorkerPrivate(ThumbnailWorker *qq)
     : q(qq)
 {
     thumbHelper.initSizeLimit();
+    threadPool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
 }
 
 QString ThumbnailWorkerPrivate::createThumbnail(const QUrl &url, Global::ThumbnailSize size)
@@ -92,7 +94,10 @@ void ThumbnailWorkerPrivate::startDelayWork()
         delayTimer = new QTimer(q);
         delayTimer->setInterval(2 * 1000);
         delayTimer->setSingleShot(true);
-        q->connect(delayTimer, &QTimer::timeout, q, [this] { q->onTaskAdded(delayTaskMap); }, Qt::QueuedConnection);
+        q->connect(delayTimer, &QTimer::timeout, q, [this] {
+            auto map = std::move(delayTaskMap);
+            q->onTaskAdded(map);
+        }, Qt::QueuedConnection);
     }
 
     delayTimer->start();
@@ -131,6 +136,108 @@ QUrl ThumbnailWorkerPrivate::clearCheckCount(const QUrl &url)
     return tmpUrl;
 }
 
+void ThumbnailWorkerPrivate::delayTask(const ThumbnailTask &task)
+{
+    // 超过10次，放弃生成
+    const int count = task.checkCount + 1;
+    if (count > 10)
+        return;
+
+    delayTaskMap.insert(setCheckCount(task.url, count), task.size);
+    startDelayWork();
+}
+
+ThumbnailWorkerPrivate::TaskCategory ThumbnailWorkerPrivate::taskCategory(const QUrl &url)
+{
+    // 只根据文件名判断，入队时不读取文件内容
+    const auto &types = mimeDb.mimeTypesForFileName(url.fileName());
+    if (types.isEmpty())
+        return kImageTask;
+
+    const QString &mimeName = types.first().name();
+    if (mimeName.startsWith("video/") || mimeName.startsWith("audio/") || mimeName == Global::Mime::kTypeAppVRRMedia)
+        return kMediaTask;
+    if (mimeName.startsWith("image/") && mimeName != Global::Mime::kTypeImageVDjvu && mimeName != Global::Mime::kTypeImageVDMultipage)
+        return kImageTask;
+
+    return kDocumentTask;
+}
+
+int ThumbnailWorkerPrivate::categoryLimit(TaskCategory category) const
+{
+    // 图片解码只占用CPU，可以占满线程池；音视频和文档可能启动外部进程，最多同时两个
+    return category == kImageTask ? threadPool.maxThreadCount() : 2;
+}
+
+bool ThumbnailWorkerPrivate::takeNextTask(ThumbnailTask *task)
+{
+    for (auto queue : { &visibleTasks, &normalTasks }) {
+        for (int i = 0; i < queue->count(); ++i) {
+            if (runningCount[queue->at(i).category] >= categoryLimit(queue->at(i).category))
+                continue;
+
+            *task = queue->takeAt(i);
+            pendingUrls.remove(task->url);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThumbnailWorkerPrivate::dispatchTasks()
+{
+    QMutexLocker lk(&taskMutex);
+    while (!isStoped && runningTotal < threadPool.maxThreadCount()) {
+        ThumbnailTask task;
+        if (!takeNextTask(&task))
+            break;
+
+        ++runningCount[task.category];
+        ++runningTotal;
+        threadPool.start(QRunnable::create([this, task]() {
+            runTask(task);
+
+            {
+                QMutexLocker lk(&taskMutex);
+                --runningCount[task.category];
+                --runningTotal;
+            }
+            dispatchTasks();
+        }));
+    }
+}
+
+void ThumbnailWorkerPrivate::runTask(const ThumbnailTask &task)
+{
+    if (isStoped)
+        return;
+
+    const QUrl &url = task.url;
+    if (!thumbHelper.checkThumbEnable(url))
+        return;
+
+    const auto &img = thumbHelper.thumbnailImage(url, task.size);
+    if (!img.isNull()) {
+        Q_EMIT q->thumbnailCreateFinished(url, img.text(QT_STRINGIFY(Thumb::Path)));
+        return;
+    }
+
+    // check whether the file is stable
+    // if not, rejoin the event queue and create thumbnail later
+    if (!checkFileStable(url)) {
+        QMetaObject::invokeMethod(q, [this, task]() { delayTask(task); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // create thumbnail
+    const auto &thumbnailPath = createThumbnail(url, task.size);
+    if (!thumbnailPath.isEmpty())
+        Q_EMIT q->thumbnailCreateFinished(url, thumbnailPath);
+    else
+        Q_EMIT q->thumbnailCreateFailed(url);
+}
+
 ThumbnailWorker::ThumbnailWorker(QObject *parent)
     : QObject(parent),
       d(new ThumbnailWorkerPrivate(this))
@@ -139,6 +246,8 @@ ThumbnailWorker::ThumbnailWorker(QObject *parent)
 
 ThumbnailWorker::~ThumbnailWorker()
 {
+    stop();
+    d->threadPool.waitForDone();
 }
 
 bool ThumbnailWorker::registerCreator(const QString &mimeType, ThumbnailWorker::ThumbnailCreator creator)
@@ -157,58 +266,72 @@ bool ThumbnailWorker::registerCreator(const QString &mimeType, ThumbnailWorker::
 void ThumbnailWorker::stop()
 {
     d->isStoped = true;
+
+    QMutexLocker lk(&d->taskMutex);
+    d->visibleTasks.clear();
+    d->normalTasks.clear();
+    d->pendingUrls.clear();
 }
 
-void ThumbnailWorker::onTaskAdded(const ThumbnailTaskMap &taskMap)
+void ThumbnailWorker::prioritizeTasks(const QList<QUrl> &urls)
 {
-    if (d->isStoped)
+    QMutexLocker lk(&d->taskMutex);
+    if (d->normalTasks.isEmpty())
         return;
 
-    QMapIterator<QUrl, Global::ThumbnailSize> iter(taskMap);
-    while (iter.hasNext()) {
-        iter.next();
-        QUrl fileUrl = d->originalUrl = iter.key();
-        if (!d->thumbHelper.checkThumbEnable(fileUrl))
-            continue;
-
-        const auto &img = d->thumbHelper.thumbnailImage(fileUrl, iter.value());
-        if (!img.isNull()) {
-            Q_EMIT thumbnailCreateFinished(iter.key(), img.text(QT_STRINGIFY(Thumb::Path)));
-            continue;
-        }
-
-        createThumbnail(fileUrl, iter.value());
+    const QSet<QUrl> urlSet(urls.begin(), urls.end());
+    for (int i = 0; i < d->normalTasks.count();) {
+        if (urlSet.contains(d->normalTasks.at(i).url))
+            d->visibleTasks.append(d->normalTasks.takeAt(i));
+        else
+            ++i;
     }
 }
 
-void ThumbnailWorker::createThumbnail(const QUrl &url, Global::ThumbnailSize size)
+QList<QUrl> ThumbnailWorker::cancelTasks(const QList<QUrl> &urls)
 {
-    // check whether the file is stable
-    // if not, rejoin the event queue and create thumbnail later
-    if (!d->checkFileStable(url)) {
-        if (!d->delayTaskMap.contains(d->originalUrl)) {
-            d->originalUrl = d->setCheckCount(d->originalUrl, 1);
-        } else {
-            d->delayTaskMap.remove(d->originalUrl);
-            // 超过10次，放弃生成
-            auto count = d->checkCount(d->originalUrl);
-            if (++count > 10)
-                return;
-
-            d->originalUrl = d->setCheckCount(d->originalUrl, count);
+    QList<QUrl> canceled;
+    QMutexLocker lk(&d->taskMutex);
+    QSet<QUrl> urlSet(urls.begin(), urls.end());
+    urlSet.intersect(d->pendingUrls);
+    if (urlSet.isEmpty())
+        return canceled;
+
+    for (auto queue : { &d->visibleTasks, &d->normalTasks }) {
+        for (int i = 0; i < queue->count();) {
+            if (urlSet.contains(queue->at(i).url))
+                canceled.append(queue->takeAt(i).url);
+            else
+                ++i;
         }
+    }
+    d->pendingUrls.subtract(urlSet);
 
-        d->delayTaskMap.insert(d->originalUrl, size);
-        d->startDelayWork();
+    return canceled;
+}
+
+void ThumbnailWorker::onTaskAdded(const ThumbnailTaskMap &taskMap)
+{
+    if (d->isStoped)
         return;
-    } else if (d->originalUrl.hasQuery()) {
-        d->originalUrl = d->clearCheckCount(d->originalUrl);
+
+    {
+        QMutexLocker lk(&d->taskMutex);
+        QMapIterator<QUrl, Global::ThumbnailSize> iter(taskMap);
+        while (iter.hasNext()) {
+            iter.next();
+            ThumbnailWorkerPrivate::ThumbnailTask task;
+            task.url = d->clearCheckCount(iter.key());
+            if (d->pendingUrls.contains(task.url))
+                continue;
+
+            task.size = iter.value();
+            task.checkCount = d->checkCount(iter.key());
+            task.category = d->taskCategory(task.url);
+            d->pendingUrls.insert(task.url);
+            d->normalTasks.append(task);
+        }
     }
 
-    // create thumbnail
-    const auto &thumbnailPath = d->createThumbnail(url, size);
-    if (!thumbnailPath.isEmpty())
-        Q_EMIT thumbnailCreateFinished(d->originalUrl, thumbnailPath);
-    else
-        Q_EMIT thumbnailCreateFailed(d->originalUrl);
+    d->dispatchTasks();
 }
@@ -28,6 +28,10 @@ public:
     bool registerCreator(const QString &mimeType, ThumbnailCreator creator);
     void stop();
 
+    // 以下接口是线程安全的
+    void prioritizeTasks(const QList<QUrl> &urls);
+    QList<QUrl> cancelTasks(const QList<QUrl> &urls);
+
 public Q_SLOTS:
     void onTaskAdded(const ThumbnailTaskMap &taskMap);
 
@@ -35,9 +39,6 @@ Q_SIGNALS:
     void thumbnailCreateFinished(const QUrl &url, const QString &thumbnail);
     void thumbnailCreateFailed(const QUrl &url);
 
-private:
-    void createThumbnail(const QUrl &url, Global::ThumbnailSize size);
-
 private:
     QScopedPointer<ThumbnailWorkerPrivate> d;
 };
@@ -56,12 +56,13 @@ EventChannelManager *Event::channel()
 void Event::registerEventType(EventStratege stratege, const QString &space, const QString &topic)
 {
     QString key { space + ":" + topic };
+    // 插件可能在工作线程中并发加载，查重和分配 id 都需要在锁内完成
+    QWriteLocker guard(&d->rwLock);
     if (Q_UNLIKELY(d->eventsMap[stratege].contains(key))) {
         qCWarning(logDPF) << "Register repeat event: " << key;
         return;
     }
 
-    QWriteLocker guard(&d->rwLock);
     d->eventsMap[stratege].insert(key, genCustomEventId());
 }
 
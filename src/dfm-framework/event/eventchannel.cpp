@@ -60,10 +60,11 @@ QVariant EventChannel::send()
 
 QVariant EventChannel::send(const QVariantList &params)
 {
-    if (!conn)
+    const auto &receiver = std::atomic_load(&curReceiver);
+    if (!receiver || !receiver->conn)
         return QVariant();
 
-    return conn(params);
+    return receiver->conn(params);
 }
 
 EventChannelFuture EventChannel::asyncSend()
@@ -87,8 +88,19 @@ bool EventChannelManager::disconnect(const QString &space, const QString &topic)
 bool EventChannelManager::disconnect(const EventType &type)
 {
     QWriteLocker guard(&rwLock);
-    if (channelMap.contains(type))
-        return channelMap.remove(type) > 0;
+    if (channelMap.remove(type) > 0) {
+        updateChannelSnapshot();
+        return true;
+    }
 
     return false;
 }
+
+void EventChannelManager::updateChannelSnapshot()
+{
+    ChannelSnapshot *snapshot = new ChannelSnapshot;
+    snapshot->reserve(channelMap.size());
+    for (auto it = channelMap.cbegin(); it != channelMap.cend(); ++it)
+        snapshot->insert(it.key(), it.value());
+    std::atomic_store(&channelSnapshot, std::shared_ptr<const ChannelSnapshot>(snapshot));
+}
@@ -17,13 +17,17 @@ bool EventDispatcher::dispatch()
 
 bool EventDispatcher::dispatch(const QVariantList &params)
 {
-    if (std::any_of(filterList.begin(), filterList.end(), [params](const EventHandler<Listener> &h) {
+    const auto &tables = std::atomic_load(&handlerTables);
+    if (!tables)
+        return true;
+
+    if (std::any_of(tables->filters.cbegin(), tables->filters.cend(), [&params](const EventHandler<Listener> &h) {
             return h.handler(params).toBool();
         })) {
         return false;
     }
 
-    std::for_each(handlerList.begin(), handlerList.end(), [params](const EventHandler<Listener> &h) {
+    std::for_each(tables->handlers.cbegin(), tables->handlers.cend(), [&params](const EventHandler<Listener> &h) {
         h.handler(params);
     });
 
@@ -42,35 +46,43 @@ QFuture<bool> EventDispatcher::asyncDispatch(const QVariantList &params)
     }));
 }
 
+void EventDispatcher::updateTables()
+{
+    // QList 隐式共享，快照只增加引用计数，下次修改列表时才会复制
+    std::atomic_store(&handlerTables,
+                      std::shared_ptr<const HandlerTables>(new HandlerTables { handlerList, filterList }));
+}
+
 bool EventDispatcherManager::installGlobalEventFilter(QObject *obj, EventDispatcherManager::GlobalFilter filter)
 {
     Q_ASSERT(obj);
 
     QWriteLocker guard(&rwLock);
-    return globalFilterMap.insert(obj, filter) != globalFilterMap.end();
+    bool ret = globalFilterMap.insert(obj, filter) != globalFilterMap.end();
+    updateGlobalFilterSnapshot();
+    return ret;
 }
 
 bool EventDispatcherManager::removeGlobalEventFilter(QObject *obj)
 {
     QWriteLocker guard(&rwLock);
-    if (globalFilterMap.contains(obj))
-        return globalFilterMap.remove(obj) > 0;
+    if (globalFilterMap.remove(obj) > 0) {
+        updateGlobalFilterSnapshot();
+        return true;
+    }
 
     return false;
 }
 
 bool EventDispatcherManager::globalFiltered(EventType type, const QVariantList &params)
 {
-    QReadLocker lk(&rwLock);
-
-    qsizetype size { globalFilterMap.size() };
-    for (qsizetype i = 0; i != size; ++i) {
-        auto key { globalFilterMap.keys()[i] };
-        if (key) {
-            auto func { globalFilterMap.value(key) };
-            lk.unlock();
-            return func(type, params);
-        }
+    const auto &filters = std::atomic_load(&globalFilterSnapshot);
+    if (!filters)
+        return false;
+
+    for (auto it = filters->cbegin(); it != filters->cend(); ++it) {
+        if (it.key())
+            return it.value()(type, params);
     }
 
     return false;
@@ -85,8 +97,25 @@ bool EventDispatcherManager::unsubscribe(const QString &space, const QString &to
 bool EventDispatcherManager::unsubscribe(EventType type)
 {
     QWriteLocker guard(&rwLock);
-    if (dispatcherMap.contains(type))
-        return dispatcherMap.remove(type) > 0;
+    if (dispatcherMap.remove(type) > 0) {
+        updateDispatcherSnapshot();
+        return true;
+    }
 
     return false;
 }
+
+void EventDispatcherManager::updateDispatcherSnapshot()
+{
+    DispatcherSnapshot *snapshot = new DispatcherSnapshot;
+    snapshot->reserve(dispatcherMap.size());
+    for (auto it = dispatcherMap.cbegin(); it != dispatcherMap.cend(); ++it)
+        snapshot->insert(it.key(), it.value());
+    std::atomic_store(&dispatcherSnapshot, std::shared_ptr<const DispatcherSnapshot>(snapshot));
+}
+
+void EventDispatcherManager::updateGlobalFilterSnapshot()
+{
+    std::atomic_store(&globalFilterSnapshot,
+                      std::shared_ptr<const GlobalEventFilterMap>(new GlobalEventFilterMap(globalFilterMap)));
+}
@@ -10,6 +10,9 @@
 #include <dfm-framework/lifecycle/plugin.h>
 #include <dfm-framework/lifecycle/plugincreator.h>
 
+#include <QThreadPool>
+#include <QWaitCondition>
+
 DPF_BEGIN_NAMESPACE
 
 PluginManagerPrivate::PluginManagerPrivate(PluginManager *qq)
@@ -245,6 +248,7 @@ void PluginManagerPrivate::jsonToMeta(PluginMetaObjectPointer metaObject, const
     metaObject->d->description = metaData.value(kPluginDescription).toString();
     metaObject->d->urlLink = metaData.value(kPluginUrlLink).toString();
     metaObject->d->customData = metaData.value(kCustomData).toVariant().toMap();
+    metaObject->d->concurrentInit = metaData.value(kPluginConcurrentInit).toBool();
 
     QJsonArray &&dependsArray = metaData.value(kPluginDepends).toArray();
     auto itera = dependsArray.begin();
@@ -308,16 +312,19 @@ void PluginManagerPrivate::jsonToMeta(PluginMetaObjectPointer metaObject, const
 
 /*!
  * \brief 内部使用QPluginLoader加载所有插件
+ * 按照依赖关系在线程池中并发加载，插件只在其依赖的插件加载完成后才会加载，
+ * 工作线程中创建的插件实例会被移回调用线程
  */
 bool PluginManagerPrivate::loadPlugins()
 {
     qCInfo(logDPF) << "Start loading all plugins: ";
+    if (!startupTimer.isValid())
+        startupTimer.start();
+    ownerThread = QThread::currentThread();
     dependsSort(&loadQueue, &pluginsToLoad);
 
-    bool ret = true;
-    std::for_each(loadQueue.begin(), loadQueue.end(), [&ret, this](PluginMetaObjectPointer pointer) {
-        if (!PluginManagerPrivate::doLoadPlugin(pointer))
-            ret = false;
+    bool ret = runDependsGraph(loadQueue, PluginTimeline::kLoad, [](PluginMetaObjectPointer) {
+        return true;
     });
     qCInfo(logDPF) << "End loading all plugins.";
 
@@ -326,14 +333,18 @@ bool PluginManagerPrivate::loadPlugins()
 
 /*!
  * \brief 初始化所有插件
+ * 元数据中声明了 ConcurrentInit 的插件在线程池中初始化，其他插件仍在调用线程中初始化，
+ * 任何插件都只在其依赖的插件初始化完成后才会初始化
  */
 bool PluginManagerPrivate::initPlugins()
 {
     qCInfo(logDPF) << "Start initializing all plugins: ";
-    bool ret = true;
-    std::for_each(loadQueue.begin(), loadQueue.end(), [&ret, this](PluginMetaObjectPointer pointer) {
-        if (!PluginManagerPrivate::doInitPlugin(pointer))
-            ret = false;
+    if (!startupTimer.isValid())
+        startupTimer.start();
+    ownerThread = QThread::currentThread();
+
+    bool ret = runDependsGraph(loadQueue, PluginTimeline::kInit, [](PluginMetaObjectPointer pointer) {
+        return pointer->d->concurrentInit;
     });
     qCInfo(logDPF) << "End initialization of all plugins.";
 
@@ -349,12 +360,16 @@ bool PluginManagerPrivate::initPlugins()
 bool PluginManagerPrivate::startPlugins()
 {
     qCInfo(logDPF) << "Start start all plugins: ";
+    if (!startupTimer.isValid())
+        startupTimer.start();
+
     bool ret = true;
     std::for_each(loadQueue.begin(), loadQueue.end(), [&ret, this](PluginMetaObjectPointer pointer) {
-        if (!PluginManagerPrivate::doStartPlugin(pointer))
+        if (!runStage(pointer, PluginTimeline::kStart))
             ret = false;
     });
     qCInfo(logDPF) << "End start of all plugins.";
+    dumpTimeline();
 
     emit Listener::instance()->pluginsStarted();
     allPluginsStarted = true;
@@ -435,6 +450,8 @@ bool PluginManagerPrivate::doLoadPlugin(PluginMetaObjectPointer pointer)
 
     pointer->d->state = PluginMetaObject::State::kLoading;
 
+    // 虚拟插件共享同一个 PluginCreator，并发加载时需要串行化
+    QMutexLocker virtualLocker(pointer->isVirtual() ? &virtualPluginsMutex : nullptr);
     if (pointer->isVirtual() && loadedVirtualPlugins.contains(pointer->d->realName)) {
         auto creator = qobject_cast<PluginCreator *>(pointer->d->loader->instance());
         if (creator)
@@ -587,6 +604,169 @@ bool PluginManagerPrivate::doStopPlugin(PluginMetaObjectPointer pointer)
     return true;
 }
 
+/*!
+ * \brief 执行插件的某个启动阶段并记录耗时
+ */
+bool PluginManagerPrivate::runStage(PluginMetaObjectPointer pointer, PluginTimeline::Stage stage)
+{
+    const qint64 begin = startupTimer.nsecsElapsed() / 1000;
+    QThread *current = QThread::currentThread();
+    bool ret = false;
+    switch (stage) {
+    case PluginTimeline::kLoad:
+        ret = doLoadPlugin(pointer);
+        // 在工作线程创建的插件对象需要移回调用线程，否则其事件处理依赖于线程池中的线程
+        if (ret && ownerThread && current != ownerThread) {
+            if (pointer->d->plugin && pointer->d->plugin->thread() == current)
+                pointer->d->plugin->moveToThread(ownerThread);
+            QObject *instance = pointer->d->loader->isLoaded() ? pointer->d->loader->instance() : nullptr;
+            if (instance && instance->thread() == current)
+                instance->moveToThread(ownerThread);
+        }
+        break;
+    case PluginTimeline::kInit:
+        ret = doInitPlugin(pointer);
+        break;
+    case PluginTimeline::kStart:
+        ret = doStartPlugin(pointer);
+        break;
+    default:
+        return false;
+    }
+
+    const qint64 end = startupTimer.nsecsElapsed() / 1000;
+    QMutexLocker locker(&timelineMutex);
+    PluginTimeline &timeline = timelines[pointer->name()];
+    timeline.begin[stage] = begin;
+    timeline.cost[stage] = end - begin;
+    timeline.concurrent[stage] = ownerThread && current != ownerThread;
+    return ret;
+}
+
+/*!
+ * \brief 按照依赖关系执行 queue 中插件的某个阶段，没有依赖关系的插件可以并发执行
+ * \param queue 已经按依赖排序的插件队列
+ * \param runInPool 返回 true 的插件在线程池中执行，否则在调用线程中执行
+ * \return 所有插件都执行成功时返回 true
+ */
+bool PluginManagerPrivate::runDependsGraph(const QQueue<PluginMetaObjectPointer> &queue, PluginTimeline::Stage stage,
+                                           std::function<bool(PluginMetaObjectPointer)> runInPool)
+{
+    const int count = queue.size();
+    QHash<QString, int> indexes;
+    for (int i = 0; i < count; ++i)
+        indexes.insert(queue.at(i)->name(), i);
+
+    // waiting: 尚未完成的依赖数量，dependents: 依赖于该插件的插件
+    QVector<int> waiting(count, 0);
+    QVector<QVector<int>> dependents(count);
+    for (int i = 0; i < count; ++i) {
+        for (const PluginDepend &depend : queue.at(i)->depends()) {
+            int dep = indexes.value(depend.name(), -1);
+            if (dep < 0 || dep == i)
+                continue;
+            ++waiting[i];
+            dependents[dep].append(i);
+        }
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 6));
+    QMutex mutex;
+    QWaitCondition finishedCond;
+    QList<QPair<int, bool>> finished;
+
+    QVector<bool> dispatched(count, false);
+    QList<int> ready;
+    for (int i = 0; i < count; ++i) {
+        if (waiting[i] == 0)
+            ready.append(i);
+    }
+
+    bool ret = true;
+    int done = 0;
+    int running = 0;
+    auto complete = [&](int index, bool ok) {
+        ++done;
+        if (!ok)
+            ret = false;
+        for (int next : dependents[index]) {
+            if (--waiting[next] == 0)
+                ready.append(next);
+        }
+    };
+
+    while (done < count) {
+        // 按照排序后的顺序分发，保证调用线程中执行的插件顺序与串行时一致
+        std::sort(ready.begin(), ready.end());
+        while (!ready.isEmpty()) {
+            int index = ready.takeFirst();
+            PluginMetaObjectPointer pointer = queue.at(index);
+            dispatched[index] = true;
+            if (runInPool(pointer)) {
+                ++running;
+                pool.start(QRunnable::create([this, &mutex, &finishedCond, &finished, index, pointer, stage]() {
+                    bool ok = runStage(pointer, stage);
+                    QMutexLocker locker(&mutex);
+                    finished.append({ index, ok });
+                    finishedCond.wakeOne();
+                }));
+            } else {
+                complete(index, runStage(pointer, stage));
+            }
+        }
+
+        if (done == count || running == 0)
+            break;
+
+        QList<QPair<int, bool>> results;
+        {
+            QMutexLocker locker(&mutex);
+            while (finished.isEmpty())
+                finishedCond.wait(&mutex);
+            results.swap(finished);
+        }
+        running -= results.size();
+        for (const auto &result : results)
+            complete(result.first, result.second);
+    }
+    pool.waitForDone();
+
+    // 循环依赖导致部分插件无法调度，按照队列顺序串行执行
+    if (done < count) {
+        qCWarning(logDPF) << "Maybe circle depends occured, run remaining plugins serially";
+        for (int i = 0; i < count; ++i) {
+            if (!dispatched[i] && !runStage(queue.at(i), stage))
+                ret = false;
+        }
+    }
+
+    return ret;
+}
+
+/*!
+ * \brief 输出插件启动时间线，用于追踪启动耗时的变化
+ */
+void PluginManagerPrivate::dumpTimeline()
+{
+    QMutexLocker locker(&timelineMutex);
+    auto ms = [](qint64 us) { return us / 1000.0; };
+    qCInfo(logDPF, "Plugins startup timeline(ms), total: %.2f", ms(startupTimer.nsecsElapsed() / 1000));
+    for (const PluginMetaObjectPointer &pointer : loadQueue) {
+        if (!timelines.contains(pointer->name()))
+            continue;
+        const PluginTimeline &timeline = timelines.value(pointer->name());
+        qCInfo(logDPF, "  %-36s load %8.2f +%7.2f%s init %8.2f +%7.2f%s start %8.2f +%7.2f",
+               qUtf8Printable(pointer->name()),
+               ms(timeline.begin[PluginTimeline::kLoad]), ms(timeline.cost[PluginTimeline::kLoad]),
+               timeline.concurrent[PluginTimeline::kLoad] ? "*" : " ",
+               ms(timeline.begin[PluginTimeline::kInit]), ms(timeline.cost[PluginTimeline::kInit]),
+               timeline.concurrent[PluginTimeline::kInit] ? "*" : " ",
+               ms(timeline.begin[PluginTimeline::kStart]), ms(timeline.cost[PluginTimeline::kStart]));
+    }
+    qCInfo(logDPF) << "(* means the stage ran on a worker thread)";
+}
+
 bool PluginManagerPrivate::doPluginSort(const PluginDependGroup group, QMap<QString, PluginMetaObjectPointer> src, QQueue<PluginMetaObjectPointer> *dest)
 {
     if (!group.isEmpty() && src.isEmpty()) {
@@ -18,12 +18,33 @@
 #include <QDebug>
 #include <QWriteLocker>
 #include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QHash>
+#include <QThread>
 
 DPF_BEGIN_NAMESPACE
 
 class PluginMetaObject;
 class PluginManager;
 
+/*!
+ * \brief 单个插件启动过程中各阶段的耗时记录，单位微秒，begin 相对于 loadPlugins 开始的时间
+ */
+struct PluginTimeline
+{
+    enum Stage {
+        kLoad,
+        kInit,
+        kStart,
+        kStageCount
+    };
+
+    qint64 begin[kStageCount] { -1, -1, -1 };
+    qint64 cost[kStageCount] { 0, 0, 0 };
+    bool concurrent[kStageCount] { false, false, false };
+};
+
 class PluginManagerPrivate : public QSharedData
 {
     Q_DISABLE_COPY(PluginManagerPrivate)
@@ -40,6 +61,11 @@ class PluginManagerPrivate : public QSharedData
     QQueue<PluginMetaObjectPointer> loadQueue;
     bool allPluginsInitialized { false };
     bool allPluginsStarted { false };
+    QMutex virtualPluginsMutex;
+    QThread *ownerThread { nullptr };
+    QElapsedTimer startupTimer;
+    QMutex timelineMutex;
+    QHash<QString, PluginTimeline> timelines;
     std::function<bool(const QString &)> lazyPluginFilter;
     std::function<bool(const QString &)> blackListFilter;
 
@@ -64,6 +90,10 @@ private:
     bool doInitPlugin(PluginMetaObjectPointer pointer);
     bool doStartPlugin(PluginMetaObjectPointer pointer);
     bool doStopPlugin(PluginMetaObjectPointer pointer);
+    bool runStage(PluginMetaObjectPointer pointer, PluginTimeline::Stage stage);
+    bool runDependsGraph(const QQueue<PluginMetaObjectPointer> &queue, PluginTimeline::Stage stage,
+                         std::function<bool(PluginMetaObjectPointer)> runInPool);
+    void dumpTimeline();
 
     void scanfAllPlugin();
     void scanfRealPlugin(PluginMetaObjectPointer metaObj,
@@ -29,6 +29,8 @@ inline constexpr char kPluginDescription[] { "Description" };
 inline constexpr char kPluginUrlLink[] { "UrlLink" };
 /// \brief kPluginDepends 插件依赖
 inline constexpr char kPluginDepends[] { "Depends" };
+/// \brief kPluginConcurrentInit 插件的 initialize 是否可以在工作线程中与其他插件并发执行，默认在主线程执行
+inline constexpr char kPluginConcurrentInit[] { "ConcurrentInit" };
 /// \brief kCustomData 插件自定义数据
 inline constexpr char kCustomData[] { "Custom" };
 /// \brief kPluginDepends virtual plugin meta info
@@ -58,6 +60,7 @@ class PluginMetaObjectPrivate
 
 public:
     bool isVirtual { false };
+    bool concurrentInit { false };
     QString realName;   // only virtual plugin
 
     QString iid;
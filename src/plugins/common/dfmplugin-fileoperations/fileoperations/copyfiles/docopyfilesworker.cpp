@@ -3,6 +3,9 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "docopyfilesworker.h"
+#include "fileoperations/fileoperationutils/direntryprefetcher.h"
+#include "fileoperations/fileoperationutils/bigfilecopyscheduler.h"
+
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/interfaces/abstractdiriterator.h>
 #include <dfm-base/utils/clipboard.h>
@@ -66,6 +69,13 @@ bool DoCopyFilesWorker::doWork()
         return false;
     }
 
+    // 线程池中的大文件拷贝可能在最后一个文件之后才失败
+    waitThreadPoolOver();
+    if (asyncCopyFailed) {
+        endWork();
+        return false;
+    }
+
     // sync
     syncFilesToDevice();
 
@@ -79,8 +89,12 @@ void DoCopyFilesWorker::stop()
 {
     // clean muilt thread copy file info queue
     threadCopyFileCount = 0;
+    if (dirPrefetcher)
+        dirPrefetcher->stop();
 
     FileOperateBaseWorker::stop();
+    // 唤醒等待大文件拷贝名额的线程，让它检查停止状态
+    BigFileCopyScheduler::instance()->wakeAll();
 }
 
 bool DoCopyFilesWorker::initArgs()
@@ -134,6 +148,8 @@ bool DoCopyFilesWorker::initArgs()
 
 void DoCopyFilesWorker::endWork()
 {
+    if (dirPrefetcher)
+        dirPrefetcher->stop();
     waitThreadPoolOver();
 
     // deal target files
@@ -29,8 +29,6 @@
 
 DPFILEOPERATIONS_USE_NAMESPACE
 
-std::atomic_bool AbstractWorker::bigFileCopy { false };
-
 /*!
  * \brief setWorkArgs 设置当前任务的参数
  * \param args 参数
@@ -260,6 +258,7 @@ bool AbstractWorker::statisticsFilesSize()
         connect(statisticsFilesSizeJob.data(), &DFMBASE_NAMESPACE::FileStatisticsJob::finished,
                 this, &AbstractWorker::onStatisticsFilesSizeFinish, Qt::DirectConnection);
         connect(statisticsFilesSizeJob.data(), &DFMBASE_NAMESPACE::FileStatisticsJob::sizeChanged, this, &AbstractWorker::onStatisticsFilesSizeUpdate, Qt::DirectConnection);
+        statisticsFilesSizeJob->setFileHints(DFMBASE_NAMESPACE::FileStatisticsJob::kCollectFileList);
         statisticsFilesSizeJob->start(sourceUrls);
     }
     return true;
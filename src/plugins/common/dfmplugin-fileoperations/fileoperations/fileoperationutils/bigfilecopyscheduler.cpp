@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bigfilecopyscheduler.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+QString sysBlockPath(dev_t dev)
+{
+    return QString("/sys/dev/block/%1:%2").arg(major(dev)).arg(minor(dev));
+}
+
+// 分区换算成所在的磁盘，同一块盘上的不同分区共用名额
+QString diskSysPath(dev_t dev)
+{
+    const QString &path = sysBlockPath(dev);
+    if (QFile::exists(path + "/partition"))
+        return QFileInfo(path + "/..").canonicalFilePath();
+    return QFileInfo(path).canonicalFilePath();
+}
+
+QByteArray readSysFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll().trimmed();
+}
+}
+
+BigFileCopyScheduler::Ticket::Ticket(BigFileCopyScheduler *scheduler, quint64 device)
+    : scheduler(scheduler), device(device)
+{
+}
+
+BigFileCopyScheduler::Ticket::~Ticket()
+{
+    scheduler->release(device);
+}
+
+BigFileCopyScheduler *BigFileCopyScheduler::instance()
+{
+    static BigFileCopyScheduler ins;
+    return &ins;
+}
+
+BigFileCopyScheduler::TicketPointer BigFileCopyScheduler::acquire(const QUrl &target, const std::function<bool()> &isStopped)
+{
+    const quint64 device = deviceOf(target);
+
+    QMutexLocker lk(&mutex);
+    if (!slotsCache.contains(device))
+        slotsCache.insert(device, slotsOfDevice(device));
+    const int slots = slotsCache.value(device);
+
+    while (running >= kMaxConcurrent || runningOfDevice.value(device) >= slots) {
+        if (isStopped && isStopped())
+            return nullptr;
+        slotReleased.wait(&mutex);
+    }
+
+    ++running;
+    ++runningOfDevice[device];
+    return TicketPointer(new Ticket(this, device));
+}
+
+void BigFileCopyScheduler::wakeAll()
+{
+    QMutexLocker lk(&mutex);
+    slotReleased.wakeAll();
+}
+
+quint64 BigFileCopyScheduler::deviceOf(const QUrl &target)
+{
+    // 目标文件可能还不存在，向上找到存在的目录
+    QString path = target.path();
+    struct stat st;
+    while (::stat(path.toLocal8Bit().constData(), &st) != 0) {
+        const QString &parent = QFileInfo(path).path();
+        if (parent == path)
+            return 0;
+        path = parent;
+    }
+
+    const QByteArray &disk = readSysFile(diskSysPath(st.st_dev) + "/dev");
+    const auto &numbers = disk.split(':');
+    if (numbers.count() == 2)
+        return makedev(numbers.first().toUInt(), numbers.last().toUInt());
+
+    return st.st_dev;
+}
+
+int BigFileCopyScheduler::slotsOfDevice(quint64 device)
+{
+    const QByteArray &rotational = readSysFile(diskSysPath(static_cast<dev_t>(device)) + "/queue/rotational");
+    return rotational == "1" ? 1 : 2;
+}
+
+void BigFileCopyScheduler::release(quint64 device)
+{
+    QMutexLocker lk(&mutex);
+    --running;
+    if (--runningOfDevice[device] <= 0)
+        runningOfDevice.remove(device);
+    slotReleased.wakeAll();
+}
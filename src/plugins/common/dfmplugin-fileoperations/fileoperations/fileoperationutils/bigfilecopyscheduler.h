@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BIGFILECOPYSCHEDULER_H
+#define BIGFILECOPYSCHEDULER_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QUrl>
+#include <QWaitCondition>
+
+#include <functional>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief 大文件拷贝调度，所有拷贝任务共用
+ *
+ * 按目标文件所在的物理磁盘分配拷贝名额：机械盘同一时间只拷贝一个大文件，
+ * 固态盘等非机械设备允许两个，不同磁盘之间互不影响，总数不超过kMaxConcurrent。
+ * 名额用Ticket表示，Ticket析构时归还名额并唤醒等待者，Ticket可以交给其它线程释放。
+ */
+class BigFileCopyScheduler
+{
+public:
+    class Ticket
+    {
+    public:
+        ~Ticket();
+
+    private:
+        friend class BigFileCopyScheduler;
+        Ticket(BigFileCopyScheduler *scheduler, quint64 device);
+        BigFileCopyScheduler *scheduler { nullptr };
+        quint64 device { 0 };
+    };
+    using TicketPointer = QSharedPointer<Ticket>;
+
+    static BigFileCopyScheduler *instance();
+
+    // 阻塞直到目标设备有空闲名额，isStopped返回true时放弃等待并返回空
+    TicketPointer acquire(const QUrl &target, const std::function<bool()> &isStopped);
+    void wakeAll();
+
+    static quint64 deviceOf(const QUrl &target);
+    static int slotsOfDevice(quint64 device);
+
+private:
+    BigFileCopyScheduler() = default;
+    void release(quint64 device);
+
+private:
+    static constexpr int kMaxConcurrent { 4 };
+    QMutex mutex;
+    QWaitCondition slotReleased;
+    QHash<quint64, int> runningOfDevice;
+    QHash<quint64, int> slotsCache;
+    int running { 0 };
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // BIGFILECOPYSCHEDULER_H
@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "direntryprefetcher.h"
+
+#include <dfm-base/interfaces/abstractdiriterator.h>
+#include <dfm-base/base/schemefactory.h>
+
+#include <QRunnable>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+DFMBASE_USE_NAMESPACE
+USING_IO_NAMESPACE
+
+namespace {
+// 单个目录的子项超过这个数量就放弃预读取，由拷贝线程边遍历边拷贝
+const int kMaxEntriesPerDir { 20000 };
+// 所有目录预读取但未被取走的子项上限，超过后不再继续预读取下一级目录
+const int kMaxBufferedEntries { 100000 };
+}
+
+DirEntryPrefetcher::DirEntryPrefetcher(int threadCount)
+{
+    pool.setMaxThreadCount(qMax(1, threadCount));
+}
+
+DirEntryPrefetcher::~DirEntryPrefetcher()
+{
+    stop();
+    pool.waitForDone();
+}
+
+void DirEntryPrefetcher::prefetch(const QList<QUrl> &dirs, int priority)
+{
+    if (stopped)
+        return;
+
+    QMutexLocker lk(&mutex);
+    for (const auto &dir : dirs) {
+        const ListingPointer &queued = listings.value(dir);
+        if (queued) {
+            // 线程池不能修改排队任务的优先级，取出后按新的优先级重新排队
+            if (queued->task && priority > queued->priority && pool.tryTake(queued->task)) {
+                queued->priority = priority;
+                pool.start(queued->task, priority);
+            }
+            continue;
+        }
+
+        if (bufferedEntries >= kMaxBufferedEntries)
+            continue;
+
+        ListingPointer listing(new Listing);
+        listing->priority = priority;
+        listing->task = QRunnable::create([this, dir, listing]() {
+            enumerate(dir, listing);
+        });
+        listings.insert(dir, listing);
+        pool.start(listing->task, priority);
+    }
+}
+
+bool DirEntryPrefetcher::take(const QUrl &dir, QList<DFileInfoPointer> *entries)
+{
+    QMutexLocker lk(&mutex);
+    auto listing = listings.value(dir);
+    if (!listing)
+        return false;
+
+    // 还在排队的目录不再等待线程池调度，直接在拷贝线程中遍历
+    if (listing->task && pool.tryTake(listing->task)) {
+        delete listing->task;
+        listing->task = nullptr;
+        lk.unlock();
+        enumerate(dir, listing);
+        lk.relock();
+    }
+
+    while (!listing->finished && !stopped)
+        listingFinished.wait(&mutex);
+
+    if (!listing->finished)
+        return false;
+
+    listings.remove(dir);
+    bufferedEntries -= listing->entries.count();
+    if (!listing->ok)
+        return false;
+
+    *entries = std::move(listing->entries);
+    return true;
+}
+
+void DirEntryPrefetcher::discard(const QList<QUrl> &dirs)
+{
+    if (stopped || dirs.isEmpty())
+        return;
+
+    QMutexLocker lk(&mutex);
+    for (const auto &dir : dirs) {
+        QString prefix = dir.path();
+        if (!prefix.endsWith('/'))
+            prefix.append('/');
+
+        for (auto it = listings.begin(); it != listings.end();) {
+            if (it.key() == dir || it.key().path().startsWith(prefix)) {
+                releaseListing(it.value());
+                it = listings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void DirEntryPrefetcher::releaseListing(const ListingPointer &listing)
+{
+    bufferedEntries -= listing->entries.count();
+    listing->entries.clear();
+    // 还没开始遍历的直接从队列中取出，正在遍历的在结束时发现已被移除
+    if (listing->task && pool.tryTake(listing->task)) {
+        delete listing->task;
+        listing->task = nullptr;
+    }
+}
+
+void DirEntryPrefetcher::stop()
+{
+    stopped = true;
+    pool.clear();
+
+    QMutexLocker lk(&mutex);
+    listingFinished.wakeAll();
+}
+
+QList<QUrl> DirEntryPrefetcher::subDirs(const QList<DFileInfoPointer> &entries)
+{
+    QList<QUrl> dirs;
+    for (const auto &info : entries) {
+        if (info->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool()
+            && !info->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool())
+            dirs.append(info->uri());
+    }
+    return dirs;
+}
+
+void DirEntryPrefetcher::enumerate(const QUrl &dir, const ListingPointer &listing)
+{
+    {
+        QMutexLocker lk(&mutex);
+        listing->task = nullptr;
+    }
+
+    QList<DFileInfoPointer> entries;
+    bool ok = false;
+
+    QString error;
+    const AbstractDirIteratorPointer &iterator = DirIteratorFactory::create<AbstractDirIterator>(dir, &error);
+    if (iterator) {
+        ok = true;
+        iterator->setProperty("QueryAttributes", "standard::name");
+        while (iterator->hasNext()) {
+            if (stopped || entries.count() >= kMaxEntriesPerDir) {
+                ok = false;
+                break;
+            }
+
+            DFileInfoPointer info(new DFileInfo(iterator->next()));
+            info->initQuerier();
+            entries.append(info);
+        }
+    }
+
+    QList<QUrl> dirs = ok ? subDirs(entries) : QList<QUrl>();
+    {
+        QMutexLocker lk(&mutex);
+        // 遍历过程中被放弃的目录不再缓存结果，也不再预读取下一级
+        if (listings.value(dir) != listing) {
+            ok = false;
+            dirs.clear();
+        }
+        if (ok) {
+            bufferedEntries += entries.count();
+            listing->entries = std::move(entries);
+        }
+        listing->ok = ok;
+        listing->finished = true;
+        listingFinished.wakeAll();
+    }
+
+    // 下一级目录继续排队，线程池中的空闲线程会取走它们
+    prefetch(dirs);
+}
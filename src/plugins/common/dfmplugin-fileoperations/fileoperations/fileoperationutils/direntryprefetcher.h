@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DIRENTRYPREFETCHER_H
+#define DIRENTRYPREFETCHER_H
+
+#include "dfmplugin_fileoperations_global.h"
+#include "workerdata.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <atomic>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief 目录项预读取
+ *
+ * 拷贝目录时，拷贝线程需要逐个遍历子项并查询文件信息，大量小文件时单线程遍历是瓶颈。
+ * 这里在独立的线程池中并行遍历目录并初始化子项的DFileInfo，遍历完成的目录会把自己的子目录
+ * 继续放入线程池的队列，拷贝线程到达某个目录时直接取走已经准备好的子项。
+ * 错误处理仍然由拷贝线程完成：预读取失败、目录过大或者未预读取的目录，take返回false，
+ * 由调用者按原来的方式同步遍历。
+ */
+class DirEntryPrefetcher
+{
+public:
+    explicit DirEntryPrefetcher(int threadCount);
+    ~DirEntryPrefetcher();
+
+    // priority越大越先遍历，拷贝线程正在处理的目录的子目录优先，已经排队的目录会提高优先级
+    void prefetch(const QList<QUrl> &dirs, int priority = 0);
+    bool take(const QUrl &dir, QList<DFileInfoPointer> *entries);
+    // 拷贝线程不会再使用这些目录及其下级目录的预读取结果，释放它们占用的缓存
+    void discard(const QList<QUrl> &dirs);
+    void stop();
+
+    static QList<QUrl> subDirs(const QList<DFileInfoPointer> &entries);
+
+private:
+    struct Listing
+    {
+        bool finished { false };
+        bool ok { false };
+        int priority { 0 };
+        QRunnable *task { nullptr };   // 还在线程池队列中等待时有效
+        QList<DFileInfoPointer> entries;
+    };
+    using ListingPointer = QSharedPointer<Listing>;
+
+    void enumerate(const QUrl &dir, const ListingPointer &listing);
+    void releaseListing(const ListingPointer &listing);
+
+private:
+    QThreadPool pool;
+    QMutex mutex;
+    QWaitCondition listingFinished;
+    QHash<QUrl, ListingPointer> listings;
+    int bufferedEntries { 0 };   // 已经预读取但还没被取走的子项数量，用于限制内存
+    std::atomic_bool stopped { false };
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // DIRENTRYPREFETCHER_H
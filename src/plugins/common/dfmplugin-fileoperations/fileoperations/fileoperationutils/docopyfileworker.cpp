@@ -15,11 +15,13 @@
 
 #include <QDebug>
 #include <QTime>
+#include <QElapsedTimer>
 #include <QWaitCondition>
 #include <QMutex>
 #include <QThread>
 
 #include <fcntl.h>
+#include <unistd.h>
 #include <zlib.h>
 #include <sys/mman.h>
 
@@ -272,9 +274,6 @@ DoCopyFileWorker::NextDo DoCopyFileWorker::doCopyFilePractically(const DFileInfo
 
     } while (fromDevice->pos() != fromSize);
 
-    delete[] data;
-    data = nullptr;
-
     // 执行同步策略
     if ((workData->exBlockSyncEveryWrite || toIsSmb) && toFd > 0)
         syncfs(toFd);
@@ -284,12 +283,17 @@ DoCopyFileWorker::NextDo DoCopyFileWorker::doCopyFilePractically(const DFileInfo
 
     // 对文件加权
     setTargetPermissions(fromInfo->uri(), toInfo->uri());
-    if (!stateCheck())
+    if (!stateCheck()) {
+        delete[] data;
         return NextDo::kDoCopyErrorAddCancel;
+    }
 
-    // 校验文件完整性
+    // 校验文件完整性，复用拷贝的缓冲区
+    toDevice->close();
     if (skip)
-        *skip = verifyFileIntegrity(blockSize, sourceCheckSum, fromInfo, toInfo, toDevice);
+        *skip = verifyFileIntegrity(data, blockSize, sourceCheckSum, fromInfo, toInfo);
+    delete[] data;
+    data = nullptr;
     toInfo->refresh();
 
     if (skip && *skip)
@@ -794,29 +798,63 @@ DoCopyFileWorker::NextDo DoCopyFileWorker::doWriteFileErrorRetry(const DFileInfo
     return NextDo::kDoCopyReDoCurrentFile;
 }
 
-bool DoCopyFileWorker::verifyFileIntegrity(const qint64 &blockSize, const ulong &sourceCheckSum,
-                                           const DFileInfoPointer &fromInfo, const DFileInfoPointer &toInfo,
-                                           QSharedPointer<DFMIO::DFile> &toDevice)
+/*!
+ * \brief DoCopyFileWorker::verifyFileIntegrity 重新读取目标文件计算校验值，与拷贝时从源数据计算的校验值比较
+ * 默认读取刚写入的页缓存；integrityCheckFromDisk打开时先同步目标文件并丢弃页缓存，保证校验的是磁盘上的数据
+ * \param data 拷贝时使用的缓冲区，大小为blockSize
+ */
+bool DoCopyFileWorker::verifyFileIntegrity(char *data, const qint64 &blockSize, const ulong &sourceCheckSum,
+                                           const DFileInfoPointer &fromInfo, const DFileInfoPointer &toInfo)
 {
     if (!workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking))
         return true;
-    char *data = new char[static_cast<uint>(blockSize + 1)];
+
     QElapsedTimer t;
+    t.start();
+    const auto fromSize = fromInfo->attribute(DFileInfo::AttributeID::kStandardSize).toLongLong();
     ulong targetCheckSum = adler32(0L, nullptr, 0);
+    qint64 readTotal = 0;
+    int fd = -1;
+    FinallyUtil release([&] {
+        if (fd >= 0)
+            close(fd);
+    });
+
     Q_FOREVER {
-        qint64 size = toDevice->read(data, blockSize);
+        QString errorMsg;
+        if (fd < 0) {
+            fd = open(toInfo->uri().path().toUtf8().constData(), O_RDONLY);
+            if (fd >= 0) {
+                if (workData->integrityCheckFromDisk) {
+                    fdatasync(fd);
+                    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                }
+                posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+            } else {
+                errorMsg = strerror(errno);
+            }
+        }
+
+        ssize_t size = fd >= 0 ? read(fd, data, static_cast<size_t>(blockSize)) : -1;
+        if (size < 0 && errorMsg.isEmpty())
+            errorMsg = strerror(errno);
 
         if (Q_UNLIKELY(size <= 0)) {
-            if (size == 0 && toInfo->attribute(DFileInfo::AttributeID::kStandardSize).toLongLong() == toDevice->pos()) {
+            if (size == 0 && readTotal == fromSize)
                 break;
-            }
 
             AbstractJobHandler::SupportAction actionForCheckRead = doHandleErrorAndWait(fromInfo->uri(),
                                                                                         toInfo->uri(),
                                                                                         AbstractJobHandler::JobErrorType::kIntegrityCheckingError,
                                                                                         true,
-                                                                                        toDevice->lastError().errorMsg());
+                                                                                        errorMsg);
             if (!isStopped() && AbstractJobHandler::SupportAction::kRetryAction == actionForCheckRead) {
+                // 从头重新校验
+                if (fd >= 0)
+                    close(fd);
+                fd = -1;
+                readTotal = 0;
+                targetCheckSum = adler32(0L, nullptr, 0);
                 continue;
             } else {
                 checkRetry();
@@ -824,17 +862,14 @@ bool DoCopyFileWorker::verifyFileIntegrity(const qint64 &blockSize, const ulong
             }
         }
 
+        readTotal += size;
         targetCheckSum = adler32(targetCheckSum, reinterpret_cast<Bytef *>(data), static_cast<uInt>(size));
 
-        if (Q_UNLIKELY(!stateCheck())) {
-            delete[] data;
-            data = nullptr;
+        if (Q_UNLIKELY(!stateCheck()))
             return false;
-        }
     }
-    delete[] data;
 
-    fmDebug("Time spent of integrity check of the file: %d", t.elapsed());
+    fmDebug("Time spent of integrity check of the file: %lld", t.elapsed());
 
     if (sourceCheckSum != targetCheckSum) {
         fmWarning("Failed on file integrity checking, source file: 0x%lx, target file: 0x%lx", sourceCheckSum, targetCheckSum);
@@ -112,9 +112,8 @@ private:   // file copy
                                  const qint64 &surplusSize, qint64 &curWrite);
     void setTargetPermissions(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo);
     void setTargetPermissions(const QUrl &fromUrl, const QUrl &toUrl);
-    bool verifyFileIntegrity(const qint64 &blockSize, const ulong &sourceCheckSum,
-                             const DFileInfoPointer &fromInfo, const DFileInfoPointer &toInfo,
-                             QSharedPointer<DFMIO::DFile> &toFile);
+    bool verifyFileIntegrity(char *data, const qint64 &blockSize, const ulong &sourceCheckSum,
+                             const DFileInfoPointer &fromInfo, const DFileInfoPointer &toInfo);
     void checkRetry();
     bool isStopped();
     void syncBlockFile(const DFileInfoPointer toInfo);
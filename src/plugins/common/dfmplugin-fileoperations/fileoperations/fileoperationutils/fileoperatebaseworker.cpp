@@ -5,6 +5,8 @@
 #include "fileoperatebaseworker.h"
 #include "fileoperations/fileoperationutils/fileoperationsutils.h"
 #include "workerdata.h"
+#include "direntryprefetcher.h"
+#include "bigfilecopyscheduler.h"
 
 #include <dfm-base/interfaces/abstractdiriterator.h>
 #include <dfm-base/base/schemefactory.h>
@@ -19,6 +21,7 @@
 #include <QDateTime>
 #include <QApplication>
 #include <QProcess>
+#include <QFileInfo>
 #include <QtConcurrent>
 
 #include <fcntl.h>
@@ -647,16 +650,12 @@ bool FileOperateBaseWorker::checkAndCopyFile(const DFileInfoPointer fromInfo, co
     if (jobType == AbstractJobHandler::JobType::kCutType)
         return doCopyOtherFile(fromInfo, toInfo, skip);
 
-    if (isSourceFileLocal && isTargetFileLocal && !workData->signalThread) {
-        while (bigFileCopy && !isStopped()) {
-            QThread::msleep(10);
-        }
-        if (fromSize > bigFileSize) {
-            bigFileCopy = true;
-            auto result = doCopyLocalByRange(fromInfo, toInfo, skip);
-            bigFileCopy = false;
-            return result;
-        }
+    // copy_file_range不经过用户态缓冲区，需要完整性校验的大文件走边读边计算校验值的流程
+    const bool integrityChecking = workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking);
+    if (isSourceFileLocal && isTargetFileLocal && !workData->signalThread
+        && !(integrityChecking && fromSize > bigFileSize)) {
+        if (fromSize > bigFileSize)
+            return doCopyLocalByRange(fromInfo, toInfo, skip);
         return doCopyLocalFile(fromInfo, toInfo);
     }
 
@@ -710,42 +709,41 @@ bool FileOperateBaseWorker::checkAndCopyDir(const DFileInfoPointer &fromInfo, co
         }
     }
 
-    // 遍历源文件，执行一个一个的拷贝
-    QString error;
-    const AbstractDirIteratorPointer &iterator = DirIteratorFactory::create<AbstractDirIterator>(fromInfo->uri(), &error);
-    if (!iterator) {
-        fmCritical() << "create dir's iterator failed, case : " << error;
-        doHandleErrorAndWait(fromInfo->uri(), toInfo->uri(), AbstractJobHandler::JobErrorType::kProrogramError);
-        return false;
-    }
-
     bool self = true;
-    iterator->setProperty("QueryAttributes", "standard::name");
-    while (iterator->hasNext()) {
-        if (!stateCheck()) {
-            return false;
+    // 子项已经被预读取，直接拷贝，同时让它的子目录优先预读取
+    QList<DFileInfoPointer> entries;
+    if (dirPrefetcher && dirPrefetcher->take(fromInfo->uri(), &entries)) {
+        const QList<QUrl> &subDirs = DirEntryPrefetcher::subDirs(entries);
+        dirPrefetcher->prefetch(subDirs, 1);
+        for (const auto &info : entries) {
+            if (!stateCheck())
+                return false;
+            if (!copyDirEntry(info, toInfo, skip, &self))
+                return false;
         }
-
-        const QUrl &url = iterator->next();
-        DFileInfoPointer info(new DFileInfo(url));
-        info->initQuerier();
-        bool ok = doCopyFile(info, toInfo, skip);
-        if (!ok && (!skip || !*skip)) {
+        // 子目录都已拷贝完成，被跳过的子目录的预读取结果不会再被使用
+        dirPrefetcher->discard(subDirs);
+    } else {
+        // 遍历源文件，执行一个一个的拷贝
+        QString error;
+        const AbstractDirIteratorPointer &iterator = DirIteratorFactory::create<AbstractDirIterator>(fromInfo->uri(), &error);
+        if (!iterator) {
+            fmCritical() << "create dir's iterator failed, case : " << error;
+            doHandleErrorAndWait(fromInfo->uri(), toInfo->uri(), AbstractJobHandler::JobErrorType::kProrogramError);
             return false;
         }
 
-        if (jobType == AbstractJobHandler::JobType::kCutType) {
-            if (!ok) {
-                self = false;
-                continue;
+        iterator->setProperty("QueryAttributes", "standard::name");
+        while (iterator->hasNext()) {
+            if (!stateCheck()) {
+                return false;
             }
 
-            if (info->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool()
-                || info->attribute(DFileInfo::AttributeID::kStandardIsFile).toBool()) {
-                cutAndDeleteFiles.append(info);
-            } else if (self && !cutAndDeleteFiles.contains(info)) {
-                self = false;
-            }
+            const QUrl &url = iterator->next();
+            DFileInfoPointer info(new DFileInfo(url));
+            info->initQuerier();
+            if (!copyDirEntry(info, toInfo, skip, &self))
+                return false;
         }
     }
 
@@ -765,16 +763,35 @@ bool FileOperateBaseWorker::checkAndCopyDir(const DFileInfoPointer &fromInfo, co
     return true;
 }
 
-void FileOperateBaseWorker::waitThreadPoolOver()
+bool FileOperateBaseWorker::copyDirEntry(const DFileInfoPointer &info, const DFileInfoPointer &toInfo, bool *skip, bool *self)
 {
-    // wait all thread start
-    if (!isStopped() && threadPool) {
-        QThread::msleep(10);
+    bool ok = doCopyFile(info, toInfo, skip);
+    if (!ok && (!skip || !*skip)) {
+        return false;
     }
-    // wait thread pool copy local file or copy big file over
-    while (threadPool && threadPool->activeThreadCount() > 0) {
-        QThread::msleep(10);
+
+    if (jobType == AbstractJobHandler::JobType::kCutType) {
+        if (!ok) {
+            *self = false;
+            return true;
+        }
+
+        if (info->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool()
+            || info->attribute(DFileInfo::AttributeID::kStandardIsFile).toBool()) {
+            cutAndDeleteFiles.append(info);
+        } else if (*self && !cutAndDeleteFiles.contains(info)) {
+            *self = false;
+        }
     }
+
+    return true;
+}
+
+void FileOperateBaseWorker::waitThreadPoolOver()
+{
+    // wait thread pool copy local file or copy big file over, include queued tasks
+    if (threadPool)
+        threadPool->waitForDone();
 }
 
 void FileOperateBaseWorker::initCopyWay()
@@ -798,6 +815,20 @@ void FileOperateBaseWorker::initCopyWay()
         initThreadCopy();
     }
 
+    if (workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking))
+        workData->integrityCheckFromDisk = FileOperationsUtils::integrityCheckFromDisk();
+
+    // 本地源目录并行预读取子项，拷贝线程只负责分发
+    if (isSourceFileLocal) {
+        dirPrefetcher.reset(new DirEntryPrefetcher(FileUtils::getCpuProcessCount() > 4 ? 4 : 2));
+        QList<QUrl> sourceDirs;
+        for (const auto &url : sourceUrls) {
+            if (QFileInfo(url.path()).isDir())
+                sourceDirs.append(url);
+        }
+        dirPrefetcher->prefetch(sourceDirs, 1);
+    }
+
     copyTid = (countWriteType == CountWriteSizeType::kTidType) ? syscall(SYS_gettid) : -1;
 }
 
@@ -885,7 +916,7 @@ QUrl FileOperateBaseWorker::createNewTargetUrl(const DFileInfoPointer &toInfo, c
 
 bool FileOperateBaseWorker::doCopyLocalFile(const DFileInfoPointer fromInfo, const DFileInfoPointer toInfo)
 {
-    if (!stateCheck())
+    if (asyncCopyFailed || !stateCheck())
         return false;
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
@@ -904,13 +935,37 @@ bool FileOperateBaseWorker::doCopyLocalFile(const DFileInfoPointer fromInfo, con
 
 bool FileOperateBaseWorker::doCopyLocalByRange(const DFileInfoPointer fromInfo, const DFileInfoPointer toInfo, bool *skip)
 {
-    waitThreadPoolOver();
-    const QString &targetUrl = toInfo->uri().toString();
+    // 拷贝在线程池中异步完成，跳过只影响这一个文件，不需要告知调用者
+    Q_UNUSED(skip)
+    if (asyncCopyFailed)
+        return false;
 
-    FileUtils::cacheCopyingFileUrl(targetUrl);
-    DoCopyFileWorker::NextDo nextDo = threadCopyWorker[0]->doCopyFileByRange(fromInfo, toInfo, skip);
-    FileUtils::removeCopyingFileUrl(targetUrl);
-    return nextDo == DoCopyFileWorker::NextDo::kDoCopyNext;
+    // 等待目标磁盘的大文件名额，拿到后在线程池中拷贝，后面的小文件不用等大文件拷贝完成
+    auto ticket = BigFileCopyScheduler::instance()->acquire(toInfo->uri(), [this]() { return isStopped(); });
+    if (!ticket || !stateCheck())
+        return false;
+
+    auto worker = threadCopyWorker[threadCopyFileCount % threadCount];
+    QtConcurrent::run(threadPool.data(), [this, worker, fromInfo, toInfo, ticket]() mutable {
+        const QString &targetUrl = toInfo->uri().toString();
+        FileUtils::cacheCopyingFileUrl(targetUrl);
+        bool skipped { false };
+        DoCopyFileWorker::NextDo nextDo { DoCopyFileWorker::NextDo::kDoCopyNext };
+        do {
+            nextDo = worker->doCopyFileByRange(fromInfo, toInfo, &skipped);
+        } while (nextDo == DoCopyFileWorker::NextDo::kDoCopyReDoCurrentFile && !isStopped());
+        FileUtils::removeCopyingFileUrl(targetUrl);
+        ticket.reset();
+
+        // 与同步拷贝时返回 false 一致：没有跳过的错误结束整个任务
+        if (nextDo == DoCopyFileWorker::NextDo::kDoCopyErrorAddCancel && !skipped && !isStopped()) {
+            fmWarning() << "copy file by range failed, stop copying, url from: " << fromInfo->uri();
+            asyncCopyFailed = true;
+        }
+    });
+
+    threadCopyFileCount++;
+    return true;
 }
 
 bool FileOperateBaseWorker::doCopyOtherFile(const DFileInfoPointer fromInfo, const DFileInfoPointer toInfo, bool *skip)
@@ -16,6 +16,7 @@ class QObject;
 
 DPFILEOPERATIONS_BEGIN_NAMESPACE
 class DoCopyFileWorker;
+class DirEntryPrefetcher;
 class FileOperateBaseWorker : public AbstractWorker, public QEnableSharedFromThis<FileInfo>
 {
 
@@ -98,6 +99,7 @@ private:
     bool doCopyLocalFile(const DFileInfoPointer fromInfo, const DFileInfoPointer toInfo);
     bool doCopyOtherFile(const DFileInfoPointer fromInfo, const DFileInfoPointer toInfo, bool *skip);
     bool doCopyLocalByRange(const DFileInfoPointer fromInfo, const DFileInfoPointer toInfo, bool *skip);
+    bool copyDirEntry(const DFileInfoPointer &info, const DFileInfoPointer &toInfo, bool *skip, bool *self);
 
 protected Q_SLOTS:
     void emitErrorNotify(const QUrl &from, const QUrl &to, const AbstractJobHandler::JobErrorType &error,
@@ -131,7 +133,9 @@ protected:
     QList<QUrl> syncFiles;
 
     std::atomic_int threadCopyFileCount { 0 };
+    std::atomic_bool asyncCopyFailed { false };   // 线程池中的大文件拷贝出错且没有跳过，后续拷贝不再继续
     QList<DFileInfoPointer> cutAndDeleteFiles;
+    QSharedPointer<DirEntryPrefetcher> dirPrefetcher { nullptr };   // 并行预读取源目录的子项
 };
 DPFILEOPERATIONS_END_NAMESPACE
 
@@ -32,6 +32,7 @@ inline constexpr char kFileOperations[] { "org.deepin.dde.file-manager.operation
 inline constexpr char kFileBigSize[] { "file.operation.bigfilesize" };
 inline constexpr char kBlockEverySync[] { "file.operation.blockeverysync" };
 inline constexpr char kBroadcastPaste[] { "file.operation.broadcastpastevent" };
+inline constexpr char kIntegrityCheckFromDisk[] { "file.operation.integritycheckfromdisk" };
 QMutex FileOperationsUtils::mutex;
 
 /*!
@@ -169,6 +170,11 @@ bool FileOperationsUtils::blockSync()
     return sync;
 }
 
+bool FileOperationsUtils::integrityCheckFromDisk()
+{
+    return DConfigManager::instance()->value(kFileOperations, kIntegrityCheckFromDisk).toBool();
+}
+
 QUrl FileOperationsUtils::parentUrl(const QUrl &url)
 {
     auto parent = url.adjusted(QUrl::StripTrailingSlash);
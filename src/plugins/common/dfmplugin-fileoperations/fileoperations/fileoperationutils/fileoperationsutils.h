@@ -76,6 +76,7 @@ private:
     static bool isFileOnDisk(const QUrl &url);
     static qint64 bigFileSize();
     static bool blockSync();
+    static bool integrityCheckFromDisk();
     static QUrl parentUrl(const QUrl &url);
     static bool canBroadcastPaste();
 
@@ -6,6 +6,7 @@
 
 #include <dfm-base/dfm_event_defines.h>
 #include <dfm-base/utils/clipboard.h>
+#include <dfm-base/base/device/deviceproxymanager.h>
 
 #include <dfm-framework/event/event.h>
 
@@ -112,4 +113,6 @@ void FileOperationsEventHandler::handleFinishedNotify(const JobInfoPointer &jobI
     auto jobType = jobInfo->value(AbstractJobHandler::NotifyInfoKey::kJobtypeKey).value<DFMBASE_NAMESPACE::AbstractJobHandler::JobType>();
     publishJobResultEvent(jobType, srcUrls, destUrls, customInfos, *ok, *errMsg);
     removeUrlsInClipboard(jobType, srcUrls, destUrls, *ok);
+    // usage of the devices is changed, refresh them without waiting for the next polling
+    DevProxyMng->requestUsageUpdate(srcUrls + destUrls);
 }
@@ -6,6 +6,8 @@
 #include "private/tagproxyhandle_p.h"
 #include "utils/tagmanager.h"
 
+#include <dfm-base/utils/filetagsnapshot.h>
+
 using namespace dfmplugin_tag;
 static constexpr char kDaemonName[] { "org.deepin.Filemanager.Daemon" };
 static constexpr char kTagDBusPath[] { "/org/deepin/Filemanager/Daemon/TagManager" };
@@ -152,6 +154,44 @@ QVariantHash TagProxyHandle::getAllFileWithTags()
     return data.toHash();
 }
 
+/*!
+ * \brief 获取标签服务生成的文件标记快照，快照通过 unix fd 传递后只读映射，不经过 dbus 序列化
+ */
+bool TagProxyHandle::getFileTagSnapshot(DFMBASE_NAMESPACE::FileTagSnapshot *snapshot)
+{
+    if (!snapshot || !d->isDBusRuning())
+        return false;
+
+    if (!d->tagDBusInterface->connection().connectionCapabilities().testFlag(QDBusConnection::UnixFileDescriptorPassing)) {
+        fmWarning() << "Current dbus connection does not support passing unix file descriptors";
+        return false;
+    }
+
+    auto &&reply = d->tagDBusInterface->Snapshot();
+    reply.waitForFinished();
+    if (!reply.isValid()) {
+        fmWarning() << "getFileTagSnapshot failed :" << reply.error();
+        return false;
+    }
+
+    const QDBusUnixFileDescriptor &fd = reply.value();
+    return fd.isValid() && snapshot->attach(fd.fileDescriptor());
+}
+
+QByteArray TagProxyHandle::getChangesSince(quint64 since)
+{
+    if (!d->isDBusRuning())
+        return {};
+
+    auto &&reply = d->tagDBusInterface->Changes(since);
+    reply.waitForFinished();
+    if (!reply.isValid()) {
+        fmWarning() << "getChangesSince failed :" << reply.error();
+        return {};
+    }
+    return reply.value();
+}
+
 bool TagProxyHandle::addTags(const QVariantMap &value)
 {
     auto &&reply = d->tagDBusInterface->Insert(int(InsertOpts::kTags), value);
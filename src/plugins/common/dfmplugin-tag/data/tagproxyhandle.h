@@ -9,6 +9,10 @@
 
 #define TagProxyHandleIns DPTAG_NAMESPACE::TagProxyHandle::instance()
 
+namespace dfmbase {
+class FileTagSnapshot;
+}
+
 namespace dfmplugin_tag {
 
 class TagProxyHandlePrivate;
@@ -26,6 +30,8 @@ public:
     QVariantMap getFilesThroughTag(const QStringList &value);
     QVariantMap getTagsColor(const QStringList &value);
     QVariantHash getAllFileWithTags();
+    bool getFileTagSnapshot(DFMBASE_NAMESPACE::FileTagSnapshot *snapshot);
+    QByteArray getChangesSince(quint64 since);
 
     bool addTags(const QVariantMap &value);
     bool addTagsForFiles(const QVariantMap &value);
@@ -44,6 +44,18 @@ enum class UpdateOpts : int {
     kFilesPaths
 };
 
+// change kinds recorded by the tag daemon, see TagManager.Changes
+enum class ChangeOpts : int {
+    kTagsAdded,
+    kTagsDeleted,
+    kTagsColorChanged,
+    kTagsNameChanged,
+    kFilesTagged,
+    kFilesUntagged,
+    kFilesDeleted,
+    kFilePathsChanged
+};
+
 inline constexpr int kTagDiameter { 10 };
 
 namespace TagActionId {
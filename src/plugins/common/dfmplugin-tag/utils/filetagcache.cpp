@@ -11,8 +11,13 @@
 #include <QColor>
 #include <QDebug>
 #include <QSet>
+#include <QDataStream>
 
 DPTAG_USE_NAMESPACE
+DFMBASE_USE_NAMESPACE
+
+// 快照之后修改过的文件超过这个数量时重新加载快照
+static constexpr int kMaxOverlayFiles = 8192;
 
 FileTagCacheWorker::FileTagCacheWorker(QObject *parent)
     : QObject(parent)
@@ -59,12 +64,14 @@ void FileTagCacheWorker::onFilesTagged(const QVariantMap &fileAndTags)
 {
     FileTagCache::instance().taggeFiles(fileAndTags);
     emit FileTagCacheIns.filesTagged(fileAndTags);
+    FileTagCache::instance().compact();
 }
 
 void FileTagCacheWorker::onFilesUntagged(const QVariantMap &fileAndTags)
 {
     FileTagCache::instance().untaggeFiles(fileAndTags);
     emit FileTagCacheIns.filesUntagged(fileAndTags);
+    FileTagCache::instance().compact();
 }
 
 FileTagCachePrivate::FileTagCachePrivate(FileTagCache *qq)
@@ -76,6 +83,34 @@ FileTagCachePrivate::~FileTagCachePrivate()
 {
 }
 
+QStringList FileTagCachePrivate::tagsOfFile(const QString &path) const
+{
+    auto it = fileTagsCache.constFind(path);
+    if (it != fileTagsCache.constEnd())
+        return it.value();
+
+    if (!snapshot)
+        return {};
+
+    QStringList tags;
+    const auto &ids = snapshot->tagIds(path);
+    for (quint32 id : ids) {
+        const QString &tag { id < static_cast<quint32>(snapshotTags.size()) ? snapshotTags.at(static_cast<int>(id)) : QString() };
+        if (!tag.isEmpty() && !tags.contains(tag))
+            tags.append(tag);
+    }
+    return tags;
+}
+
+void FileTagCachePrivate::setTagsOfFile(const QString &path, const QStringList &tags)
+{
+    // 快照中存在的文件需要保留一个空列表来覆盖快照
+    if (tags.isEmpty() && !(snapshot && snapshot->contains(path)))
+        fileTagsCache.remove(path);
+    else
+        fileTagsCache.insert(path, tags);
+}
+
 FileTagCache::FileTagCache(QObject *parent)
     : QObject(parent), d(new FileTagCachePrivate(this))
 {
@@ -87,21 +122,147 @@ FileTagCache &FileTagCache::instance()
     return cache;
 }
 
+/*!
+ * \brief 加载文件标记和标记属性到缓存
+ * 已经同步过时只向标签服务获取之后的变更，否则（首次加载、服务重启、落后太多）重新加载快照
+ */
 void FileTagCache::loadFileTagsFromDatabase()
 {
     fmInfo() << "Start initilize FileTagCache";
-    // 加载数据库所有文件标记,和标记属性到缓存
     if (!TagProxyHandle::instance()->isValid())
         fmWarning() << "tagService is inValid";
-    d->fileTagsCache = TagProxyHandle::instance()->getAllFileWithTags();
+
     const auto &tagsColor = TagProxyHandle::instance()->getAllTags();
-    auto it = tagsColor.begin();
-    for (; it != tagsColor.end(); ++it)
-        d->tagProperty.insert(it.key(), QColor(it.value().toString()));
+    {
+        QWriteLocker lk(&d->lock);
+        auto it = tagsColor.begin();
+        for (; it != tagsColor.end(); ++it)
+            d->tagProperty.insert(it.key(), QColor(it.value().toString()));
+    }
+
+    if (d->sequence != 0 && syncChanges())
+        return;
+
+    reloadFileTags();
+}
+
+void FileTagCache::reloadFileTags()
+{
+    QSharedPointer<FileTagSnapshot> snapshot(new FileTagSnapshot);
+    if (TagProxyHandle::instance()->getFileTagSnapshot(snapshot.data())) {
+        const auto &tags = snapshot->tagNames();
+        QWriteLocker lk(&d->lock);
+        d->snapshot = snapshot;
+        d->snapshotTags = tags;
+        d->fileTagsCache.clear();
+        d->sequence = snapshot->sequence();
+        fmInfo() << "File tags loaded from snapshot, files:" << snapshot->fileCount();
+        return;
+    }
+
+    // 不支持快照的服务回退到全量查询
+    const auto &fileTags = TagProxyHandle::instance()->getAllFileWithTags();
+    QHash<QString, QStringList> cache;
+    cache.reserve(fileTags.size());
+    for (auto it = fileTags.begin(); it != fileTags.end(); ++it)
+        cache.insert(it.key(), it.value().toStringList());
+
+    QWriteLocker lk(&d->lock);
+    d->snapshot.reset();
+    d->snapshotTags.clear();
+    d->fileTagsCache.swap(cache);
+    d->sequence = 0;
+}
+
+/*!
+ * \brief 应用标签服务记录的变更，数据格式见 TagDbHandler::changesSince
+ * \return 服务要求重新加载快照或者获取失败时返回 false
+ */
+bool FileTagCache::syncChanges()
+{
+    const QByteArray &data = TagProxyHandle::instance()->getChangesSince(d->sequence);
+    if (data.isEmpty())
+        return false;
+
+    QDataStream stream(data);
+    quint64 current { 0 };
+    bool reset { true };
+    qint32 count { 0 };
+    stream >> current >> reset >> count;
+    if (stream.status() != QDataStream::Ok || reset)
+        return false;
+
+    // 变更都是幂等的，与已经通过信号收到的修改重复应用不影响结果
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        quint64 seq { 0 };
+        qint32 type { 0 };
+        QVariant value;
+        stream >> seq >> type >> value;
+        if (stream.status() == QDataStream::Ok)
+            applyChange(type, value);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        fmWarning() << "Parse tag changes failed, reload all file tags";
+        return false;
+    }
+
+    d->sequence = current;
+    fmInfo() << "File tags synchronized, changes:" << count << "sequence:" << current;
+    return true;
+}
+
+void FileTagCache::applyChange(int type, const QVariant &data)
+{
+    switch (static_cast<ChangeOpts>(type)) {
+    case ChangeOpts::kTagsAdded:
+        addTags(data.toMap());
+        break;
+    case ChangeOpts::kTagsDeleted:
+        deleteTags(data.toStringList());
+        break;
+    case ChangeOpts::kTagsColorChanged:
+        changeTagColor(data.toMap());
+        break;
+    case ChangeOpts::kTagsNameChanged: {
+        const auto &oldAndNew = data.toMap();
+        changeTagName(oldAndNew);
+        for (auto it = oldAndNew.begin(); it != oldAndNew.end(); ++it)
+            changeFilesTagName(it.key(), it.value().toString());
+        break;
+    }
+    case ChangeOpts::kFilesTagged:
+        taggeFiles(data.toMap());
+        break;
+    case ChangeOpts::kFilesUntagged:
+        untaggeFiles(data.toMap());
+        break;
+    case ChangeOpts::kFilesDeleted:
+        removeFiles(data.toStringList());
+        break;
+    case ChangeOpts::kFilePathsChanged:
+        moveFiles(data.toMap());
+        break;
+    }
+}
+
+/*!
+ * \brief 快照之后的修改太多时重新加载快照，避免修改记录无限增长
+ */
+void FileTagCache::compact()
+{
+    {
+        QReadLocker lk(&d->lock);
+        if (!d->snapshot || d->fileTagsCache.size() < kMaxOverlayFiles)
+            return;
+    }
+
+    reloadFileTags();
 }
 
 void FileTagCache::addTags(const QVariantMap &tags)
 {
+    QWriteLocker lk(&d->lock);
     auto it = tags.begin();
     for (; it != tags.end(); ++it) {
         if (d->tagProperty.contains(it.key()))
@@ -112,28 +273,24 @@ void FileTagCache::addTags(const QVariantMap &tags)
 
 void FileTagCache::deleteTags(const QStringList &tags)
 {
-    QVariantMap map {};
+    QWriteLocker lk(&d->lock);
     for (const QString &tag : tags) {
         d->tagProperty.remove(tag);
 
-        auto iter = d->fileTagsCache.begin();
-        while (iter != d->fileTagsCache.end()) {
-            if (iter.value().toStringList().contains(tag)) {
-                QStringList fileTags = map[iter.key()].toStringList();
-                fileTags.append(tag);
-                map[iter.key()] = fileTags;
-            }
-
-            ++iter;
+        // 快照中的文件通过标签id引用标签，只需要把标签id置为无效
+        for (QString &name : d->snapshotTags) {
+            if (name == tag)
+                name.clear();
         }
-    }
 
-    if (!map.isEmpty())
-        untaggeFiles(map);
+        for (auto iter = d->fileTagsCache.begin(); iter != d->fileTagsCache.end(); ++iter)
+            iter.value().removeAll(tag);
+    }
 }
 
 void FileTagCache::changeTagColor(const QVariantMap &tagAndColorName)
 {
+    QWriteLocker lk(&d->lock);
     auto it = tagAndColorName.begin();
     for (; it != tagAndColorName.end(); ++it) {
         if (d->tagProperty.contains(it.key()))
@@ -143,6 +300,7 @@ void FileTagCache::changeTagColor(const QVariantMap &tagAndColorName)
 
 void FileTagCache::changeTagName(const QVariantMap &oldAndNew)
 {
+    QWriteLocker lk(&d->lock);
     auto it = oldAndNew.begin();
     for (; it != oldAndNew.end(); ++it) {
         const QString &oldName { it.key() };
@@ -157,52 +315,69 @@ void FileTagCache::changeTagName(const QVariantMap &oldAndNew)
 
 void FileTagCache::changeFilesTagName(const QString &oldName, const QString &newName)
 {
-    std::for_each(d->fileTagsCache.begin(), d->fileTagsCache.end(), [oldName, newName](QVariant &var) {
-        QStringList tagNames { var.toStringList() };
+    QWriteLocker lk(&d->lock);
+    for (QString &name : d->snapshotTags) {
+        if (name == oldName)
+            name = newName;
+    }
+
+    std::for_each(d->fileTagsCache.begin(), d->fileTagsCache.end(), [oldName, newName](QStringList &tagNames) {
         auto result { std::find(tagNames.begin(), tagNames.end(), oldName) };
         if (result != tagNames.end()) {
-            int index { result - tagNames.begin() };
+            int index { static_cast<int>(result - tagNames.begin()) };
             tagNames.replace(index, newName);
-            var.setValue(tagNames);
         }
     });
 }
 
 void FileTagCache::taggeFiles(const QVariantMap &fileAndTags)
 {
+    QWriteLocker lk(&d->lock);
     auto it = fileAndTags.begin();
     for (; it != fileAndTags.end(); ++it) {
-        if (!d->fileTagsCache.contains(it.key())) {
-            d->fileTagsCache.insert(it.key(), it.value().toStringList());
-        } else {
-            const auto &lst = it.value().toStringList();
-            auto cacheLst = d->fileTagsCache.value(it.key()).toStringList();
-            for (const QString &tag : lst)
-                if (!cacheLst.contains(tag))
-                    cacheLst.append(tag);
-
-            d->fileTagsCache[it.key()] = cacheLst;
-        }
+        const auto &lst = it.value().toStringList();
+        auto cacheLst = d->tagsOfFile(it.key());
+        for (const QString &tag : lst)
+            if (!cacheLst.contains(tag))
+                cacheLst.append(tag);
+
+        d->setTagsOfFile(it.key(), cacheLst);
     }
 }
 
 void FileTagCache::untaggeFiles(const QVariantMap &fileAndTags)
 {
+    QWriteLocker lk(&d->lock);
     auto it = fileAndTags.begin();
     for (; it != fileAndTags.end(); ++it) {
-        if (d->fileTagsCache.contains(it.key())) {
-            const auto &lst = it.value().toStringList();
-            auto cacheLst = d->fileTagsCache.value(it.key()).toStringList();
-            for (const QString &tag : lst)
-                if (cacheLst.contains(tag))
-                    cacheLst.removeOne(tag);
-
-            if (cacheLst.isEmpty()) {
-                d->fileTagsCache.remove(it.key());
-            } else {
-                d->fileTagsCache[it.key()] = cacheLst;
-            }
-        }
+        auto cacheLst = d->tagsOfFile(it.key());
+        if (cacheLst.isEmpty())
+            continue;
+
+        const auto &lst = it.value().toStringList();
+        for (const QString &tag : lst)
+            cacheLst.removeOne(tag);
+
+        d->setTagsOfFile(it.key(), cacheLst);
+    }
+}
+
+void FileTagCache::removeFiles(const QStringList &paths)
+{
+    QWriteLocker lk(&d->lock);
+    for (const QString &path : paths)
+        d->setTagsOfFile(path, {});
+}
+
+void FileTagCache::moveFiles(const QVariantMap &oldAndNew)
+{
+    QWriteLocker lk(&d->lock);
+    auto it = oldAndNew.begin();
+    for (; it != oldAndNew.end(); ++it) {
+        const auto &tags = d->tagsOfFile(it.key());
+        d->setTagsOfFile(it.key(), {});
+        if (!tags.isEmpty())
+            d->setTagsOfFile(it.value().toString(), tags);
     }
 }
 
@@ -221,10 +396,10 @@ QStringList FileTagCache::getTagsByFiles(const QStringList &paths) const
         return {};
 
     QReadLocker wlk(&d->lock);
-    QStringList intersectionTags = d->fileTagsCache.value(paths.first()).toStringList();
+    QStringList intersectionTags = d->tagsOfFile(paths.first());
 
     for (const QString &path : paths) {
-        QStringList tags = d->fileTagsCache.value(path).toStringList();
+        QStringList tags = d->tagsOfFile(path);
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
         intersectionTags = intersectionTags.toSet().intersect(tags.toSet()).values();
 #else
@@ -63,6 +63,13 @@ private:
     void changeFilesTagName(const QString &oldName, const QString &newName);
     void taggeFiles(const QVariantMap &fileAndTags);
     void untaggeFiles(const QVariantMap &fileAndTags);
+    void removeFiles(const QStringList &paths);
+    void moveFiles(const QVariantMap &oldAndNew);
+
+    bool syncChanges();
+    void applyChange(int type, const QVariant &data);
+    void reloadFileTags();
+    void compact();
 
 private:
     QScopedPointer<FileTagCachePrivate> d;
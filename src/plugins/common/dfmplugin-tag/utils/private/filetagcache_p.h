@@ -7,9 +7,12 @@
 
 #include "utils/filetagcache.h"
 
+#include <dfm-base/utils/filetagsnapshot.h>
+
 #include <QReadWriteLock>
 #include <QMutex>
 #include <QHash>
+#include <QSharedPointer>
 
 namespace dfmplugin_tag {
 class FileTagCachePrivate
@@ -17,13 +20,20 @@ class FileTagCachePrivate
     friend class FileTagCache;
     FileTagCache *const q;
 
-    QHash<QString, QVariant> fileTagsCache;   // file path ->  tag name list
+    // 标签服务提供的只读快照，之后的修改记录在 fileTagsCache 中
+    QSharedPointer<DFMBASE_NAMESPACE::FileTagSnapshot> snapshot;
+    QStringList snapshotTags;   // snapshot tag id -> current tag name, empty if deleted
+    QHash<QString, QStringList> fileTagsCache;   // file path -> tag name list, overrides snapshot, empty if untagged
     QHash<QString, QColor> tagProperty;   // tag name -> QColor
+    quint64 sequence { 0 };   // 已同步到的标签服务变更序号，0 表示没有可增量同步的基准
     QReadWriteLock lock;
 
 public:
     explicit FileTagCachePrivate(FileTagCache *qq);
     virtual ~FileTagCachePrivate();
+
+    QStringList tagsOfFile(const QString &path) const;
+    void setTagsOfFile(const QString &path, const QStringList &tags);
 };
 }
 
@@ -17,11 +17,20 @@
 #include <QFile>
 #include <QXmlStreamReader>
 #include <QUrl>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtConcurrent>
 
 SERVERRECENTMANAGER_BEGIN_NAMESPACE
 DFMBASE_USE_NAMESPACE
 using namespace GlobalServerDefines;
 
+static constexpr char kBookmarkBegin[] { "<bookmark " };
+static constexpr char kBookmarkEnd[] { "</bookmark>" };
+static constexpr uint kChecksumSeed { 0x9e3779b9 };
+static constexpr qint64 kFullCheckInterval { 5 * 60 * 1000 };
+static constexpr int kMinParallelCheck { 64 };
+
 RecentIterateWorker::RecentIterateWorker(QObject *parent)
     : QObject(parent)
 {
@@ -36,78 +45,166 @@ void RecentIterateWorker::onRequestReload(const QString &xbelPath, qint64 timest
     });
 
     QFile file(xbelPath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         fmWarning() << "Failed to open recent file:" << xbelPath;
         return;
     }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    // 未变化的条目不会重新检查文件，定期全部检查一次以发现被删除的文件
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const bool fullCheck = now - lastFullCheckTime > kFullCheckInterval;
+    const quint64 fileChecksum = checksum(data.constData(), data.size());
+    if (!fullCheck && fileChecksum == lastChecksum)
+        return;
 
-    QStringList curPathList;
-    const QStringList cachedPathList = itemsInfo.keys();
+    // bookmark 元素的属性值和文本中不会出现未转义的 '<'，可以直接按字节切分
+    QList<quint64> keys;
+    QHash<quint64, BookmarkEntry> entries;
+    QVector<quint64> uncheckedKeys;
+    int from = 0;
+    while (true) {
+        const int begin = data.indexOf(kBookmarkBegin, from);
+        if (begin < 0)
+            break;
+        int end = data.indexOf(kBookmarkEnd, begin);
+        if (end < 0) {
+            fmWarning() << "Error reading recent XML file: unterminated bookmark at" << begin;
+            return;
+        }
+        end += static_cast<int>(qstrlen(kBookmarkEnd));
+        from = end;
 
-    QXmlStreamReader reader(&file);
-    while (!reader.atEnd() && !reader.hasError()) {
-        if (reader.readNext() == QXmlStreamReader::EndDocument)
+        const quint64 key = checksum(data.constData() + begin, end - begin);
+        keys.append(key);
+        if (entries.contains(key))
             continue;
 
-        if (!reader.isStartElement() || reader.name() != "bookmark")
+        auto cached = bookmarkCache.constFind(key);
+        if (cached != bookmarkCache.constEnd() && !fullCheck) {
+            entries.insert(key, cached.value());
             continue;
+        }
 
-        processBookmarkElement(reader, curPathList);
+        const BookmarkEntry &entry = cached != bookmarkCache.constEnd()
+                ? cached.value()
+                : parseBookmarkElement(data.mid(begin, end - begin));
+        entries.insert(key, entry);
+        if (!entry.filePath.isEmpty())
+            uncheckedKeys.append(key);
     }
 
-    if (reader.hasError()) {
-        fmWarning() << "Error reading recent XML file:" << reader.errorString();
-        return;
+    QVector<BookmarkEntry *> unchecked;
+    unchecked.reserve(uncheckedKeys.size());
+    for (quint64 key : uncheckedKeys)
+        unchecked.append(&entries[key]);
+    checkBookmarkEntries(unchecked);
+
+    QSet<QString> curPaths;
+    curPaths.reserve(keys.size());
+    for (quint64 key : keys) {
+        const BookmarkEntry &entry = entries.value(key);
+        if (!entry.valid)
+            continue;
+        curPaths.insert(entry.bindPath);
+        updateItem(entry);
     }
+    removeOutdatedItems(curPaths);
+
+    bookmarkCache = entries;
+    lastChecksum = fileChecksum;
+    if (fullCheck)
+        lastFullCheckTime = now;
 
-    removeOutdatedItems(cachedPathList, curPathList);
+    fmDebug() << "Reload recent file:" << keys.size() << "bookmarks," << unchecked.size() << "checked";
 }
 
-void RecentIterateWorker::processBookmarkElement(QXmlStreamReader &reader, QStringList &curPathList)
+quint64 RecentIterateWorker::checksum(const char *data, int size)
 {
-    Q_ASSERT(qApp->thread() != QThread::currentThread());
+    const auto len = static_cast<size_t>(size);
+    return (static_cast<quint64>(static_cast<uint>(qHashBits(data, len, 0))) << 32)
+            | static_cast<uint>(qHashBits(data, len, kChecksumSeed));
+}
+
+RecentIterateWorker::BookmarkEntry RecentIterateWorker::parseBookmarkElement(const QByteArray &element)
+{
+    BookmarkEntry entry;
+
+    // 只读取 bookmark 元素本身的属性，子元素使用的命名空间在文件头中声明，不在这里解析
+    QXmlStreamReader reader(element);
+    while (!reader.atEnd() && !reader.isStartElement())
+        reader.readNext();
+    if (!reader.isStartElement() || reader.name() != QLatin1String("bookmark"))
+        return entry;
 
-    const QString location = reader.attributes().value("href").toString();
+    entry.location = reader.attributes().value("href").toString();
     const QString readTime = reader.attributes().value("modified").toString();
+    entry.modified = QDateTime::fromString(readTime, Qt::ISODate).toSecsSinceEpoch();
 
-    if (location.isEmpty())
-        return;
+    if (entry.location.isEmpty())
+        return entry;
 
-    const QUrl url(location);
+    const QUrl url(entry.location);
     if (!url.isLocalFile())
-        return;
+        return entry;
     if (ProtocolUtils::isRemoteFile(url))
-        return;
+        return entry;
 
-    QFileInfo info(url.toLocalFile());
-    if (!info.exists() || !info.isFile())
-        return;
+    entry.filePath = url.toLocalFile();
+    return entry;
+}
 
-    const auto bindPath = FileUtils::bindPathTransform(info.absoluteFilePath(), false);
-    qint64 readTimeSecs = QDateTime::fromString(readTime, Qt::ISODate).toSecsSinceEpoch();
+void RecentIterateWorker::checkBookmarkEntries(const QVector<BookmarkEntry *> &entries)
+{
+    Q_ASSERT(qApp->thread() != QThread::currentThread());
 
-    curPathList.append(bindPath);
-    if (itemsInfo.contains(bindPath)) {
-        if (itemsInfo[bindPath].modified != readTimeSecs) {
-            itemsInfo[bindPath].modified = readTimeSecs;
-            emit itemChanged(bindPath, itemsInfo[bindPath]);
+    auto check = [](BookmarkEntry *entry) {
+        QFileInfo info(entry->filePath);
+        entry->valid = info.exists() && info.isFile();
+        if (entry->valid)
+            entry->bindPath = info.absoluteFilePath();
+    };
+
+    // 检查文件的耗时主要在 IO 上，条目较多时并行检查
+    if (entries.size() < kMinParallelCheck)
+        std::for_each(entries.cbegin(), entries.cend(), check);
+    else
+        QtConcurrent::blockingMap(entries, check);
+
+    // 挂载信息的转换需要加锁，放在当前线程中进行
+    for (BookmarkEntry *entry : entries) {
+        if (entry->valid)
+            entry->bindPath = FileUtils::bindPathTransform(entry->bindPath, false);
+    }
+}
+
+void RecentIterateWorker::updateItem(const BookmarkEntry &entry)
+{
+    auto it = itemsInfo.find(entry.bindPath);
+    if (it != itemsInfo.end()) {
+        if (it->modified != entry.modified) {
+            it->modified = entry.modified;
+            emit itemChanged(entry.bindPath, it.value());
         }
     } else {
-        RecentItem item { location, readTimeSecs };
-        itemsInfo.insert(bindPath, item);
-        emit itemAdded(bindPath, item);
+        RecentItem item { entry.location, entry.modified };
+        itemsInfo.insert(entry.bindPath, item);
+        emit itemAdded(entry.bindPath, item);
     }
 }
 
-void RecentIterateWorker::removeOutdatedItems(const QStringList &cachedPathList, const QStringList &curPathList)
+void RecentIterateWorker::removeOutdatedItems(const QSet<QString> &curPaths)
 {
     Q_ASSERT(qApp->thread() != QThread::currentThread());
 
     QStringList removedPathList;
-    for (const auto &cachedPath : cachedPathList) {
-        if (!curPathList.contains(cachedPath)) {
-            itemsInfo.remove(cachedPath);
-            removedPathList << cachedPath;
+    for (auto it = itemsInfo.begin(); it != itemsInfo.end();) {
+        if (!curPaths.contains(it.key())) {
+            removedPathList << it.key();
+            it = itemsInfo.erase(it);
+        } else {
+            ++it;
         }
     }
 
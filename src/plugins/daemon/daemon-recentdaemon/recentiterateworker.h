@@ -10,7 +10,8 @@
 #include <DRecentManager>
 
 #include <QObject>
-#include <QXmlStreamReader>
+#include <QHash>
+#include <QSet>
 
 SERVERRECENTMANAGER_BEGIN_NAMESPACE
 
@@ -34,11 +35,28 @@ Q_SIGNALS:
     void itemChanged(const QString &path, const RecentItem &item);
 
 private:
-    void processBookmarkElement(QXmlStreamReader &reader, QStringList &curPathList);
-    void removeOutdatedItems(const QStringList &cachedPathList, const QStringList &curPathList);
+    // xbel 中一个 bookmark 元素的解析和文件检查结果
+    struct BookmarkEntry
+    {
+        QString location;
+        QString filePath;
+        QString bindPath;
+        qint64 modified { 0 };
+        bool valid { false };
+    };
+
+    static quint64 checksum(const char *data, int size);
+    static BookmarkEntry parseBookmarkElement(const QByteArray &element);
+    void checkBookmarkEntries(const QVector<BookmarkEntry *> &entries);
+    void updateItem(const BookmarkEntry &entry);
+    void removeOutdatedItems(const QSet<QString> &curPaths);
 
 private:
     QMap<QString, RecentItem> itemsInfo;
+    // 以元素内容的校验值为键，内容未变化的元素不再解析和检查文件
+    QHash<quint64, BookmarkEntry> bookmarkCache;
+    quint64 lastChecksum { 0 };
+    qint64 lastFullCheckTime { 0 };
 };
 
 SERVERRECENTMANAGER_END_NAMESPACE
@@ -143,6 +143,11 @@ void DeviceManagerDBus::DetachAllMountedDevices()
     DevMngIns->detachAllProtoDevs();
 }
 
+void DeviceManagerDBus::RequestUsageUpdate(QStringList ids)
+{
+    DevMngIns->requestDeviceUsageUpdate(ids);
+}
+
 /*!
  * \brief user input a opts, then return devices list
  * \param opts: refrecne to DeviceService::blockDevicesIdList
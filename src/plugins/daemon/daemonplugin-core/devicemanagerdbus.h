@@ -45,6 +45,7 @@ public slots:
     void DetachBlockDevice(QString id);
     void DetachProtocolDevice(QString id);
     void DetachAllMountedDevices();
+    void RequestUsageUpdate(QStringList ids);
 
     QStringList GetBlockDevicesIdList(int opts);
     QVariantMap QueryBlockDeviceInfo(QString id, bool reload);
@@ -12,6 +12,7 @@
 #include <dfm-base/utils/finallyutil.h>
 #include <dfm-base/base/db/sqlitehandle.h>
 #include <dfm-base/base/db/sqlitehelper.h>
+#include <dfm-base/utils/filetagsnapshot.h>
 
 #include <dfm-io/dfmio_utils.h>
 
@@ -20,12 +21,35 @@
 #include <QDebug>
 #include <QProcess>
 #include <QVariant>
+#include <QDataStream>
+#include <QDateTime>
+
+#include <unistd.h>
 
 DFMBASE_USE_NAMESPACE
 DAEMONPTAG_BEGIN_NAMESPACE
 
 static constexpr char kTagTableFileTags[] = "file_tags";
 static constexpr char kTagTableTagProperty[] = "tag_property";
+// 保留的变更记录数，客户端落后更多时需要重新加载快照
+static constexpr int kMaxChangeLog = 4096;
+// 单条语句绑定的参数个数上限，低版本 sqlite 的 SQLITE_MAX_VARIABLE_NUMBER 为 999
+static constexpr int kMaxBindCount = 500;
+
+// 将 list 按照 kMaxBindCount 分段调用 func，用于拼接 IN (...) 查询
+static bool forEachChunk(const QStringList &list, std::function<bool(const QVariantList &)> func)
+{
+    for (int i = 0; i < list.size(); i += kMaxBindCount) {
+        QVariantList values;
+        const int end = qMin(i + kMaxBindCount, list.size());
+        values.reserve(end - i);
+        for (int j = i; j < end; ++j)
+            values.append(list.at(j));
+        if (!func(values))
+            return false;
+    }
+    return true;
+}
 
 TagDbHandler *TagDbHandler::instance()
 {
@@ -60,13 +84,22 @@ QVariantMap TagDbHandler::getTagsColor(const QStringList &tags)
     }
 
     // query
-    const auto &field = Expression::Field<TagProperty>;
+    const QString &sql { "SELECT tagName, tagColor FROM " + SqliteHelper::tableName<TagProperty>() + " WHERE tagName IN (" };
     QVariantMap tagColorsMap;
-    for (auto &tag : tags) {
-        const auto &beanList = handle->query<TagProperty>().where(field("tagName") == tag).toBeans();
-        const auto &color = beanList.isEmpty() ? "" : beanList.first()->getTagColor();
-        if (!color.isEmpty())
-            tagColorsMap.insert(tag, QVariant { QVariant { color } });
+    bool ret = forEachChunk(tags, [&](const QVariantList &values) {
+        return handle->excutePrepared(sql + SqliteHelper::placeholders(values.size()) + ") ORDER BY tagIndex DESC;", values,
+                                      [&tagColorsMap](QSqlQuery *query) {
+                                          // 同名的标签取第一条记录，倒序遍历时后插入的值会被先插入的覆盖
+                                          while (query->next()) {
+                                              const QString &color { query->value(1).toString() };
+                                              if (!color.isEmpty())
+                                                  tagColorsMap.insert(query->value(0).toString(), QVariant { color });
+                                          }
+                                      });
+    });
+    if (!ret) {
+        lastErr = "query color of tags failed!";
+        return {};
     }
 
     finally.dismiss();
@@ -81,20 +114,25 @@ QVariantMap TagDbHandler::getTagsByUrls(const QStringList &urlList)
         return {};
     }
 
-    // query
-    const auto &field = Expression::Field<FileTagInfo>;
-    QVariantMap allFileTags;
-    for (auto &path : urlList) {
-        const auto &beanList = handle->query<FileTagInfo>().where(field("filePath") == path).toBeans();
-
-        QStringList fileTags;
-        for (auto oneBean : beanList)
-            fileTags.append(oneBean->getTagName());
-
-        if (!fileTags.isEmpty())
-            allFileTags.insert(path, fileTags);
+    // query, 每 kMaxBindCount 个文件一条 IN 查询
+    const QString &sql { "SELECT filePath, tagName FROM " + SqliteHelper::tableName<FileTagInfo>() + " WHERE filePath IN (" };
+    QHash<QString, QStringList> fileTags;
+    bool ret = forEachChunk(urlList, [&](const QVariantList &values) {
+        return handle->excutePrepared(sql + SqliteHelper::placeholders(values.size()) + ") ORDER BY fileIndex;", values,
+                                      [&fileTags](QSqlQuery *query) {
+                                          while (query->next())
+                                              fileTags[query->value(0).toString()].append(query->value(1).toString());
+                                      });
+    });
+    if (!ret) {
+        lastErr = "query tags of files failed!";
+        return {};
     }
 
+    QVariantMap allFileTags;
+    for (auto it = fileTags.cbegin(); it != fileTags.cend(); ++it)
+        allFileTags.insert(it.key(), it.value());
+
     finally.dismiss();
     return allFileTags;
 }
@@ -108,23 +146,33 @@ QVariant TagDbHandler::getSameTagsOfDiffUrls(const QStringList &urlList)
         return {};
     }
 
-    QMap<QString, int> tagCount;
+    // 任意一个文件没有标签时交集为空
     const auto &allTags = getTagsByUrls(urlList);
-    auto it = allTags.begin();
-    for (; it != allTags.end(); ++it) {
-        const auto tempTags = it.value().toStringList();
-        for (const auto &tagName : tempTags)
-            ++tagCount[tagName];
-    }
+    QSet<QString> sameTagSet;
+    for (int i = 0; i < urlList.size(); ++i) {
+        if (!allTags.contains(urlList.at(i))) {
+            sameTagSet.clear();
+            break;
+        }
+
+        const QStringList &tags { allTags.value(urlList.at(i)).toStringList() };
+#if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+        const QSet<QString> &tagSet { tags.toSet() };
+#else
+        const QSet<QString> tagSet { tags.begin(), tags.end() };
+#endif
+        if (i == 0)
+            sameTagSet = tagSet;
+        else
+            sameTagSet.intersect(tagSet);
 
-    int size { urlList.size() };
-    QStringList sameTags;
-    QMap<QString, int>::const_iterator ct = tagCount.begin();
-    for (; ct != tagCount.end(); ++ct) {
-        if (ct.value() == size)
-            sameTags.append(ct.key());
+        if (sameTagSet.isEmpty())
+            break;
     }
 
+    QStringList sameTags { sameTagSet.values() };
+    std::sort(sameTags.begin(), sameTags.end());
+
     finally.dismiss();
     return sameTags;
 }
@@ -139,17 +187,24 @@ QVariantMap TagDbHandler::getFilesByTag(const QStringList &tags)
     }
 
     // query
-    const auto &field = Expression::Field<FileTagInfo>;
-    QVariantMap allTagFiles;
-    for (auto &tag : tags) {
-        const auto &obj = handle->query<FileTagInfo>().where(field("tagName") == tag).toBeans();
-        QStringList files;
-        for (auto tempBean : obj)
-            files.append(tempBean->getFilePath());
-
-        allTagFiles.insert(tag, QVariant { files });
+    const QString &sql { "SELECT tagName, filePath FROM " + SqliteHelper::tableName<FileTagInfo>() + " WHERE tagName IN (" };
+    QHash<QString, QStringList> tagFiles;
+    bool ret = forEachChunk(tags, [&](const QVariantList &values) {
+        return handle->excutePrepared(sql + SqliteHelper::placeholders(values.size()) + ") ORDER BY fileIndex;", values,
+                                      [&tagFiles](QSqlQuery *query) {
+                                          while (query->next())
+                                              tagFiles[query->value(0).toString()].append(query->value(1).toString());
+                                      });
+    });
+    if (!ret) {
+        lastErr = "query files of tags failed!";
+        return {};
     }
 
+    QVariantMap allTagFiles;
+    for (auto &tag : tags)
+        allTagFiles.insert(tag, QVariant { tagFiles.value(tag) });
+
     finally.dismiss();
     return allTagFiles;
 }
@@ -198,6 +253,7 @@ bool TagDbHandler::addTagProperty(const QVariantMap &data)
         }
     }
 
+    recordChange(ChangeOpts::kTagsAdded, data);
     emit newTagsAdded(data);
     finally.dismiss();
     return true;
@@ -235,15 +291,12 @@ bool TagDbHandler::addTagsForFiles(const QVariantMap &data)
     }
 
     // insert file--tags
-    bool ret = handle->transaction([tmpData, this]() -> bool {
-        for (auto dataIt = tmpData.begin(); dataIt != tmpData.end(); ++dataIt) {
-            bool ret = tagFile(dataIt.key(), dataIt.value());
-            if (!ret)
-                return ret;
-        }
-        return true;
+    bool ret = handle->transaction([&tmpData, this]() -> bool {
+        return tagFiles(tmpData);
     });
 
+    if (ret)
+        recordChange(ChangeOpts::kFilesTagged, data);
     emit filesWereTagged(data);
     finally.dismiss();
     return ret;
@@ -260,13 +313,12 @@ bool TagDbHandler::removeTagsOfFiles(const QVariantMap &data)
 
     // remove file--tags
 
-    bool ret = handle->transaction([data, this]() -> bool {
-        for (auto it = data.begin(); it != data.end(); ++it)
-            if (!removeSpecifiedTagOfFile(it.key(), it.value()))
-                return false;
-        return true;
+    bool ret = handle->transaction([&data, this]() -> bool {
+        return removeSpecifiedTagsOfFiles(data);
     });
 
+    if (ret)
+        recordChange(ChangeOpts::kFilesUntagged, data);
     emit filesUntagged(data);
     finally.dismiss();
     return ret;
@@ -281,19 +333,17 @@ bool TagDbHandler::deleteTags(const QStringList &tags)
         return false;
     }
 
-    const auto &fieldOne = Expression::Field<TagProperty>;
-    const auto &fieldTwo = Expression::Field<FileTagInfo>;
-
-    bool ret = true;
-    for (const auto &tag : tags) {
-        ret = handle->remove<TagProperty>(fieldOne("tagName") == tag);
-        if (!ret)
-            return ret;
-        ret = handle->remove<FileTagInfo>(fieldTwo("tagName") == tag);
-        if (!ret)
-            return ret;
+    const QList<QVariantList> columns { QVariantList(tags.begin(), tags.end()) };
+    bool ret = handle->transaction([&columns, this]() -> bool {
+        return handle->excuteBatch("DELETE FROM " + SqliteHelper::tableName<TagProperty>() + " WHERE tagName = ?;", columns)
+                && handle->excuteBatch("DELETE FROM " + SqliteHelper::tableName<FileTagInfo>() + " WHERE tagName = ?;", columns);
+    });
+    if (!ret) {
+        lastErr = "delete tags failed!";
+        return ret;
     }
 
+    recordChange(ChangeOpts::kTagsDeleted, tags);
     emit tagsDeleted(tags);
     finally.dismiss();
     return ret;
@@ -308,12 +358,17 @@ bool TagDbHandler::deleteFiles(const QStringList &urls)
         return false;
     }
 
-    auto field = Expression::Field<FileTagInfo>;
-    for (const auto &url : urls) {
-        if (!handle->remove<FileTagInfo>(field("filePath") == url))
-            return false;
+    const QList<QVariantList> columns { QVariantList(urls.begin(), urls.end()) };
+    bool ret = handle->transaction([&columns, this]() -> bool {
+        return handle->excuteBatch("DELETE FROM " + SqliteHelper::tableName<FileTagInfo>() + " WHERE filePath = ?;", columns);
+    });
+    if (!ret) {
+        lastErr = "delete files failed!";
+        return false;
     }
 
+    recordChange(ChangeOpts::kFilesDeleted, urls);
+
     finally.dismiss();
     return true;
 }
@@ -335,6 +390,7 @@ bool TagDbHandler::changeTagColors(const QVariantMap &data)
             return ret;
     }
 
+    recordChange(ChangeOpts::kTagsColorChanged, data);
     emit tagsColorChanged(data);
 
     finally.dismiss();
@@ -360,8 +416,10 @@ bool TagDbHandler::changeTagNamesWithFiles(const QVariantMap &data)
             ret = false;
     }
 
-    if (!updatedData.isEmpty())
+    if (!updatedData.isEmpty()) {
+        recordChange(ChangeOpts::kTagsNameChanged, updatedData);
         emit tagsNameChanged(updatedData);
+    }
 
     if (ret)
         finally.dismiss();
@@ -379,10 +437,17 @@ bool TagDbHandler::changeFilePaths(const QVariantMap &data)
     }
 
     auto it = data.begin();
-    for (; it != data.end(); ++it)
-        if (!changeFilePath(it.key(), it.value().toString()))
+    QVariantMap changedPaths;
+    for (; it != data.end(); ++it) {
+        if (!changeFilePath(it.key(), it.value().toString())) {
+            if (!changedPaths.isEmpty())
+                recordChange(ChangeOpts::kFilePathsChanged, changedPaths);
             return false;
+        }
+        changedPaths.insert(it.key(), it.value());
+    }
 
+    recordChange(ChangeOpts::kFilePathsChanged, changedPaths);
     finally.dismiss();
     return true;
 }
@@ -392,9 +457,88 @@ QString TagDbHandler::lastError() const
     return lastErr;
 }
 
+quint64 TagDbHandler::changeSequence() const
+{
+    return sequence;
+}
+
+/*!
+ * \brief 序列化 since 之后的所有变更
+ * 数据格式：quint64 当前序号, bool 是否需要重新加载快照, qint32 变更数量, 之后每个变更为 (quint64 序号, qint32 类型, QVariant 数据)
+ * since 早于记录的最早变更或者来自上一次启动的服务时，客户端需要重新加载快照
+ */
+QByteArray TagDbHandler::changesSince(quint64 since) const
+{
+    bool reset { since > sequence };
+    if (!changeLog.isEmpty() && since + 1 < changeLog.first().sequence)
+        reset = true;
+    if (changeLog.isEmpty() && since != sequence)
+        reset = true;
+
+    QList<const Change *> changes;
+    if (!reset) {
+        for (const auto &change : changeLog) {
+            if (change.sequence > since)
+                changes.append(&change);
+        }
+    }
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << sequence << reset << qint32(changes.size());
+    for (const auto *change : changes)
+        stream << change->sequence << qint32(change->type) << change->data;
+    return data;
+}
+
+/*!
+ * \brief 获取当前数据的快照，数据没有变化时复用上一次生成的快照
+ * \return memfd 文件描述符，仍由 TagDbHandler 持有，失败时返回 -1
+ */
+int TagDbHandler::snapshotFd()
+{
+    if (snapshotFileDescriptor >= 0 && snapshotSequence == sequence)
+        return snapshotFileDescriptor;
+
+    QHash<QString, QStringList> fileTags;
+    const QString &sql { "SELECT filePath, tagName FROM " + SqliteHelper::tableName<FileTagInfo>() + " ORDER BY fileIndex;" };
+    bool ret = handle->excutePrepared(sql, {}, [&fileTags](QSqlQuery *query) {
+        while (query->next()) {
+            QStringList &tags { fileTags[query->value(0).toString()] };
+            const QString &tag { query->value(1).toString() };
+            if (!tags.contains(tag))
+                tags.append(tag);
+        }
+    });
+    if (!ret) {
+        fmWarning() << "Query file tags for snapshot failed";
+        return -1;
+    }
+
+    int fd = FileTagSnapshot::createSealedFd(FileTagSnapshot::build(sequence, fileTags));
+    if (fd < 0)
+        return -1;
+
+    if (snapshotFileDescriptor >= 0)
+        ::close(snapshotFileDescriptor);
+    snapshotFileDescriptor = fd;
+    snapshotSequence = sequence;
+    fmInfo() << "Tag snapshot created, files:" << fileTags.size() << "sequence:" << sequence;
+    return snapshotFileDescriptor;
+}
+
+void TagDbHandler::recordChange(ChangeOpts type, const QVariant &data)
+{
+    changeLog.append({ ++sequence, type, data });
+    while (changeLog.size() > kMaxChangeLog)
+        changeLog.removeFirst();
+}
+
 TagDbHandler::TagDbHandler(QObject *parent)
     : QObject(parent)
 {
+    // 以启动时间作为序号起点，客户端持有的旧序号在服务重启后会被识别出来
+    sequence = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) << 16;
     initialize();
 }
 
@@ -425,6 +569,12 @@ void TagDbHandler::initialize()
 
     if (!createTable(kTagTableTagProperty))
         fmWarning() << "Create table failed:" << kTagTableFileTags;
+
+    // 按文件和标签查询时使用的索引
+    if (!handle->createIndex<FileTagInfo>("idx_file_tags_filePath", { "filePath" })
+        || !handle->createIndex<FileTagInfo>("idx_file_tags_tagName", { "tagName" })
+        || !handle->createIndex<TagProperty>("idx_tag_property_tagName", { "tagName" }))
+        fmWarning() << "Create index failed:" << handle->lastQuery();
 }
 
 bool TagDbHandler::createTable(const QString &tableName)
@@ -479,31 +629,38 @@ bool TagDbHandler::insertTagProperty(const QString &name, const QVariant &value)
     return true;
 }
 
-bool TagDbHandler::tagFile(const QString &file, const QVariant &tags)
+bool TagDbHandler::tagFiles(const QVariantMap &fileTags)
 {
     DFMBASE_NAMESPACE::FinallyUtil finally([&]() { lastErr.clear(); });
 
-    if (file.isEmpty() || tags.isNull()) {
-        lastErr = "input parameter is empty!";
-        return false;
+    // 按列组织绑定值，一条预编译语句批量插入
+    QVariantList paths;
+    QVariantList tagNames;
+    for (auto it = fileTags.begin(); it != fileTags.end(); ++it) {
+        if (it.key().isEmpty() || it.value().isNull()) {
+            lastErr = "input parameter is empty!";
+            return false;
+        }
+
+        const QStringList &tags { it.value().toStringList() };
+        for (const auto &tag : tags) {
+            paths.append(it.key());
+            tagNames.append(tag);
+        }
     }
 
-    // insert file--tags
-    const QStringList &tempTags = tags.toStringList();
-    int suc = tempTags.count();
-    for (const auto &tag : tempTags) {
-        FileTagInfo temp;
-        temp.setFilePath(file);
-        temp.setTagName(tag);
-        temp.setTagOrder(0);
-        temp.setFuture("null");
-        if (-1 == handle->insert<FileTagInfo>(temp))
-            break;
-        suc--;
+    if (paths.isEmpty()) {
+        finally.dismiss();
+        return true;
     }
 
-    if (0 < suc) {
-        lastErr = QString("Tag file failed! file: %1, tagName: %2").arg(file).arg(tempTags.at(--suc));
+    const QString &sql { "INSERT INTO " + SqliteHelper::tableName<FileTagInfo>()
+                         + "(filePath,tagName,tagOrder,future) VALUES (?,?,?,?);" };
+    const QList<QVariantList> columns { paths, tagNames,
+                                        QVector<QVariant>(paths.size(), 0).toList(),
+                                        QVector<QVariant>(paths.size(), QString("null")).toList() };
+    if (!handle->excuteBatch(sql, columns)) {
+        lastErr = QString("Tag files failed! count: %1").arg(paths.size());
         return false;
     }
 
@@ -511,26 +668,28 @@ bool TagDbHandler::tagFile(const QString &file, const QVariant &tags)
     return true;
 }
 
-bool TagDbHandler::removeSpecifiedTagOfFile(const QString &url, const QVariant &val)
+bool TagDbHandler::removeSpecifiedTagsOfFiles(const QVariantMap &fileTags)
 {
     DFMBASE_NAMESPACE::FinallyUtil finally([&]() { lastErr.clear(); });
 
-    if (url.isEmpty() || val.isNull()) {
-        lastErr = "input parameter is empty!";
-        return false;
-    }
+    QVariantList paths;
+    QVariantList tagNames;
+    for (auto it = fileTags.begin(); it != fileTags.end(); ++it) {
+        if (it.key().isEmpty() || it.value().isNull()) {
+            lastErr = "input parameter is empty!";
+            return false;
+        }
 
-    auto field = Expression::Field<FileTagInfo>;
-    const auto tempTags = val.toStringList();
-    int suc = tempTags.count();
-    for (const auto &tag : tempTags) {
-        if (!handle->remove<FileTagInfo>((field("filePath") == url) && (field("tagName") == tag)))
-            break;
-        suc--;
+        const QStringList &tags { it.value().toStringList() };
+        for (const auto &tag : tags) {
+            paths.append(it.key());
+            tagNames.append(tag);
+        }
     }
 
-    if (0 < suc) {
-        lastErr = QString("Remove specified tag Of File failed! file: %1, tagName: %2").arg(url).arg(tempTags.at(--suc));
+    const QString &sql { "DELETE FROM " + SqliteHelper::tableName<FileTagInfo>() + " WHERE filePath = ? AND tagName = ?;" };
+    if (!handle->excuteBatch(sql, { paths, tagNames })) {
+        lastErr = QString("Remove specified tags of files failed! count: %1").arg(paths.size());
         return false;
     }
 
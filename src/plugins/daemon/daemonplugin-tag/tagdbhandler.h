@@ -10,6 +10,7 @@
 #include <dfm-base/base/db/sqlitehandle.h>
 
 #include <QObject>
+#include <QVariant>
 
 DAEMONPTAG_BEGIN_NAMESPACE
 
@@ -57,17 +58,22 @@ public:
 
     QString lastError() const;
 
+    quint64 changeSequence() const;
+    QByteArray changesSince(quint64 since) const;
+    int snapshotFd();
+
 private:
     explicit TagDbHandler(QObject *parent = nullptr);
     void initialize();
     bool createTable(const QString &tableName);
     bool checkTag(const QString &tag);
     bool insertTagProperty(const QString &name, const QVariant &value);
-    bool tagFile(const QString &file, const QVariant &tags);
-    bool removeSpecifiedTagOfFile(const QString &url, const QVariant &val);
+    bool tagFiles(const QVariantMap &fileTags);
+    bool removeSpecifiedTagsOfFiles(const QVariantMap &fileTags);
     bool changeTagColor(const QString &tagName, const QString &newTagColor);
     bool changeTagNameWithFile(const QString &tagName, const QString &newName);
     bool changeFilePath(const QString &oldPath, const QString &newPath);
+    void recordChange(ChangeOpts type, const QVariant &data);
 
 Q_SIGNALS:
     void newTagsAdded(const QVariantMap &newTags);
@@ -80,6 +86,18 @@ Q_SIGNALS:
 private:
     QScopedPointer<DFMBASE_NAMESPACE::SqliteHandle> handle;
     QString lastErr;
+
+    // 变更序号和最近的变更记录，客户端据此增量同步
+    struct Change
+    {
+        quint64 sequence;
+        ChangeOpts type;
+        QVariant data;
+    };
+    quint64 sequence { 0 };
+    QList<Change> changeLog;
+    int snapshotFileDescriptor { -1 };
+    quint64 snapshotSequence { 0 };
 };
 
 DAEMONPTAG_END_NAMESPACE
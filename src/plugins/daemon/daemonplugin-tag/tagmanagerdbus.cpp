@@ -98,3 +98,20 @@ bool TagManagerDBus::Update(int opt, const QVariantMap value)
 
     return false;
 }
+
+/*!
+ * \brief 获取所有文件标记的只读快照，数据放在密封的 memfd 中，客户端直接 mmap 使用
+ */
+QDBusUnixFileDescriptor TagManagerDBus::Snapshot()
+{
+    // QDBusUnixFileDescriptor 会复制 fd，快照的 fd 仍由 TagDbHandler 持有
+    return QDBusUnixFileDescriptor(TagDbHandler::instance()->snapshotFd());
+}
+
+/*!
+ * \brief 获取序号 since 之后的变更，格式见 TagDbHandler::changesSince
+ */
+QByteArray TagManagerDBus::Changes(qulonglong since)
+{
+    return TagDbHandler::instance()->changesSince(since);
+}
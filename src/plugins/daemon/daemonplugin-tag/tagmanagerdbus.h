@@ -9,6 +9,7 @@
 #include <QVariantMap>
 #include <QDBusVariant>
 #include <QDBusMessage>
+#include <QDBusUnixFileDescriptor>
 
 class TagManagerDBus : public QObject
 {
@@ -23,6 +24,8 @@ public Q_SLOTS:
     bool Insert(int opt, const QVariantMap value);
     bool Delete(int opt, const QVariantMap value);
     bool Update(int opt, const QVariantMap value);
+    QDBusUnixFileDescriptor Snapshot();
+    QByteArray Changes(qulonglong since);
 
 Q_SIGNALS:
     void TagsServiceReady();
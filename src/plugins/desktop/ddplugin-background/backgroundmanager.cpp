@@ -15,8 +15,14 @@
 #include <dfm-base/dfm_desktop_defines.h>
 #include <dfm-base/utils/universalutils.h>
 
+#include <QGuiApplication>
 #include <QImageReader>
 #include <QtConcurrent>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QDir>
 
 DFMBASE_USE_NAMESPACE
 DDP_BACKGROUND_USE_NAMESPACE
@@ -27,6 +33,9 @@ DDP_BACKGROUND_USE_NAMESPACE
 #define CanvasCoreUnsubscribe(topic, func) \
     dpfSignalDispatcher->unsubscribe("ddplugin_core", QT_STRINGIFY2(topic), this, func);
 
+// keep the scaled wallpapers of the last few configurations
+static constexpr int kMaxCacheFiles { 16 };
+
 inline QString getScreenName(QWidget *win)
 {
     Q_ASSERT(win);
@@ -316,6 +325,7 @@ void BackgroundBridge::request(bool refresh)
 
         // use the resolution before screen zooming
         req.size = root->property(DesktopFrameProperty::kPropScreenHandleGeometry).toRect().size();
+        req.ratio = root->devicePixelRatioF();
 
         if (!refresh)
             req.path = d->backgroundPaths.value(req.screen);
@@ -344,6 +354,7 @@ void BackgroundBridge::forceRequest()
 
         // use the resolution before screen zooming
         req.size = sc->handleGeometry().size();
+        req.ratio = qGuiApp->devicePixelRatio();
         requestion.append(req);
     }
 
@@ -417,10 +428,101 @@ void BackgroundBridge::onFinished(void *pData)
     dpfSignalDispatcher->publish("ddplugin_background", "signal_Background_BackgroundSetted");
 }
 
+QImage BackgroundBridge::getImage(const QString &path, const QSize &size, bool *scaled)
+{
+    if (path.isEmpty() || size.isEmpty())
+        return QImage();
+
+    QString currentWallpaper = path.startsWith("file:") ? QUrl(path).toLocalFile() : path;
+    QImage image = readScaledImage(currentWallpaper, size, scaled);
+    if (image.isNull())
+        return image;
+
+    // crop the center area that fills the screen.
+    if (image.width() > size.width() || image.height() > size.height()) {
+        image = image.copy(QRect(static_cast<int>((image.width() - size.width()) / 2.0),
+                                 static_cast<int>((image.height() - size.height()) / 2.0),
+                                 size.width(),
+                                 size.height()));
+    }
+
+    return image;
+}
+
+QImage BackgroundBridge::readScaledImage(const QString &localPath, const QSize &size, bool *scaled)
+{
+    QImageReader reader(localPath);
+    // fix whiteboard shows when a jpeg file with filename xxx.png
+    // content formart not epual to extension
+    reader.setDecideFormatFromContent(true);
+
+    const QSize imageSize = reader.size();
+    const QSize expanded = imageSize.isValid()
+            ? imageSize.scaled(size, Qt::KeepAspectRatioByExpanding)
+            : QSize();
+    if (scaled)
+        *scaled = imageSize != expanded;
+
+    // let the image handler decode to the target size directly,
+    // jpeg is downscaled while decoding and never holds the full resolution image.
+    if (expanded.isValid() && expanded.width() < imageSize.width())
+        reader.setScaledSize(expanded);
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        fmWarning() << "can not read wallpaper" << localPath << reader.errorString();
+        return image;
+    }
+
+    if (image.size() != expanded) {
+        image = image.scaled(size, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        if (scaled)
+            *scaled = true;
+    }
+
+    return image;
+}
+
+QString BackgroundBridge::cacheFile(const QString &localPath, const QSize &size, qreal ratio)
+{
+    QFileInfo info(localPath);
+    if (!info.isFile())
+        return QString();
+
+    const QString key = QString("%0:%1:%2x%3@%4").arg(info.absoluteFilePath())
+                                .arg(info.lastModified().toMSecsSinceEpoch())
+                                .arg(size.width())
+                                .arg(size.height())
+                                .arg(ratio);
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/wallpaper";
+    return dir + "/" + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex() + ".png";
+}
+
+void BackgroundBridge::saveCache(const QString &file, const QImage &image)
+{
+    QDir dir = QFileInfo(file).absoluteDir();
+    if (!dir.mkpath("."))
+        return;
+
+    // write to a temporary file so that a reader never gets a partial image.
+    QSaveFile saver(file);
+    if (!saver.open(QIODevice::WriteOnly) || !image.save(&saver, "png") || !saver.commit()) {
+        fmWarning() << "failed to save wallpaper cache" << file;
+        return;
+    }
+
+    const QFileInfoList caches = dir.entryInfoList({ "*.png" }, QDir::Files, QDir::Time);
+    for (int i = kMaxCacheFiles; i < caches.size(); ++i)
+        QFile::remove(caches.at(i).absoluteFilePath());
+}
+
 void BackgroundBridge::runUpdate(BackgroundBridge *self, QList<Requestion> reqs)
 {
     fmInfo() << "getting background in work thread...." << QThread::currentThreadId();
     QList<Requestion> recorder;
+    // screens with the same wallpaper and geometry share one pixmap.
+    QHash<QString, QPixmap> shared;
+    QList<QPair<QString, QImage>> pendingCaches;
     for (Requestion &req : reqs) {
         // check stop
         if (!self->getting)
@@ -429,35 +531,48 @@ void BackgroundBridge::runUpdate(BackgroundBridge *self, QList<Requestion> reqs)
         if (req.path.isEmpty())
             req.path = self->d->service->background(req.screen);
 
-        QPixmap backgroundPixmap = BackgroundBridge::getPixmap(req.path);
-        if (backgroundPixmap.isNull()) {
-            fmCritical() << "screen " << req.screen << "backfround path" << req.path
-                         << "can not read!";
+        const QString localPath = req.path.startsWith("file:") ? QUrl(req.path).toLocalFile() : req.path;
+        const QString cache = cacheFile(localPath, req.size, req.ratio);
+        const QString sharedKey = cache.isEmpty()
+                ? QString("%0:%1x%2@%3").arg(req.path).arg(req.size.width()).arg(req.size.height()).arg(req.ratio)
+                : cache;
+        if (shared.contains(sharedKey)) {
+            req.pixmap = shared.value(sharedKey);
+            recorder.append(req);
             continue;
         }
 
-        // check stop
-        if (!self->getting)
-            return;
+        QImage image;
+        if (!cache.isEmpty() && QFile::exists(cache)) {
+            image = QImage(cache);
+            if (image.size() != req.size) {
+                QFile::remove(cache);
+                image = QImage();
+            }
+        }
+
+        if (image.isNull()) {
+            bool scaled = false;
+            image = BackgroundBridge::getImage(req.path, req.size, &scaled);
+            if (image.isNull()) {
+                fmCritical() << "screen " << req.screen << "backfround path" << req.path
+                             << "can not read!";
+                continue;
+            }
 
-        QSize trueSize = req.size;
-        auto pix = backgroundPixmap.scaled(trueSize,
-                                           Qt::KeepAspectRatioByExpanding,
-                                           Qt::SmoothTransformation);
+            // only cache the images that are expensive to produce.
+            if (scaled && !cache.isEmpty())
+                pendingCaches.append(qMakePair(cache, image));
+        }
 
         // check stop
         if (!self->getting)
             return;
 
-        if (pix.width() > trueSize.width() || pix.height() > trueSize.height()) {
-            pix = pix.copy(QRect(static_cast<int>((pix.width() - trueSize.width()) / 2.0),
-                                 static_cast<int>((pix.height() - trueSize.height()) / 2.0),
-                                 trueSize.width(),
-                                 trueSize.height()));
-        }
-
-        fmDebug() << req.screen << "background path" << req.path << "truesize" << trueSize;
-        req.pixmap = pix;
+        fmDebug() << req.screen << "background path" << req.path << "truesize" << req.size;
+        req.pixmap = QPixmap::fromImage(image);
+        req.pixmap.setDevicePixelRatio(req.ratio);
+        shared.insert(sharedKey, req.pixmap);
         recorder.append(req);
     }
 
@@ -469,4 +584,8 @@ void BackgroundBridge::runUpdate(BackgroundBridge *self, QList<Requestion> reqs)
     *pRecorder = std::move(recorder);
     QMetaObject::invokeMethod(self, "onFinished", Qt::QueuedConnection, Q_ARG(void *, pRecorder));
     self->getting = false;
+
+    // the wallpapers are shown, save the scaled images for the next time.
+    for (const auto &pending : pendingCaches)
+        saveCache(pending.first, pending.second);
 }
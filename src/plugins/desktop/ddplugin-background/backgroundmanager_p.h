@@ -21,6 +21,7 @@ public:
         QString screen;
         QString path;
         QSize size;
+        qreal ratio = 1.0;
         QPixmap pixmap;
     };
 
@@ -46,9 +47,13 @@ public:
     void terminate(bool wait);
     Q_INVOKABLE void onFinished(void *pData);
     static QPixmap getPixmap(const QString &path, const QPixmap &defalutPixmap = QPixmap());
+    static QImage getImage(const QString &path, const QSize &size, bool *scaled = nullptr);
 
 private:
     static void runUpdate(BackgroundBridge *self, QList<Requestion> reqs);
+    static QImage readScaledImage(const QString &localPath, const QSize &size, bool *scaled);
+    static QString cacheFile(const QString &localPath, const QSize &size, qreal ratio);
+    static void saveCache(const QString &file, const QImage &image);
 
 private:
     class BackgroundManagerPrivate *d = nullptr;
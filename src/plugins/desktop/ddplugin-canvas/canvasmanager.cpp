@@ -544,13 +544,15 @@ void CanvasManagerPrivate::onFileInserted(const QModelIndex &parent, int first,
         return false;
     };
 
-    auto fileInsertToGrid = [this](const QUrl &url) {
+    // the files to append are collected and appended to grid together.
+    QStringList toAppend;
+    auto fileInsertToGrid = [&toAppend](const QUrl &url) {
         const QString path = url.toString();
         QPair<int, QPoint> pos;
 
         // file is not existed, append it.
         if (!GridIns->point(path, pos))
-            GridIns->append(path);
+            toAppend.append(path);
     };
 
     for (int i = first; i <= last; i++) {
@@ -570,6 +572,9 @@ void CanvasManagerPrivate::onFileInserted(const QModelIndex &parent, int first,
         fileInsertToGrid(url);
     }
 
+    if (!toAppend.isEmpty())
+        GridIns->append(toAppend);
+
     q->update();
 }
 
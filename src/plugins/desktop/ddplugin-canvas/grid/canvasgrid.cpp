@@ -7,6 +7,7 @@
 
 #include <QApplication>
 #include <QUrl>
+#include <QSet>
 #include <QDebug>
 
 using namespace ddplugin_canvas;
@@ -380,6 +381,12 @@ void CanvasGridPrivate::restore(QStringList currentItems)
     // the item's pos in record is invalid to current grid.
     QStringList invalidPos;
 
+    // items not yet restored, checked by hash instead of searching in \a currentItems.
+    QSet<QString> remaining;
+    remaining.reserve(currentItems.size());
+    for (const QString &item : currentItems)
+        remaining.insert(item);
+
     // restore each surface.
     for (int idx : idxs) {
         const QHash<QString, QPoint> &oldPos = profile.value(idx);
@@ -393,7 +400,7 @@ void CanvasGridPrivate::restore(QStringList currentItems)
             // using covertFileUrlToDesktop(itor.key()).toString() to cover it to file://
             QString item = itor.key();
 
-            if (!currentItems.contains(item))
+            if (!remaining.contains(item))
                 continue; // item was removed.
 
             const QPoint &pos = itor.value();
@@ -404,14 +411,18 @@ void CanvasGridPrivate::restore(QStringList currentItems)
                 invalidPos.append(item);
 
             // remove item restored
-            currentItems.removeOne(item);
+            remaining.remove(item);
         }
     }
 
     // append invalid-pos and rest items to empty pos
     {
         QStringList overloadItems;
-        overloadItems << invalidPos << currentItems;
+        overloadItems << invalidPos;
+        for (const QString &item : currentItems) {
+            if (remaining.contains(item))
+                overloadItems << item;
+        }
         if (!overloadItems.isEmpty())
             q->append(overloadItems);
     }
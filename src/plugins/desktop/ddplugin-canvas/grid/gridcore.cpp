@@ -6,6 +6,7 @@
 #include "displayconfig.h"
 
 #include <QHashFunctions>
+#include <QtAlgorithms>
 
 uint qHash(const QPoint &key, uint seed)
 {
@@ -14,6 +15,49 @@ uint qHash(const QPoint &key, uint seed)
 
 using namespace ddplugin_canvas;
 
+GridOccupancy::GridOccupancy(const QSize &size, const QHash<QPoint, QString> &used)
+{
+    if (size.width() <= 0 || size.height() <= 0)
+        return;
+
+    height = size.height();
+    cells = size.width() * size.height();
+    bits.fill(0, (cells + 63) / 64);
+
+    // mark the padding bits of the last word as used, so that searching never goes out of the surface.
+    if (cells % 64)
+        bits.last() = ~quint64(0) << (cells % 64);
+
+    for (auto itor = used.begin(); itor != used.end(); ++itor) {
+        if (CanvasGridSpecialist::isValid(itor.key(), size))
+            setUsed(toCell(itor.key()));
+    }
+}
+
+int GridOccupancy::nextVoid(int from) const
+{
+    if (from < 0)
+        from = 0;
+    if (from >= cells)
+        return -1;
+
+    int word = from / 64;
+    quint64 voids = ~bits.at(word) & (~quint64(0) << (from % 64));
+    while (!voids) {
+        if (++word >= bits.size())
+            return -1;
+        voids = ~bits.at(word);
+    }
+
+    return word * 64 + static_cast<int>(qCountTrailingZeroBits(voids));
+}
+
+void GridOccupancy::setUsed(int cell)
+{
+    if (cell >= 0 && cell < cells)
+        bits[cell / 64] |= quint64(1) << (cell % 64);
+}
+
 GridCore::GridCore()
 {
 }
@@ -69,14 +113,9 @@ void GridCore::remove(int index, const QPoint &pos)
 QList<QPoint> GridCore::voidPos(int index) const
 {
     QList<QPoint> ret;
-    const QSize &size = surfaces.value(index, QSize(0, 0));
-    const QHash<QPoint, QString> &usedPos = posItem.value(index);
-    for (int x = 0; x < size.width(); ++x)
-        for (int y = 0; y < size.height(); ++y) {
-            QPoint pos(x, y);
-            if (!usedPos.contains(pos))
-                ret.append(pos);
-        }
+    const GridOccupancy occupancy(surfaces.value(index, QSize(0, 0)), posItem.value(index));
+    for (int cell = occupancy.nextVoid(0); cell >= 0; cell = occupancy.nextVoid(cell + 1))
+        ret.append(occupancy.toPos(cell));
 
     return ret;
 }
@@ -84,23 +123,18 @@ QList<QPoint> GridCore::voidPos(int index) const
 bool GridCore::findVoidPos(GridPos &pos) const
 {
     for (int idx : surfaceIndex()) {
-        const QHash<QPoint, QString> &usedPos = posItem.value(idx);
-        const QSize &size = surfaces.value(idx);
-
         // no void pos
         if (isFull(idx))
             continue;
 
         // find first void pos.
-        for (int x = 0; x < size.width(); ++x)
-            for (int y = 0; y < size.height(); ++y) {
-                QPoint curPos(x, y);
-                if (!usedPos.contains(curPos)) {
-                    pos.first = idx;
-                    pos.second = curPos;
-                    return true;
-                }
-            }
+        const GridOccupancy occupancy(surfaces.value(idx), posItem.value(idx));
+        int cell = occupancy.nextVoid(0);
+        if (cell >= 0) {
+            pos.first = idx;
+            pos.second = occupancy.toPos(cell);
+            return true;
+        }
     }
 
     return false;
@@ -246,19 +280,16 @@ QStringList AppendOper::appendAfter(QStringList items, int index, const QPoint &
     if (items.isEmpty())
         return items;
 
-    QList<QPoint> posList = voidPos(index);
-    for (const QPoint &pos : posList) {
-        if ((pos.x() > begin.x())
-            || (pos.x() == begin.x() && pos.y() >= begin.y())
-            || DisplayConfig::instance()->autoAlign()) {
-            // all items is appenped
-            if (items.isEmpty())
-                return items;
-
-            QString &&item = items.takeFirst();
-            insert(index, pos, item);
-        }
-    }
+    const QSize size = surfaceSize(index);
+    const GridOccupancy occupancy(size, posItem.value(index));
+
+    // the void pos after \a begin, or all void pos if auto align.
+    int from = 0;
+    if (!DisplayConfig::instance()->autoAlign())
+        from = begin.x() < 0 ? 0 : begin.x() * size.height() + qBound(0, begin.y(), size.height());
+
+    for (int cell = occupancy.nextVoid(from); cell >= 0 && !items.isEmpty(); cell = occupancy.nextVoid(cell + 1))
+        insert(index, occupancy.toPos(cell), items.takeFirst());
 
     return items;
 }
@@ -266,15 +297,13 @@ QStringList AppendOper::appendAfter(QStringList items, int index, const QPoint &
 void AppendOper::append(QStringList items)
 {
     for (int idx : surfaceIndex()) {
-        auto posList = voidPos(idx);
-        for (const QPoint &pos : posList) {
-            // all items is appenped
-            if (items.isEmpty())
-                return;
-
-            QString &&it = items.takeFirst();
-            insert(idx, pos, it);
-        }
+        // all items is appenped
+        if (items.isEmpty())
+            return;
+
+        const GridOccupancy occupancy(surfaces.value(idx), posItem.value(idx));
+        for (int cell = occupancy.nextVoid(0); cell >= 0 && !items.isEmpty(); cell = occupancy.nextVoid(cell + 1))
+            insert(idx, occupancy.toPos(cell), items.takeFirst());
     }
 
     // overload
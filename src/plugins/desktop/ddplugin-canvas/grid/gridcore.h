@@ -9,12 +9,41 @@
 
 #include <QMap>
 #include <QSize>
+#include <QVector>
 
 extern uint qHash(const QPoint &key, uint seed);
 
 namespace ddplugin_canvas {
 
 typedef QPair<int, QPoint> GridPos;
+
+// occupancy bitmap of a surface, cells are numbered by column (x * height + y) as icons are arranged.
+// void pos is searched 64 cells a time instead of looking up posItem for each cell.
+class GridOccupancy
+{
+public:
+    explicit GridOccupancy(const QSize &size, const QHash<QPoint, QString> &used);
+    int nextVoid(int from) const;
+    void setUsed(int cell);
+
+    inline int cellCount() const {
+        return cells;
+    }
+
+    inline int toCell(const QPoint &pos) const {
+        return pos.x() * height + pos.y();
+    }
+
+    inline QPoint toPos(int cell) const {
+        return QPoint(cell / height, cell % height);
+    }
+
+private:
+    int height = 0;
+    int cells = 0;
+    QVector<quint64> bits;
+};
+
 class GridCore
 {
 protected:
@@ -96,16 +96,31 @@ void CanvasProxyModelPrivate::sourceRowsAboutToBeRemoved(const QModelIndex &sour
     if (files.isEmpty())
         return;
 
-    // remove one by one
+    QList<int> rows;
+    rows.reserve(files.count());
     for (const QUrl &url : files) {
-        int row = fileList.indexOf(url);
-        if (row < 0)
-            continue;
+        int row = rowOf(url);
+        if (row >= 0)
+            rows << row;
+    }
 
-        q->beginRemoveRows(q->rootIndex(), row, row);
-        fileList.removeAt(row);
-        fileMap.remove(url);
+    // remove contiguous rows together, from the bottom so that the rows above stay valid.
+    std::sort(rows.begin(), rows.end());
+    int last = rows.count() - 1;
+    while (last >= 0) {
+        int first = last;
+        while (first > 0 && rows.at(first - 1) == rows.at(first) - 1)
+            --first;
+
+        const int top = rows.at(first);
+        const int bottom = rows.at(last);
+        q->beginRemoveRows(q->rootIndex(), top, bottom);
+        for (int row = top; row <= bottom; ++row)
+            fileMap.remove(fileList.at(row));
+        fileList.erase(fileList.begin() + top, fileList.begin() + bottom + 1);
         q->endRemoveRows();
+
+        last = first - 1;
     }
 }
 
@@ -114,7 +129,7 @@ void CanvasProxyModelPrivate::sourceDataRenamed(const QUrl &oldUrl, const QUrl &
     // canvas filter
     bool ignore = renameFilter(oldUrl, newUrl);
 
-    int row = fileList.indexOf(oldUrl);
+    int row = fileMap.contains(oldUrl) ? rowOf(oldUrl) : -1;
     if (ignore) {
         if (row >= 0) {
             q->beginRemoveRows(q->rootIndex(), row, row);
@@ -144,7 +159,7 @@ void CanvasProxyModelPrivate::sourceDataRenamed(const QUrl &oldUrl, const QUrl &
             fileMap.remove(oldUrl);
             q->endRemoveRows();
 
-            row = fileList.indexOf(newUrl);
+            row = rowOf(newUrl);
         } else {
             fileList.replace(row, newUrl);
             fileMap.remove(oldUrl);
@@ -328,10 +343,26 @@ void CanvasProxyModelPrivate::standardSort(QList<QUrl> &files) const
     return;
 }
 
+int CanvasProxyModelPrivate::rowOf(const QUrl &url) const
+{
+    auto it = rowIndexes.constFind(url);
+    if (it != rowIndexes.constEnd() && it.value() < fileList.count() && fileList.at(it.value()) == url)
+        return it.value();
+
+    // the recorded row is outdated after fileList changed, rebuild all rows at once.
+    rowIndexes.clear();
+    rowIndexes.reserve(fileList.count());
+    for (int i = 0; i < fileList.count(); ++i)
+        rowIndexes.insert(fileList.at(i), i);
+
+    return rowIndexes.value(url, -1);
+}
+
 void CanvasProxyModelPrivate::clearMapping()
 {
     fileList.clear();
     fileMap.clear();
+    rowIndexes.clear();
 }
 
 void CanvasProxyModelPrivate::createMapping()
@@ -471,7 +502,7 @@ QModelIndex CanvasProxyModel::index(const QUrl &url, int column) const
         return QModelIndex();
 
     if (d->fileMap.contains(url)) {
-        int row = d->fileList.indexOf(url);
+        int row = d->rowOf(url);
         return createIndex(row, column);
     }
 
@@ -898,7 +929,7 @@ bool CanvasProxyModel::take(const QUrl &url)
     // canvas filter
     d->removeFilter(url);
 
-    int row = d->fileList.indexOf(url);
+    int row = d->rowOf(url);
     if (Q_UNLIKELY(row < 0)) {
         fmCritical() << "invaild index of" << url;
         return false;
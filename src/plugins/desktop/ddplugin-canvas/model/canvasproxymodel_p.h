@@ -27,6 +27,7 @@ public:
     QModelIndexList indexs(const QList<QUrl> &files) const;
     bool doSort(QList<QUrl> &files) const;
     bool lessThan(const QUrl &left, const QUrl &right) const;
+    int rowOf(const QUrl &url) const;
 public slots:
     void doRefresh(bool global, bool updateFile);
     void sourceDataChanged(const QModelIndex &sourceTopleft,
@@ -60,6 +61,8 @@ public:
     QDir::Filters filters = QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System;
     QList<QUrl> fileList;
     QMap<QUrl, FileInfoPointer> fileMap;
+    // row of each url in fileList, rebuilt lazily by rowOf() once it is stale.
+    mutable QHash<QUrl, int> rowIndexes;
     FileInfoModel *srcModel = nullptr;
     QSharedPointer<QTimer> refreshTimer;
     int fileSortRole = DFMGLOBAL_NAMESPACE::ItemRoles::kItemFileMimeTypeRole;
@@ -19,10 +19,17 @@
 #include <QDateTime>
 #include <QApplication>
 #include <QTimer>
+#include <QTimerEvent>
+#include <QSet>
+
+#include <algorithm>
 
 DFMBASE_USE_NAMESPACE
 using namespace ddplugin_canvas;
 
+// 合并短时间内连续的新增和删除，如批量粘贴、删除文件
+static constexpr int kPendingInterval { 20 };
+
 FileInfoModelPrivate::FileInfoModelPrivate(FileInfoModel *qq)
     : QObject(qq), q(qq)
 {
@@ -55,20 +62,29 @@ QIcon FileInfoModelPrivate::fileIcon(FileInfoPointer info)
 void FileInfoModelPrivate::resetData(const QList<QUrl> &urls)
 {
     fmDebug() << "to reset file, count:" << urls.size();
+    // 重置前未处理的新增和删除都已包含在新的文件列表中
+    pendingInserts.clear();
+    pendingRemoves.clear();
+    if (pendingTimer >= 0) {
+        killTimer(pendingTimer);
+        pendingTimer = -1;
+    }
+
     QList<QUrl> fileUrls;
-    QMap<QUrl, FileInfoPointer> fileMaps;
+    QList<FileInfoPointer> fileInfos;
+    fileUrls.reserve(urls.size());
+    fileInfos.reserve(urls.size());
     for (const QUrl &child : urls) {
         if (auto itemInfo = FileCreator->createFileInfo(child)) {
             fileUrls.append(itemInfo->urlOf(UrlInfoType::kUrl));
-            fileMaps.insert(itemInfo->urlOf(UrlInfoType::kUrl), itemInfo);
+            fileInfos.append(itemInfo);
         }
     }
 
     q->beginResetModel();
     {
         QWriteLocker lk(&lock);
-        fileList = fileUrls;
-        fileMap = fileMaps;
+        fileList.reset(fileUrls, fileInfos);
     }
 
     modelState = FileInfoModelPrivate::NormalState;
@@ -77,31 +93,105 @@ void FileInfoModelPrivate::resetData(const QList<QUrl> &urls)
 
 void FileInfoModelPrivate::insertData(const QUrl &url)
 {
-    int row = -1;
-    {
-        QReadLocker lk(&lock);
-        if (auto cur = fileMap.value(url)) {
-            lk.unlock();
+    // 保持事件顺序，先处理之前缓存的删除
+    if (!pendingRemoves.isEmpty())
+        flushPending();
+
+    pendingInserts.append(url);
+    if (pendingTimer < 0)
+        pendingTimer = startTimer(kPendingInterval);
+}
+
+void FileInfoModelPrivate::removeData(const QUrl &url)
+{
+    if (!pendingInserts.isEmpty())
+        flushPending();
+
+    pendingRemoves.append(url);
+    if (pendingTimer < 0)
+        pendingTimer = startTimer(kPendingInterval);
+}
+
+void FileInfoModelPrivate::flushPending()
+{
+    if (pendingTimer >= 0) {
+        killTimer(pendingTimer);
+        pendingTimer = -1;
+    }
+
+    // 新增和删除不会同时缓存，见 insertData 和 removeData
+    if (!pendingInserts.isEmpty()) {
+        QList<QUrl> urls;
+        urls.swap(pendingInserts);
+        insertRows(urls);
+    }
+
+    if (!pendingRemoves.isEmpty()) {
+        QList<QUrl> urls;
+        urls.swap(pendingRemoves);
+        removeRows(urls);
+    }
+}
+
+void FileInfoModelPrivate::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == pendingTimer) {
+        flushPending();
+        event->accept();
+        return;
+    }
+
+    return QObject::timerEvent(event);
+}
+
+void FileInfoModelPrivate::insertRows(const QList<QUrl> &urls)
+{
+    QList<QUrl> newUrls;
+    QList<FileInfoPointer> newInfos;
+    QSet<QUrl> added;
+    for (const QUrl &url : urls) {
+        FileInfoPointer cur;
+        {
+            QReadLocker lk(&lock);
+            cur = fileList.fileInfo(url);
+        }
+
+        if (cur) {
             fmInfo() << "the file to insert is existed" << url;
             cur->refresh();   // refresh fileinfo.
             const QModelIndex &index = q->index(url);
             emit q->dataChanged(index, index);
-            return;
+            continue;
         }
-        row = fileList.count();
+
+        if (added.contains(url))
+            continue;
+
+        auto itemInfo = FileCreator->createFileInfo(url);
+        if (Q_UNLIKELY(!itemInfo)) {
+            fmWarning() << "fail to create file info" << url;
+            continue;
+        }
+
+        added.insert(url);
+        newUrls.append(url);
+        newInfos.append(itemInfo);
     }
 
-    auto itemInfo = FileCreator->createFileInfo(url);
-    if (Q_UNLIKELY(!itemInfo)) {
-        fmWarning() << "fail to create file info" << url;
+    if (newUrls.isEmpty())
         return;
+
+    int row = -1;
+    {
+        QReadLocker lk(&lock);
+        row = fileList.count();
     }
 
-    q->beginInsertRows(q->rootIndex(), row, row);
+    q->beginInsertRows(q->rootIndex(), row, row + newUrls.count() - 1);
     {
         QWriteLocker lk(&lock);
-        fileList.append(url);
-        fileMap.insert(url, itemInfo);
+        for (int i = 0; i < newUrls.count(); ++i)
+            fileList.append(newUrls.at(i), newInfos.at(i));
     }
     q->endInsertRows();
 
@@ -110,39 +200,59 @@ void FileInfoModelPrivate::insertData(const QUrl &url)
     // the first time if the cached icon is empty, even if the icon icon resource is installed next.
     //
     // detail see: https://bugreports.qt.io/browse/QTBUG-112257
-    if (FileUtils::isDesktopFileInfo(itemInfo)) {
-        checkAndRefreshDesktopIcon(itemInfo);
+    for (const FileInfoPointer &itemInfo : newInfos) {
+        if (FileUtils::isDesktopFileInfo(itemInfo))
+            checkAndRefreshDesktopIcon(itemInfo);
     }
 }
 
-void FileInfoModelPrivate::removeData(const QUrl &url)
+void FileInfoModelPrivate::removeRows(const QList<QUrl> &urls)
 {
-    int position = -1;
+    QList<int> rows;
     {
         QReadLocker lk(&lock);
-        position = fileList.indexOf(url);
+        for (const QUrl &url : urls) {
+            int position = fileList.indexOf(url);
+            if (Q_UNLIKELY(position < 0)) {
+                fmInfo() << "file dose not exists:" << url;
+                continue;
+            }
+            rows.append(position);
+        }
     }
 
-    if (Q_UNLIKELY(position < 0)) {
-        fmInfo() << "file dose not exists:" << url;
+    if (rows.isEmpty())
         return;
-    }
 
-    q->beginRemoveRows(q->rootIndex(), position, position);
-    {
-        QWriteLocker lk(&lock);
-        position = fileList.indexOf(url);
-        fileList.removeAt(position);
-        fileMap.remove(url);
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    // 从后往前按连续区间删除，前面区间的行号不受影响
+    int last = rows.count() - 1;
+    while (last >= 0) {
+        int first = last;
+        while (first > 0 && rows.at(first - 1) == rows.at(first) - 1)
+            --first;
+
+        q->beginRemoveRows(q->rootIndex(), rows.at(first), rows.at(last));
+        {
+            QWriteLocker lk(&lock);
+            fileList.removeRows(rows.at(first), last - first + 1);
+        }
+        q->endRemoveRows();
+        last = first - 1;
     }
-    q->endRemoveRows();
+
+    QWriteLocker lk(&lock);
+    fileList.updateIndexes();
 }
 
 void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
 {
+    flushPending();
     if (newUrl.isEmpty()) {
         fmInfo() << "target url is empty, remove old" << oldUrl;
-        removeData(oldUrl);
+        removeRows({ oldUrl });
         return;
     }
 
@@ -151,7 +261,7 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
     auto newInfo = FileCreator->createFileInfo(newUrl);
     if (Q_UNLIKELY(newInfo.isNull())) {
         fmWarning() << "fail to create new file info:" << newUrl << "old" << oldUrl;
-        removeData(oldUrl);
+        removeRows({ oldUrl });
         return;
     }
 
@@ -159,9 +269,9 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
         QWriteLocker lk(&lock);
         int position = fileList.indexOf(oldUrl);
         if (Q_LIKELY(position < 0)) {
-            if (!fileMap.contains(newUrl)) {
+            if (!fileList.contains(newUrl)) {
                 lk.unlock();
-                insertData(newUrl);
+                insertRows({ newUrl });
                 return;
             }
         } else {
@@ -172,19 +282,18 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
 
                 // then remove and emit remove signal.
                 lk.unlock();
-                removeData(oldUrl);
+                removeRows({ oldUrl });
                 lk.relock();
                 position = fileList.indexOf(newUrl);
-                auto cur = fileMap.value(newUrl);
+                auto cur = fileList.fileInfo(newUrl);
                 lk.unlock();
 
                 // refresh file
-                cur->refresh();
+                if (cur)
+                    cur->refresh();
                 fmInfo() << "move file" << oldUrl << "to overwritte" << newUrl;
             } else {
-                fileList.replace(position, newUrl);
-                fileMap.remove(oldUrl);
-                fileMap.insert(newUrl, newInfo);
+                fileList.replace(oldUrl, newUrl, newInfo);
                 lk.unlock();
 
                 // refresh file because an old info cahe may exist.
@@ -202,15 +311,16 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
 
 void FileInfoModelPrivate::updateData(const QUrl &url)
 {
+    flushPending();
     {
         QReadLocker lk(&lock);
-        if (Q_UNLIKELY(!fileMap.contains(url)))
+        if (Q_UNLIKELY(!fileList.contains(url)))
             return;
 
         // Although the files cached in InfoCache will be refreshed automatically,
         // a redundant refresh is still required here, because the current variant of FileInfo
         // (like DesktopFileInfo created from DesktopFileCreator) is not in InfoCache and will not be refreshed automatically.
-        if (auto info = fileMap.value(url))
+        if (auto info = fileList.fileInfo(url))
             info->updateAttributes();
     }
 
@@ -223,9 +333,10 @@ void FileInfoModelPrivate::updateData(const QUrl &url)
 
 void FileInfoModelPrivate::dataUpdated(const QUrl &url, const bool isLinkOrg)
 {
+    flushPending();
     {
         QReadLocker lk(&lock);
-        if (Q_UNLIKELY(!fileMap.contains(url)))
+        if (Q_UNLIKELY(!fileList.contains(url)))
             return;
     }
 
@@ -243,13 +354,11 @@ void FileInfoModelPrivate::dataUpdated(const QUrl &url, const bool isLinkOrg)
 void FileInfoModelPrivate::thumbUpdated(const QUrl &url, const QString &thumb)
 {
     using namespace dfmbase::Global;
+    flushPending();
     FileInfoPointer info { nullptr };
     {
         QReadLocker lk(&lock);
-        if (Q_UNLIKELY(!fileMap.contains(url)))
-            return;
-
-        if (!(info = fileMap.value(url)))
+        if (!(info = fileList.fileInfo(url)))
             return;
     }
     // Creating thumbnail icon in a thread may cause the program to crash
@@ -364,11 +473,7 @@ QModelIndex FileInfoModel::index(int row, int column, const QModelIndex &parent)
     if (row < 0 || column < 0 || rowCount(rootIndex()) <= row)
         return QModelIndex();
 
-    auto url = d->fileList.at(row);
-    if (d->fileMap.contains(url))
-        return createIndex(row, column);
-
-    return QModelIndex();
+    return createIndex(row, column);
 }
 
 QModelIndex FileInfoModel::index(const QUrl &url, int column) const
@@ -376,10 +481,9 @@ QModelIndex FileInfoModel::index(const QUrl &url, int column) const
     if (url.isEmpty())
         return QModelIndex();
 
-    if (d->fileMap.contains(url)) {
-        int row = d->fileList.indexOf(url);
+    int row = d->fileList.indexOf(url);
+    if (row >= 0)
         return createIndex(row, column);
-    }
 
     if (url == rootUrl())
         return rootIndex();
@@ -392,10 +496,7 @@ FileInfoPointer FileInfoModel::fileInfo(const QModelIndex &index) const
     if (index == rootIndex())
         return FileCreator->createFileInfo(rootUrl());
 
-    if (index.row() < 0 || index.row() >= d->fileList.count())
-        return nullptr;
-
-    return d->fileMap.value(d->fileList.at(index.row()));
+    return d->fileList.fileInfo(index.row());
 }
 
 QUrl FileInfoModel::fileUrl(const QModelIndex &index) const
@@ -411,7 +512,7 @@ QUrl FileInfoModel::fileUrl(const QModelIndex &index) const
 
 QList<QUrl> FileInfoModel::files() const
 {
-    return d->fileList;
+    return d->fileList.toList();
 }
 
 void FileInfoModel::refresh(const QModelIndex &parent)
@@ -429,8 +530,10 @@ int FileInfoModel::modelState() const
 
 void FileInfoModel::update()
 {
-    for (auto itor = d->fileMap.begin(); itor != d->fileMap.end(); ++itor)
-        itor.value()->updateAttributes();
+    for (const FileInfoPointer &info : d->fileList.fileInfos()) {
+        if (info)
+            info->updateAttributes();
+    }
 
     emit dataChanged(createIndex(0, 0), createIndex(rowCount(rootIndex()) - 1, 0));
 }
@@ -442,8 +545,10 @@ void FileInfoModel::updateFile(const QUrl &url)
 
 void FileInfoModel::refreshAllFile()
 {
-    for (auto itor = d->fileMap.begin(); itor != d->fileMap.end(); ++itor)
-        itor.value()->refresh();
+    for (const FileInfoPointer &info : d->fileList.fileInfos()) {
+        if (info)
+            info->refresh();
+    }
 
     emit dataChanged(createIndex(0, 0), createIndex(rowCount(rootIndex()) - 1, 0));
 }
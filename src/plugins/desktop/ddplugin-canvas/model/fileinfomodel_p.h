@@ -7,6 +7,7 @@
 
 #include "fileinfomodel.h"
 #include "fileprovider.h"
+#include "indexedfilelist.h"
 
 #include <QReadWriteLock>
 
@@ -25,6 +26,9 @@ public:
     void doRefresh();
     QIcon fileIcon(FileInfoPointer info);
     void checkAndRefreshDesktopIcon(const FileInfoPointer &info, int retryCount = 5);
+    void insertRows(const QList<QUrl> &urls);
+    void removeRows(const QList<QUrl> &urls);
+    void flushPending();
 
 public slots:
     void resetData(const QList<QUrl> &urls);
@@ -35,14 +39,21 @@ public slots:
     void dataUpdated(const QUrl &url, const bool isLinkOrg);
     void thumbUpdated(const QUrl &url, const QString &thumb);
 
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
 public:
     QDir::Filters filters = QDir::NoFilter;
     ModelState modelState = NullState;
     FileProvider *fileProvider = nullptr;
-    QList<QUrl> fileList;
-    QMap<QUrl, FileInfoPointer> fileMap;
+    IndexedFileList fileList;
     QReadWriteLock lock;
 
+    // 连续的新增或删除先缓存，合并后按连续的行区间发出信号
+    QList<QUrl> pendingInserts;
+    QList<QUrl> pendingRemoves;
+    int pendingTimer = -1;
+
 private:
     FileInfoModel *q = nullptr;
 };
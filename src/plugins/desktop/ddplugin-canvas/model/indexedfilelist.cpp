@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "indexedfilelist.h"
+
+using namespace ddplugin_canvas;
+
+int IndexedFileList::indexOf(const QUrl &url) const
+{
+    auto it = nodes.constFind(url);
+    if (it == nodes.constEnd())
+        return -1;
+
+    const int row = it->row;
+    if (row >= 0 && row < urls.count() && urls.at(row) == url)
+        return row;
+
+    // 批量删除过程中记录的行号可能已失效
+    return urls.indexOf(url, dirtyRow < 0 ? 0 : dirtyRow);
+}
+
+FileInfoPointer IndexedFileList::fileInfo(const QUrl &url) const
+{
+    return nodes.value(url).info;
+}
+
+FileInfoPointer IndexedFileList::fileInfo(int row) const
+{
+    if (row < 0 || row >= urls.count())
+        return nullptr;
+
+    return nodes.value(urls.at(row)).info;
+}
+
+QList<FileInfoPointer> IndexedFileList::fileInfos() const
+{
+    QList<FileInfoPointer> infos;
+    infos.reserve(nodes.size());
+    for (auto it = nodes.constBegin(); it != nodes.constEnd(); ++it)
+        infos.append(it->info);
+
+    return infos;
+}
+
+void IndexedFileList::reset(const QList<QUrl> &fileUrls, const QList<FileInfoPointer> &infos)
+{
+    Q_ASSERT(fileUrls.count() == infos.count());
+    clear();
+    urls.reserve(fileUrls.count());
+    nodes.reserve(fileUrls.count());
+    for (int i = 0; i < fileUrls.count(); ++i)
+        append(fileUrls.at(i), infos.at(i));
+}
+
+void IndexedFileList::clear()
+{
+    urls.clear();
+    nodes.clear();
+    dirtyRow = -1;
+}
+
+bool IndexedFileList::append(const QUrl &url, const FileInfoPointer &info)
+{
+    auto it = nodes.find(url);
+    if (it != nodes.end()) {
+        it->info = info;
+        return false;
+    }
+
+    nodes.insert(url, { urls.count(), info });
+    urls.append(url);
+    return true;
+}
+
+bool IndexedFileList::replace(const QUrl &oldUrl, const QUrl &newUrl, const FileInfoPointer &info)
+{
+    const int row = indexOf(oldUrl);
+    if (row < 0 || nodes.contains(newUrl))
+        return false;
+
+    nodes.remove(oldUrl);
+    nodes.insert(newUrl, { row, info });
+    urls.replace(row, newUrl);
+    return true;
+}
+
+void IndexedFileList::removeRows(int first, int count)
+{
+    if (first < 0 || count <= 0 || first + count > urls.count())
+        return;
+
+    for (int i = first; i < first + count; ++i)
+        nodes.remove(urls.at(i));
+
+    urls.erase(urls.begin() + first, urls.begin() + first + count);
+    if (first < urls.count())
+        dirtyRow = dirtyRow < 0 ? first : qMin(dirtyRow, first);
+}
+
+void IndexedFileList::updateIndexes()
+{
+    if (dirtyRow < 0)
+        return;
+
+    for (int i = dirtyRow; i < urls.count(); ++i)
+        nodes[urls.at(i)].row = i;
+
+    dirtyRow = -1;
+}
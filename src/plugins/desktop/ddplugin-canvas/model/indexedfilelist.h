@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef INDEXEDFILELIST_H
+#define INDEXEDFILELIST_H
+
+#include "ddplugin_canvas_global.h"
+
+#include <dfm-base/interfaces/fileinfo.h>
+
+#include <QList>
+#include <QHash>
+#include <QUrl>
+
+namespace ddplugin_canvas {
+
+/*!
+ * \brief 按行排列的文件列表，通过 url 查找行号和文件信息。
+ * 每个文件在哈希表中记录所在行，删除行后只需在 updateIndexes 中统一修正一次，
+ * 修正前查到的行号与 url 不一致时回退为顺序查找，结果始终正确。
+ */
+class IndexedFileList
+{
+public:
+    inline int count() const { return urls.count(); }
+    inline int size() const { return urls.count(); }
+    inline bool isEmpty() const { return urls.isEmpty(); }
+    inline bool contains(const QUrl &url) const { return nodes.contains(url); }
+    inline QUrl at(int row) const { return urls.at(row); }
+    inline QUrl first() const { return urls.first(); }
+    inline QUrl last() const { return urls.last(); }
+    inline QList<QUrl> toList() const { return urls; }
+
+    int indexOf(const QUrl &url) const;
+    FileInfoPointer fileInfo(const QUrl &url) const;
+    FileInfoPointer fileInfo(int row) const;
+    QList<FileInfoPointer> fileInfos() const;
+
+    void reset(const QList<QUrl> &fileUrls, const QList<FileInfoPointer> &infos);
+    void clear();
+    // url 已存在时只更新文件信息并返回 false
+    bool append(const QUrl &url, const FileInfoPointer &info = {});
+    bool replace(const QUrl &oldUrl, const QUrl &newUrl, const FileInfoPointer &info);
+    void removeRows(int first, int count);
+    void updateIndexes();
+
+private:
+    struct Node
+    {
+        int row = -1;
+        FileInfoPointer info;
+    };
+
+    QList<QUrl> urls;
+    QHash<QUrl, Node> nodes;
+    int dirtyRow = -1;   // 从该行开始记录的行号已失效，-1 表示全部有效
+};
+
+}
+
+#endif   // INDEXEDFILELIST_H
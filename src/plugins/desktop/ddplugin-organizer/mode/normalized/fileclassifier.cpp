@@ -8,9 +8,20 @@
 #include "config/configpresenter.h"
 
 #include <QDebug>
+#include <QSet>
+
+#include <algorithm>
 
 using namespace ddplugin_organizer;
 
+static void removeAll(QList<QUrl> &items, const QSet<QUrl> &files)
+{
+    items.erase(std::remove_if(items.begin(), items.end(), [&files](const QUrl &url) {
+                    return files.contains(url);
+                }),
+                items.end());
+}
+
 FileClassifier *ClassifierCreator::createClassifier(Classifier mode)
 {
     FileClassifier *ret = nullptr;
@@ -35,6 +46,8 @@ FileClassifier::FileClassifier(QObject *parent)
 void FileClassifier::reset(const QList<QUrl> &urls)
 {
     collections.clear();
+    itemKeys.clear();
+    itemKeys.reserve(urls.size());
     for (const QString &id : classes()) {
         CollectionBaseDataPtr dp(new CollectionBaseData);
         dp->name = className(id);
@@ -51,11 +64,13 @@ void FileClassifier::reset(const QList<QUrl> &urls)
         }
 
         auto it = collections.find(type);
-        if (it != collections.end())
+        if (it != collections.end()) {
             it.value()->items.append(url);
-        else
+            itemKeys.insert(url, type);
+        } else
             Q_ASSERT_X(it == collections.end(), "TypeClassifier", QString("unrecognized type %0").arg(type).toStdString().c_str());
     }
+    indexDirty = false;
 }
 
 QList<CollectionBaseDataPtr> FileClassifier::baseData() const
@@ -83,19 +98,22 @@ QString FileClassifier::replace(const QUrl &oldUrl, const QUrl &newUrl)
     if (Q_UNLIKELY(newType.isEmpty())) {
         fmWarning() << "can not find file:" << newUrl;
         collections[oldType]->items.removeOne(oldUrl);
+        itemKeys.remove(oldUrl);
         return newType;
     }
 
+    itemKeys.remove(oldUrl);
+    itemKeys.insert(newUrl, newType);
     if (oldType == newType) {
         int idx = collections[newType]->items.indexOf(oldUrl);
         collections[newType]->items.replace(idx, newUrl);
-        emit itemsChanged(newType);
+        notifyItemsChanged(newType);
     } else {
         collections[oldType]->items.removeOne(oldUrl);
-        emit itemsChanged(oldType);
+        notifyItemsChanged(oldType);
 
         collections[newType]->items.append(newUrl);
-        emit itemsChanged(newType);
+        notifyItemsChanged(newType);
     }
 #else
     // old does not exist.
@@ -157,17 +175,19 @@ QString FileClassifier::append(const QUrl &url)
         auto it = collections.find(ret);
         if (it != collections.end()) {
             it.value()->items.append(url);
-            emit itemsChanged(ret);
+            itemKeys.insert(url, ret);
+            notifyItemsChanged(ret);
         } else {
             Q_ASSERT_X(it == collections.end(), "TypeClassifier", QString("unrecognized type %0").arg(ret).toStdString().c_str());
         }
     } else {   // existed
         if (cur != ret) {
             collections[cur]->items.removeOne(url);
-            emit itemsChanged(cur);
+            notifyItemsChanged(cur);
 
             collections[ret]->items.append(url);
-            emit itemsChanged(ret);
+            itemKeys.insert(url, ret);
+            notifyItemsChanged(ret);
         }
     }
 
@@ -189,17 +209,19 @@ QString FileClassifier::prepend(const QUrl &url)
         auto it = collections.find(ret);
         if (it != collections.end()) {
             it.value()->items.prepend(url);
-            emit itemsChanged(ret);
+            itemKeys.insert(url, ret);
+            notifyItemsChanged(ret);
         } else {
             Q_ASSERT_X(it == collections.end(), "TypeClassifier", QString("unrecognized type %0").arg(ret).toStdString().c_str());
         }
     } else {   // existed
         if (cur != ret) {
             collections[cur]->items.removeOne(url);
-            emit itemsChanged(cur);
+            notifyItemsChanged(cur);
 
             collections[ret]->items.prepend(url);
-            emit itemsChanged(ret);
+            itemKeys.insert(url, ret);
+            notifyItemsChanged(ret);
         }
     }
 
@@ -213,16 +235,13 @@ void FileClassifier::insert(const QUrl &, const QString &, const int)
 
 QString FileClassifier::remove(const QUrl &url)
 {
-    QString ret;
-    for (auto itor = collections.begin(); itor != collections.end(); ++itor) {
-        if (itor.value()->items.contains(url)) {
-            itor.value()->items.removeOne(url);
-            ret = itor.key();
-            emit itemsChanged(ret);
-            break;
-        }
-    }
+    QString ret = key(url);
+    if (ret.isEmpty())
+        return ret;
 
+    collections[ret]->items.removeOne(url);
+    itemKeys.remove(url);
+    notifyItemsChanged(ret);
     return ret;
 }
 
@@ -235,16 +254,105 @@ QString FileClassifier::change(const QUrl &url)
     QString ret = classify(url);
     if (ret != cur) {
         collections[cur]->items.removeOne(url);
-        emit itemsChanged(cur);
+        notifyItemsChanged(cur);
 
         collections[ret]->items.append(url);
-        emit itemsChanged(ret);
+        itemKeys.insert(url, ret);
+        notifyItemsChanged(ret);
 
         return ret;
     }
     return "";
 }
 
+QString FileClassifier::key(const QUrl &url) const
+{
+    ensureIndex();
+    return itemKeys.value(url);
+}
+
+bool FileClassifier::contains(const QString &key, const QUrl &url) const
+{
+    ensureIndex();
+    auto it = itemKeys.constFind(url);
+    return it != itemKeys.constEnd() && it.value() == key;
+}
+
+void FileClassifier::moveUrls(const QList<QUrl> &urls, const QString &targetKey, int targetIndex)
+{
+    CollectionDataProvider::moveUrls(urls, targetKey, targetIndex);
+    indexDirty = true;
+}
+
+void FileClassifier::prependItems(const QList<QUrl> &urls)
+{
+    QStringList changed;
+    batchKeys = &changed;
+    for (const QUrl &url : urls)
+        prepend(url);
+    batchKeys = nullptr;
+
+    for (const QString &key : changed)
+        emit itemsChanged(key);
+}
+
+void FileClassifier::removeItems(const QList<QUrl> &urls)
+{
+    ensureIndex();
+
+    // 按分组收集后每个分组只遍历一次
+    QHash<QString, QSet<QUrl>> removed;
+    for (const QUrl &url : urls) {
+        auto it = itemKeys.find(url);
+        if (it == itemKeys.end())
+            continue;
+        removed[it.value()].insert(url);
+        itemKeys.erase(it);
+    }
+
+    for (auto it = removed.cbegin(); it != removed.cend(); ++it)
+        removeAll(collections[it.key()]->items, it.value());
+
+    for (auto it = removed.cbegin(); it != removed.cend(); ++it)
+        emit itemsChanged(it.key());
+}
+
+void FileClassifier::changeItems(const QList<QUrl> &urls)
+{
+    ensureIndex();
+
+    QStringList changed;
+    QHash<QString, QSet<QUrl>> removed;
+    QList<QPair<QString, QUrl>> added;
+    for (const QUrl &url : urls) {
+        auto it = itemKeys.find(url);
+        if (it == itemKeys.end())
+            continue;
+
+        const QString cur = it.value();
+        const QString ret = classify(url);
+        if (ret == cur || !collections.contains(ret))
+            continue;
+
+        removed[cur].insert(url);
+        added.append(qMakePair(ret, url));
+        it.value() = ret;
+        if (!changed.contains(cur))
+            changed.append(cur);
+        if (!changed.contains(ret))
+            changed.append(ret);
+    }
+
+    for (auto it = removed.cbegin(); it != removed.cend(); ++it)
+        removeAll(collections[it.key()]->items, it.value());
+
+    for (const auto &item : added)
+        collections[item.first]->items.append(item.second);
+
+    for (const QString &key : changed)
+        emit itemsChanged(key);
+}
+
 bool FileClassifier::acceptInsert(const QUrl &url)
 {
     const auto type { classify(url) };
@@ -257,3 +365,32 @@ bool FileClassifier::acceptRename(const QUrl &oldUrl, const QUrl &newUrl)
     const auto type { classify(newUrl) };
     return classes().contains(type);
 }
+
+void FileClassifier::notifyItemsChanged(const QString &key)
+{
+    if (!batchKeys) {
+        emit itemsChanged(key);
+        return;
+    }
+
+    if (!batchKeys->contains(key))
+        batchKeys->append(key);
+}
+
+void FileClassifier::ensureIndex() const
+{
+    int total = 0;
+    for (auto it = collections.cbegin(); it != collections.cend(); ++it)
+        total += it.value()->items.size();
+
+    if (!indexDirty && total == itemKeys.size())
+        return;
+
+    itemKeys.clear();
+    itemKeys.reserve(total);
+    for (auto it = collections.cbegin(); it != collections.cend(); ++it) {
+        for (const QUrl &url : it.value()->items)
+            itemKeys.insert(url, it.value()->key);
+    }
+    indexDirty = false;
+}
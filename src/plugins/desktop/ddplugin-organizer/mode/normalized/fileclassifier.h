@@ -47,10 +47,29 @@ public:
     void insert(const QUrl &, const QString &, const int) override;
     QString remove(const QUrl &) override;
     QString change(const QUrl &) override;
+    QString key(const QUrl &) const override;
+    bool contains(const QString &key, const QUrl &url) const override;
+    void moveUrls(const QList<QUrl> &urls, const QString &targetKey, int targetIndex) override;
+
+public:
+    // 批量更新，每个分组只发送一次 itemsChanged
+    void prependItems(const QList<QUrl> &urls);
+    void removeItems(const QList<QUrl> &urls);
+    void changeItems(const QList<QUrl> &urls);
 
 public:
     bool acceptInsert(const QUrl &url) override;
     bool acceptRename(const QUrl &oldUrl, const QUrl &newUrl) override;
+
+protected:
+    void notifyItemsChanged(const QString &key);
+    void ensureIndex() const;
+
+private:
+    // 文件所属分组的索引，items 被直接修改导致文件总数变化时重建
+    mutable QHash<QUrl, QString> itemKeys;
+    mutable bool indexDirty = true;
+    QStringList *batchKeys = nullptr;
 };
 
 }
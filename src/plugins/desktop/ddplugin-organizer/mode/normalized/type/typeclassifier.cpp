@@ -230,15 +230,12 @@ bool TypeClassifier::acceptRename(const QUrl &oldUrl, const QUrl &newUrl)
     if (!CfgPresenter->organizeOnTriggered())
         return FileClassifier::acceptRename(oldUrl, newUrl);
 
-    QList<QUrl> collected;
-    for (auto base : baseData())
-        collected.append(base->items);
-    if (collected.contains(newUrl)) {
+    if (!key(newUrl).isEmpty()) {
         // if the newUrl existed in collections, means new file replaced the old file.
         // remove it from collection
         remove(newUrl);
         return true;
-    } else if (collected.contains(oldUrl)) {
+    } else if (!key(oldUrl).isEmpty()) {
         return true;
     }
     return false;
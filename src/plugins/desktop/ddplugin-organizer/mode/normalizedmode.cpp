@@ -25,6 +25,7 @@
 #include <QScrollBar>
 #include <QDebug>
 #include <QTime>
+#include <QSet>
 
 #include <DGuiApplicationHelper>
 
@@ -396,10 +397,9 @@ bool NormalizedModePrivate::moveFilesToCanvas(int viewIndex, const QList<QUrl> &
 
     q->canvasGridShell->tryAppendAfter(files, viewIndex, gridPos);
 
-    for (auto url : collectionItems) {
-        classifier->remove(url);
+    classifier->removeItems(collectionItems);
+    for (auto url : collectionItems)
         q->canvasModelShell->fetch(url);
-    }
 
     dpfSlotChannel->push("ddplugin_canvas", "slot_CanvasView_Select", collectionItems);
     return true;
@@ -419,13 +419,21 @@ void NormalizedModePrivate::restore(const QList<CollectionBaseDataPtr> &cfgs, bo
     // order by config
     for (const CollectionBaseDataPtr &cfg : cfgs) {
         if (auto base = classifier->baseData(cfg->key)) {
-            QList<QUrl> org = base->items;
+            QSet<QUrl> remaining;
+            for (const QUrl &url : base->items)
+                remaining.insert(url);
+
             QList<QUrl> ordered;
             for (const QUrl &old : cfg->items) {
-                if (org.contains(old)) {
+                if (remaining.remove(old))
                     ordered << old;
-                    org.removeOne(old);
-                }
+            }
+
+            // keep the classified order of those are not in config.
+            QList<QUrl> org;
+            for (const QUrl &url : base->items) {
+                if (remaining.contains(url))
+                    org << url;
             }
 
             // those are not in config files should not be organized.
@@ -523,14 +531,11 @@ void NormalizedMode::layout()
     {
         const QStringList &ordered = d->classifier->classes();
         const int max = ordered.size();
-        std::sort(holders.begin(), holders.end(), [&ordered, max](const CollectionHolderPointer &t1, const CollectionHolderPointer &t2) {
-            int i1 = ordered.indexOf(t1->id());
-            if (i1 < 0)
-                i1 = max;
-            int i2 = ordered.indexOf(t2->id());
-            if (i2 < 0)
-                i2 = max;
-            return i1 < i2;
+        QHash<QString, int> rank;
+        for (int i = 0; i < max; ++i)
+            rank.insert(ordered.at(i), i);
+        std::sort(holders.begin(), holders.end(), [&rank, max](const CollectionHolderPointer &t1, const CollectionHolderPointer &t2) {
+            return rank.value(t1->id(), max) < rank.value(t2->id(), max);
         });
     }
 
@@ -747,14 +752,11 @@ void NormalizedMode::onFileRenamed(const QUrl &oldUrl, const QUrl &newUrl)
             return;
         QString newType = d->classifier->classify(newUrl);
         if (newType == oldType) {
-            auto idx = d->classifier->baseData(oldType)->items.indexOf(oldUrl);
-            d->classifier->baseData(oldType)->items.replace(idx, newUrl);
+            d->classifier->replace(oldUrl, newUrl);
         } else {
-            d->classifier->baseData(oldType)->items.removeAll(oldUrl);
+            d->classifier->remove(oldUrl);
             dpfSlotChannel->push("ddplugin_canvas", "slot_CanvasView_Select", QList<QUrl> { newUrl });
         }
-
-        Q_EMIT d->classifier->itemsChanged(oldType);
     } else {
         d->classifier->replace(oldUrl, newUrl);
     }
@@ -789,10 +791,9 @@ void NormalizedMode::onFileInserted(const QModelIndex &parent, int first, int la
         QModelIndex index = model->index(i, 0, parent);
         if (Q_UNLIKELY(!index.isValid()))
             continue;
-        auto url = model->fileUrl(index);
-        d->classifier->prepend(url);
-        urls.append(url);
+        urls.append(model->fileUrl(index));
     }
+    d->classifier->prependItems(urls);
 
     d->switchCollection();
 
@@ -804,13 +805,14 @@ void NormalizedMode::onFileInserted(const QModelIndex &parent, int first, int la
 
 void NormalizedMode::onFileAboutToBeRemoved(const QModelIndex &parent, int first, int last)
 {
+    QList<QUrl> urls;
     for (int i = first; i <= last; i++) {
         QModelIndex index = model->index(i, 0, parent);
         if (Q_UNLIKELY(!index.isValid()))
             continue;
-        QUrl url = model->fileUrl(index);
-        d->classifier->remove(url);
+        urls.append(model->fileUrl(index));
     }
+    d->classifier->removeItems(urls);
 
     d->switchCollection();
 }
@@ -819,10 +821,12 @@ void NormalizedMode::onFileDataChanged(const QModelIndex &topLeft, const QModelI
 {
     if (Q_UNLIKELY(!topLeft.isValid() || !bottomRight.isValid()))
         return;
+    QList<QUrl> urls;
     for (int i = topLeft.row(); i <= bottomRight.row(); i++) {
         QModelIndex index = model->index(i, 0);
-        d->classifier->change(model->fileUrl(index));
+        urls.append(model->fileUrl(index));
     }
+    d->classifier->changeItems(urls);
 }
 
 void NormalizedMode::onReorganizeDesktop()
@@ -9,6 +9,13 @@
 #include <dfm-base/base/schemefactory.h>
 
 #include <QDebug>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <dirent.h>
+#include <sys/stat.h>
 
 static int kEmitInterval = 50;   // 推送时间间隔（ms
 static constexpr char kFilterFolders[] = "^/(dev|proc|sys|run|tmpfs).*$";
@@ -16,11 +23,40 @@ static constexpr char kFilterFolders[] = "^/(dev|proc|sys|run|tmpfs).*$";
 DFMBASE_USE_NAMESPACE
 DPSEARCH_USE_NAMESPACE
 
+static const QRegularExpression &filterFoldersRegex()
+{
+    static const QRegularExpression reg(kFilterFolders);
+    return reg;
+}
+
 IteratorSearcher::IteratorSearcher(const QUrl &url, const QString &key, QObject *parent)
     : AbstractSearcher(url, SearchHelper::instance()->checkWildcardAndToRegularExpression(key), parent)
 {
     searchPathList << url;
+    searchedPathSet << url;
     regex = QRegularExpression(keyword, QRegularExpression::CaseInsensitiveOption);
+    regex.optimize();
+
+    // 取出关键字中最长的字面片段，文件名不包含它就一定不匹配
+    // '[' 在通配符中表示字符集合，包含它的关键字不能按字面匹配
+    if (key.contains('['))
+        return;
+
+    if (!key.contains('*') && !key.contains('?')) {
+        literalKey = key;
+        literalOnly = true;
+    } else {
+        QString part;
+        for (const QChar &c : key + '*') {
+            if (c != '*' && c != '?') {
+                part.append(c);
+                continue;
+            }
+            if (part.length() > literalKey.length())
+                literalKey = part;
+            part.clear();
+        }
+    }
 }
 
 bool IteratorSearcher::search()
@@ -31,7 +67,10 @@ bool IteratorSearcher::search()
 
     notifyTimer.start();
     // 遍历搜索
-    doSearch();
+    if (searchUrl.isLocalFile())
+        doLocalSearch();
+    else
+        doSearch();
 
     //检查是否还有数据
     if (status.testAndSetRelease(kRuning, kCompleted)) {
@@ -46,6 +85,9 @@ bool IteratorSearcher::search()
 void IteratorSearcher::stop()
 {
     status.storeRelease(kTerminated);
+
+    QMutexLocker lk(&dirQueueMutex);
+    dirQueueCond.wakeAll();
 }
 
 bool IteratorSearcher::hasItem() const
@@ -62,12 +104,17 @@ QList<QUrl> IteratorSearcher::takeAll()
 
 void IteratorSearcher::tryNotify()
 {
+    // 多个线程同时搜索，只需要其中一个推送
+    if (!notifyMutex.tryLock())
+        return;
+
     int cur = notifyTimer.elapsed();
     if (hasItem() && (cur - lastEmit) > kEmitInterval) {
         lastEmit = cur;
         fmDebug() << "IteratorSearcher unearthed, current spend:" << cur;
         emit unearthed(this);
     }
+    notifyMutex.unlock();
 }
 
 void IteratorSearcher::doSearch()
@@ -86,7 +133,7 @@ void IteratorSearcher::doSearch()
 
         // 仅在过滤目录下进行搜索时，过滤目录下的内容才能被检索
         if (dfmbase::FileUtils::isLocalFile(url)) {
-            QRegularExpression reg(kFilterFolders);
+            const auto &reg = filterFoldersRegex();
             const auto &searchRootPath = searchUrl.toLocalFile();
             const auto &filePath = url.toLocalFile();
             if (!reg.match(searchRootPath).hasMatch() && reg.match(filePath).hasMatch())
@@ -106,17 +153,18 @@ void IteratorSearcher::doSearch()
             // 将目录添加到待搜索目录中
             if (info->isAttributes(OptInfoType::kIsDir) && !info->isAttributes(OptInfoType::kIsSymLink)) {
                 const auto &fileUrl = info->urlOf(UrlInfoType::kUrl);
-                if (!searchPathList.contains(fileUrl) || !fileUrl.path().startsWith("/sys/"))
+                if (!searchedPathSet.contains(fileUrl) || !fileUrl.path().startsWith("/sys/")) {
                     searchPathList << fileUrl;
+                    searchedPathSet << fileUrl;
+                }
             }
 
-            QRegularExpressionMatch match = regex.match(info->displayOf(DisPlayInfoType::kFileDisplayName));
-            if (match.hasMatch()) {
+            if (matchName(info->displayOf(DisPlayInfoType::kFileDisplayName))) {
                 const auto &fileUrl = info->urlOf(UrlInfoType::kUrl);
                 {
                     info->updateAttributes();
                     QMutexLocker lk(&mutex);
-                    allResults << fileUrl;                   
+                    allResults << fileUrl;
                 }
 
                 //推送
@@ -127,3 +175,133 @@ void IteratorSearcher::doSearch()
         iterator.clear();
     }
 }
+
+void IteratorSearcher::doLocalSearch()
+{
+    searchRootFiltered = filterFoldersRegex().match(searchUrl.toLocalFile()).hasMatch();
+    localDirQueue.clear();
+    localDirQueue.enqueue(QFile::encodeName(searchUrl.toLocalFile()));
+    busyWorkers = 0;
+
+    // 当前线程也参与搜索
+    const int threadCount = qBound(2, QThread::idealThreadCount(), 8);
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount - 1);
+    for (int i = 0; i < threadCount - 1; ++i)
+        QtConcurrent::run(&pool, [this]() { localSearchWorker(); });
+
+    localSearchWorker();
+    pool.waitForDone();
+}
+
+void IteratorSearcher::localSearchWorker()
+{
+    QByteArray dirPath;
+    QList<QByteArray> subDirs;
+    forever {
+        {
+            QMutexLocker lk(&dirQueueMutex);
+            // 上一个目录遍历完成，把它的子目录放入队列
+            if (!dirPath.isEmpty()) {
+                --busyWorkers;
+                for (const auto &dir : subDirs)
+                    localDirQueue.enqueue(dir);
+                if (!subDirs.isEmpty() || busyWorkers == 0)
+                    dirQueueCond.wakeAll();
+                subDirs.clear();
+            }
+
+            // 队列为空并且没有线程在遍历时，搜索结束
+            while (localDirQueue.isEmpty() && busyWorkers > 0 && status.loadAcquire() == kRuning)
+                dirQueueCond.wait(&dirQueueMutex);
+
+            if (localDirQueue.isEmpty() || status.loadAcquire() != kRuning) {
+                dirQueueCond.wakeAll();
+                return;
+            }
+
+            dirPath = localDirQueue.dequeue();
+            ++busyWorkers;
+        }
+
+        searchLocalDir(dirPath, &subDirs);
+    }
+}
+
+void IteratorSearcher::searchLocalDir(const QByteArray &dirPath, QList<QByteArray> *subDirs)
+{
+    // 仅在过滤目录下进行搜索时，过滤目录下的内容才能被检索
+    if (!searchRootFiltered && filterFoldersRegex().match(QFile::decodeName(dirPath)).hasMatch())
+        return;
+
+    DIR *dir = opendir(dirPath.constData());
+    if (!dir)
+        return;
+
+    const QByteArray &prefix = dirPath.endsWith('/') ? dirPath : dirPath + '/';
+    while (struct dirent *entry = readdir(dir)) {
+        //中断
+        if (status.loadAcquire() != kRuning)
+            break;
+
+        // 与原来的遍历保持一致，不搜索隐藏文件
+        if (entry->d_name[0] == '.')
+            continue;
+
+        const QByteArray &path = prefix + entry->d_name;
+        unsigned char type = entry->d_type;
+        if (type == DT_UNKNOWN) {
+            struct stat st;
+            if (lstat(path.constData(), &st) != 0)
+                continue;
+            type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISLNK(st.st_mode) ? DT_LNK : DT_REG);
+        }
+
+        // 将目录添加到待搜索目录中，不进入链接目录
+        if (type == DT_DIR)
+            subDirs->append(path);
+
+        const QString &name = QFile::decodeName(entry->d_name);
+        const bool isDesktopFile = name.endsWith(".desktop");
+        if (!isDesktopFile && !matchName(name))
+            continue;
+
+        // 失效的链接不显示
+        struct stat st;
+        if (type == DT_LNK && stat(path.constData(), &st) != 0)
+            continue;
+
+        const QUrl &url = QUrl::fromLocalFile(QFile::decodeName(path));
+        auto info = InfoFactory::create<FileInfo>(url);
+        if (!info)
+            continue;
+
+        // desktop文件的显示名称与文件名不同，使用显示名称匹配
+        if (isDesktopFile && !matchName(info->displayOf(DisPlayInfoType::kFileDisplayName)))
+            continue;
+
+        info->updateAttributes();
+        addResult(url);
+    }
+
+    closedir(dir);
+}
+
+bool IteratorSearcher::matchName(const QString &name) const
+{
+    if (!literalKey.isEmpty() && !name.contains(literalKey, Qt::CaseInsensitive))
+        return false;
+
+    return literalOnly || regex.match(name).hasMatch();
+}
+
+void IteratorSearcher::addResult(const QUrl &url)
+{
+    {
+        QMutexLocker lk(&mutex);
+        allResults << url;
+    }
+
+    //推送
+    tryNotify();
+}
@@ -9,7 +9,10 @@
 
 #include <QTime>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QRegularExpression>
+#include <QQueue>
+#include <QSet>
 
 DPSEARCH_BEGIN_NAMESPACE
 
@@ -29,14 +32,32 @@ private:
     void tryNotify();
     void doSearch();
 
+    // 本地目录多线程遍历，只读取文件名，命中后才查询文件信息
+    void doLocalSearch();
+    void localSearchWorker();
+    void searchLocalDir(const QByteArray &dirPath, QList<QByteArray> *subDirs);
+    bool matchName(const QString &name) const;
+    void addResult(const QUrl &url);
+
 private:
     QAtomicInt status = kReady;
     QList<QUrl> allResults;
     mutable QMutex mutex;
     QList<QUrl> searchPathList;
+    QSet<QUrl> searchedPathSet;
     QRegularExpression regex;
+    QString literalKey;   // 关键字中必须出现的字面字符串，用于在正则匹配前快速过滤
+    bool literalOnly { false };   // 关键字没有通配符，只需要字面匹配
+
+    // 本地遍历的待搜索目录队列
+    QMutex dirQueueMutex;
+    QWaitCondition dirQueueCond;
+    QQueue<QByteArray> localDirQueue;
+    int busyWorkers { 0 };
+    bool searchRootFiltered { false };
 
     //计时
+    QMutex notifyMutex;
     QTime notifyTimer;
     int lastEmit = 0;
 };
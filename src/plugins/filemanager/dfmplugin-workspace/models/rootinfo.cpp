@@ -34,7 +34,11 @@ RootInfo::~RootInfo()
     disconnect();
     if (watcher)
         watcher->stopWatcher();
-    cancelWatcherEvent = true;
+    {
+        QMutexLocker lk(&watcherEventMutex);
+        cancelWatcherEvent = true;
+        watcherEventCondition.wakeAll();
+    }
     for (auto &future : watcherEventFutures) {
         future.waitForFinished();
     }
@@ -185,7 +189,7 @@ void RootInfo::reset()
 
 void RootInfo::doFileDeleted(const QUrl &url)
 {
-    enqueueEvent(QPair<QUrl, EventType>(url, kRmFile));
+    enqueueEvent(QPair<QUrl, EventType>(url, EventType::kRmFile));
     metaObject()->invokeMethod(this, QT_STRINGIFY(doThreadWatcherEvent), Qt::QueuedConnection);
 }
 
@@ -203,118 +207,98 @@ void RootInfo::dofileMoved(const QUrl &fromUrl, const QUrl &toUrl)
 
 void RootInfo::dofileCreated(const QUrl &url)
 {
-    enqueueEvent(QPair<QUrl, EventType>(url, kAddFile));
+    enqueueEvent(QPair<QUrl, EventType>(url, EventType::kAddFile));
     metaObject()->invokeMethod(this, QT_STRINGIFY(doThreadWatcherEvent), Qt::QueuedConnection);
 }
 
 void RootInfo::doFileUpdated(const QUrl &url)
 {
-    enqueueEvent(QPair<QUrl, EventType>(url, kUpdateFile));
+    enqueueEvent(QPair<QUrl, EventType>(url, EventType::kUpdateFile));
     metaObject()->invokeMethod(this, QT_STRINGIFY(doThreadWatcherEvent), Qt::QueuedConnection);
 }
 
+/*!
+ * \brief 处理监视器事件，同一个url的事件合并为最终状态后分批提交
+ * 队列为空时在条件变量上等待新事件，空闲一段时间后退出
+ */
 void RootInfo::doWatcherEvent()
 {
     if (processFileEventRuning)
         return;
 
     processFileEventRuning = true;
+    WatcherEventCoalescer coalescer;
     QElapsedTimer timer;
     timer.start();
-    QList<QUrl> adds, updates, removes;
-    qint64 oldtime = 0;
-    int emptyLoopCount = 0;
-    while (checkFileEventQueue() || timer.elapsed() < 200) {
-        //检查超时，重新设置起始时间
-        if (timer.elapsed() - oldtime >= 200) {
-            // 处理添加文件
-            if (!adds.isEmpty())
-                addChildren(adds);
-            if (!updates.isEmpty())
-                updateChildren(updates); 
-            if (!removes.isEmpty())
-                removeChildren(removes);
-
-            adds.clear();
-            updates.clear();
-            removes.clear();
-
-            oldtime = timer.elapsed();
-        }
-
-        if (cancelWatcherEvent)
-            return;
-
-        if (!checkFileEventQueue()) {
-            if (emptyLoopCount >= 5)
-                break;
+    bool rootRemoved = false;
+    while (!rootRemoved) {
+        const auto &events = takeEvents();
+        for (const auto &event : events) {
+            if (cancelWatcherEvent)
+                return;
+
+            const QUrl &fileUrl = event.first;
+            if (!fileUrl.isValid())
+                continue;
 
-            QThread::msleep(20);
-            if (adds.isEmpty() && updates.isEmpty() && removes.isEmpty())
-                oldtime = timer.elapsed();
+            if (UniversalUtils::urlEquals(fileUrl, url)) {
+                if (event.second == EventType::kAddFile)
+                    continue;
+                else if (event.second == EventType::kRmFile) {
+                    emit InfoCacheController::instance().removeCacheFileInfo({ fileUrl });
+                    WatcherCache::instance().removeCacheWatcherByParent(fileUrl);
+                    emit requestCloseTab(fileUrl);
+                    emit requestClearRoot(fileUrl);
+                    QWriteLocker lk(&childrenLock);
+                    childrenUrlList.clear();
+                    sourceDataList.clear();
+                    rootRemoved = true;
+                    break;
+                }
+            }
 
-            ++emptyLoopCount;
-            continue;
+            coalescer.push(fileUrl, event.second);
         }
 
-        emptyLoopCount = 0;
-        QPair<QUrl, EventType> event = dequeueEvent();
-        const QUrl &fileUrl = event.first;
-
         if (cancelWatcherEvent)
             return;
+        if (rootRemoved)
+            break;
 
-        if (!fileUrl.isValid())
-            continue;
-
-        if (UniversalUtils::urlEquals(fileUrl, url)) {
-            if (event.second == kAddFile)
-                continue;
-            else if (event.second == kRmFile) {
-                emit InfoCacheController::instance().removeCacheFileInfo({ fileUrl });
-                WatcherCache::instance().removeCacheWatcherByParent(fileUrl);
-                emit requestCloseTab(fileUrl);
-                emit requestClearRoot(fileUrl);
-                QWriteLocker lk(&childrenLock);
-                childrenUrlList.clear();
-                sourceDataList.clear();
-                break;
-            }
+        if (!coalescer.isEmpty() && timer.elapsed() >= coalescer.batchWindow()) {
+            commitWatcherEvents(coalescer.take());
+            timer.restart();
         }
 
-        if (cancelWatcherEvent)
-            return;
-
-        if (event.second == kAddFile) {
-            // 判断update和remove中是否存在存在就移除
-            updates.removeOne(fileUrl);
-            removes.removeOne(fileUrl);
-            if (adds.contains(fileUrl))
-                continue;
+        QMutexLocker lk(&watcherEventMutex);
+        if (!watcherEvent.isEmpty() || cancelWatcherEvent)
+            continue;
 
-            adds.append(fileUrl);
-        } else if (event.second == kUpdateFile) {
-            // 如果在增加或者移除中就不添加
-            if (adds.contains(fileUrl) || removes.contains(fileUrl) || updates.contains(fileUrl))
-                continue;
-            updates.append(fileUrl);
+        if (coalescer.isEmpty()) {
+            // 没有待处理的事件，空闲超时后退出，新的事件会重新启动处理
+            watcherEventCondition.wait(&watcherEventMutex, WatcherEventCoalescer::kMaxBatchWindow);
+            if (watcherEvent.isEmpty() && !cancelWatcherEvent) {
+                processFileEventRuning = false;
+                return;
+            }
         } else {
-            adds.removeOne(fileUrl);
-            updates.removeOne(fileUrl);
-            if (removes.contains(fileUrl))
-                continue;
-            removes.append(fileUrl);
+            watcherEventCondition.wait(&watcherEventMutex,
+                                       static_cast<unsigned long>(qMax<qint64>(1, coalescer.batchWindow() - timer.elapsed())));
         }
     }
     processFileEventRuning = false;
 
-    // 处理添加文件
-    if (!removes.isEmpty())
-        removeChildren(removes);
-    if (!adds.isEmpty())
-        addChildren(adds);
-    if (!updates.isEmpty())
-        updateChildren(updates);
+    commitWatcherEvents(coalescer.take());
+}
+
+void RootInfo::commitWatcherEvents(const WatcherEventCoalescer::Batch &batch)
+{
+    if (!batch.removes.isEmpty())
+        removeChildren(batch.removes);
+    if (!batch.adds.isEmpty())
+        addChildren(batch.adds);
+    if (!batch.updates.isEmpty())
+        updateChildren(batch.updates);
 }
 
 void RootInfo::doThreadWatcherEvent()
@@ -457,6 +441,11 @@ void RootInfo::addChildren(const QList<SortInfoPointer> &children)
             continue;
 
         QWriteLocker lk(&childrenLock);
+        int index = childrenUrlList.indexOf(file->fileUrl());
+        if (index >= 0) {
+            sourceDataList.replace(index, file);
+            continue;
+        }
         childrenUrlList.append(file->fileUrl());
         sourceDataList.append(file);
     }
@@ -476,8 +465,9 @@ SortInfoPointer RootInfo::addChild(const FileInfoPointer &child)
 
     {
         QWriteLocker lk(&childrenLock);
-        if (childrenUrlList.contains(childUrl)) {
-            sourceDataList.replace(childrenUrlList.indexOf(childUrl), sort);
+        int index = childrenUrlList.indexOf(childUrl);
+        if (index >= 0) {
+            sourceDataList.replace(index, sort);
             return sort;
         }
         childrenUrlList.append(childUrl);
@@ -522,7 +512,7 @@ void RootInfo::removeChildren(const QList<QUrl> &urlList)
         removeUrls.append(realUrl);
         QWriteLocker lk(&childrenLock);
         childIndex = childrenUrlList.indexOf(realUrl);
-        if (childIndex < 0 || childIndex >= childrenUrlList.length()) {
+        if (childIndex < 0 || childIndex >= childrenUrlList.count()) {
             removeChildren.append(sortFileInfo(child));
             continue;
         }
@@ -557,12 +547,13 @@ SortInfoPointer RootInfo::updateChild(const QUrl &url)
     auto realUrl = info->urlOf(UrlInfoType::kUrl);
 
     QWriteLocker lk(&childrenLock);
-    if (!childrenUrlList.contains(realUrl))
+    int index = childrenUrlList.indexOf(realUrl);
+    if (index < 0)
         return nullptr;
     sort = sortFileInfo(info);
     if (sort.isNull())
         return nullptr;
-    sourceDataList.replace(childrenUrlList.indexOf(realUrl), sort);
+    sourceDataList.replace(index, sort);
 
     // NOTE: GlobalEventType::kHideFiles event is watched in fileview, but this can be used to notify update view
     // when the file is modified in other way.
@@ -585,16 +576,11 @@ void RootInfo::updateChildren(const QList<QUrl> &urls)
     emit watcherUpdateFiles(updates);
 }
 
-bool RootInfo::checkFileEventQueue()
-{
-    QMutexLocker lk(&watcherEventMutex);
-    return !watcherEvent.isEmpty();
-}
-
 void RootInfo::enqueueEvent(const QPair<QUrl, EventType> &e)
 {
     QMutexLocker lk(&watcherEventMutex);
     watcherEvent.enqueue(e);
+    watcherEventCondition.wakeAll();
 }
 
 QPair<QUrl, RootInfo::EventType> RootInfo::dequeueEvent()
@@ -606,6 +592,14 @@ QPair<QUrl, RootInfo::EventType> RootInfo::dequeueEvent()
     return QPair<QUrl, RootInfo::EventType>();
 }
 
+QQueue<QPair<QUrl, RootInfo::EventType>> RootInfo::takeEvents()
+{
+    QQueue<QPair<QUrl, EventType>> events;
+    QMutexLocker lk(&watcherEventMutex);
+    events.swap(watcherEvent);
+    return events;
+}
+
 // When monitoring the mtp directory, the monitor monitors that the scheme of the
 // url used for adding and deleting files is mtp (mtp://path).
 // Here, the monitor's url is used to re-complete the current url
@@ -7,6 +7,8 @@
 
 #include "dfmplugin_workspace_global.h"
 #include "utils/traversaldirthreadmanager.h"
+#include "utils/indexedorderlist.h"
+#include "utils/watchereventcoalescer.h"
 
 #include <dfm-base/dfm_base_global.h>
 #include <dfm-base/utils/traversaldirthread.h>
@@ -15,6 +17,7 @@
 #include <QReadWriteLock>
 #include <QQueue>
 #include <QFuture>
+#include <QWaitCondition>
 
 namespace dfmplugin_workspace {
 
@@ -23,11 +26,7 @@ class RootInfo : public QObject
 {
     Q_OBJECT
 
-    enum EventType {
-        kAddFile,
-        kUpdateFile,
-        kRmFile
-    };
+    using EventType = WatcherEventCoalescer::EventType;
 
 public:
     struct DirIteratorThread
@@ -119,10 +118,11 @@ private:
     bool containsChild(const QUrl &url);
     SortInfoPointer updateChild(const QUrl &url);
     void updateChildren(const QList<QUrl> &urls);
+    void commitWatcherEvents(const WatcherEventCoalescer::Batch &batch);
 
-    bool checkFileEventQueue();
     void enqueueEvent(const QPair<QUrl, EventType> &e);
     QPair<QUrl, EventType> dequeueEvent();
+    QQueue<QPair<QUrl, EventType>> takeEvents();
     FileInfoPointer fileInfo(const QUrl &url);
 
 public:
@@ -137,7 +137,7 @@ private:
     std::atomic_bool traversaling { false };
 
     QReadWriteLock childrenLock;
-    QList<QUrl> childrenUrlList {};
+    IndexedOrderList<QUrl> childrenUrlList;
     QList<SortInfoPointer> sourceDataList {};
     // origin data sort information
     dfmio::DEnumerator::SortRoleCompareFlag originSortRole { dfmio::DEnumerator::SortRoleCompareFlag::kSortRoleCompareDefault };
@@ -150,6 +150,7 @@ private:
 
     QQueue<QPair<QUrl, EventType>> watcherEvent {};
     QMutex watcherEventMutex;
+    QWaitCondition watcherEventCondition;
     QAtomicInteger<bool> processFileEventRuning = false;
 
     QList<TraversalThreadPointer> discardedThread {};
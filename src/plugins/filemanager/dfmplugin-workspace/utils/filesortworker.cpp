@@ -10,12 +10,18 @@
 #include <dfm-base/utils/fileinfohelper.h>
 #include <dfm-base/base/standardpaths.h>
 #include <dfm-base/utils/universalutils.h>
+#include <dfm-base/utils/chinese2pinyin.h>
+#include <dfm-base/mimetype/dmimedatabase.h>
+#include <dfm-base/mimetype/mimetypecache.h>
 #include "workspacehelper.h"
 
 #include <dfm-io/dfmio_utils.h>
 
 #include <QStandardPaths>
 
+#include <algorithm>
+#include <limits>
+
 using namespace dfmplugin_workspace;
 using namespace dfmbase::Global;
 using namespace dfmio;
@@ -72,6 +78,8 @@ FileSortWorker::SortOpt FileSortWorker::setSortAgruments(const Qt::SortOrder ord
     }
 
     sortOrder = order;
+    if (opt == FileSortWorker::SortOpt::kSortOptOtherChanged)
+        sortKeys.clear();
     orgSortRole = sortRole;
     this->isMixDirAndFile = isMixDirAndFile;
     switch (sortRole) {
@@ -100,7 +108,7 @@ QUrl FileSortWorker::mapToIndex(int index)
 
     if (index < 0 || index >= visibleChildren.count())
         return QUrl();
-    return visibleChildren.at(index);
+    return urlIds.url(visibleChildren.at(index));
 }
 
 int FileSortWorker::childrenCount()
@@ -112,7 +120,12 @@ int FileSortWorker::childrenCount()
 FileItemDataPointer FileSortWorker::childData(const QUrl &url)
 {
     QReadLocker lk(&childrenDataLocker);
-    return childrenDataMap.value(url);
+    const auto id = urlIds.find(url);
+    const auto &data = childrenDataMap.value(id);
+    // 加锁前后id可能被回收并分配给其他文件，确认id仍然对应这个url
+    if (!data || urlIds.url(id) != url)
+        return nullptr;
+    return data;
 }
 
 void FileSortWorker::setRootData(const FileItemDataPointer data)
@@ -127,16 +140,16 @@ FileItemDataPointer FileSortWorker::rootData() const
 
 FileItemDataPointer FileSortWorker::childData(const int index)
 {
-    QUrl url;
+    quint32 id = UrlIdTable::kInvalidId;
     {
         QReadLocker lk(&locker);
         if (index < 0 || index >= visibleChildren.count())
             return nullptr;
-        url = visibleChildren.at(index);
+        id = visibleChildren.at(index);
     }
 
     QReadLocker lk(&childrenDataLocker);
-    return childrenDataMap.value(url);
+    return childrenDataMap.value(id);
 }
 
 void FileSortWorker::cancel()
@@ -148,13 +161,25 @@ void FileSortWorker::cancel()
 int FileSortWorker::getChildShowIndex(const QUrl &url)
 {
     QReadLocker lk(&locker);
-    return visibleChildren.indexOf(url);
+    const auto id = urlIds.find(url);
+    if (id == UrlIdTable::kInvalidId)
+        return -1;
+
+    const int index = visibleChildren.indexOf(id);
+    // 同childData，id可能已被回收给其他文件
+    if (index < 0 || urlIds.url(id) != url)
+        return -1;
+    return index;
 }
 
 QList<QUrl> FileSortWorker::getChildrenUrls()
 {
-    QReadLocker lk(&locker);
-    return visibleChildren;
+    QList<quint32> ids;
+    {
+        QReadLocker lk(&locker);
+        ids = visibleChildren.toList();
+    }
+    return urlIds.urls(ids);
 }
 
 QDir::Filters FileSortWorker::getFilters() const
@@ -238,7 +263,7 @@ void FileSortWorker::handleFilters(QDir::Filters filters)
 void FileSortWorker::HandleNameFilters(const QStringList &filters)
 {
     nameFilters = filters;
-    QHash<QUrl, FileItemDataPointer>::iterator itr = childrenDataMap.begin();
+    auto itr = childrenDataMap.begin();
     for (; itr != childrenDataMap.end(); ++itr) {
         checkNameFilters(itr.value());
     }
@@ -333,6 +358,7 @@ void FileSortWorker::handleWatcherRemoveChildren(const QList<SortInfoPointer> &c
     auto subChildren = this->children.take(parentUrl);
     auto subVisibleList = visibleTreeChildren.take(parentUrl);
     bool removed = false;
+    QList<quint32> removedIds;
     for (const auto &sortInfo : children) {
         if (isCanceled)
             return;
@@ -342,18 +368,23 @@ void FileSortWorker::handleWatcherRemoveChildren(const QList<SortInfoPointer> &c
 
         subChildren.remove(sortInfo->fileUrl());
         subVisibleList.removeOne(sortInfo->fileUrl());
+        const auto id = urlIds.find(sortInfo->fileUrl());
+        if (id == UrlIdTable::kInvalidId)
+            continue;
+        removedIds.append(id);
+        sortKeys.remove(id);
 
         {
             QWriteLocker lk(&childrenDataLocker);
-            childrenDataMap.remove(sortInfo->fileUrl());
+            childrenDataMap.remove(id);
         }
 
         int showIndex = -1;
         {
             QReadLocker lk(&locker);
-            if (!visibleChildren.contains(sortInfo->fileUrl()))
+            showIndex = visibleChildren.indexOf(id);
+            if (showIndex < 0)
                 continue;
-            showIndex = visibleChildren.indexOf(sortInfo->fileUrl());
         }
 
         Q_EMIT removeRows(showIndex, 1);
@@ -367,6 +398,7 @@ void FileSortWorker::handleWatcherRemoveChildren(const QList<SortInfoPointer> &c
         Q_EMIT removeFinish();
     this->children.insert(parentUrl, subChildren);
     visibleTreeChildren.insert(parentUrl, subVisibleList);
+    releaseIds(removedIds);
 }
 
 bool FileSortWorker::handleWatcherUpdateFile(const SortInfoPointer child)
@@ -487,12 +519,8 @@ bool FileSortWorker::handleUpdateFile(const QUrl &url)
         return false;
 
     bool childVisible = false;
-    int childIndex = -1;
-    {
-        QReadLocker lk(&locker);
-        childVisible = visibleChildren.contains(url);
-        childIndex = visibleChildren.indexOf(url);
-    }
+    int childIndex = getChildShowIndex(url);
+    childVisible = childIndex >= 0;
 
     if (childVisible) {
         if (!checkFilters(sortInfo, true)) {
@@ -552,7 +580,7 @@ bool FileSortWorker::handleUpdateFile(const QUrl &url)
         {
             QWriteLocker lk(&locker);
 
-            insertToList(visibleChildren, showIndex, sortInfo->fileUrl());
+            visibleChildren.insert(showIndex, urlIds.intern(sortInfo->fileUrl()));
         }
         added = true;
 
@@ -590,6 +618,7 @@ void FileSortWorker::handleRefresh()
     children.clear();
     visibleTreeChildren.clear();
     depthMap.clear();
+    sortKeys.clear();
 
     {
         QWriteLocker lk(&childrenDataLocker);
@@ -664,6 +693,8 @@ void FileSortWorker::handleSortByMimeType()
 {
     if (isCanceled)
         return;
+    // 文件信息已经转换完成，类型的显示名称可能发生了变化
+    sortKeys.clear();
     resortCurrent(false);
 }
 
@@ -745,7 +776,12 @@ bool FileSortWorker::handleAddChildren(const QString &key,
 
     // 获取相对于已有的新增加的文件
     QList<QUrl> newChildren;
-    childrenDataLastMap.clear();
+    if (!childrenDataLastMap.isEmpty()) {
+        // 刷新后没有再出现的文件
+        const auto lastIds = childrenDataLastMap.keys();
+        childrenDataLastMap.clear();
+        releaseIds(lastIds);
+    }
 
     auto parentUrl = parantUrl(children.first()->fileUrl());
     // 获取当前的插入的位置
@@ -850,7 +886,7 @@ void FileSortWorker::filterAndSortFiles(const QUrl &dir, const bool fileter, con
     if (istree)
         visibleList = sortAllTreeFilesByParent(dir, reverse);
     else {
-        visibleList = sortTreeFiles(visibleTreeChildren.contains(current) ? visibleTreeChildren[current] : visibleChildren, reverse);
+        visibleList = sortTreeFiles(visibleTreeChildren.contains(current) ? visibleTreeChildren[current] : getChildrenUrls(), reverse);
     }
 
     // 执行界面刷新  设置过滤，当前的目录是当前树的根目录，反序。所有的显示url都要改变
@@ -879,7 +915,7 @@ void FileSortWorker::resortCurrent(const bool reverse)
     if (istree)
         visibleList = sortAllTreeFilesByParent(current, reverse);
     else {
-        visibleList = sortTreeFiles(visibleTreeChildren.contains(current) ? visibleTreeChildren[current] : visibleChildren, reverse);
+        visibleList = sortTreeFiles(visibleTreeChildren.contains(current) ? visibleTreeChildren[current] : getChildrenUrls(), reverse);
     }
 
     resortVisibleChildren(visibleList);
@@ -1018,7 +1054,7 @@ bool FileSortWorker::addChild(const SortInfoPointer &sortInfo,
     Q_EMIT insertRows(showIndex, 1);
     {
         QWriteLocker lk(&locker);
-        insertToList(visibleChildren, showIndex, sortInfo->fileUrl());
+        visibleChildren.insert(showIndex, urlIds.intern(sortInfo->fileUrl()));
     }
 
     if (sort == AbstractSortFilter::SortScenarios::kSortScenariosWatcherAddFile)
@@ -1041,6 +1077,7 @@ bool FileSortWorker::sortInfoUpdateByFileInfo(const FileInfoPointer fileInfo)
     if (!sortInfo)
         return false;
 
+    sortKeys.remove(urlIds.find(url));
     sortInfo->setUrl(fileInfo->urlOf(UrlInfoType::kUrl));
     sortInfo->setSize(fileInfo->size());
     sortInfo->setFile(fileInfo->isAttributes(OptInfoType::kIsFile));
@@ -1092,10 +1129,9 @@ void FileSortWorker::switchListView()
     children.clear();
     children.insert(current, allShowChildren);
     // 移除fileitem
-    QWriteLocker lk(&childrenDataLocker);
-    for (const auto &url : removeChildren)
-        childrenDataMap.remove(url);
+    removeFileItems(removeChildren);
 
+    QWriteLocker lk(&childrenDataLocker);
     for (auto itemData : childrenDataMap)
         itemData->setExpanded(false);
 }
@@ -1120,7 +1156,7 @@ QList<QUrl> FileSortWorker::sortAllTreeFilesByParent(const QUrl &dir, const bool
 
             QList<QUrl> sortList {};
             if (visibleTreeChildren.isEmpty() && UniversalUtils::urlEquals(parent, current)) {
-                sortList = sortTreeFiles(visibleChildren, reverse);
+                sortList = sortTreeFiles(getChildrenUrls(), reverse);
             } else {
                 sortList = bSort ? sortTreeFiles(visibleTreeChildren.take(parent), reverse) : visibleTreeChildren.value(parent);
             }
@@ -1159,24 +1195,33 @@ QList<QUrl> FileSortWorker::sortTreeFiles(const QList<QUrl> &children, const boo
 
     QList<QUrl> sortList;
     int sortIndex = 0;
+    // 排序过程只使用id，排序完成后再转换成url
+    const auto &childIds = urlIds.intern(children);
+    QList<quint32> sortIds;
+    sortIds.reserve(childIds.count());
+    auto idAt = [&sortIds](int index) { return sortIds.at(index); };
+    // 先把排序键值一次性准备好，后续二分插入时只比较缓存的值
+    if (!reverse && !prepareSortKeys(childIds))
+        return {};
     QHash<QUrl, SortInfoPointer> sortInfos = reverse && !isMixDirAndFile ? this->children.value(parentUrl)
                                                                          : QHash<QUrl, SortInfoPointer>();
     bool firstFile = false;
-    for (const auto &url : children) {
+    for (int i = 0; i < childIds.count(); ++i) {
         if (isCanceled)
             return {};
         if (!reverse) {
-            sortIndex = insertSortList(url, sortList, AbstractSortFilter::SortScenarios::kSortScenariosNormal);
+            sortIndex = insertSortList(childIds.at(i), sortIds.count(), idAt, AbstractSortFilter::SortScenarios::kSortScenariosNormal);
         } else if (!firstFile && !isMixDirAndFile) {
-            auto sortInfo = sortInfos.value(url);
+            auto sortInfo = sortInfos.value(children.at(i));
             if (sortInfo && sortInfo->isFile()) {
                 firstFile = true;
-                sortIndex = sortList.count();
+                sortIndex = sortIds.count();
             }
         }
-        insertToList(sortList, sortIndex, url);
+        insertToList(sortIds, sortIndex, childIds.at(i));
     }
 
+    sortList = urlIds.urls(sortIds);
     if (sortList.isEmpty())
         return {};
 
@@ -1242,9 +1287,46 @@ void FileSortWorker::removeSubDir(const QUrl &dir)
 
 void FileSortWorker::removeFileItems(const QList<QUrl> &urls)
 {
-    QWriteLocker lk(&childrenDataLocker);
-    for (const auto &url : urls)
-        childrenDataMap.remove(url);
+    QList<quint32> ids;
+    ids.reserve(urls.count());
+    for (const auto &url : urls) {
+        const auto id = urlIds.find(url);
+        if (id != UrlIdTable::kInvalidId)
+            ids.append(id);
+    }
+
+    for (const auto id : ids)
+        sortKeys.remove(id);
+
+    {
+        QWriteLocker lk(&childrenDataLocker);
+        for (const auto id : ids)
+            childrenDataMap.remove(id);
+    }
+
+    releaseIds(ids);
+}
+
+void FileSortWorker::releaseIds(const QList<quint32> &ids)
+{
+    // 仍然被显示列表或者文件数据引用的id不能回收
+    QList<quint32> unused;
+    {
+        QReadLocker lk(&childrenDataLocker);
+        for (const auto id : ids) {
+            if (!childrenDataMap.contains(id) && !childrenDataLastMap.contains(id) && !sortKeys.contains(id))
+                unused.append(id);
+        }
+    }
+
+    {
+        QReadLocker lk(&locker);
+        unused.erase(std::remove_if(unused.begin(), unused.end(),
+                                    [this](quint32 id) { return visibleChildren.contains(id); }),
+                     unused.end());
+    }
+
+    urlIds.release(unused);
 }
 
 int8_t FileSortWorker::findDepth(const QUrl &parent)
@@ -1318,15 +1400,11 @@ void FileSortWorker::removeVisibleChildren(const int startPos, const int size)
         return;
     Q_EMIT removeRows(startPos, size);
     {
-        auto tmp = getChildrenUrls();
-        QList<QUrl> visibleList;
-        visibleList.append(tmp.mid(0, startPos));
-        visibleList.append(tmp.mid(startPos + size));
         if (isCanceled)
             return;
 
         QWriteLocker lk(&locker);
-        visibleChildren = visibleList;
+        visibleChildren.remove(startPos, size);
     }
 
     Q_EMIT removeFinish();
@@ -1345,21 +1423,27 @@ void FileSortWorker::createAndInsertItemData(const int8_t depth, const SortInfoP
 
     item->setDepth(depth);
 
-    if (!istree || !child->isDir()) {
-        QWriteLocker lk(&childrenDataLocker);
-        childrenDataMap.insert(child->fileUrl(), item);
-        return;
-    }
-
+    const auto id = urlIds.intern(child->fileUrl());
     QWriteLocker lk(&childrenDataLocker);
-    childrenDataMap.insert(child->fileUrl(), item);
+    childrenDataMap.insert(id, item);
 }
 
 int FileSortWorker::insertSortList(const QUrl &needNode, const QList<QUrl> &list,
                                    AbstractSortFilter::SortScenarios sort)
+{
+    if (list.isEmpty())
+        return 0;
+
+    // 二分查找只会访问log(n)个节点，按需转换成id
+    return insertSortList(urlIds.intern(needNode), list.count(),
+                          [this, &list](int index) { return urlIds.intern(list.at(index)); }, sort);
+}
+
+int FileSortWorker::insertSortList(const quint32 needNode, const int count, const std::function<quint32(int)> &idAt,
+                                   AbstractSortFilter::SortScenarios sort)
 {
     int begin = 0;
-    int end = list.count();
+    int end = count;
 
     if (end <= 0)
         return 0;
@@ -1367,11 +1451,11 @@ int FileSortWorker::insertSortList(const QUrl &needNode, const QList<QUrl> &list
     if (isCanceled)
         return 0;
 
-    if ((sortOrder == Qt::AscendingOrder) ^ !lessThan(needNode, list.first(), sort))
+    if ((sortOrder == Qt::AscendingOrder) ^ !lessThan(needNode, idAt(0), sort))
         return 0;
 
-    if ((sortOrder == Qt::AscendingOrder) ^ lessThan(needNode, list.last(), sort))
-        return list.count();
+    if ((sortOrder == Qt::AscendingOrder) ^ lessThan(needNode, idAt(count - 1), sort))
+        return count;
 
     int row = (begin + end) / 2;
 
@@ -1383,7 +1467,7 @@ int FileSortWorker::insertSortList(const QUrl &needNode, const QList<QUrl> &list
         if (begin == end)
             break;
 
-        const QUrl &node = list.at(row);
+        const quint32 node = idAt(row);
         if ((sortOrder == Qt::AscendingOrder) ^ lessThan(needNode, node, sort)) {
             begin = row;
             row = (end + begin + 1) / 2;
@@ -1399,7 +1483,146 @@ int FileSortWorker::insertSortList(const QUrl &needNode, const QList<QUrl> &list
 }
 
 // 左边比右边小返回true，
-bool FileSortWorker::lessThan(const QUrl &left, const QUrl &right, AbstractSortFilter::SortScenarios sort)
+bool FileSortWorker::lessThan(const quint32 left, const quint32 right, AbstractSortFilter::SortScenarios sort)
+{
+    if (isCanceled)
+        return false;
+
+    // 自定义了排序规则的，需要使用完整的文件信息进行比较
+    if (sortAndFilter)
+        return lessThanByInfo(left, right, sort);
+
+    // 先保证两个键值都已经缓存，再取引用，避免插入新键值时哈希表重排导致引用失效
+    sortKey(left);
+    const SortKey &rightKey = sortKey(right);
+    const SortKey &leftKey = sortKey(left);
+
+    if (!leftKey.isValid || !rightKey.isValid)
+        return false;
+
+    // The folder is fixed in the front position
+    if (!isMixDirAndFile)
+        if (leftKey.isDir ^ rightKey.isDir)
+            return (sortOrder == Qt::DescendingOrder) ^ leftKey.isDir;
+
+    if (isCanceled)
+        return false;
+
+    const bool isNumeric = leftKey.isNumeric && rightKey.isNumeric;
+    const bool isSame = isNumeric ? leftKey.number == rightKey.number : leftKey.text == rightKey.text;
+
+    // When the selected sort attribute value is the same, sort by file name
+    if (isSame)
+        return FileUtils::compareByStringEx(leftKey.displayName, rightKey.displayName);
+
+    if (isNumeric || orgSortRole == kItemFileSizeRole)
+        return leftKey.number < rightKey.number;
+
+    return FileUtils::compareByStringEx(leftKey.text, rightKey.text);
+}
+
+const FileSortWorker::SortKey &FileSortWorker::sortKey(const quint32 id)
+{
+    auto it = sortKeys.constFind(id);
+    if (it != sortKeys.constEnd())
+        return it.value();
+
+    const auto &item = childrenDataMap.value(id);
+    const FileInfoPointer info = item && item->fileInfo()
+            ? item->fileInfo()
+            : InfoFactory::create<FileInfo>(urlIds.url(id));
+
+    // 获取不到文件信息的不缓存，下次比较时重新获取
+    static const SortKey kInvalidKey;
+    if (!info)
+        return kInvalidKey;
+
+    return sortKeys.insert(id, makeSortKey(info)).value();
+}
+
+bool FileSortWorker::prepareSortKeys(const QList<quint32> &ids)
+{
+    sortKeys.reserve(sortKeys.size() + ids.count());
+    // 按类型排序时先批量识别本地文件的类型，识别结果进入共享的缓存，之后获取文件类型时直接命中
+    // 只能按扩展名识别的文件不读取内容，仍由 DMimeDatabase 单独处理
+    if (orgSortRole == kItemFileMimeTypeRole) {
+        QStringList paths;
+        for (const auto id : ids) {
+            const QUrl &url = urlIds.url(id);
+            if (sortKeys.contains(id) || !url.isLocalFile())
+                continue;
+            const QString &path = url.toLocalFile();
+            if (!DMimeDatabase::onlyMatchExtension(path))
+                paths.append(path);
+        }
+        MimeTypeCache::instance()->mimeTypesForFiles(paths);
+    }
+
+    // 按拼音排序时先只取显示名称，最后整列批量转换
+    deferPinyinKeys = orgSortRole == kItemFilePinyinNameRole;
+    QList<quint32> pinyinIds;
+    QStringList names;
+    for (const auto id : ids) {
+        if (isCanceled) {
+            deferPinyinKeys = false;
+            return false;
+        }
+
+        if (deferPinyinKeys && !sortKeys.contains(id)) {
+            const auto &key = sortKey(id);
+            if (key.isValid) {
+                pinyinIds.append(id);
+                names.append(key.text);
+            }
+            continue;
+        }
+        sortKey(id);
+    }
+    deferPinyinKeys = false;
+
+    const auto &pinyinNames = Pinyin::Chinese2Pinyin(names);
+    for (int i = 0; i < pinyinIds.count(); ++i)
+        sortKeys[pinyinIds.at(i)].text = pinyinNames.at(i);
+
+    return true;
+}
+
+FileSortWorker::SortKey FileSortWorker::makeSortKey(const FileInfoPointer &info)
+{
+    SortKey key;
+    key.isValid = true;
+    key.isDir = info->isAttributes(OptInfoType::kIsDir);
+    key.displayName = info->displayOf(DisPlayInfoType::kFileDisplayName);
+
+    switch (orgSortRole) {
+    case kItemFileLastModifiedRole: {
+        const QVariant &val = info->customData(orgSortRole);
+        if (val.isValid()) {
+            key.text = val.toString();
+            break;
+        }
+        // 按秒比较，与按格式化后的时间字符串比较的结果一致，无效的时间（显示为"-"）排在最后
+        auto lastModified = info->timeOf(TimeInfoType::kLastModified).value<QDateTime>();
+        key.isNumeric = true;
+        key.number = lastModified.isValid() ? lastModified.toSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+        break;
+    }
+    case kItemFileSizeRole:
+        key.text = data(info, orgSortRole).toString();
+        key.number = info->size();
+        break;
+    case kItemFilePinyinNameRole:
+        key.text = deferPinyinKeys ? key.displayName : data(info, orgSortRole).toString();
+        break;
+    default:
+        key.text = data(info, orgSortRole).toString();
+        break;
+    }
+
+    return key;
+}
+
+bool FileSortWorker::lessThanByInfo(const quint32 left, const quint32 right, AbstractSortFilter::SortScenarios sort)
 {
     if (isCanceled)
         return false;
@@ -1409,10 +1632,10 @@ bool FileSortWorker::lessThan(const QUrl &left, const QUrl &right, AbstractSortF
 
     const FileInfoPointer leftInfo = leftItem && leftItem->fileInfo()
             ? leftItem->fileInfo()
-            : InfoFactory::create<FileInfo>(left);
+            : InfoFactory::create<FileInfo>(urlIds.url(left));
     const FileInfoPointer rightInfo = rightItem && rightItem->fileInfo()
             ? rightItem->fileInfo()
-            : InfoFactory::create<FileInfo>(right);
+            : InfoFactory::create<FileInfo>(urlIds.url(right));
 
     if (!leftInfo)
         return false;
@@ -1663,7 +1886,7 @@ int8_t FileSortWorker::getDepth(const QUrl &url)
 
 int FileSortWorker::findRealShowIndex(const QUrl &preItemUrl)
 {
-    const FileItemDataPointer &preItemPtr = childrenDataMap.value(preItemUrl, nullptr);
+    const FileItemDataPointer &preItemPtr = childrenDataMap.value(urlIds.find(preItemUrl), nullptr);
     if (!preItemPtr || !preItemPtr->data(Global::ItemRoles::kItemTreeViewExpandedRole).toBool())
         return indexOfVisibleChild(preItemUrl) + 1;
 
@@ -1677,33 +1900,25 @@ int FileSortWorker::findRealShowIndex(const QUrl &preItemUrl)
 
 int FileSortWorker::indexOfVisibleChild(const QUrl &itemUrl)
 {
-    QReadLocker lk(&locker);
-    return visibleChildren.indexOf(itemUrl);
+    return getChildShowIndex(itemUrl);
 }
 
 int FileSortWorker::setVisibleChildren(const int startPos, const QList<QUrl> &filterUrls, const FileSortWorker::InsertOpt opt, const int endPos)
 {
-    QList<QUrl> visibleList;
-    if (opt == InsertOpt::kInsertOptForce) {
-        visibleList = filterUrls;
-    } else {
-        auto tmp = getChildrenUrls();
-        visibleList.append(tmp.mid(0, startPos));
-        visibleList.append(filterUrls);
-        if (opt == InsertOpt::kInsertOptReplace) {
-            visibleList.append(tmp.mid(endPos != -1 ? endPos : startPos + filterUrls.length()));
-        } else if (opt == InsertOpt::kInsertOptAppend) {
-            visibleList.append(tmp.mid(startPos));
-        }
-    }
-
+    const auto &filterIds = urlIds.intern(filterUrls);
     if (isCanceled)
         return -1;
 
     QWriteLocker lk(&locker);
-    visibleChildren = visibleList;
+    if (opt == InsertOpt::kInsertOptForce) {
+        visibleChildren.reset(filterIds);
+    } else if (opt == InsertOpt::kInsertOptReplace) {
+        visibleChildren.replace(startPos, endPos != -1 ? endPos : startPos + filterIds.length(), filterIds);
+    } else {
+        visibleChildren.replace(startPos, startPos, filterIds);
+    }
 
-    return visibleList.length();
+    return visibleChildren.count();
 }
 
 bool FileSortWorker::checkAndUpdateFileInfoUpdate()
@@ -7,6 +7,8 @@
 
 #include "dfmplugin_workspace_global.h"
 #include "models/fileitemdata.h"
+#include "utils/indexedorderlist.h"
+#include "utils/urlidtable.h"
 #include <dfm-base/dfm_global_defines.h>
 #include <dfm-base/interfaces/fileinfo.h>
 #include <dfm-base/interfaces/abstractsortfilter.h>
@@ -21,6 +23,8 @@
 #include <QReadWriteLock>
 #include <QMultiMap>
 
+#include <functional>
+
 using namespace dfmbase;
 namespace dfmplugin_workspace {
 class FileSortWorker : public QObject
@@ -38,6 +42,17 @@ class FileSortWorker : public QObject
         kInsertOptForce = 2,
     };
 
+    // 排序用的预计算键值，每个文件在当前排序规则下只计算一次，避免每次比较都去构造QVariant和格式化字符串
+    struct SortKey
+    {
+        bool isValid { false };
+        bool isDir { false };
+        bool isNumeric { false };
+        qint64 number { 0 };
+        QString text;
+        QString displayName;
+    };
+
 public:
     explicit FileSortWorker(const QUrl &url,
                             const QString &key,
@@ -180,6 +195,7 @@ private:
     QList<QUrl> removeVisibleTreeChildren(const QUrl &parent);
     void removeSubDir(const QUrl &dir);
     void removeFileItems(const QList<QUrl> &urls);
+    void releaseIds(const QList<quint32> &ids);
     int8_t findDepth(const QUrl &parent);
     int findEndPos(const QUrl &dir);
     int findStartPos(const QUrl &parent);
@@ -194,7 +210,13 @@ private:
 private:
     int insertSortList(const QUrl &needNode, const QList<QUrl> &list,
                        AbstractSortFilter::SortScenarios sort);
-    bool lessThan(const QUrl &left, const QUrl &right, AbstractSortFilter::SortScenarios sort);
+    int insertSortList(const quint32 needNode, const int count, const std::function<quint32(int)> &idAt,
+                       AbstractSortFilter::SortScenarios sort);
+    bool lessThan(const quint32 left, const quint32 right, AbstractSortFilter::SortScenarios sort);
+    bool lessThanByInfo(const quint32 left, const quint32 right, AbstractSortFilter::SortScenarios sort);
+    const SortKey &sortKey(const quint32 id);
+    SortKey makeSortKey(const FileInfoPointer &info);
+    bool prepareSortKeys(const QList<quint32> &ids);
     QVariant data(const FileInfoPointer &info, Global::ItemRoles role);
 
     bool checkFilters(const SortInfoPointer &sortInfo, const bool byInfo = false);
@@ -215,9 +237,13 @@ private:
     QDirIterator::IteratorFlags flags { QDirIterator::NoIteratorFlags };
     QHash<QUrl, QHash<QUrl, SortInfoPointer>> children {};
     QReadWriteLock childrenDataLocker;
-    QHash<QUrl, FileItemDataPointer> childrenDataMap {};
-    QHash<QUrl, FileItemDataPointer> childrenDataLastMap {};
-    QList<QUrl> visibleChildren {};
+    // 以下容器都以urlIds中的id作为键值，只在对外接口处转换成QUrl
+    UrlIdTable urlIds;
+    QHash<quint32, FileItemDataPointer> childrenDataMap {};
+    QHash<quint32, FileItemDataPointer> childrenDataLastMap {};
+    IndexedOrderList<quint32> visibleChildren;
+    QHash<quint32, SortKey> sortKeys {};
+    bool deferPinyinKeys { false };
     QReadWriteLock locker;
     AbstractSortFilterPointer sortAndFilter { nullptr };
     FileViewFilterCallback filterCallback { nullptr };
@@ -0,0 +1,281 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef INDEXEDORDERLIST_H
+#define INDEXEDORDERLIST_H
+
+#include "dfmplugin_workspace_global.h"
+
+#include <QList>
+#include <QHash>
+#include <QVector>
+
+#include <random>
+
+namespace dfmplugin_workspace {
+
+/*!
+ * \brief 有序列表，支持按位置插入、删除和按值查询位置，都是O(log n)
+ *
+ * 内部是一个按位置组织的treap（隐式键），每个节点记录子树大小和父节点，
+ * 另外用一个哈希表记录值到节点的映射，用于快速查询值所在的位置。
+ * 列表中的值不能重复。
+ * 这个类不是线程安全的，由使用者加锁。
+ */
+template<typename T>
+class IndexedOrderList
+{
+    struct Node
+    {
+        explicit Node(const T &v, quint32 p)
+            : value(v), priority(p) { }
+        T value;
+        quint32 priority { 0 };
+        int size { 1 };
+        Node *left { nullptr };
+        Node *right { nullptr };
+        Node *parent { nullptr };
+    };
+
+public:
+    IndexedOrderList() = default;
+    IndexedOrderList(const IndexedOrderList &) = delete;
+    IndexedOrderList &operator=(const IndexedOrderList &) = delete;
+    ~IndexedOrderList() { clear(); }
+
+    int count() const { return nodeSize(root); }
+    bool isEmpty() const { return root == nullptr; }
+    bool contains(const T &value) const { return nodes.contains(value); }
+
+    T at(int index) const
+    {
+        Node *node = nodeAt(index);
+        return node ? node->value : T();
+    }
+
+    int indexOf(const T &value) const
+    {
+        Node *node = nodes.value(value, nullptr);
+        if (!node)
+            return -1;
+
+        int index = nodeSize(node->left);
+        while (node->parent) {
+            if (node == node->parent->right)
+                index += nodeSize(node->parent->left) + 1;
+            node = node->parent;
+        }
+        return index;
+    }
+
+    // index小于0或者大于列表长度时追加到最后，与原来insertToList的行为一致
+    void insert(int index, const T &value) { insert(index, QList<T>() << value); }
+    void append(const T &value) { insert(count(), value); }
+
+    void insert(int index, const QList<T> &values)
+    {
+        if (values.isEmpty())
+            return;
+        if (index < 0 || index > count())
+            index = count();
+
+        Node *left = nullptr;
+        Node *right = nullptr;
+        split(root, index, left, right);
+        root = merge(merge(left, build(values)), right);
+        if (root)
+            root->parent = nullptr;
+    }
+
+    void removeAt(int index) { remove(index, 1); }
+
+    bool removeOne(const T &value)
+    {
+        int index = indexOf(value);
+        if (index < 0)
+            return false;
+        removeAt(index);
+        return true;
+    }
+
+    void remove(int index, int size)
+    {
+        if (index < 0 || index >= count() || size <= 0)
+            return;
+
+        Node *left = nullptr;
+        Node *middle = nullptr;
+        Node *right = nullptr;
+        split(root, index, left, right);
+        split(right, size, middle, right);
+        destroy(middle);
+        root = merge(left, right);
+        if (root)
+            root->parent = nullptr;
+    }
+
+    // 替换[start, end)之间的数据
+    void replace(int start, int end, const QList<T> &values)
+    {
+        start = qBound(0, start, count());
+        end = qBound(start, end, count());
+        remove(start, end - start);
+        insert(start, values);
+    }
+
+    void reset(const QList<T> &values)
+    {
+        clear();
+        root = build(values);
+    }
+
+    void clear()
+    {
+        destroy(root);
+        root = nullptr;
+        nodes.clear();
+    }
+
+    QList<T> toList() const
+    {
+        QList<T> list;
+        list.reserve(count());
+        QVector<Node *> stack;
+        Node *node = root;
+        while (node || !stack.isEmpty()) {
+            while (node) {
+                stack.append(node);
+                node = node->left;
+            }
+            node = stack.takeLast();
+            list.append(node->value);
+            node = node->right;
+        }
+        return list;
+    }
+
+private:
+    static int nodeSize(const Node *node) { return node ? node->size : 0; }
+
+    static void update(Node *node)
+    {
+        node->size = 1 + nodeSize(node->left) + nodeSize(node->right);
+        if (node->left)
+            node->left->parent = node;
+        if (node->right)
+            node->right->parent = node;
+    }
+
+    Node *nodeAt(int index) const
+    {
+        if (index < 0 || index >= count())
+            return nullptr;
+
+        Node *node = root;
+        while (node) {
+            int leftSize = nodeSize(node->left);
+            if (index == leftSize)
+                return node;
+            if (index < leftSize) {
+                node = node->left;
+            } else {
+                index -= leftSize + 1;
+                node = node->right;
+            }
+        }
+        return nullptr;
+    }
+
+    // 把前count个节点分到left，其他的分到right
+    static void split(Node *node, int count, Node *&left, Node *&right)
+    {
+        if (!node) {
+            left = right = nullptr;
+            return;
+        }
+
+        node->parent = nullptr;
+        if (nodeSize(node->left) < count) {
+            split(node->right, count - nodeSize(node->left) - 1, node->right, right);
+            left = node;
+        } else {
+            split(node->left, count, left, node->left);
+            right = node;
+        }
+        update(node);
+    }
+
+    static Node *merge(Node *left, Node *right)
+    {
+        if (!left || !right)
+            return left ? left : right;
+
+        if (left->priority > right->priority) {
+            left->right = merge(left->right, right);
+            update(left);
+            return left;
+        }
+
+        right->left = merge(left, right->left);
+        update(right);
+        return right;
+    }
+
+    // 按顺序构建树，使用栈维护最右链，O(n)
+    // 列表中的值必须唯一，已存在的值会被忽略，否则旧节点会留在树中而无法通过值找到
+    Node *build(const QList<T> &values)
+    {
+        QVector<Node *> rightSpine;
+        for (const auto &value : values) {
+            Q_ASSERT(!nodes.contains(value));
+            if (nodes.contains(value))
+                continue;
+
+            Node *node = new Node(value, generator());
+            nodes.insert(value, node);
+            Node *last = nullptr;
+            while (!rightSpine.isEmpty() && rightSpine.last()->priority < node->priority) {
+                last = rightSpine.takeLast();
+                update(last);
+            }
+            node->left = last;
+            if (!rightSpine.isEmpty())
+                rightSpine.last()->right = node;
+            rightSpine.append(node);
+        }
+
+        Node *top = rightSpine.isEmpty() ? nullptr : rightSpine.first();
+        while (!rightSpine.isEmpty())
+            update(rightSpine.takeLast());
+
+        return top;
+    }
+
+    void destroy(Node *node)
+    {
+        QVector<Node *> stack;
+        if (node)
+            stack.append(node);
+        while (!stack.isEmpty()) {
+            Node *cur = stack.takeLast();
+            if (cur->left)
+                stack.append(cur->left);
+            if (cur->right)
+                stack.append(cur->right);
+            auto it = nodes.find(cur->value);
+            if (it != nodes.end() && it.value() == cur)
+                nodes.erase(it);
+            delete cur;
+        }
+    }
+
+private:
+    Node *root { nullptr };
+    QHash<T, Node *> nodes;
+    std::minstd_rand generator { 20240101 };
+};
+
+}
+
+#endif   // INDEXEDORDERLIST_H
@@ -162,6 +162,7 @@ ElideTextLayout *ItemDelegateHelper::createTextLayout(const QString &name, QText
                                                       qreal lineHeight, int alignmentFlag, QPainter *painter)
 {
     ElideTextLayout *layout = new ElideTextLayout(name);
+    layout->setCacheEnabled(true);
 
     layout->setAttribute(ElideTextLayout::kWrapMode, wordWrap);
     layout->setAttribute(ElideTextLayout::kLineHeight, lineHeight);
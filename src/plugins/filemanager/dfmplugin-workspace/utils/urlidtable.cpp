@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "urlidtable.h"
+
+using namespace dfmplugin_workspace;
+
+quint32 UrlIdTable::intern(const QUrl &url)
+{
+    {
+        QReadLocker lk(&lock);
+        auto it = ids.constFind(url);
+        if (it != ids.constEnd())
+            return it.value();
+    }
+
+    QWriteLocker lk(&lock);
+    auto it = ids.constFind(url);
+    if (it != ids.constEnd())
+        return it.value();
+
+    return allocate(url);
+}
+
+QList<quint32> UrlIdTable::intern(const QList<QUrl> &urls)
+{
+    QList<quint32> result;
+    result.reserve(urls.count());
+
+    QWriteLocker lk(&lock);
+    for (const auto &url : urls) {
+        auto it = ids.constFind(url);
+        if (it != ids.constEnd()) {
+            result.append(it.value());
+            continue;
+        }
+        result.append(allocate(url));
+    }
+    return result;
+}
+
+void UrlIdTable::release(const QList<quint32> &idList)
+{
+    QWriteLocker lk(&lock);
+    for (const auto id : idList) {
+        if (id >= static_cast<quint32>(urlList.count()))
+            continue;
+
+        QUrl &url = urlList[static_cast<int>(id)];
+        if (url.isEmpty())
+            continue;
+
+        ids.remove(url);
+        url = QUrl();
+        freeIds.append(id);
+    }
+
+    // 全部回收后释放占用的空间
+    if (ids.isEmpty()) {
+        urlList.clear();
+        freeIds.clear();
+    }
+}
+
+void UrlIdTable::clear()
+{
+    QWriteLocker lk(&lock);
+    ids.clear();
+    urlList.clear();
+    freeIds.clear();
+}
+
+quint32 UrlIdTable::allocate(const QUrl &url)
+{
+    quint32 id = kInvalidId;
+    if (!freeIds.isEmpty()) {
+        id = freeIds.takeLast();
+        urlList[static_cast<int>(id)] = url;
+    } else {
+        id = static_cast<quint32>(urlList.count());
+        urlList.append(url);
+    }
+
+    ids.insert(url, id);
+    return id;
+}
+
+quint32 UrlIdTable::find(const QUrl &url) const
+{
+    QReadLocker lk(&lock);
+    return ids.value(url, kInvalidId);
+}
+
+QUrl UrlIdTable::url(const quint32 id) const
+{
+    QReadLocker lk(&lock);
+    if (id >= static_cast<quint32>(urlList.count()))
+        return QUrl();
+    return urlList.at(static_cast<int>(id));
+}
+
+QList<QUrl> UrlIdTable::urls(const QList<quint32> &idList) const
+{
+    QList<QUrl> result;
+    result.reserve(idList.count());
+
+    QReadLocker lk(&lock);
+    for (const auto id : idList)
+        result.append(id < static_cast<quint32>(urlList.count()) ? urlList.at(static_cast<int>(id)) : QUrl());
+    return result;
+}
+
+int UrlIdTable::count() const
+{
+    QReadLocker lk(&lock);
+    return ids.count();
+}
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef URLIDTABLE_H
+#define URLIDTABLE_H
+
+#include "dfmplugin_workspace_global.h"
+
+#include <QUrl>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+namespace dfmplugin_workspace {
+
+/*!
+ * \brief url驻留表，把url映射成稠密的32位id
+ *
+ * 排序线程内部用id作为键值，只在和model/view交互的时候才转换成QUrl，
+ * 避免每次哈希和比较都要重新计算QUrl的哈希值。
+ * 文件移除后通过 release 回收id，回收的id会重新分配给新的url，
+ * 调用者需保证回收时已经没有容器再引用这些id。
+ */
+class UrlIdTable
+{
+public:
+    static constexpr quint32 kInvalidId { 0xFFFFFFFF };
+
+    quint32 intern(const QUrl &url);
+    QList<quint32> intern(const QList<QUrl> &urls);
+    void release(const QList<quint32> &idList);
+    void clear();
+    quint32 find(const QUrl &url) const;
+    QUrl url(const quint32 id) const;
+    QList<QUrl> urls(const QList<quint32> &idList) const;
+    int count() const;
+
+private:
+    quint32 allocate(const QUrl &url);
+
+private:
+    mutable QReadWriteLock lock;
+    QHash<QUrl, quint32> ids;
+    QVector<QUrl> urlList;
+    QVector<quint32> freeIds;
+};
+
+}
+
+#endif   // URLIDTABLE_H
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "watchereventcoalescer.h"
+
+using namespace dfmplugin_workspace;
+
+// 一批超过这个数量认为处于事件风暴中
+static constexpr int kBurstEventCount { 64 };
+
+void WatcherEventCoalescer::push(const QUrl &url, EventType type)
+{
+    auto it = pending.find(url);
+    if (it == pending.end()) {
+        pending.insert(url, type);
+        order.append(url);
+        return;
+    }
+
+    // 如果在增加或者移除中就不更新
+    if (type == kUpdateFile)
+        return;
+
+    it.value() = type;
+}
+
+WatcherEventCoalescer::Batch WatcherEventCoalescer::take()
+{
+    Batch batch;
+    for (const auto &url : order) {
+        switch (pending.value(url)) {
+        case kAddFile:
+            batch.adds.append(url);
+            break;
+        case kUpdateFile:
+            batch.updates.append(url);
+            break;
+        case kRmFile:
+            batch.removes.append(url);
+            break;
+        }
+    }
+
+    window = pending.count() >= kBurstEventCount ? qMin(window * 2, kMaxBatchWindow) : kMinBatchWindow;
+    pending.clear();
+    order.clear();
+    return batch;
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WATCHEREVENTCOALESCER_H
+#define WATCHEREVENTCOALESCER_H
+
+#include "dfmplugin_workspace_global.h"
+
+#include <QUrl>
+#include <QHash>
+#include <QList>
+
+namespace dfmplugin_workspace {
+
+/*!
+ * \brief 合并文件监视器事件，每个url只保留最终状态
+ *
+ * 合并规则与原来RootInfo中的一致：
+ * 添加会覆盖之前的更新和删除；删除会覆盖之前的添加和更新；
+ * 已经有添加或删除的url再收到更新时忽略。
+ * 每个事件的处理是O(1)的，提交时按删除、添加、更新的顺序分批输出，
+ * 每批内部保持url第一次出现的顺序。
+ * 提交间隔根据事件量自适应：零星事件尽快提交，事件风暴时逐步放大间隔。
+ * 这个类不是线程安全的。
+ */
+class WatcherEventCoalescer
+{
+public:
+    enum EventType {
+        kAddFile,
+        kUpdateFile,
+        kRmFile
+    };
+
+    struct Batch
+    {
+        QList<QUrl> removes;
+        QList<QUrl> adds;
+        QList<QUrl> updates;
+    };
+
+    static constexpr int kMinBatchWindow { 20 };   // ms
+    static constexpr int kMaxBatchWindow { 200 };   // ms
+
+    void push(const QUrl &url, EventType type);
+    Batch take();
+
+    bool isEmpty() const { return pending.isEmpty(); }
+    int count() const { return pending.count(); }
+    int batchWindow() const { return window; }
+
+private:
+    QHash<QUrl, EventType> pending;
+    QList<QUrl> order;
+    int window { kMinBatchWindow };
+};
+
+}
+
+#endif   // WATCHEREVENTCOALESCER_H
@@ -2130,9 +2130,16 @@ void FileView::initializeScrollBarWatcher()
 
     connect(verticalScrollBar(), &QScrollBar::sliderPressed, this, [this] { d->scrollBarSliderPressed = true; });
     connect(verticalScrollBar(), &QScrollBar::sliderReleased, this, [this] { d->scrollBarSliderPressed = false; });
+    d->thumbnailJobTimer = new QTimer(this);
+    d->thumbnailJobTimer->setInterval(100);
+    d->thumbnailJobTimer->setSingleShot(true);
+
+    connect(d->thumbnailJobTimer, &QTimer::timeout, this, [this] { d->updateThumbnailJobs(); });
+
     connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this] {
         if (d->scrollBarSliderPressed)
             d->scrollBarValueChangedTimer->start();
+        d->thumbnailJobTimer->start();
     });
 }
 
@@ -22,6 +22,7 @@
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/base/configs/dconfig/dconfigmanager.h>
 #include <dfm-base/utils/viewdefines.h>
+#include <dfm-base/utils/thumbnail/thumbnailfactory.h>
 
 #include <QScrollBar>
 #include <QVBoxLayout>
@@ -285,3 +286,37 @@ void FileViewPrivate::updateHorizontalOffset()
         horizontalOffset = -(contentWidth - itemWidth * itemColumn) / 2;
     }
 }
+
+void FileViewPrivate::updateThumbnailJobs()
+{
+    QRect rect = q->viewport()->rect();
+    rect.moveTop(q->verticalOffset());
+
+    QList<QUrl> visibleUrls;
+    for (const auto &range : q->visibleIndexes(rect)) {
+        for (int i = range.first; i <= range.second; ++i) {
+            const QUrl &url = q->model()->data(q->model()->index(i, 0, q->rootIndex()), kItemUrlRole).toUrl();
+            if (url.isValid())
+                visibleUrls.append(url);
+        }
+    }
+
+    // 可见的文件优先生成缩略图
+    ThumbnailFactory::instance()->prioritizeThumbnailJobs(visibleUrls);
+
+    const QSet<QUrl> visibleSet(visibleUrls.begin(), visibleUrls.end());
+    QList<QUrl> hiddenUrls;
+    for (const auto &url : thumbnailVisibleUrls) {
+        if (!visibleSet.contains(url))
+            hiddenUrls.append(url);
+    }
+    thumbnailVisibleUrls = visibleUrls;
+
+    // 移出可见区域的任务被取消，清除标记，再次显示时重新加入任务
+    const auto &canceledUrls = ThumbnailFactory::instance()->cancelThumbnailJobs(hiddenUrls);
+    for (const auto &url : canceledUrls) {
+        const auto &info = q->model()->fileInfo(q->model()->getIndexByUrl(url));
+        if (info)
+            info->setExtendedAttributes(ExtInfoType::kFileThumbnail, QVariant());
+    }
+}
@@ -79,6 +79,9 @@ class FileViewPrivate
     QTimer *scrollBarValueChangedTimer { nullptr };
     bool scrollBarSliderPressed { false };
 
+    QTimer *thumbnailJobTimer { nullptr };
+    QList<QUrl> thumbnailVisibleUrls;
+
     bool pressedStartWithExpand { false };
     bool mouseLeftPressed { false };
     QPoint mouseLastPos { QPoint(0, 0) };
@@ -107,6 +110,7 @@ class FileViewPrivate
     QVariant fileViewStateValue(const QUrl &url, const QString &key, const QVariant &defalutValue);
 
     void updateHorizontalOffset();
+    void updateThumbnailJobs();
 };
 
 }
@@ -48,12 +48,12 @@ public:
     void setIndexCorrupted(bool corrupted);
 
 Q_SIGNALS:
-    void progressChanged(SERVICETEXTINDEX_NAMESPACE::IndexTask::Type type, qint64 count);
+    void progressChanged(SERVICETEXTINDEX_NAMESPACE::IndexTask::Type type, qint64 count, double throughput);
     void finished(SERVICETEXTINDEX_NAMESPACE::IndexTask::Type type, bool success);
 
 private:
     void doTask();
-    void onProgressChanged(qint64 count);
+    void onProgressChanged(qint64 count, double throughput);
 
     Type m_type;
     QString m_path;
@@ -7,6 +7,7 @@
 #include "progressnotifier.h"
 #include "utils/indextraverseutils.h"
 #include "utils/scopeguard.h"
+#include "utils/indexmanifest.h"
 
 #include <docparser.h>
 
@@ -24,6 +25,13 @@
 #include <QRegularExpression>
 #include <QStandardPaths>
 #include <QQueue>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QThread>
+#include <QRunnable>
 
 #include <dirent.h>
 #include <sys/types.h>
@@ -41,12 +49,13 @@ public:
     explicit ProgressReporter()
         : processedCount(0), lastReportTime(QDateTime::currentDateTime())
     {
+        elapsed.start();
     }
 
     ~ProgressReporter()
     {
         // 确保最后一次进度能够显示
-        emit ProgressNotifier::instance()->progressChanged(processedCount);
+        emit ProgressNotifier::instance()->progressChanged(processedCount, throughput());
     }
 
     void increment()
@@ -56,18 +65,26 @@ public:
         // 检查是否经过了足够的时间间隔(1秒)
         QDateTime now = QDateTime::currentDateTime();
         if (lastReportTime.msecsTo(now) >= 1000) {   // 1000ms = 1s
-            emit ProgressNotifier::instance()->progressChanged(processedCount);
+            emit ProgressNotifier::instance()->progressChanged(processedCount, throughput());
             lastReportTime = now;
         }
     }
 
 private:
+    // 每秒处理的文件数
+    double throughput() const
+    {
+        const qint64 ms = elapsed.elapsed();
+        return ms > 0 ? processedCount * 1000.0 / ms : 0;
+    }
+
     qint64 processedCount;
     QDateTime lastReportTime;
+    QElapsedTimer elapsed;
 };
 
 // 目录遍历相关函数
-using FileHandler = std::function<void(const QString &path)>;
+using FileHandler = std::function<void(const QString &path, const struct stat &st)>;
 
 // 常量定义
 static constexpr char kSupportFiles[] { "(rtf)|(odt)|(ods)|(odp)|(odg)|(docx)|(xlsx)|(pptx)|(ppsx)|(md)|"
@@ -99,10 +116,9 @@ DocumentPtr createFileDocument(const QString &file)
     return doc;
 }
 
-bool checkNeedUpdate(const QString &file, const IndexReaderPtr &reader, bool *needAdd)
+bool checkNeedUpdate(const QString &file, const SearcherPtr &searcher, bool *needAdd)
 {
     try {
-        SearcherPtr searcher = newLucene<IndexSearcher>(reader);
         TermQueryPtr query = newLucene<TermQuery>(newLucene<Term>(L"path", file.toStdWString()));
 
         TopDocsPtr topDocs = searcher->search(query, 1);
@@ -129,62 +145,140 @@ bool checkNeedUpdate(const QString &file, const IndexReaderPtr &reader, bool *ne
     }
 }
 
-bool isSupportedFile(const QString &path)
+bool isSupportedSuffix(const QString &path)
 {
-    QFileInfo fileInfo(path);
-    if (!fileInfo.exists() || !fileInfo.isFile())
+    const int dot = path.lastIndexOf('.');
+    if (dot < 0 || dot < path.lastIndexOf('/'))
         return false;
 
-    QString suffix = fileInfo.suffix().toLower();
     static const QRegularExpression suffixRegex(kSupportFiles);
-    return suffixRegex.match(suffix).hasMatch();
+    return suffixRegex.match(path.mid(dot + 1).toLower()).hasMatch();
 }
 
-void processFile(const QString &path, const IndexWriterPtr &writer, ProgressReporter *reporter)
+/*!
+ * \brief 并行提取文档内容，由调用线程统一写入IndexWriter
+ *
+ * DocParser::convertFile 比较耗时，放到线程池中并行执行；
+ * 提取完成的文档放入队列，调用 submit/finish 的线程取出后写入索引，
+ * 同时在队列中的文档数量有上限，避免内存占用过多。
+ */
+class DocumentPipeline
 {
-    try {
-        if (!isSupportedFile(path))
-            return;
-#ifdef QT_DEBUG
-        fmDebug() << "Adding [" << path << "]";
-#endif
-        writer->addDocument(createFileDocument(path));
-        if (reporter) {
-            reporter->increment();
+public:
+    enum class Action {
+        Add,
+        Update
+    };
+
+    DocumentPipeline(const IndexWriterPtr &writer, ProgressReporter *reporter, IndexManifest *manifest)
+        : writer(writer), reporter(reporter), manifest(manifest)
+    {
+        // 后台服务，只使用一半的核心
+        pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+        maxPending = pool.maxThreadCount() * 2;
+    }
+
+    ~DocumentPipeline()
+    {
+        finish();
+        pool.waitForDone();
+    }
+
+    void submit(const QString &path, const FileStamp &stamp, Action action)
+    {
+        {
+            QMutexLocker lk(&mutex);
+            while (pending >= maxPending && finished.isEmpty())
+                docReady.wait(&mutex);
+            ++pending;
         }
-    } catch (const std::exception &e) {
-        fmWarning() << "Process file failed:" << path << e.what();
+
+        pool.start(QRunnable::create([this, path, stamp, action]() {
+            Result result { path, stamp, action, nullptr };
+            try {
+                result.doc = createFileDocument(path);
+            } catch (const std::exception &e) {
+                fmWarning() << "Create document failed:" << path << e.what();
+            }
+
+            QMutexLocker lk(&mutex);
+            finished.enqueue(result);
+            docReady.wakeAll();
+        }));
+
+        writeFinished();
     }
-}
 
-void updateFile(const QString &path, const IndexReaderPtr &reader,
-                const IndexWriterPtr &writer, ProgressReporter *reporter)
-{
-    try {
-        if (!isSupportedFile(path))
-            return;
+    void finish()
+    {
+        forever {
+            {
+                QMutexLocker lk(&mutex);
+                if (pending == 0)
+                    return;
+                while (finished.isEmpty())
+                    docReady.wait(&mutex);
+            }
+            writeFinished();
+        }
+    }
 
-        bool needAdd = false;
-        if (checkNeedUpdate(path, reader, &needAdd)) {
-            if (needAdd) {
+private:
+    struct Result
+    {
+        QString path;
+        FileStamp stamp;
+        Action action;
+        DocumentPtr doc;
+    };
+
+    void writeFinished()
+    {
+        QQueue<Result> results;
+        {
+            QMutexLocker lk(&mutex);
+            results.swap(finished);
+        }
+
+        for (const auto &result : results) {
+            try {
+                if (result.doc) {
+                    if (result.action == Action::Add) {
 #ifdef QT_DEBUG
-                fmDebug() << "Adding [" << path << "]";
+                        fmDebug() << "Adding [" << result.path << "]";
 #endif
-                writer->addDocument(createFileDocument(path));
-            } else {
-                fmDebug() << "Updating file [" << path << "]";
-                TermPtr term = newLucene<Term>(L"path", path.toStdWString());
-                writer->updateDocument(term, createFileDocument(path));
+                        writer->addDocument(result.doc);
+                    } else {
+                        fmDebug() << "Updating file [" << result.path << "]";
+                        TermPtr term = newLucene<Term>(L"path", result.path.toStdWString());
+                        writer->updateDocument(term, result.doc);
+                    }
+                    if (manifest)
+                        manifest->insert(result.path, result.stamp);
+                }
+            } catch (const std::exception &e) {
+                fmWarning() << "Write document failed:" << result.path << e.what();
             }
-        }
 
-        if (reporter) {
-            reporter->increment();
+            if (reporter)
+                reporter->increment();
         }
-    } catch (const std::exception &e) {
-        fmWarning() << "Update file failed:" << path << e.what();
+
+        QMutexLocker lk(&mutex);
+        pending -= results.count();
     }
-}
+
+private:
+    IndexWriterPtr writer;
+    ProgressReporter *reporter { nullptr };
+    IndexManifest *manifest { nullptr };
+    QThreadPool pool;
+    QMutex mutex;
+    QWaitCondition docReady;
+    QQueue<Result> finished;
+    int pending { 0 };
+    int maxPending { 2 };
+};
 
 void traverseDirectoryCommon(const QString &rootPath, TaskState &state,
                              const FileHandler &fileHandler)
@@ -237,7 +331,7 @@ void traverseDirectoryCommon(const QString &rootPath, TaskState &state,
             // 对于普通文件，只检查路径有效性
             if (S_ISREG(st.st_mode)) {
                 if (IndexTraverseUtils::isValidFile(fullPath)) {
-                    fileHandler(fullPath);
+                    fileHandler(fullPath, st);
                 }
             }
             // 对于目录，加入队列（后续会检查是否访问过）
@@ -249,21 +343,73 @@ void traverseDirectoryCommon(const QString &rootPath, TaskState &state,
 }
 
 void traverseDirectory(const QString &rootPath, const IndexWriterPtr &writer,
-                       TaskState &running)
+                       TaskState &running, IndexManifest *manifest)
 {
     ProgressReporter reporter;
-    traverseDirectoryCommon(rootPath, running, [&](const QString &path) {
-        processFile(path, writer, &reporter);
+    DocumentPipeline pipeline(writer, &reporter, manifest);
+    traverseDirectoryCommon(rootPath, running, [&](const QString &path, const struct stat &st) {
+        if (isSupportedSuffix(path))
+            pipeline.submit(path, FileStamp::fromStat(st), DocumentPipeline::Action::Add);
     });
+    pipeline.finish();
 }
 
 void traverseForUpdate(const QString &rootPath, const IndexReaderPtr &reader,
-                       const IndexWriterPtr &writer, TaskState &running)
+                       const IndexWriterPtr &writer, TaskState &running, IndexManifest *manifest)
 {
     ProgressReporter reporter;
-    traverseDirectoryCommon(rootPath, running, [&](const QString &path) {
-        updateFile(path, reader, writer, &reporter);
+    DocumentPipeline pipeline(writer, &reporter, manifest);
+
+    // 有清单时只比较文件状态，没有清单（旧版本的索引）时查询索引中记录的修改时间
+    const bool hasManifest = manifest->isLoaded();
+    SearcherPtr searcher = hasManifest ? nullptr : newLucene<IndexSearcher>(reader);
+    QSet<QString> visitedFiles;
+
+    traverseDirectoryCommon(rootPath, running, [&](const QString &path, const struct stat &st) {
+        if (!isSupportedSuffix(path))
+            return;
+
+        visitedFiles.insert(path);
+        const FileStamp stamp = FileStamp::fromStat(st);
+        if (manifest->contains(path)) {
+            if (manifest->stamp(path) != stamp)
+                pipeline.submit(path, stamp, DocumentPipeline::Action::Update);
+            else
+                reporter.increment();
+            return;
+        }
+
+        // 不在清单中的文件也使用更新的方式写入，避免与索引中已有的文档重复
+        if (hasManifest) {
+            pipeline.submit(path, stamp, DocumentPipeline::Action::Update);
+            return;
+        }
+
+        bool needAdd = false;
+        if (checkNeedUpdate(path, searcher, &needAdd)) {
+            pipeline.submit(path, stamp, needAdd ? DocumentPipeline::Action::Add : DocumentPipeline::Action::Update);
+        } else {
+            manifest->insert(path, stamp);
+            reporter.increment();
+        }
     });
+    pipeline.finish();
+
+    // 遍历完整结束时，删除已经不存在的文件的索引
+    if (!running.isRunning() || !hasManifest)
+        return;
+
+    for (const QString &path : manifest->pathsUnder(rootPath)) {
+        if (visitedFiles.contains(path))
+            continue;
+        try {
+            fmDebug() << "Removing vanished file [" << path << "]";
+            writer->deleteDocuments(newLucene<Term>(L"path", path.toStdWString()));
+            manifest->remove(path);
+        } catch (const std::exception &e) {
+            fmWarning() << "Failed to remove index for path:" << path << e.what();
+        }
+    }
 }
 
 }   // namespace
@@ -274,6 +420,9 @@ TaskHandler TaskHandlers::CreateIndexHandler()
     return [](const QString &path, TaskState &running) -> bool {
         fmInfo() << "Creating index for path:" << path;
 
+        // 清单与索引必须一致，重建期间先删除旧的清单
+        IndexManifest::removeFile();
+
         QDir dir;
         if (!dir.exists(path)) {
             fmWarning() << "Source directory doesn't exist:" << path;
@@ -305,8 +454,9 @@ TaskHandler TaskHandlers::CreateIndexHandler()
 
             fmInfo() << "Indexing to directory:" << indexStorePath();
 
+            IndexManifest manifest;
             writer->deleteAll();
-            traverseDirectory(path, writer, running);
+            traverseDirectory(path, writer, running, &manifest);
 
             if (!running.isRunning()) {
                 fmInfo() << "Create index task was interrupted";
@@ -314,6 +464,9 @@ TaskHandler TaskHandlers::CreateIndexHandler()
             }
 
             writer->optimize();
+            writer->commit();
+            if (!manifest.save())
+                fmWarning() << "Failed to save index manifest:" << IndexManifest::manifestPath();
             return true;
         } catch (const LuceneException &e) {
             fmWarning() << "Create index failed with Lucene exception:"
@@ -359,14 +512,23 @@ TaskHandler TaskHandlers::UpdateIndexHandler()
                 }
             });
 
-            traverseForUpdate(path, reader, writer, running);
+            IndexManifest manifest;
+            if (!manifest.load())
+                fmInfo() << "No index manifest, compare with the modified time in index";
+
+            traverseForUpdate(path, reader, writer, running, &manifest);
+
+            // 增量更新不再执行optimize，合并段的工作交给IndexWriter的合并策略
+            writer->commit();
+            // 没有清单时，只有完整遍历后生成的清单才是可信的
+            if ((manifest.isLoaded() || running.isRunning()) && !manifest.save())
+                fmWarning() << "Failed to save index manifest:" << IndexManifest::manifestPath();
 
             if (!running.isRunning()) {
                 fmInfo() << "Update index task was interrupted";
                 return false;
             }
 
-            writer->optimize();
             return true;
         } catch (const LuceneException &e) {
             // Lucene异常表示索引损坏
@@ -406,6 +568,9 @@ TaskHandler TaskHandlers::RemoveIndexHandler()
             // 将路径列表字符串转换为QStringList
             QStringList paths = pathList.split("|", Qt::SkipEmptyParts);
 
+            IndexManifest manifest;
+            manifest.load();
+
             ProgressReporter reporter;
             for (const QString &path : paths) {
                 if (!running.isRunning())
@@ -415,6 +580,7 @@ TaskHandler TaskHandlers::RemoveIndexHandler()
                     fmDebug() << "Removing index for path:" << path;
                     TermPtr term = newLucene<Term>(L"path", path.toStdWString());
                     writer->deleteDocuments(term);
+                    manifest.remove(path);
                     reporter.increment();
                 } catch (const std::exception &e) {
                     fmWarning() << "Failed to remove index for path:" << path << e.what();
@@ -422,12 +588,15 @@ TaskHandler TaskHandlers::RemoveIndexHandler()
                 }
             }
 
+            writer->commit();
+            if (manifest.isLoaded() && !manifest.save())
+                fmWarning() << "Failed to save index manifest:" << IndexManifest::manifestPath();
+
             if (!running.isRunning()) {
                 fmInfo() << "Remove index task was interrupted";
                 return false;
             }
 
-            writer->optimize();
             return true;
         } catch (const LuceneException &e) {
             fmWarning() << "Remove index failed with Lucene exception:"
@@ -144,12 +144,12 @@ QString TaskManager::typeToString(IndexTask::Type type)
     }
 }
 
-void TaskManager::onTaskProgress(IndexTask::Type type, qint64 count)
+void TaskManager::onTaskProgress(IndexTask::Type type, qint64 count, double throughput)
 {
     if (!currentTask) return;
 
-    fmDebug() << "Task progress:" << type << count;
-    emit taskProgressChanged(typeToString(type), currentTask->taskPath(), count);
+    fmDebug() << "Task progress:" << type << count << throughput;
+    emit taskProgressChanged(typeToString(type), currentTask->taskPath(), count, throughput);
 }
 
 void TaskManager::onTaskFinished(IndexTask::Type type, bool success)
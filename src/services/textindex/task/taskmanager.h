@@ -27,11 +27,11 @@ public:
 
 Q_SIGNALS:
     void taskFinished(const QString &type, const QString &path, bool success);
-    void taskProgressChanged(const QString &type, const QString &path, qint64 count);
+    void taskProgressChanged(const QString &type, const QString &path, qint64 count, double throughput);
     void startTaskInThread();
 
 private Q_SLOTS:
-    void onTaskProgress(IndexTask::Type type, qint64 count);
+    void onTaskProgress(IndexTask::Type type, qint64 count, double throughput);
     void onTaskFinished(IndexTask::Type type, bool success);
 
 private:
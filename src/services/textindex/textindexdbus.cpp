@@ -22,8 +22,8 @@ void TextIndexDBusPrivate::initConnect()
     });
 
     QObject::connect(taskManager, &TaskManager::taskProgressChanged,
-                     q, [this](const QString &type, const QString &path, qint64 count) {
-        emit q->TaskProgressChanged(type, path, count);
+                     q, [this](const QString &type, const QString &path, qint64 count, double throughput) {
+        emit q->TaskProgressChanged(type, path, count, throughput);
     });
 }
 
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "indexmanifest.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+SERVICETEXTINDEX_BEGIN_NAMESPACE
+
+namespace {
+constexpr quint32 kManifestMagic { 0x54494D46 };
+constexpr quint32 kManifestVersion { 1 };
+}
+
+FileStamp FileStamp::fromStat(const struct stat &st)
+{
+    FileStamp stamp;
+    stamp.mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+    stamp.size = st.st_size;
+    stamp.inode = st.st_ino;
+    return stamp;
+}
+
+QString IndexManifest::manifestPath()
+{
+    // 放在索引目录中，索引损坏清理目录时一起删除
+    return indexStorePath() + "/textindex.manifest";
+}
+
+bool IndexManifest::load()
+{
+    stamps.clear();
+    loaded = false;
+
+    QFile file(manifestPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != kManifestMagic || version != kManifestVersion) {
+        fmWarning() << "Ignore index manifest with unknown format:" << manifestPath();
+        return false;
+    }
+
+    stamps.reserve(static_cast<int>(count));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        FileStamp stamp;
+        in >> path >> stamp.mtime >> stamp.size >> stamp.inode;
+        stamps.insert(path, stamp);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        fmWarning() << "Index manifest is broken:" << manifestPath();
+        stamps.clear();
+        return false;
+    }
+
+    loaded = true;
+    return true;
+}
+
+bool IndexManifest::save() const
+{
+    QDir().mkpath(indexStorePath());
+    QSaveFile file(manifestPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        fmWarning() << "Cannot write index manifest:" << manifestPath();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << kManifestMagic << kManifestVersion << static_cast<quint32>(stamps.count());
+    for (auto it = stamps.cbegin(); it != stamps.cend(); ++it)
+        out << it.key() << it.value().mtime << it.value().size << it.value().inode;
+
+    return file.commit();
+}
+
+void IndexManifest::removeFile()
+{
+    QFile::remove(manifestPath());
+}
+
+QStringList IndexManifest::pathsUnder(const QString &root) const
+{
+    const QString prefix = root.endsWith('/') ? root : root + '/';
+    QStringList paths;
+    for (auto it = stamps.cbegin(); it != stamps.cend(); ++it) {
+        if (it.key().startsWith(prefix))
+            paths.append(it.key());
+    }
+    return paths;
+}
+
+SERVICETEXTINDEX_END_NAMESPACE
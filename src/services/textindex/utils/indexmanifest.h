@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef INDEXMANIFEST_H
+#define INDEXMANIFEST_H
+
+#include "service_textindex_global.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <sys/stat.h>
+
+SERVICETEXTINDEX_BEGIN_NAMESPACE
+
+// 已索引文件的状态，用于更新索引时判断文件是否变化
+struct FileStamp
+{
+    qint64 mtime { 0 };   // 毫秒
+    qint64 size { 0 };
+    quint64 inode { 0 };
+
+    static FileStamp fromStat(const struct stat &st);
+    bool operator==(const FileStamp &other) const
+    {
+        return mtime == other.mtime && size == other.size && inode == other.inode;
+    }
+    bool operator!=(const FileStamp &other) const { return !(*this == other); }
+};
+
+// 索引清单，记录 path -> (mtime, size, inode)，保存在索引目录中
+class IndexManifest
+{
+public:
+    static QString manifestPath();
+
+    bool load();
+    bool save() const;
+    static void removeFile();
+
+    bool isLoaded() const { return loaded; }
+    bool contains(const QString &path) const { return stamps.contains(path); }
+    FileStamp stamp(const QString &path) const { return stamps.value(path); }
+    void insert(const QString &path, const FileStamp &stamp) { stamps.insert(path, stamp); }
+    void remove(const QString &path) { stamps.remove(path); }
+    void clear() { stamps.clear(); }
+    QStringList pathsUnder(const QString &root) const;
+
+private:
+    QHash<QString, FileStamp> stamps;
+    bool loaded { false };
+};
+
+SERVICETEXTINDEX_END_NAMESPACE
+
+#endif   // INDEXMANIFEST_H
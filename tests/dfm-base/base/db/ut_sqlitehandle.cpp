@@ -3,10 +3,16 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "stubext.h"
+#include "benchmarkext.h"
+#include "ut_testobj_user.h"
 #include <dfm-base/base/db/sqlitehandle.h>
 
+#include <QTemporaryDir>
+
 #include <gtest/gtest.h>
 
+DFMBASE_USE_NAMESPACE
+
 class UT_SqliteHelper : public testing::Test
 {
 protected:
@@ -16,3 +22,105 @@ protected:
 public:
     stub_ext::StubExt stub;
 };
+
+TEST_F(UT_SqliteHelper, excuteBatch_excutePrepared_createIndex)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    SqliteHandle handle(dir.filePath("batch.db"));
+    ASSERT_TRUE(handle.createTable<TestObj::User>(SqliteConstraint::primary("id"),
+                                                  SqliteConstraint::autoIncreament("id")));
+    EXPECT_TRUE(handle.createIndex<TestObj::User>("idx_user_name", { "name" }));
+
+    const QList<QVariantList> columns { { "a", "b", "c'quote" },
+                                        { "pa", "pb", "pc" },
+                                        { "a@x", "b@x", "c@x" },
+                                        { 1.0, 2.0, 3.0 },
+                                        { 10.0, 20.0, 30.0 } };
+    EXPECT_TRUE(handle.transaction([&]() {
+        return handle.excuteBatch("INSERT INTO User(name,password,email,height,weight) VALUES (?,?,?,?,?);", columns);
+    }));
+
+    QStringList names;
+    const QVariantList values { "a", "c'quote", "none" };
+    EXPECT_TRUE(handle.excutePrepared("SELECT name FROM User WHERE name IN (" + SqliteHelper::placeholders(values.size()) + ") ORDER BY id;",
+                                      values, [&names](QSqlQuery *query) {
+                                          while (query->next())
+                                              names.append(query->value(0).toString());
+                                      }));
+    EXPECT_EQ(names, QStringList({ "a", "c'quote" }));
+
+    // 批量语句失败时事务回滚并返回失败
+    EXPECT_FALSE(handle.transaction([&]() {
+        return handle.excuteBatch("INSERT INTO User(name) VALUES (?);", { { "d" } })
+                && handle.excuteBatch("INSERT INTO NoSuchTable(name) VALUES (?);", { { "e" } });
+    }));
+    int userCount { 0 };
+    EXPECT_TRUE(handle.excutePrepared("SELECT COUNT(*) FROM User;", {}, [&userCount](QSqlQuery *query) {
+        if (query->next())
+            userCount = query->value(0).toInt();
+    }));
+    EXPECT_EQ(userCount, 3);
+
+    int indexCount { 0 };
+    EXPECT_TRUE(handle.excutePrepared("SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name = ?;",
+                                      { "idx_user_name" }, [&indexCount](QSqlQuery *query) {
+                                          if (query->next())
+                                              indexCount = query->value(0).toInt();
+                                      }));
+    EXPECT_EQ(indexCount, 1);
+    EXPECT_EQ(SqliteHelper::placeholders(3), "?,?,?");
+    EXPECT_TRUE(SqliteHelper::placeholders(0).isEmpty());
+}
+
+DFM_BENCHMARK_F(UT_SqliteHelper, TagFiles)
+{
+    const int count = benchmark_ext::size(100000);
+    const int rowSample = qMin(count, 500);
+    const int chunk = 500;
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    SqliteHandle handle(dir.filePath("tags.db"));
+    ASSERT_TRUE(handle.excute("CREATE TABLE IF NOT EXISTS file_tags(fileIndex INTEGER PRIMARY KEY AUTOINCREMENT, "
+                              "filePath TEXT NOT NULL, tagName TEXT NOT NULL, tagOrder INTEGER NOT NULL, future TEXT NOT NULL);"));
+    ASSERT_TRUE(handle.excute("CREATE INDEX IF NOT EXISTS idx_file_tags_filePath ON file_tags(filePath);"));
+
+    QVariantList paths;
+    for (int i = 0; i < count; ++i)
+        paths.append(QString("/home/user/Pictures/2024/IMG_%1.jpg").arg(i));
+
+    // 逐行插入，每行一次自动提交
+    const qint64 rowCost = benchmark_ext::elapsedNs([&]() {
+        for (int i = 0; i < rowSample; ++i)
+            handle.excute(QString("INSERT INTO file_tags(filePath,tagName,tagOrder,future) VALUES ('%1','red',0,'null');")
+                                  .arg(paths.at(i).toString()));
+    });
+    ASSERT_TRUE(handle.excute("DELETE FROM file_tags;"));
+
+    // 事务内批量插入
+    const QList<QVariantList> columns { paths, QVector<QVariant>(count, "red").toList(),
+                                        QVector<QVariant>(count, 0).toList(), QVector<QVariant>(count, "null").toList() };
+    const qint64 batchCost = benchmark_ext::elapsedMs([&]() {
+        EXPECT_TRUE(handle.transaction([&]() {
+            return handle.excuteBatch("INSERT INTO file_tags(filePath,tagName,tagOrder,future) VALUES (?,?,?,?);", columns);
+        }));
+    });
+
+    // 分段 IN 查询所有文件的标签
+    int found { 0 };
+    const qint64 queryCost = benchmark_ext::elapsedMs([&]() {
+        for (int i = 0; i < count; i += chunk) {
+            const QVariantList &values = paths.mid(i, chunk);
+            handle.excutePrepared("SELECT filePath, tagName FROM file_tags WHERE filePath IN (" + SqliteHelper::placeholders(values.size()) + ");",
+                                  values, [&found](QSqlQuery *query) {
+                                      while (query->next())
+                                          ++found;
+                                  });
+        }
+    });
+    EXPECT_EQ(found, count);
+
+    benchmark_ext::report() << "tag" << count << "files, per-row insert(us/file):" << rowCost / 1000.0 / rowSample
+                            << "batched insert(ms):" << batchCost << "batched query(ms):" << queryCost;
+}
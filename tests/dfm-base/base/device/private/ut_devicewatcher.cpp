@@ -18,6 +18,7 @@
 #include <QHash>
 #include <QVariantMap>
 #include <QtConcurrent>
+#include <QDateTime>
 
 #include <gtest/gtest.h>
 
@@ -310,14 +311,69 @@ TEST_F(UT_DeviceWatcherPrivate, QueryUsageAsync)
     //    auto run = static_cast<RunType>(QtConcurrent::run);
     //    stub.set(run, stub_run);
 
+    // unmounted devices are not queried.
     EXPECT_NO_FATAL_FAILURE(pd->queryUsageAsync());
-    int maxWait = 3;
-    do {   // wait QtConcurrent::run finished
-        QThread::msleep(50);
-    } while (!query_invoked && maxWait--);
+    pd->blockUsagePool.waitForDone();
+    EXPECT_FALSE(query_invoked);
+
+    pd->allBlockInfos["/org/freedesktop/UDisks2/block_devices/loop1"]["MountPoint"] = "/home";
+    EXPECT_NO_FATAL_FAILURE(pd->queryUsageAsync());
+    pd->blockUsagePool.waitForDone();
     EXPECT_TRUE(query_invoked);
 }
 
+TEST_F(UT_DeviceWatcherPrivate, IsUsageQueryDue)
+{
+    const QString blk("/org/freedesktop/UDisks2/block_devices/loop1");
+    const QString smb("smb://1.2.3.4/hello");
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    EXPECT_TRUE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now));
+    // the last query is running.
+    EXPECT_FALSE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + 1));
+    EXPECT_FALSE(pd->usageStates[blk].timedOut);
+    EXPECT_FALSE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + pd->kQueryTimeout + 1));
+    EXPECT_TRUE(pd->usageStates[blk].timedOut);
+    EXPECT_EQ(pd->usageStatistics.value("/home").timeouts, 1);
+    // a hung query is counted only once.
+    EXPECT_FALSE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + pd->kQueryTimeout * 2));
+    EXPECT_EQ(pd->usageStatistics.value("/home").timeouts, 1);
+
+    pd->usageStates[blk] = {};
+    pd->usageStates[blk].lastQueryTime = now;
+    EXPECT_FALSE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + pd->kFastPollingInterval));
+    EXPECT_TRUE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + pd->kPollingInterval));
+
+    // network and idle devices are polled slowly.
+    pd->usageStates[smb].lastQueryTime = now;
+    EXPECT_FALSE(pd->isUsageQueryDue(smb, "/media/smb", DFMMOUNT::DeviceType::kProtocolDevice, now + pd->kPollingInterval));
+    EXPECT_TRUE(pd->isUsageQueryDue(smb, "/media/smb", DFMMOUNT::DeviceType::kProtocolDevice, now + pd->kSlowPollingInterval));
+
+    pd->usageStates[blk] = {};
+    pd->usageStates[blk].lastQueryTime = now;
+    pd->usageStates[blk].idleRounds = pd->kIdleRounds;
+    EXPECT_FALSE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + pd->kPollingInterval));
+
+    // files written, poll fast.
+    pd->requestUsageUpdate({ blk });
+    now = QDateTime::currentMSecsSinceEpoch();
+    EXPECT_TRUE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now));
+    pd->usageStates[blk].queryStartTime = 0;
+    pd->usageStates[blk].lastQueryTime = now;
+    EXPECT_TRUE(pd->isUsageQueryDue(blk, "/home", DFMMOUNT::DeviceType::kBlockDevice, now + pd->kFastPollingInterval));
+}
+
+TEST_F(UT_DeviceWatcherPrivate, IsUsageChanged)
+{
+    const quint64 gb = 1024 * 1024 * 1024;
+    DevStorage old { 100 * gb, 50 * gb, 50 * gb };
+    EXPECT_TRUE(DeviceWatcherPrivate::isUsageChanged({}, old));
+    EXPECT_FALSE(DeviceWatcherPrivate::isUsageChanged(old, old));
+    EXPECT_FALSE(DeviceWatcherPrivate::isUsageChanged(old, { 100 * gb, 50 * gb - 1024, 50 * gb + 1024 }));
+    EXPECT_TRUE(DeviceWatcherPrivate::isUsageChanged(old, { 100 * gb, 49 * gb, 51 * gb }));
+    EXPECT_TRUE(DeviceWatcherPrivate::isUsageChanged(old, { 101 * gb, 50 * gb, 51 * gb }));
+}
+
 TEST_F(UT_DeviceWatcherPrivate, UpdateStorage)
 {
     EXPECT_NO_FATAL_FAILURE(pd->updateStorage("/org/freedesktop/UDisks2/block_devices/loop1", 100, 50));
@@ -344,10 +400,18 @@ TEST_F(UT_DeviceWatcherPrivate, QueryUsageOfItem)
     QVariantMap testInfo { { "MountPoint", "/home" } };
     EXPECT_NO_FATAL_FAILURE(pd->queryUsageOfItem(testInfo, DFMMOUNT::DeviceType::kAllDevice));
 
+    int emitted = 0;
+    auto conn = QObject::connect(DevMngIns, &DeviceManager::devSizeChanged, pd, [&emitted] { ++emitted; });
     EXPECT_NO_FATAL_FAILURE(pd->queryUsageOfItem(testInfo, DFMMOUNT::DeviceType::kBlockDevice));
     EXPECT_NO_FATAL_FAILURE(pd->queryUsageOfItem(testInfo, DFMMOUNT::DeviceType::kProtocolDevice));
     EXPECT_TRUE(blkQueried);
     EXPECT_TRUE(protoQueried);
+
+    // only changed usage is notified.
+    EXPECT_EQ(emitted, 1);
+    EXPECT_EQ(pd->usageStates.value("").idleRounds, 1);
+    EXPECT_EQ(watcher->usageStatistics().value("/home").queries, 2);
+    QObject::disconnect(conn);
 }
 
 TEST_F(UT_DeviceWatcherPrivate, QueryUsageOfBlock)
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stubext.h>
+#include <dfm-base/mimetype/dmimedatabase.h>
+#include <dfm-base/utils/protocolutils.h>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+
+DFMBASE_USE_NAMESPACE
+
+TEST(UT_DMimeDatabase, OnlyMatchExtension)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QFile file(dir.filePath("note.txt"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    stub_ext::StubExt stub;
+    bool remote = false;
+    stub.set_lamda(&ProtocolUtils::isRemoteFile, [&remote] { __DBG_STUB_INVOKE__ return remote; });
+
+    EXPECT_FALSE(DMimeDatabase::onlyMatchExtension(file.fileName()));
+    EXPECT_FALSE(DMimeDatabase::onlyMatchExtension(dir.filePath("app.lock")));
+    EXPECT_TRUE(DMimeDatabase::onlyMatchExtension("/proc/kmsg"));
+    EXPECT_TRUE(DMimeDatabase::onlyMatchExtension("/run/user/1000/gvfs/smb-share:server=host,share=data/app.lock"));
+
+    remote = true;
+    EXPECT_TRUE(DMimeDatabase::onlyMatchExtension(file.fileName()));
+}
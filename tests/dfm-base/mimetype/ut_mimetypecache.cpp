@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/mimetype/mimetypecache.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+
+DFMBASE_USE_NAMESPACE
+
+namespace {
+const QByteArray kPngHeader("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+
+QString writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        file.write(data);
+    return path;
+}
+
+// 依次生成图片、脚本和文本文件，只有文本文件能通过扩展名确定类型
+QStringList makeFiles(const QTemporaryDir &dir, int count)
+{
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        switch (i % 3) {
+        case 0:
+            paths.append(writeFile(dir.filePath(QString("image_%1").arg(i)), kPngHeader));
+            break;
+        case 1:
+            paths.append(writeFile(dir.filePath(QString("script_%1").arg(i)), "#!/bin/sh\necho hello\n"));
+            break;
+        default:
+            paths.append(writeFile(dir.filePath(QString("file_%1.txt").arg(i)), "hello"));
+            break;
+        }
+    }
+    return paths;
+}
+}
+
+TEST(UT_MimeTypeCache, MatchQMimeDatabase)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString &png = writeFile(dir.filePath("image"), kPngHeader);
+    const QString &script = writeFile(dir.filePath("run"), "#!/bin/sh\necho hello\n");
+    const QString &text = writeFile(dir.filePath("note.txt"), "hello");
+
+    MimeTypeCache cache(dir.filePath("mimetype.cache"));
+    QMimeDatabase db;
+    for (const auto &path : { png, script, text, dir.path() })
+        EXPECT_EQ(cache.mimeTypeForFile(path).name(), db.mimeTypeForFile(path).name()) << path.toStdString();
+    EXPECT_EQ(cache.mimeTypeForFile(png, QMimeDatabase::MatchContent).name(), "image/png");
+
+    auto s = cache.statistics();
+    EXPECT_EQ(s.lookups, 5u);
+    EXPECT_EQ(s.fastPaths, 1u);
+    EXPECT_EQ(s.sniffs, 3u);
+    EXPECT_EQ(s.cacheHits, 0u);
+
+    // 文件没有变化时命中缓存
+    EXPECT_EQ(cache.mimeTypeForFile(png).name(), "image/png");
+    EXPECT_EQ(cache.statistics().cacheHits, 1u);
+
+    // 内容和大小变化后重新识别
+    writeFile(png, "plain text now, not an image");
+    EXPECT_EQ(cache.mimeTypeForFile(png).name(), db.mimeTypeForFile(png).name());
+    EXPECT_EQ(cache.statistics().sniffs, 4u);
+}
+
+TEST(UT_MimeTypeCache, SharedThroughCacheFile)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString &png = writeFile(dir.filePath("image"), kPngHeader);
+    const QString &cacheFile = dir.filePath("mimetype.cache");
+
+    {
+        MimeTypeCache cache(cacheFile);
+        EXPECT_EQ(cache.mimeTypeForFile(png).name(), "image/png");
+        cache.flush();
+    }
+
+    // 另一个进程读取缓存文件中的识别结果
+    MimeTypeCache other(cacheFile);
+    EXPECT_EQ(other.mimeTypeForFile(png).name(), "image/png");
+    EXPECT_EQ(other.statistics().cacheHits, 1u);
+    EXPECT_EQ(other.statistics().sniffs, 0u);
+}
+
+TEST(UT_MimeTypeCache, ResetOversizedCacheFile)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString &png = writeFile(dir.filePath("image"), kPngHeader);
+    const QString &cacheFile = dir.filePath("mimetype.cache");
+
+    MimeTypeCache cache(cacheFile);
+    EXPECT_EQ(cache.mimeTypeForFile(png).name(), "image/png");
+    cache.flush();
+    ASSERT_TRUE(QFile::resize(cacheFile, 32 * 1024 * 1024 + 1));
+
+    // 截断后保留文件头，之后追加的记录仍能被读取
+    cache.loadRecords();
+    QFile file(cacheFile);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(file.readAll(), QByteArray("DFMMIME1"));
+    file.close();
+
+    cache.appendRecord(MimeTypeCache::Key(), "text/plain");
+    cache.flush();
+    MimeTypeCache other(cacheFile);
+    EXPECT_EQ(other.mimeNames.value(MimeTypeCache::Key()), "text/plain");
+}
+
+TEST(UT_MimeTypeCache, BatchMatchQMimeDatabase)
+{
+    const int count = 6;
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QStringList &paths = makeFiles(dir, count);
+
+    QMimeDatabase db;
+    MimeTypeCache cache(dir.filePath("mimetype.cache"));
+    const auto &first = cache.mimeTypesForFiles(paths);
+    const auto &second = cache.mimeTypesForFiles(paths);
+    ASSERT_EQ(first.count(), count);
+    ASSERT_EQ(second.count(), count);
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(first.at(i).name(), db.mimeTypeForFile(paths.at(i)).name());
+        EXPECT_EQ(second.at(i).name(), first.at(i).name());
+    }
+    // 扩展名能确定类型的文件不读取内容，第二次全部命中缓存
+    EXPECT_EQ(cache.statistics().sniffs, static_cast<quint64>(count - count / 3));
+}
+
+DFM_BENCHMARK(UT_MimeTypeCache, Batch)
+{
+    const int count = benchmark_ext::size(2000);
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QStringList &paths = makeFiles(dir, count);
+
+    QMimeDatabase db;
+    const qint64 qtCost = benchmark_ext::elapsedMs([&]() {
+        for (const auto &path : paths)
+            db.mimeTypeForFile(path);
+    });
+
+    MimeTypeCache cache(dir.filePath("mimetype.cache"));
+    const qint64 firstCost = benchmark_ext::elapsedMs([&]() {
+        cache.mimeTypesForFiles(paths);
+    });
+    const qint64 secondCost = benchmark_ext::elapsedMs([&]() {
+        cache.mimeTypesForFiles(paths);
+    });
+
+    const auto &s = cache.statistics();
+    benchmark_ext::report() << "resolve" << count << "files, QMimeDatabase:" << qtCost << "ms, batch:" << firstCost
+                            << "ms, cached batch:" << secondCost << "ms, sniffs:" << s.sniffs << "hit rate:" << s.hitRate();
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/chinese2pinyin.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+TEST(UT_Chinese2Pinyin, Convert)
+{
+    EXPECT_EQ(Pinyin::Chinese2Pinyin(QString("中文文件.txt")), QString("zhong1wen2wen2jian4.txt"));
+    EXPECT_EQ(Pinyin::Chinese2Pinyin(QString("新建文件夹 (2)")), QString("xin1jian4wen2jian4jia1 (2)"));
+    EXPECT_EQ(Pinyin::Chinese2Pinyin(QString()), QString());
+    // 不在字典中的字符保持原样
+    EXPECT_EQ(Pinyin::Chinese2Pinyin(QString("ａ・😀")), QString("ａ・😀"));
+
+    // 不含汉字时共享原字符串
+    const QString ascii("readme.md");
+    QString result;
+    Pinyin::Chinese2Pinyin(ascii, &result);
+    EXPECT_EQ(result, ascii);
+    EXPECT_EQ(result.constData(), ascii.constData());
+
+    const QStringList names { "中", "abc", "文件", "" };
+    EXPECT_EQ(Pinyin::Chinese2Pinyin(names), QStringList({ "zhong1", "abc", "wen2jian4", "" }));
+}
+
+DFM_BENCHMARK(UT_Chinese2Pinyin, Throughput)
+{
+    const int count = benchmark_ext::size(1000000);
+
+    // 常用汉字区间内随机组成的文件名，一半带有扩展名和数字
+    std::mt19937 gen(5);
+    QStringList names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QString name;
+        for (int j = 2 + static_cast<int>(gen() % 8); j > 0; --j)
+            name.append(QChar(static_cast<ushort>(0x4e00 + gen() % 0x5000)));
+        if (i % 2)
+            name.append(QString("_%1.txt").arg(i));
+        names.append(name);
+    }
+
+    qint64 length = 0;
+    const qint64 single = benchmark_ext::elapsedMs([&]() {
+        for (const auto &name : names)
+            length += Pinyin::Chinese2Pinyin(name).length();
+    });
+
+    QStringList batch;
+    const qint64 batched = benchmark_ext::elapsedMs([&]() {
+        batch = Pinyin::Chinese2Pinyin(names);
+    });
+
+    benchmark_ext::report() << "convert" << count << "names, one by one:" << single << "ms, batch:" << batched << "ms";
+
+    for (const auto &pinyin : batch)
+        length -= pinyin.length();
+    EXPECT_EQ(length, 0);
+    EXPECT_EQ(batch.count(), count);
+}
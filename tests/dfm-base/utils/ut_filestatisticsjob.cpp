@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/filestatisticsjob.h"
+#include <dfm-base/dfm_global_defines.h>
+#include <dfm-base/file/local/syncfileinfo.h>
+#include <dfm-base/base/schemefactory.h>
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <unistd.h>
+
+DFMBASE_USE_NAMESPACE
+
+namespace {
+struct Result
+{
+    qint64 totalSize { 0 };
+    int filesCount { 0 };
+    int directoryCount { 0 };
+    QList<QUrl> allFiles;
+};
+
+// 生成 dirs 个子目录，每个子目录 files 个文件，第 i 个文件大小为 i + 1 字节
+qint64 makeTree(const QString &root, int dirs, int files)
+{
+    qint64 size = 0;
+    for (int i = 0; i < dirs; ++i) {
+        const QString dir = QString("%1/dir_%2/sub").arg(root).arg(i);
+        QDir().mkpath(dir);
+        for (int j = 0; j < files; ++j) {
+            QFile file(QString("%1/file_%2").arg(dir).arg(j));
+            if (file.open(QIODevice::WriteOnly))
+                size += file.write(QByteArray(j + 1, 'x'));
+        }
+    }
+    return size;
+}
+
+Result statistics(const QList<QUrl> &urls, FileStatisticsJob::FileHints hints = FileStatisticsJob::kNoHint)
+{
+    FileStatisticsJob job;
+    job.setFileHints(hints);
+    job.start(urls);
+    job.wait();
+
+    Result result;
+    result.totalSize = job.totalSize();
+    result.filesCount = job.filesCount();
+    result.directoryCount = job.directorysCount();
+    result.allFiles = job.getFileSizeInfo()->allFiles;
+    return result;
+}
+}
+
+class UT_FileStatisticsJob : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        InfoFactory::regClass<SyncFileInfo>(Global::Scheme::kFile);
+    }
+};
+
+TEST_F(UT_FileStatisticsJob, LocalDirectoryTotals)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const qint64 size = makeTree(dir.path(), 4, 10);
+
+    // 硬链接只统计一次大小，文件数仍然计入
+    const QString target = dir.path() + "/dir_0/sub/file_9";
+    ASSERT_EQ(::link(QFile::encodeName(target).constData(), QFile::encodeName(dir.path() + "/dir_1/link").constData()), 0);
+    ASSERT_TRUE(QFile::link(target, dir.path() + "/dir_2/symlink"));
+
+    const auto &result = statistics({ QUrl::fromLocalFile(dir.path()) });
+    EXPECT_EQ(result.totalSize, size);
+    EXPECT_EQ(result.filesCount, 4 * 10 + 2);
+    EXPECT_EQ(result.directoryCount, 1 + 4 * 2);
+    EXPECT_EQ(result.allFiles.count(), 1);
+
+    // 目录没有变化时使用缓存，结果不变
+    const auto &cached = statistics({ QUrl::fromLocalFile(dir.path()) });
+    EXPECT_EQ(cached.totalSize, result.totalSize);
+    EXPECT_EQ(cached.filesCount, result.filesCount);
+    EXPECT_EQ(cached.directoryCount, result.directoryCount);
+
+    // 目录项变化后重新统计
+    QFile file(dir.path() + "/dir_3/sub/new");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(100, 'x'));
+    file.close();
+    const auto &changed = statistics({ QUrl::fromLocalFile(dir.path()) });
+    EXPECT_EQ(changed.totalSize, size + 100);
+    EXPECT_EQ(changed.filesCount, result.filesCount + 1);
+}
+
+TEST_F(UT_FileStatisticsJob, CollectFileList)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    makeTree(dir.path(), 3, 5);
+
+    const auto &result = statistics({ QUrl::fromLocalFile(dir.path()) }, FileStatisticsJob::kCollectFileList);
+    // 源目录、子目录和所有文件
+    EXPECT_EQ(result.allFiles.count(), 1 + 3 * 2 + 3 * 5);
+    EXPECT_EQ(result.allFiles.first(), QUrl::fromLocalFile(dir.path()));
+
+    // 父目录总是排在其中的文件之前
+    for (int i = 1; i < result.allFiles.count(); ++i) {
+        const QUrl &parent = QUrl::fromLocalFile(QFileInfo(result.allFiles.at(i).toLocalFile()).absolutePath());
+        EXPECT_LT(result.allFiles.indexOf(parent), i);
+    }
+}
+
+DFM_BENCHMARK_F(UT_FileStatisticsJob, Throughput)
+{
+    const int dirs = benchmark_ext::size(200);
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const qint64 size = makeTree(dir.path(), dirs, 50);
+    const QList<QUrl> urls { QUrl::fromLocalFile(dir.path()) };
+
+    Result listed;
+    const qint64 uncached = benchmark_ext::elapsedMs([&]() {
+        listed = statistics(urls, FileStatisticsJob::kCollectFileList);
+    });
+    Result cached;
+    const qint64 cachedCost = benchmark_ext::elapsedMs([&]() {
+        cached = statistics(urls);
+    });
+
+    benchmark_ext::report() << "statistics" << listed.filesCount << "files, walk cost" << uncached << "ms, cached cost" << cachedCost << "ms";
+
+    EXPECT_EQ(listed.totalSize, size);
+    EXPECT_EQ(cached.totalSize, size);
+    EXPECT_EQ(cached.filesCount, dirs * 50);
+}
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/filetagsnapshot.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QVariant>
+#include <QTemporaryFile>
+
+#include <unistd.h>
+
+DFMBASE_USE_NAMESPACE
+
+namespace {
+QStringList tagsOf(const FileTagSnapshot &snapshot, const QString &path)
+{
+    const auto &names = snapshot.tagNames();
+    QStringList tags;
+    for (quint32 id : snapshot.tagIds(path))
+        tags.append(names.value(static_cast<int>(id)));
+    return tags;
+}
+}
+
+TEST(UT_FileTagSnapshot, BuildAndLookup)
+{
+    QHash<QString, QStringList> fileTags;
+    fileTags.insert("/home/user/a.txt", { "red", "work" });
+    fileTags.insert("/home/user/中文.txt", { "work" });
+    fileTags.insert("/home/user/empty", {});
+
+    FileTagSnapshot snapshot;
+    EXPECT_FALSE(snapshot.isValid());
+    ASSERT_TRUE(snapshot.attach(FileTagSnapshot::build(42, fileTags)));
+    EXPECT_EQ(snapshot.sequence(), 42u);
+    EXPECT_EQ(snapshot.fileCount(), 2);
+    EXPECT_EQ(snapshot.tagNames().size(), 2);
+    EXPECT_EQ(tagsOf(snapshot, "/home/user/a.txt"), QStringList({ "red", "work" }));
+    EXPECT_EQ(tagsOf(snapshot, "/home/user/中文.txt"), QStringList({ "work" }));
+    EXPECT_FALSE(snapshot.contains("/home/user/empty"));
+    EXPECT_FALSE(snapshot.contains("/home/user/b.txt"));
+    EXPECT_TRUE(snapshot.tagIds("/home/user/b.txt").isEmpty());
+
+    int visited = 0;
+    snapshot.forEachFile([&visited, &fileTags](const QString &path, const QVector<quint32> &ids) {
+        EXPECT_EQ(ids.size(), fileTags.value(path).size());
+        ++visited;
+    });
+    EXPECT_EQ(visited, 2);
+
+    snapshot.detach();
+    EXPECT_FALSE(snapshot.isValid());
+    EXPECT_FALSE(snapshot.attach(QByteArray("DTAG")));
+}
+
+TEST(UT_FileTagSnapshot, SealedFd)
+{
+    QHash<QString, QStringList> fileTags;
+    fileTags.insert("/tmp/file", { "blue" });
+
+    const int fd = FileTagSnapshot::createSealedFd(FileTagSnapshot::build(7, fileTags));
+    if (fd < 0)
+        GTEST_SKIP() << "memfd is not supported";
+
+    // 密封之后不能再写入
+    EXPECT_LT(::write(fd, "x", 1), 0);
+
+    FileTagSnapshot snapshot;
+    ASSERT_TRUE(snapshot.attach(fd));
+    ::close(fd);
+    EXPECT_EQ(snapshot.sequence(), 7u);
+    EXPECT_EQ(tagsOf(snapshot, "/tmp/file"), QStringList({ "blue" }));
+}
+
+TEST(UT_FileTagSnapshot, RejectUnsealedFd)
+{
+    QHash<QString, QStringList> fileTags;
+    fileTags.insert("/tmp/file", { "blue" });
+
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    file.write(FileTagSnapshot::build(7, fileTags));
+    ASSERT_TRUE(file.flush());
+
+    // 内容合法但没有封印，仍然可以被修改
+    FileTagSnapshot snapshot;
+    EXPECT_FALSE(snapshot.attach(file.handle()));
+}
+
+DFM_BENCHMARK(UT_FileTagSnapshot, MemoryAndLookup)
+{
+    using benchmark_ext::residentKb;
+    const int count = benchmark_ext::size(100000);
+    const QStringList tags { "red", "orange", "yellow", "green", "blue", "purple", "gray" };
+
+    QStringList paths;
+    paths.reserve(count);
+    QHash<QString, QStringList> fileTags;
+    for (int i = 0; i < count; ++i) {
+        paths.append(QString("/home/user/Documents/project_%1/file_%2.txt").arg(i % 100).arg(i));
+        fileTags.insert(paths.last(), { tags.at(i % tags.size()), tags.at((i / 7) % tags.size()) });
+    }
+
+    qint64 rssBefore = residentKb();
+    QHash<QString, QVariant> variantCache;
+    qint64 cost = benchmark_ext::elapsedMs([&]() {
+        for (auto it = fileTags.begin(); it != fileTags.end(); ++it)
+            variantCache.insert(it.key(), it.value());
+    });
+    benchmark_ext::report() << "QHash<QString, QVariant> cache" << count << "files cost" << cost << "ms, rss delta" << residentKb() - rssBefore << "kB";
+
+    rssBefore = residentKb();
+    FileTagSnapshot snapshot;
+    cost = benchmark_ext::elapsedMs([&]() {
+        ASSERT_TRUE(snapshot.attach(FileTagSnapshot::build(1, fileTags)));
+    });
+    benchmark_ext::report() << "snapshot" << count << "files cost" << cost << "ms, rss delta" << residentKb() - rssBefore << "kB";
+
+    int hits = 0;
+    const qint64 hashLookup = benchmark_ext::elapsedNs([&]() {
+        for (const auto &path : paths)
+            hits += variantCache.value(path).toStringList().size();
+    });
+    const qint64 snapshotLookup = benchmark_ext::elapsedNs([&]() {
+        for (const auto &path : paths)
+            hits -= snapshot.tagIds(path).size();
+    });
+    benchmark_ext::report() << "lookup ns per file, QHash<QString, QVariant>:" << hashLookup / count << "snapshot:" << snapshotLookup / count;
+
+    EXPECT_EQ(hits, 0);
+    EXPECT_EQ(snapshot.fileCount(), fileTags.size());
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/private/infocache_p.h"
+
+#include <QUrl>
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+
+TEST(UT_InfoCache, CacheTimeListOrder)
+{
+    CacheTimeList list;
+    const QUrl a = QUrl::fromLocalFile("/tmp/a");
+    const QUrl b = QUrl::fromLocalFile("/tmp/b");
+    const QUrl c = QUrl::fromLocalFile("/tmp/c");
+
+    list.touch(a, 1);
+    list.touch(b, 2);
+    list.touch(c, 3);
+    EXPECT_EQ(list.count(), 3);
+    EXPECT_EQ(list.oldest().url, a);
+
+    // 再次使用的挪到最后
+    list.touch(a, 4);
+    EXPECT_EQ(list.count(), 3);
+    EXPECT_EQ(list.oldest().url, b);
+
+    EXPECT_TRUE(list.remove(b));
+    EXPECT_FALSE(list.remove(b));
+    EXPECT_EQ(list.oldest().url, c);
+
+    list.popOldest();
+    EXPECT_EQ(list.oldest().url, a);
+    EXPECT_EQ(list.oldest().time, 4);
+    list.popOldest();
+    EXPECT_TRUE(list.isEmpty());
+    EXPECT_FALSE(list.contains(a));
+}
+
+TEST(UT_InfoCache, StatisticsCountMiss)
+{
+    const auto before = InfoCacheController::instance().statistics();
+    EXPECT_FALSE(InfoCacheController::instance().getCacheInfo(QUrl::fromLocalFile("/tmp/ut_infocache_not_cached")));
+    const auto after = InfoCacheController::instance().statistics();
+    EXPECT_EQ(after.misses, before.misses + 1);
+    EXPECT_EQ(after.hits, before.hits);
+}
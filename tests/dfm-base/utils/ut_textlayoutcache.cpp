@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/textlayoutcache.h"
+#include "dfm-base/utils/elidetextlayout.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+#include <QPainter>
+
+DFMBASE_USE_NAMESPACE
+
+namespace {
+const QRectF kTextRect(10, 20, 96, 48);
+
+ElideTextLayout *createLayout(const QString &text, bool cached)
+{
+    auto layout = new ElideTextLayout(text);
+    layout->setAttribute(ElideTextLayout::kLineHeight, 16);
+    layout->setAttribute(ElideTextLayout::kAlignment, Qt::AlignCenter);
+    layout->setCacheEnabled(cached);
+    return layout;
+}
+
+QList<QRectF> layoutText(const QString &text, bool cached, const QRectF &rect, QStringList *lines)
+{
+    QScopedPointer<ElideTextLayout> layout(createLayout(text, cached));
+    return layout->layout(rect, Qt::ElideMiddle, nullptr, Qt::NoBrush, lines);
+}
+
+QString itemName(int i)
+{
+    return QString("scroll_benchmark_%0_a_rather_long_file_name_that_needs_to_wrap.txt").arg(i);
+}
+
+// 按照视图滚动的方式逐帧绘制可见的文件名，返回平均每帧的耗时
+double paintFrames(int itemCount, bool cached)
+{
+    static constexpr int kVisibleItems { 60 };
+    static constexpr int kScrollStep { 20 };
+
+    QImage image(1920, 1080, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    int frames = 0;
+    const qint64 cost = benchmark_ext::elapsedNs([&]() {
+        // 先向下滚动到底再滚回顶部
+        const int lastFirst = qMax(0, itemCount - kVisibleItems);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int step = 0; step * kScrollStep <= lastFirst; ++step, ++frames) {
+                const int first = pass == 0 ? step * kScrollStep : lastFirst - step * kScrollStep;
+                image.fill(Qt::white);
+                for (int i = first; i < qMin(itemCount, first + kVisibleItems); ++i) {
+                    const QRectF rect((i % 10) * 120, (i / 10 % 6) * 60, 96, 48);
+                    QScopedPointer<ElideTextLayout> layout(createLayout(itemName(i), cached));
+                    layout->setAttribute(ElideTextLayout::kFont, painter.font());
+                    layout->layout(rect, Qt::ElideMiddle, &painter);
+                }
+            }
+        }
+    });
+    return frames > 0 ? double(cost) / frames / 1000000 : 0;
+}
+}
+
+TEST(UT_TextLayoutCache, SameResultAsDocument)
+{
+    TextLayoutCache::instance()->clear();
+    const QStringList texts { "short.txt",
+                              "a_very_long_file_name_without_any_space_to_break.txt",
+                              "a long file name with spaces that wraps over several lines and gets elided.txt",
+                              "中文文件名称比较长的时候也需要换行并在最后一行省略显示.txt" };
+    for (const QString &text : texts) {
+        for (const QRectF &rect : { kTextRect, QRectF(0, 0, 60, 10), QRectF(5, 5, 200, 100) }) {
+            QStringList expectLines;
+            QStringList cachedLines;
+            const auto &expect = layoutText(text, false, rect, &expectLines);
+            EXPECT_EQ(layoutText(text, true, rect, &cachedLines), expect) << text.toStdString();
+            EXPECT_EQ(cachedLines, expectLines);
+
+            // 命中缓存时结果不变，位置跟随文本区域
+            cachedLines.clear();
+            EXPECT_EQ(layoutText(text, true, rect, &cachedLines), expect);
+            EXPECT_EQ(cachedLines, expectLines);
+            QList<QRectF> moved;
+            for (const QRectF &r : expect)
+                moved.append(r.translated(7, 9));
+            EXPECT_EQ(layoutText(text, true, rect.translated(7, 9), nullptr), moved);
+        }
+    }
+}
+
+TEST(UT_TextLayoutCache, HitAndMiss)
+{
+    auto cache = TextLayoutCache::instance();
+    cache->clear();
+    const auto before = cache->statistics();
+
+    layoutText("name.txt", true, kTextRect, nullptr);
+    layoutText("name.txt", true, kTextRect, nullptr);
+    layoutText("name.txt", true, kTextRect.adjusted(0, 0, 10, 0), nullptr);
+    auto s = cache->statistics();
+    EXPECT_EQ(s.lookups - before.lookups, 3u);
+    EXPECT_EQ(s.hits - before.hits, 1u);
+
+    // 高度变化但能显示的行数不变时仍然命中
+    layoutText("name.txt", true, kTextRect.adjusted(0, 0, 0, 1), nullptr);
+    EXPECT_EQ(cache->statistics().hits - before.hits, 2u);
+
+    // 重命名后的新名称不会命中旧名称的结果
+    layoutText("renamed.txt", true, kTextRect, nullptr);
+    EXPECT_EQ(cache->statistics().hits - before.hits, 2u);
+
+    // 文档被外部修改后不使用缓存
+    QScopedPointer<ElideTextLayout> layout(createLayout("name.txt", true));
+    layout->documentHandle();
+    layout->layout(kTextRect, Qt::ElideMiddle);
+    EXPECT_EQ(cache->statistics().lookups - before.lookups, 5u);
+}
+
+DFM_BENCHMARK(UT_TextLayoutCache, Scroll)
+{
+    const int itemCount = benchmark_ext::size(10000);
+
+    TextLayoutCache::instance()->clear();
+    const auto before = TextLayoutCache::instance()->statistics();
+    const double uncached = paintFrames(itemCount, false);
+    const double cached = paintFrames(itemCount, true);
+    const auto after = TextLayoutCache::instance()->statistics();
+
+    TextLayoutCache::Statistics s;
+    s.lookups = after.lookups - before.lookups;
+    s.hits = after.hits - before.hits;
+    benchmark_ext::report() << "text layout scroll over" << itemCount << "items, frame time (ms): document" << uncached
+                            << "cached" << cached << "hit rate" << s.hitRate();
+}
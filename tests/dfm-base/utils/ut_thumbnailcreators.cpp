@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/thumbnail/thumbnailcreators.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QRunnable>
+
+DFMBASE_USE_NAMESPACE
+DFMGLOBAL_USE_NAMESPACE
+
+namespace {
+// 生成 count 张 width x height 的jpeg图片
+QStringList makeImages(const QString &dir, int count, int width, int height)
+{
+    QStringList files;
+    for (int i = 0; i < count; ++i) {
+        QImage img(width, height, QImage::Format_RGB32);
+        QPainter painter(&img);
+        QLinearGradient gradient(0, 0, width, height);
+        gradient.setColorAt(0, QColor::fromHsv((i * 37) % 360, 200, 220));
+        gradient.setColorAt(1, QColor::fromHsv((i * 91) % 360, 120, 80));
+        painter.fillRect(img.rect(), gradient);
+        painter.end();
+
+        const QString file = QString("%1/image_%2.jpg").arg(dir).arg(i);
+        if (img.save(file, "jpg", 85))
+            files.append(file);
+    }
+    return files;
+}
+
+// 解码完整图片后再缩放
+QImage decodeThenScale(const QString &file, ThumbnailSize size)
+{
+    QImage img(file);
+    return img.scaled(size, size, Qt::KeepAspectRatio);
+}
+
+double throughput(int count, qint64 ms)
+{
+    return ms > 0 ? count * 1000.0 / ms : 0;
+}
+}
+
+TEST(UT_ThumbnailCreators, ImageThumbnailScaledDecode)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const auto &files = makeImages(dir.path(), 1, 1600, 1200);
+    ASSERT_EQ(files.count(), 1);
+
+    const QImage &img = ThumbnailCreators::imageThumbnailCreator(files.first(), kLarge);
+    ASSERT_FALSE(img.isNull());
+    EXPECT_LE(img.width(), kLarge);
+    EXPECT_LE(img.height(), kLarge);
+    EXPECT_EQ(img.width(), kLarge);
+
+    // 小图不放大
+    QDir(dir.path()).mkdir("small");
+    const auto &small = makeImages(dir.path() + "/small", 1, 100, 80);
+    ASSERT_EQ(small.count(), 1);
+    EXPECT_EQ(ThumbnailCreators::imageThumbnailCreator(small.first(), kLarge).size(), QSize(100, 80));
+}
+
+DFM_BENCHMARK(UT_ThumbnailCreators, ImageThumbnailThroughput)
+{
+    const int count = benchmark_ext::size(24);
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const auto &files = makeImages(dir.path(), count, 3000, 2000);
+    ASSERT_EQ(files.count(), count);
+
+    const qint64 fullDecode = benchmark_ext::elapsedMs([&]() {
+        for (const auto &file : files)
+            decodeThenScale(file, kLarge);
+    });
+    const qint64 scaledDecode = benchmark_ext::elapsedMs([&]() {
+        for (const auto &file : files)
+            ThumbnailCreators::imageThumbnailCreator(file, kLarge);
+    });
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 8));
+    const qint64 pooledDecode = benchmark_ext::elapsedMs([&]() {
+        for (const auto &file : files) {
+            pool.start(QRunnable::create([file]() {
+                ThumbnailCreators::imageThumbnailCreator(file, kLarge);
+            }));
+        }
+        pool.waitForDone();
+    });
+
+    benchmark_ext::report() << "thumbnails per second, decode then scale:" << throughput(count, fullDecode)
+                            << "scaled decode:" << throughput(count, scaledDecode)
+                            << "scaled decode with" << pool.maxThreadCount() << "threads:" << throughput(count, pooledDecode);
+}
@@ -60,3 +60,15 @@ TEST_F(UT_EventChannel, test_manager_post)
     QVariant value = future.result();
     EXPECT_EQ(value.toInt(), 20);
 }
+
+TEST_F(UT_EventChannel, test_send_with_other_types)
+{
+    TestQObject b;
+    EventChannel channel;
+    channel.setReceiver(&b, &TestQObject::test1);
+
+    // 参数类型不一致时走QVariant转换
+    EXPECT_EQ(channel.send(qint64(8)).toInt(), 18);
+    EXPECT_EQ(channel.send(QString("8")).toInt(), 18);
+    EXPECT_EQ(channel.send(QVariantList { 8 }).toInt(), 18);
+}
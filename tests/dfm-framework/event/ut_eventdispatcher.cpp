@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "testqobject.h"
+#include "benchmarkext.h"
 
 #include <dfm-framework/dpf.h>
 #include <dfm-framework/event/event.h>
@@ -65,3 +66,66 @@ TEST_F(UT_EventDispatcher, test_unsub)
 
     EXPECT_TRUE(dpfSignalDispatcher->unsubscribe(eType1));
 }
+
+TEST_F(UT_EventDispatcher, test_typed_and_variant_dispatch)
+{
+    TestQObject b;
+    EventDispatcher dispatcher;
+    dispatcher.append(&b, &TestQObject::add1);
+
+    int v = 0;
+    EXPECT_TRUE(dispatcher.dispatch(&v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(dispatcher.dispatch(QVariantList { QVariant::fromValue(&v) }));
+    EXPECT_EQ(v, 2);
+
+    // 过滤器的参数类型一致，直接调用
+    int called = 0;
+    dispatcher.appendFilter(&b, &TestQObject::bigger10);
+    EXPECT_FALSE(dispatcher.dispatch(11, &called));
+    EXPECT_EQ(called, 10);
+    called = 0;
+    EXPECT_TRUE(dispatcher.dispatch(5, &called));
+    EXPECT_EQ(called, 10);
+
+    // 参数类型不一致，走QVariant转换
+    called = 0;
+    EXPECT_FALSE(dispatcher.dispatch(qint64(11), &called));
+    EXPECT_EQ(called, 10);
+}
+
+DFM_BENCHMARK_F(UT_EventDispatcher, dispatch_cost)
+{
+    TestQObject b;
+    EventDispatcher dispatcher;
+    dispatcher.append(&b, &TestQObject::add1);
+
+    const int count = benchmark_ext::size(200000);
+    int v = 0;
+
+    // 原来的方式：每次发布都把参数转换为QVariantList
+    const qint64 variantCost = benchmark_ext::elapsedNs([&]() {
+        for (int i = 0; i < count; ++i) {
+            QVariantList params;
+            makeVariantList(&params, &v);
+            dispatcher.dispatch(params);
+        }
+    });
+    const qint64 typedCost = benchmark_ext::elapsedNs([&]() {
+        for (int i = 0; i < count; ++i)
+            dispatcher.dispatch(&v);
+    });
+
+    EventType type = 3;
+    dpfSignalDispatcher->subscribe(type, &b, &TestQObject::add1);
+    const qint64 publishCost = benchmark_ext::elapsedNs([&]() {
+        for (int i = 0; i < count; ++i)
+            dpfSignalDispatcher->publish(type, &v);
+    });
+    dpfSignalDispatcher->unsubscribe(type);
+
+    EXPECT_EQ(v, count * 3);
+    benchmark_ext::report() << "ns per dispatch, variant:" << variantCost / count
+                            << "typed:" << typedCost / count
+                            << "publish by manager:" << publishCost / count;
+}
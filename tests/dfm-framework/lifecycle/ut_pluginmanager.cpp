@@ -12,6 +12,9 @@
 
 #include <gtest/gtest.h>
 
+#include <QMutex>
+#include <QThread>
+
 DPF_USE_NAMESPACE
 
 class UT_PluginManager : public testing::Test
@@ -336,3 +339,68 @@ TEST_F(UT_PluginManager, startPlugins)
     EXPECT_TRUE(started);
     EXPECT_TRUE(manager.d->allPluginsStarted);
 }
+
+TEST_F(UT_PluginManager, loadPlugins_dependsGraph)
+{
+    PluginManager manager;
+    auto makeMeta = [](const QString &name, const QStringList &depends) {
+        PluginMetaObjectPointer objPtr { new PluginMetaObject };
+        objPtr->d->name = name;
+        for (const QString &depend : depends) {
+            PluginDepend dep;
+            dep.pluginName = depend;
+            objPtr->d->depends.append(dep);
+        }
+        return objPtr;
+    };
+    // A <- B <- D, A <- C, E 无依赖
+    manager.d->pluginsToLoad << makeMeta("D", { "B" }) << makeMeta("B", { "A" })
+                             << makeMeta("C", { "A" }) << makeMeta("A", {}) << makeMeta("E", {});
+
+    QMutex mutex;
+    QStringList order;
+    stub.set_lamda(&PluginManagerPrivate::doLoadPlugin, [&mutex, &order](PluginManagerPrivate *, PluginMetaObjectPointer pointer) {
+        __DBG_STUB_INVOKE__
+        QThread::msleep(5);
+        QMutexLocker locker(&mutex);
+        order.append(pointer->name());
+        return true;
+    });
+
+    EXPECT_TRUE(manager.loadPlugins());
+    ASSERT_EQ(order.size(), 5);
+    EXPECT_LT(order.indexOf("A"), order.indexOf("B"));
+    EXPECT_LT(order.indexOf("A"), order.indexOf("C"));
+    EXPECT_LT(order.indexOf("B"), order.indexOf("D"));
+    EXPECT_EQ(manager.d->timelines.size(), 5);
+    EXPECT_GE(manager.d->timelines.value("D").begin[PluginTimeline::kLoad],
+              manager.d->timelines.value("B").begin[PluginTimeline::kLoad] + manager.d->timelines.value("B").cost[PluginTimeline::kLoad]);
+}
+
+TEST_F(UT_PluginManager, initPlugins_dependsGraph_circle)
+{
+    PluginManager manager;
+    PluginMetaObjectPointer a { new PluginMetaObject };
+    PluginMetaObjectPointer b { new PluginMetaObject };
+    a->d->name = "A";
+    b->d->name = "B";
+    a->d->concurrentInit = true;
+    PluginDepend dependA;
+    dependA.pluginName = "A";
+    PluginDepend dependB;
+    dependB.pluginName = "B";
+    a->d->depends.append(dependB);
+    b->d->depends.append(dependA);
+    manager.d->loadQueue << a << b;
+
+    QStringList inited;
+    stub.set_lamda(&PluginManagerPrivate::doInitPlugin, [&inited](PluginManagerPrivate *, PluginMetaObjectPointer pointer) {
+        __DBG_STUB_INVOKE__
+        inited.append(pointer->name());
+        return true;
+    });
+
+    // 循环依赖时退化为按队列顺序串行初始化
+    EXPECT_TRUE(manager.initPlugins());
+    EXPECT_EQ(inited, QStringList({ "A", "B" }));
+}
@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/bigfilecopyscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QtConcurrent>
+
+#include <atomic>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+TEST(UT_BigFileCopyScheduler, SlotsOfSameDeviceAreLimited)
+{
+    const QUrl target = QUrl::fromLocalFile(QDir::tempPath() + "/not_exists_dir/big.iso");
+    const quint64 device = BigFileCopyScheduler::deviceOf(target);
+    const int slots = BigFileCopyScheduler::slotsOfDevice(device);
+    ASSERT_GE(slots, 1);
+
+    auto scheduler = BigFileCopyScheduler::instance();
+    QList<BigFileCopyScheduler::TicketPointer> tickets;
+    for (int i = 0; i < slots; ++i)
+        tickets.append(scheduler->acquire(target, nullptr));
+
+    // 名额用完后，停止的任务不再等待
+    EXPECT_TRUE(scheduler->acquire(target, []() { return true; }).isNull());
+
+    std::atomic_bool acquired { false };
+    auto future = QtConcurrent::run([&]() {
+        auto ticket = scheduler->acquire(target, nullptr);
+        acquired = !ticket.isNull();
+    });
+
+    EXPECT_FALSE(acquired);
+    tickets.takeFirst().reset();
+    future.waitForFinished();
+    EXPECT_TRUE(acquired);
+}
@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/direntryprefetcher.h"
+
+#include <dfm-base/base/urlroute.h>
+#include <dfm-base/base/schemefactory.h>
+#include <dfm-base/file/local/localdiriterator.h>
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QSemaphore>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+DFMBASE_USE_NAMESPACE
+
+namespace {
+// 生成 dirCount 个子目录，每个子目录 filesPerDir 个小文件
+void makeTree(const QString &root, int dirCount, int filesPerDir)
+{
+    for (int i = 0; i < dirCount; ++i) {
+        const QString dir = QString("%1/dir_%2").arg(root).arg(i);
+        QDir().mkpath(dir);
+        for (int j = 0; j < filesPerDir; ++j) {
+            QFile file(QString("%1/file_%2").arg(dir).arg(j));
+            if (file.open(QIODevice::WriteOnly))
+                file.write("x");
+        }
+    }
+}
+
+int copyEntries(const QList<DFileInfoPointer> &entries, const QString &target)
+{
+    int count = 0;
+    for (const auto &info : entries) {
+        const QUrl &url = info->uri();
+        if (info->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool()) {
+            QDir().mkpath(target + "/" + url.fileName());
+            continue;
+        }
+        if (QFile::copy(url.path(), target + "/" + url.fileName()))
+            ++count;
+    }
+    return count;
+}
+
+QList<DFileInfoPointer> listSerially(const QUrl &dir)
+{
+    QList<DFileInfoPointer> entries;
+    const auto &iterator = DirIteratorFactory::create<AbstractDirIterator>(dir);
+    iterator->setProperty("QueryAttributes", "standard::name");
+    while (iterator->hasNext()) {
+        DFileInfoPointer info(new DFileInfo(iterator->next()));
+        info->initQuerier();
+        entries.append(info);
+    }
+    return entries;
+}
+}
+
+class UT_DirEntryPrefetcher : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        UrlRoute::regScheme(Global::Scheme::kFile, "/", QIcon(), false, QObject::tr("System Disk"));
+        DirIteratorFactory::regClass<LocalDirIterator>(Global::Scheme::kFile);
+    }
+    void TearDown() override { }
+};
+
+TEST_F(UT_DirEntryPrefetcher, TakeReturnsPrefetchedEntries)
+{
+    QTemporaryDir root;
+    makeTree(root.path(), 3, 5);
+    const QUrl rootUrl = QUrl::fromLocalFile(root.path());
+
+    DirEntryPrefetcher prefetcher(2);
+    QList<DFileInfoPointer> entries;
+    EXPECT_FALSE(prefetcher.take(rootUrl, &entries));
+
+    prefetcher.prefetch({ rootUrl });
+    ASSERT_TRUE(prefetcher.take(rootUrl, &entries));
+    EXPECT_EQ(entries.count(), 3);
+
+    const auto &dirs = DirEntryPrefetcher::subDirs(entries);
+    EXPECT_EQ(dirs.count(), 3);
+    for (const auto &dir : dirs) {
+        QList<DFileInfoPointer> children;
+        ASSERT_TRUE(prefetcher.take(dir, &children));
+        EXPECT_EQ(children.count(), 5);
+    }
+
+    // 已经被取走的目录不会再返回
+    EXPECT_FALSE(prefetcher.take(rootUrl, &entries));
+}
+
+TEST_F(UT_DirEntryPrefetcher, RaisePriorityOfQueuedDirs)
+{
+    QTemporaryDir root;
+    makeTree(root.path(), 2, 1);
+    const QUrl dirA = QUrl::fromLocalFile(root.path() + "/dir_0");
+    const QUrl dirB = QUrl::fromLocalFile(root.path() + "/dir_1");
+
+    // 占住唯一的线程，让预读取任务停留在队列中
+    DirEntryPrefetcher prefetcher(1);
+    QSemaphore started;
+    QSemaphore release;
+    prefetcher.pool.start(QRunnable::create([&]() {
+        started.release();
+        release.acquire();
+    }));
+    started.acquire();
+
+    prefetcher.prefetch({ dirA, dirB });
+    prefetcher.prefetch({ dirB }, 1);
+    EXPECT_EQ(prefetcher.listings.value(dirA)->priority, 0);
+    EXPECT_EQ(prefetcher.listings.value(dirB)->priority, 1);
+    EXPECT_NE(prefetcher.listings.value(dirB)->task, nullptr);
+
+    release.release();
+    QList<DFileInfoPointer> entries;
+    ASSERT_TRUE(prefetcher.take(dirB, &entries));
+    EXPECT_EQ(entries.count(), 1);
+}
+
+TEST_F(UT_DirEntryPrefetcher, TakeQueuedDirInline)
+{
+    QTemporaryDir root;
+    makeTree(root.path(), 1, 3);
+    const QUrl dir = QUrl::fromLocalFile(root.path() + "/dir_0");
+
+    // 唯一的线程一直被占用，排队的目录只能由调用 take 的线程遍历
+    DirEntryPrefetcher prefetcher(1);
+    QSemaphore started;
+    QSemaphore release;
+    prefetcher.pool.start(QRunnable::create([&]() {
+        started.release();
+        release.acquire();
+    }));
+    started.acquire();
+
+    prefetcher.prefetch({ dir });
+    QList<DFileInfoPointer> entries;
+    EXPECT_TRUE(prefetcher.take(dir, &entries));
+    EXPECT_EQ(entries.count(), 3);
+    release.release();
+}
+
+TEST_F(UT_DirEntryPrefetcher, DiscardReleasesBuffer)
+{
+    QTemporaryDir root;
+    makeTree(root.path(), 3, 5);
+    const QUrl rootUrl = QUrl::fromLocalFile(root.path());
+
+    DirEntryPrefetcher prefetcher(2);
+    prefetcher.prefetch({ rootUrl });
+    QList<DFileInfoPointer> entries;
+    ASSERT_TRUE(prefetcher.take(rootUrl, &entries));
+
+    // 拷贝线程跳过了这些子目录，无论预读取是否完成都不再占用缓存
+    prefetcher.discard(DirEntryPrefetcher::subDirs(entries));
+    prefetcher.pool.waitForDone();
+    EXPECT_TRUE(prefetcher.listings.isEmpty());
+    EXPECT_EQ(prefetcher.bufferedEntries, 0);
+}
+
+TEST_F(UT_DirEntryPrefetcher, StopWakesWaiter)
+{
+    QTemporaryDir root;
+    makeTree(root.path(), 1, 1);
+    DirEntryPrefetcher prefetcher(1);
+    prefetcher.stop();
+    prefetcher.prefetch({ QUrl::fromLocalFile(root.path()) });
+
+    QList<DFileInfoPointer> entries;
+    EXPECT_FALSE(prefetcher.take(QUrl::fromLocalFile(root.path()), &entries));
+}
+
+// 拷贝合成目录树，输出每秒拷贝的文件数，百万文件时把 TMPDIR 指向 tmpfs
+DFM_BENCHMARK_F(UT_DirEntryPrefetcher, CopyTree)
+{
+    const int filesPerDir = 100;
+    const int dirCount = benchmark_ext::size(4000) / filesPerDir;
+
+    QTemporaryDir source;
+    makeTree(source.path(), dirCount, filesPerDir);
+    const QUrl sourceUrl = QUrl::fromLocalFile(source.path());
+
+    auto run = [&](DirEntryPrefetcher *prefetcher) {
+        QTemporaryDir target;
+        int copied = 0;
+        const qint64 ms = qMax<qint64>(1, benchmark_ext::elapsedMs([&]() {
+            QList<DFileInfoPointer> rootEntries;
+            if (!prefetcher || !prefetcher->take(sourceUrl, &rootEntries))
+                rootEntries = listSerially(sourceUrl);
+            if (prefetcher)
+                prefetcher->prefetch(DirEntryPrefetcher::subDirs(rootEntries), 1);
+            copyEntries(rootEntries, target.path());
+
+            for (const auto &dir : DirEntryPrefetcher::subDirs(rootEntries)) {
+                QList<DFileInfoPointer> entries;
+                if (!prefetcher || !prefetcher->take(dir, &entries))
+                    entries = listSerially(dir);
+                copied += copyEntries(entries, target.path() + "/" + dir.fileName());
+            }
+        }));
+
+        benchmark_ext::report() << (prefetcher ? "prefetched" : "serial") << "copy" << copied << "files,"
+                                << copied * 1000 / ms << "files/s";
+        return copied;
+    };
+
+    EXPECT_EQ(run(nullptr), dirCount * filesPerDir);
+
+    DirEntryPrefetcher prefetcher(4);
+    prefetcher.prefetch({ sourceUrl }, 1);
+    EXPECT_EQ(run(&prefetcher), dirCount * filesPerDir);
+}
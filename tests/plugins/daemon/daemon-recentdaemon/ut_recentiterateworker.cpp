@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stubext.h"
+#include "benchmarkext.h"
+#include "recentiterateworker.h"
+
+#include <dfm-base/utils/fileutils.h>
+#include <dfm-base/utils/protocolutils.h>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QUrl>
+#include <QDateTime>
+#include <QtConcurrent>
+
+SERVERRECENTMANAGER_BEGIN_NAMESPACE
+DFM_LOG_REISGER_CATEGORY(SERVERRECENTMANAGER_NAMESPACE)
+SERVERRECENTMANAGER_END_NAMESPACE
+
+DFMBASE_USE_NAMESPACE
+SERVERRECENTMANAGER_USE_NAMESPACE
+
+namespace {
+constexpr qint64 kBaseTime { 1700000000 };
+
+// 临时目录中的 count 个文件和引用它们的 xbel，versions 决定每个条目的修改时间
+class RecentXbel
+{
+public:
+    explicit RecentXbel(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            const QString &path = dir.filePath(QString("file_%1.txt").arg(i));
+            QFile file(path);
+            if (file.open(QIODevice::WriteOnly))
+                file.close();
+            files.append(path);
+            versions.append(0);
+        }
+        write();
+    }
+
+    QString path() const { return dir.filePath("recently-used.xbel"); }
+
+    void write(int skipped = -1) const
+    {
+        QByteArray data("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<xbel version=\"1.0\"\n"
+                        "      xmlns:bookmark=\"http://www.freedesktop.org/standards/desktop-bookmarks\"\n"
+                        "      xmlns:mime=\"http://www.freedesktop.org/standards/shared-mime-info\"\n"
+                        ">\n");
+        for (int i = 0; i < files.count(); ++i) {
+            if (i == skipped)
+                continue;
+            const QString &time = QDateTime::fromSecsSinceEpoch(kBaseTime + versions.at(i), Qt::UTC).toString(Qt::ISODate);
+            data += QString("  <bookmark href=\"%1\" added=\"%2\" modified=\"%2\" visited=\"%2\">\n"
+                            "    <info>\n"
+                            "      <metadata owner=\"http://freedesktop.org\">\n"
+                            "        <mime:mime-type type=\"text/plain\"/>\n"
+                            "      </metadata>\n"
+                            "    </info>\n"
+                            "  </bookmark>\n")
+                            .arg(QUrl::fromLocalFile(files.at(i)).toString(), time)
+                            .toUtf8();
+        }
+        data += "</xbel>";
+
+        QFile file(path());
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            file.write(data);
+    }
+
+    QTemporaryDir dir;
+    QStringList files;
+    QVector<int> versions;
+};
+}
+
+class UT_RecentIterateWorker : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        stub.set_lamda(&ProtocolUtils::isRemoteFile, [] { __DBG_STUB_INVOKE__ return false; });
+        stub.set_lamda(&FileUtils::bindPathTransform, [](const QString &path, bool) {
+            __DBG_STUB_INVOKE__
+            return path;
+        });
+
+        QObject::connect(&worker, &RecentIterateWorker::itemAdded, [this] { ++added; });
+        QObject::connect(&worker, &RecentIterateWorker::itemChanged, [this] { ++changed; });
+        QObject::connect(&worker, &RecentIterateWorker::itemsRemoved, [this](const QStringList &paths) { removed += paths; });
+    }
+    void TearDown() override
+    {
+        stub.clear();
+    }
+
+    // 扫描只允许在工作线程中进行
+    void reload(const QString &xbelPath)
+    {
+        QtConcurrent::run([this, xbelPath] { worker.onRequestReload(xbelPath, 0); }).waitForFinished();
+    }
+
+    stub_ext::StubExt stub;
+    RecentIterateWorker worker;
+    int added { 0 };
+    int changed { 0 };
+    QStringList removed;
+};
+
+TEST_F(UT_RecentIterateWorker, ReloadSingleChanges)
+{
+    RecentXbel xbel(50);
+    ASSERT_TRUE(xbel.dir.isValid());
+
+    reload(xbel.path());
+    EXPECT_EQ(added, 50);
+    EXPECT_EQ(changed, 0);
+
+    // 内容未变化时不产生任何通知
+    reload(xbel.path());
+    EXPECT_EQ(added, 50);
+    EXPECT_EQ(changed, 0);
+
+    ++xbel.versions[7];
+    xbel.write();
+    reload(xbel.path());
+    EXPECT_EQ(added, 50);
+    EXPECT_EQ(changed, 1);
+
+    xbel.write(3);
+    reload(xbel.path());
+    EXPECT_EQ(removed, QStringList { xbel.files.at(3) });
+}
+
+TEST_F(UT_RecentIterateWorker, SkipMissingFiles)
+{
+    RecentXbel xbel(10);
+    ASSERT_TRUE(xbel.dir.isValid());
+    QFile::remove(xbel.files.at(0));
+
+    reload(xbel.path());
+    EXPECT_EQ(added, 9);
+}
+
+DFM_BENCHMARK_F(UT_RecentIterateWorker, ReloadSingleChange)
+{
+    const int count = benchmark_ext::size(20000);
+    const int rounds = 20;
+    RecentXbel xbel(count);
+    ASSERT_TRUE(xbel.dir.isValid());
+
+    const qint64 firstCost = benchmark_ext::elapsedMs([&] { reload(xbel.path()); });
+    ASSERT_EQ(added, count);
+
+    // 每轮只修改一个条目，模拟应用逐个打开文件时 xbel 的变化
+    qint64 changeCost { 0 };
+    for (int i = 0; i < rounds; ++i) {
+        ++xbel.versions[(i * 7919) % count];
+        xbel.write();
+        changeCost += benchmark_ext::elapsedNs([&] { reload(xbel.path()); });
+    }
+    EXPECT_EQ(changed, rounds);
+    EXPECT_TRUE(removed.isEmpty());
+
+    benchmark_ext::report() << "recent xbel" << count << "bookmarks, first reload" << firstCost << "ms,"
+                            << "single change reload" << changeCost / rounds / 1000 << "us";
+}
@@ -345,8 +345,8 @@ public:
 
         DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
         DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
-        fmodel->d->fileMap.insert(in1, info1);
-        fmodel->d->fileMap.insert(in2, info2);
+        fmodel->d->fileList.append(in1, info1);
+        fmodel->d->fileList.append(in2, info2);
         model->d->fileMap.insert(in1, info1);
         model->d->fileMap.insert(in2, info2);
     }
@@ -5,6 +5,7 @@
 #include "grid/gridcore.h"
 
 #include "stubext.h"
+#include "benchmarkext.h"
 
 #include <gtest/gtest.h>
 
@@ -261,3 +262,92 @@ TEST(AppendOper, tryAppendAfter)
     EXPECT_TRUE(ao.overload.contains(QString("5")));
     EXPECT_EQ(ao.overload.size(), 1);
 }
+
+TEST(GridOccupancy, nextVoid)
+{
+    QHash<QPoint, QString> used;
+    for (int y = 0; y < 9; ++y)
+        for (int x = 0; x < 7; ++x)
+            used.insert(QPoint(x, y), QString());
+    used.insert(QPoint(8, 0), QString());
+    used.insert(QPoint(20, 20), QString());
+
+    GridOccupancy occupancy(QSize(9, 9), used);
+    EXPECT_EQ(occupancy.cellCount(), 81);
+    EXPECT_EQ(occupancy.nextVoid(0), 63);
+    EXPECT_EQ(occupancy.toPos(63), QPoint(7, 0));
+    EXPECT_EQ(occupancy.nextVoid(72), 73);
+    EXPECT_EQ(occupancy.toCell(QPoint(8, 1)), 73);
+    EXPECT_EQ(occupancy.nextVoid(81), -1);
+
+    occupancy.setUsed(80);
+    EXPECT_EQ(occupancy.nextVoid(80), -1);
+
+    GridOccupancy empty(QSize(0, 9), used);
+    EXPECT_EQ(empty.nextVoid(0), -1);
+}
+
+TEST(AppendOper, appendAfter)
+{
+    GridCore core;
+    AppendOper ao(&core);
+    ao.surfaces.insert(1, QSize(3, 3));
+    ao.insert(1, QPoint(1, 2), "used");
+
+    auto left = ao.appendAfter({ "1", "2", "3", "4", "5" }, 1, QPoint(1, 1));
+    EXPECT_EQ(ao.posItem[1].value(QPoint(1, 1)), QString("1"));
+    EXPECT_EQ(ao.posItem[1].value(QPoint(2, 0)), QString("2"));
+    EXPECT_EQ(ao.posItem[1].value(QPoint(2, 2)), QString("4"));
+    ASSERT_EQ(left.size(), 1);
+    EXPECT_EQ(left.first(), QString("5"));
+
+    // begin is out of the column, append from next column
+    left = ao.appendAfter({ "6" }, 1, QPoint(0, 5));
+    EXPECT_TRUE(left.isEmpty());
+    EXPECT_EQ(ao.posItem[1].value(QPoint(1, 0)), QString("6"));
+}
+
+TEST(AppendOper, appendOverflow)
+{
+    GridCore core;
+    core.surfaces.insert(1, QSize(4, 3));
+    core.surfaces.insert(2, QSize(4, 3));
+
+    QStringList items;
+    for (int i = 0; i < 30; ++i)
+        items.append(QString("file:///home/test/Desktop/%0").arg(i));
+
+    AppendOper ao(&core);
+    ao.append(items.mid(0, 2));
+    ao.tryAppendAfter(items.mid(2), 1, QPoint(1, 1));
+
+    // fill the rest of screen 1 after the drop point, then screen 2, the others overload
+    const int cells = 4 * 3 * 2;
+    EXPECT_EQ(ao.posItem[1].size() + ao.posItem[2].size(), cells);
+    EXPECT_EQ(ao.overload.size(), 30 - cells);
+    EXPECT_EQ(ao.itemPos[1].value(items.at(2)), QPoint(1, 1));
+}
+
+DFM_BENCHMARK(AppendOper, appendLargeDrop)
+{
+    const int count = benchmark_ext::size(20000);
+
+    // two 4K screens with small icons
+    GridCore core;
+    core.surfaces.insert(1, QSize(64, 36));
+    core.surfaces.insert(2, QSize(64, 36));
+
+    QStringList items;
+    for (int i = 0; i < count; ++i)
+        items.append(QString("file:///home/test/Desktop/%0").arg(i));
+
+    AppendOper ao(&core);
+    const qint64 cost = benchmark_ext::elapsedMs([&]() {
+        ao.append(items.mid(0, 100));
+        ao.tryAppendAfter(items.mid(100), 1, QPoint(10, 10));
+    });
+
+    const int cells = 64 * 36 * 2;
+    EXPECT_EQ(ao.overload.size(), qMax(0, count - cells));
+    benchmark_ext::report() << "append" << count << "items to" << cells << "cells:" << cost << "ms";
+}
@@ -209,8 +209,8 @@ TEST(CanvasProxyModel, fileInfo)
 
     model.d->fileMap.insert(in1, info1);
     model.d->fileMap.insert(in2, info2);
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
 
     EXPECT_EQ(model.fileInfo(QModelIndex()), nullptr);
     EXPECT_EQ(model.fileInfo(QModelIndex(2, 0, nullptr, &model)), nullptr);
@@ -255,8 +255,8 @@ TEST(CanvasProxyModel, data_and_map)
 
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
 
     stub_ext::StubExt stub;
     QModelIndex index;
@@ -339,8 +339,8 @@ TEST(CanvasProxyModel, sort)
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
     model.d->fileMap.insert(in1, info1);
     model.d->fileMap.insert(in2, info2);
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
 
     QPersistentModelIndex idx1 = model.index(in1);
     QPersistentModelIndex idx2 = model.index(in2);
@@ -417,8 +417,8 @@ TEST(CanvasProxyModel, fetch)
     fm.d->fileList.append(in1);
     fm.d->fileList.append(in2);
 
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
 
     int bi = -1;
     QObject::connect(&model, &CanvasProxyModel::rowsAboutToBeInserted, &model, [&bi, &model](const QModelIndex &parent, int first, int last) {
@@ -562,9 +562,9 @@ TEST(CanvasProxyModelPrivate, createMapping)
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
     DFMSyncFileInfoPointer info3(new SyncFileInfo(in3));
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
-    fm.d->fileMap.insert(in3, info3);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
+    fm.d->fileList.append(in3, info3);
     model.d->fileMap.insert(in3, info3);
 
     stub_ext::StubExt stub;
@@ -585,7 +585,7 @@ TEST(CanvasProxyModelPrivate, createMapping)
     });
 
     model.d->createMapping();
-    EXPECT_EQ(filterUrl, fm.d->fileList);
+    EXPECT_EQ(filterUrl, fm.d->fileList.toList());
     EXPECT_TRUE(sort);
     ASSERT_EQ(model.d->fileList.size(), 2);
     EXPECT_EQ(model.d->fileList.at(0), in3);
@@ -642,9 +642,9 @@ TEST(CanvasProxyModelPrivate, sourceRowsInserted)
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
     DFMSyncFileInfoPointer info3(new SyncFileInfo(in3));
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
-    fm.d->fileMap.insert(in3, info3);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
+    fm.d->fileList.append(in3, info3);
 
     QUrl filterUrl;
     stub_ext::StubExt stub;
@@ -717,9 +717,9 @@ TEST(CanvasProxyModelPrivate, sourceRowsAboutToBeRemoved)
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
     DFMSyncFileInfoPointer info3(new SyncFileInfo(in3));
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
-    fm.d->fileMap.insert(in3, info3);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
+    fm.d->fileList.append(in3, info3);
     model.d->fileMap.insert(in1, info1);
     model.d->fileMap.insert(in2, info2);
     model.d->fileMap.insert(in3, info3);
@@ -773,6 +773,43 @@ TEST(CanvasProxyModelPrivate, sourceRowsAboutToBeRemoved)
     }
 }
 
+TEST(CanvasProxyModelPrivate, sourceRowsAboutToBeRemoved_ranges)
+{
+    CanvasProxyModel model;
+    FileInfoModel fm;
+    model.d->srcModel = &fm;
+
+    QList<QUrl> urls;
+    for (int i = 0; i < 5; ++i) {
+        auto url = QUrl::fromLocalFile(QString("/home/test%0").arg(i));
+        DFMSyncFileInfoPointer info(new SyncFileInfo(url));
+        urls.append(url);
+        model.d->fileList.append(url);
+        model.d->fileMap.insert(url, info);
+    }
+
+    // source order differs from the canvas order: 0, 2, 3, 1, 4
+    for (int i : { 0, 2, 3, 1, 4 })
+        fm.d->fileList.append(urls.at(i), model.d->fileMap.value(urls.at(i)));
+
+    stub_ext::StubExt stub;
+    stub.set_lamda(&CanvasProxyModelPrivate::removeFilter, [] { return false; });
+
+    QList<QPair<int, int>> removed;
+    QObject::connect(&model, &CanvasProxyModel::rowsAboutToBeRemoved, &model, [&removed](const QModelIndex &, int first, int last) {
+        removed.append(qMakePair(first, last));
+    });
+
+    // remove test0, test2 and test3, which are row 0 and rows 2-3 in canvas.
+    model.d->sourceRowsAboutToBeRemoved(QModelIndex(), 0, 2);
+    ASSERT_EQ(removed.size(), 2);
+    EXPECT_EQ(removed.at(0), qMakePair(2, 3));
+    EXPECT_EQ(removed.at(1), qMakePair(0, 0));
+    EXPECT_EQ(model.d->fileList, QList<QUrl>({ urls.at(1), urls.at(4) }));
+    EXPECT_EQ(model.d->fileMap.size(), 2);
+    EXPECT_EQ(model.index(urls.at(4)).row(), 1);
+}
+
 TEST(CanvasProxyModelPrivate, sourceDataRenamed)
 {
     CanvasProxyModel model;
@@ -786,8 +823,8 @@ TEST(CanvasProxyModelPrivate, sourceDataRenamed)
 
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
 
     bool up = false;
     QObject::connect(&model, &CanvasProxyModel::dataChanged, &model,
@@ -898,8 +935,8 @@ TEST(CanvasProxyModelPrivate, lessThan)
 
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
-    fm.d->fileMap.insert(in1, info1);
-    fm.d->fileMap.insert(in2, info2);
+    fm.d->fileList.append(in1, info1);
+    fm.d->fileList.append(in2, info2);
     model.d->fileMap.insert(in1, info1);
     model.d->fileMap.insert(in2, info2);
 
@@ -6,6 +6,7 @@
 #include "model/fileprovider.h"
 #include "utils/fileutil.h"
 #include "stubext.h"
+#include "benchmarkext.h"
 
 #include "dfm-base/utils/fileutils.h"
 #include <gtest/gtest.h>
@@ -104,7 +105,7 @@ TEST(FileInfoModel, index)
     DFMSyncFileInfoPointer info(new SyncFileInfo(in));
     FileInfoModel model;
     model.d->fileList.append(in);
-    model.d->fileMap.insert(in, info);
+    model.d->fileList.append(in, info);
 
     auto idx = model.index(-1, 0);
     EXPECT_FALSE(idx.isValid());
@@ -130,7 +131,7 @@ TEST(FileInfoModel, index2)
     FileInfoModel model;
     model.d->fileProvider->rootUrl = QUrl::fromLocalFile("/home");
     model.d->fileList.append(in);
-    model.d->fileMap.insert(in, info);
+    model.d->fileList.append(in, info);
 
     auto idx = model.index(QUrl());
     EXPECT_FALSE(idx.isValid());
@@ -153,7 +154,7 @@ TEST(FileInfoModel, fileInfo)
     FileInfoModel model;
     model.d->fileProvider->rootUrl = QUrl::fromLocalFile("/home");
     model.d->fileList.append(in);
-    model.d->fileMap.insert(in, info);
+    model.d->fileList.append(in, info);
 
     auto local = model.fileInfo(model.rootIndex());
     EXPECT_EQ(local->urlOf(SyncFileInfo::FileUrlInfoType::kUrl), model.d->fileProvider->rootUrl);
@@ -219,8 +220,8 @@ TEST(FileInfoModel, update)
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
     DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
 
-    model.d->fileMap.insert(in1, info1);
-    model.d->fileMap.insert(in2, info2);
+    model.d->fileList.append(in1, info1);
+    model.d->fileList.append(in2, info2);
 
     stub_ext::StubExt stub;
     int refresh = 0;
@@ -250,7 +251,7 @@ TEST(FileInfoModel, updateFile)
     auto in1 = QUrl::fromLocalFile("/home/test");
     model.d->fileList.append(in1);
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
-    model.d->fileMap.insert(in1, info1);
+    model.d->fileList.append(in1, info1);
 
     stub_ext::StubExt stub;
     int refresh = 0;
@@ -309,7 +310,7 @@ TEST(FileInfoModel, mimeData)
 
     auto in1 = QUrl::fromLocalFile("/home/test");
     model.d->fileList.append(in1);
-    model.d->fileMap.insert(in1, {});
+    model.d->fileList.append(in1, {});
 
     auto mm = model.mimeData({model.index(0)});
     ASSERT_NE(mm, nullptr);
@@ -334,7 +335,7 @@ TEST(FileInfoModel, flags)
     auto in1 = QUrl::fromLocalFile("/home/test");
     model.d->fileList.append(in1);
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
-    model.d->fileMap.insert(in1, info1);
+    model.d->fileList.append(in1, info1);
 
     EXPECT_EQ(model.flags(QModelIndex()), model.QAbstractItemModel::flags(QModelIndex()));
 
@@ -417,7 +418,7 @@ TEST(FileInfoModelPrivate, resetData)
     EXPECT_TRUE(be);
     EXPECT_TRUE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
-    EXPECT_TRUE(model.d->fileMap.contains(in1));
+    EXPECT_TRUE(model.d->fileList.contains(in1));
     EXPECT_EQ(model.modelState(), 1);
 }
 
@@ -442,18 +443,21 @@ TEST(FileInfoModelPrivate, insertData)
     });
 
     model.d->insertData(in1);
+    EXPECT_FALSE(be);
+    model.d->flushPending();
     EXPECT_TRUE(be);
     EXPECT_TRUE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
-    ASSERT_TRUE(model.d->fileMap.contains(in1));
+    ASSERT_TRUE(model.d->fileList.contains(in1));
 
     be = false;
     end = false;
     model.d->insertData(in1);
+    model.d->flushPending();
     EXPECT_FALSE(be);
     EXPECT_FALSE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
-    ASSERT_TRUE(model.d->fileMap.contains(in1));
+    ASSERT_TRUE(model.d->fileList.contains(in1));
 }
 
 TEST(FileInfoModelPrivate, removeData)
@@ -462,7 +466,7 @@ TEST(FileInfoModelPrivate, removeData)
     auto in1 = QUrl::fromLocalFile("/home/test");
     model.d->fileList.append(in1);
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
-    model.d->fileMap.insert(in1, info1);
+    model.d->fileList.append(in1, info1);
 
     bool be = false;
     QObject::connect(&model, &FileInfoModel::rowsAboutToBeRemoved, &model,
@@ -480,14 +484,17 @@ TEST(FileInfoModelPrivate, removeData)
     });
 
     model.d->removeData(QUrl::fromLocalFile("/home/test2"));
+    model.d->flushPending();
     EXPECT_FALSE(be);
     EXPECT_FALSE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
-    ASSERT_TRUE(model.d->fileMap.contains(in1));
+    ASSERT_TRUE(model.d->fileList.contains(in1));
 
     be = false;
     end = false;
     model.d->removeData(in1);
+    EXPECT_FALSE(be);
+    model.d->flushPending();
     EXPECT_TRUE(be);
     EXPECT_TRUE(end);
     EXPECT_TRUE(model.d->fileList.isEmpty());
@@ -519,17 +526,17 @@ TEST(FileInfoModelPrivate, replaceData)
     });
 
     model.d->fileList.append(in1);
-    model.d->fileMap.insert(in1, info1);
+    model.d->fileList.append(in1, info1);
 
     stub_ext::StubExt stub;
     QUrl rd;
-    stub.set_lamda(&FileInfoModelPrivate::removeData, [&rd](FileInfoModelPrivate *, const QUrl &url){
-        rd = url;
+    stub.set_lamda(&FileInfoModelPrivate::removeRows, [&rd](FileInfoModelPrivate *, const QList<QUrl> &urls){
+        rd = urls.first();
     });
 
     QUrl ins;
-    stub.set_lamda(&FileInfoModelPrivate::insertData, [&ins](FileInfoModelPrivate *, const QUrl &url){
-        ins = url;
+    stub.set_lamda(&FileInfoModelPrivate::insertRows, [&ins](FileInfoModelPrivate *, const QList<QUrl> &urls){
+        ins = urls.first();
     });
 
 
@@ -546,7 +553,6 @@ TEST(FileInfoModelPrivate, replaceData)
     // move a to b, a is not existed
     {
         model.d->fileList.clear();
-        model.d->fileMap.clear();
 
         up = false;
         ins = QUrl();
@@ -564,9 +570,9 @@ TEST(FileInfoModelPrivate, replaceData)
     // move a to b, b is existed
     {
         model.d->fileList.append(in1);
-        model.d->fileMap.insert(in1, info1);
+        model.d->fileList.append(in1, info1);
         model.d->fileList.append(in2);
-        model.d->fileMap.insert(in2, info2);
+        model.d->fileList.append(in2, info2);
 
         up = false;
         ins = QUrl();
@@ -585,9 +591,8 @@ TEST(FileInfoModelPrivate, replaceData)
     // move a to b, b is not existed
     {
         model.d->fileList.clear();
-        model.d->fileMap.clear();
         model.d->fileList.append(in1);
-        model.d->fileMap.insert(in1, info1);
+        model.d->fileList.append(in1, info1);
 
         up = false;
         ins = QUrl();
@@ -604,8 +609,8 @@ TEST(FileInfoModelPrivate, replaceData)
         EXPECT_TRUE(up);
         ASSERT_EQ(model.d->fileList.size(), 1);
         EXPECT_EQ(model.d->fileList.first(), in2);
-        ASSERT_EQ(model.d->fileMap.size(), 1);
-        EXPECT_TRUE(model.d->fileMap.contains(in2));
+        ASSERT_EQ(model.d->fileList.size(), 1);
+        EXPECT_TRUE(model.d->fileList.contains(in2));
     }
 }
 
@@ -613,8 +618,7 @@ TEST(FileInfoModelPrivate, dataUpdated)
 {
     FileInfoModel model;
     QUrl url1 = QUrl::fromLocalFile("temp_url");
-    model.d->fileMap.insert(url1,FileInfoPointer(new FileInfo(url1)));
-    model.d->fileList.push_back(url1);
+    model.d->fileList.append(url1,FileInfoPointer(new FileInfo(url1)));
     model.d->q = &model;
     bool connect = false;
     QObject::connect(model.d->q, &QAbstractItemModel::dataChanged,[&connect](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles){
@@ -628,8 +632,7 @@ TEST(FileInfoModelPrivate, thumbUpdated)
      FileInfoModel model;
      QUrl url = QUrl::fromLocalFile("temp_url1");
      QString thumb = QString("temp_url2");
-     model.d->fileMap.insert(url,FileInfoPointer(new FileInfo(url)));
-     model.d->fileList.push_back(url);
+     model.d->fileList.append(url,FileInfoPointer(new FileInfo(url)));
      model.d->q = &model;
      bool connect = false;
      QObject::connect(model.d->q, &QAbstractItemModel::dataChanged,[&connect](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles){
@@ -665,3 +668,147 @@ TEST(FileInfoModel, dropMimeData)
     stub.set_lamda(&FileUtils::isTrashDesktopFile,[](){return true;});
     EXPECT_TRUE(model.dropMimeData(&data,action,row,column,parent));
 }
+
+TEST(FileInfoModelPrivate, removeRows)
+{
+    FileInfoModel model;
+    QList<QUrl> urls;
+    for (int i = 0; i < 6; ++i) {
+        urls.append(QUrl::fromLocalFile(QString("/home/test%0").arg(i)));
+        model.d->fileList.append(urls.last());
+    }
+
+    QList<QPair<int, int>> ranges;
+    QObject::connect(&model, &FileInfoModel::rowsAboutToBeRemoved, &model,
+                     [&ranges](const QModelIndex &, int first, int last){
+        ranges.append(qMakePair(first, last));
+    });
+
+    model.d->removeData(urls.at(4));
+    model.d->removeData(urls.at(1));
+    model.d->removeData(urls.at(2));
+    model.d->removeData(QUrl::fromLocalFile("/home/test6"));
+    model.d->flushPending();
+
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges.at(0), qMakePair(4, 4));
+    EXPECT_EQ(ranges.at(1), qMakePair(1, 2));
+    EXPECT_EQ(model.files(), QList<QUrl>({ urls.at(0), urls.at(3), urls.at(5) }));
+    EXPECT_EQ(model.index(urls.at(3)).row(), 1);
+    EXPECT_EQ(model.index(urls.at(5)).row(), 2);
+    EXPECT_FALSE(model.index(urls.at(2)).isValid());
+}
+
+TEST(FileInfoModelPrivate, insertRows)
+{
+    FileInfoModel model;
+    auto in1 = QUrl::fromLocalFile("/home/test");
+    model.d->fileList.append(in1);
+
+    QList<QPair<int, int>> ranges;
+    QObject::connect(&model, &FileInfoModel::rowsAboutToBeInserted, &model,
+                     [&ranges](const QModelIndex &, int first, int last){
+        ranges.append(qMakePair(first, last));
+    });
+
+    auto in2 = QUrl::fromLocalFile("/home/test2");
+    auto in3 = QUrl::fromLocalFile("/home/test3");
+    model.d->insertData(in2);
+    model.d->insertData(in3);
+    model.d->insertData(in2);
+
+    // 删除前先处理缓存中的新增
+    model.d->removeData(in1);
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT_EQ(ranges.first(), qMakePair(1, 2));
+
+    model.d->flushPending();
+    EXPECT_EQ(model.files(), QList<QUrl>({ in2, in3 }));
+}
+
+namespace {
+struct PasteCost
+{
+    qint64 paste { 0 };
+    qint64 lookup { 0 };
+    qint64 remove { 0 };
+};
+
+// 粘贴 count 个文件后删除其中一半，检查信号和行号并返回各阶段耗时
+PasteCost pasteAndRemove(int count)
+{
+    FileInfoModel model;
+    FileInfoPointer info(new FileInfo(QUrl::fromLocalFile("/home/test")));
+    stub_ext::StubExt stub;
+    stub.set_lamda(&DesktopFileCreator::createFileInfo, [&info]() {
+        return info;
+    });
+    stub.set_lamda(&FileUtils::isDesktopFileInfo, []() {
+        return false;
+    });
+
+    int inserted = 0;
+    int insertSignals = 0;
+    QObject::connect(&model, &FileInfoModel::rowsInserted, &model,
+                     [&inserted, &insertSignals](const QModelIndex &, int first, int last){
+        inserted += last - first + 1;
+        ++insertSignals;
+    });
+
+    int removed = 0;
+    QObject::connect(&model, &FileInfoModel::rowsRemoved, &model,
+                     [&removed](const QModelIndex &, int first, int last){
+        removed += last - first + 1;
+    });
+
+    QList<QUrl> urls;
+    urls.reserve(count);
+    for (int i = 0; i < count; ++i)
+        urls.append(QUrl::fromLocalFile(QString("/home/test/Desktop/paste_%0.txt").arg(i)));
+
+    PasteCost cost;
+    cost.paste = benchmark_ext::elapsedMs([&]() {
+        for (const QUrl &url : urls)
+            emit model.d->fileProvider->fileInserted(url);
+        model.d->flushPending();
+    });
+
+    EXPECT_EQ(model.rowCount(model.rootIndex()), count);
+    EXPECT_EQ(inserted, count);
+    EXPECT_EQ(insertSignals, 1);
+
+    int misplaced = 0;
+    cost.lookup = benchmark_ext::elapsedMs([&]() {
+        for (int i = 0; i < count; ++i)
+            misplaced += model.index(urls.at(i)).row() != i;
+    });
+    EXPECT_EQ(misplaced, 0);
+
+    // 删除一半分散的文件，行号需要保持连续
+    cost.remove = benchmark_ext::elapsedMs([&]() {
+        for (int i = 0; i < count; i += 2)
+            emit model.d->fileProvider->fileRemoved(urls.at(i));
+        model.d->flushPending();
+    });
+
+    EXPECT_EQ(removed, (count + 1) / 2);
+    EXPECT_EQ(model.rowCount(model.rootIndex()), count / 2);
+    for (int i = 1; i < count; i += 2)
+        misplaced += model.index(urls.at(i)).row() != i / 2;
+    EXPECT_EQ(misplaced, 0);
+    return cost;
+}
+}
+
+TEST(FileInfoModelPrivate, pasteFiles)
+{
+    pasteAndRemove(21);
+}
+
+DFM_BENCHMARK(FileInfoModelPrivate, pasteFiles)
+{
+    const int count = benchmark_ext::size(20000);
+    const PasteCost &cost = pasteAndRemove(count);
+    benchmark_ext::report() << "paste" << count << "files:" << cost.paste << "ms, lookup:" << cost.lookup
+                            << "ms, remove half:" << cost.remove << "ms";
+}
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "model/indexedfilelist.h"
+
+#include <gtest/gtest.h>
+
+using namespace ddplugin_canvas;
+using namespace dfmbase;
+
+static QList<QUrl> testUrls(int count)
+{
+    QList<QUrl> urls;
+    for (int i = 0; i < count; ++i)
+        urls.append(QUrl::fromLocalFile(QString("/home/test%0").arg(i)));
+    return urls;
+}
+
+TEST(IndexedFileList, append)
+{
+    IndexedFileList list;
+    auto urls = testUrls(3);
+    for (const QUrl &url : urls)
+        EXPECT_TRUE(list.append(url));
+
+    FileInfoPointer info(new FileInfo(urls.at(1)));
+    EXPECT_FALSE(list.append(urls.at(1), info));
+    EXPECT_EQ(list.count(), 3);
+    EXPECT_EQ(list.fileInfo(urls.at(1)), info);
+    EXPECT_EQ(list.fileInfo(1), info);
+    EXPECT_EQ(list.fileInfo(3), nullptr);
+    EXPECT_EQ(list.indexOf(urls.at(2)), 2);
+    EXPECT_EQ(list.indexOf(QUrl::fromLocalFile("/home/test3")), -1);
+    EXPECT_EQ(list.toList(), urls);
+}
+
+TEST(IndexedFileList, replace)
+{
+    IndexedFileList list;
+    auto urls = testUrls(3);
+    for (const QUrl &url : urls)
+        list.append(url);
+
+    auto in = QUrl::fromLocalFile("/home/test3");
+    EXPECT_FALSE(list.replace(urls.at(1), urls.at(2), {}));
+    EXPECT_FALSE(list.replace(in, urls.at(2), {}));
+    EXPECT_TRUE(list.replace(urls.at(1), in, {}));
+    EXPECT_EQ(list.indexOf(in), 1);
+    EXPECT_FALSE(list.contains(urls.at(1)));
+    EXPECT_EQ(list.at(1), in);
+}
+
+TEST(IndexedFileList, removeRows)
+{
+    IndexedFileList list;
+    auto urls = testUrls(8);
+    for (const QUrl &url : urls)
+        list.append(url);
+
+    list.removeRows(5, 2);
+    list.removeRows(1, 2);
+
+    // 行号修正前也能查到正确的位置
+    EXPECT_EQ(list.indexOf(urls.at(0)), 0);
+    EXPECT_EQ(list.indexOf(urls.at(3)), 1);
+    EXPECT_EQ(list.indexOf(urls.at(7)), 3);
+    EXPECT_EQ(list.indexOf(urls.at(5)), -1);
+
+    list.updateIndexes();
+    EXPECT_EQ(list.indexOf(urls.at(4)), 2);
+    EXPECT_EQ(list.indexOf(urls.at(7)), 3);
+    EXPECT_EQ(list.toList(), QList<QUrl>({ urls.at(0), urls.at(3), urls.at(4), urls.at(7) }));
+
+    list.removeRows(3, 2);
+    EXPECT_EQ(list.count(), 4);
+
+    list.clear();
+    EXPECT_TRUE(list.isEmpty());
+    EXPECT_FALSE(list.contains(urls.at(0)));
+}
@@ -710,7 +710,7 @@ public:
         {
             obj.d->sourceModel->d->fileList.append(fakeFile);
             fakeInfo.reset(new SyncFileInfo(fakeFile));
-            obj.d->sourceModel->d->fileMap.insert(fakeFile, fakeInfo);
+            obj.d->sourceModel->d->fileList.append(fakeFile, fakeInfo);
 
             obj.d->canvasModel->d->fileList.append(fakeFile);
             obj.d->canvasModel->d->fileMap.insert(fakeFile, fakeInfo);
@@ -764,6 +764,9 @@ TEST_F(TestCanvasMrgFile, onFileInserted)
     stub.set_lamda((void (CanvasGrid::*)(const QString &))&CanvasGrid::append, [&callAppend](CanvasGrid *, const QString &item) {
         callAppend = item;
     });
+    stub.set_lamda((void (CanvasGrid::*)(const QStringList &))&CanvasGrid::append, [&callAppend](CanvasGrid *, const QStringList &items) {
+        callAppend = items.first();
+    });
 
     bool hasPoint = false;
     stub.set_lamda(&CanvasGrid::point, [&hasPoint]() {
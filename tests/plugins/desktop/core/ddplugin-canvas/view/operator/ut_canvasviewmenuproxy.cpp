@@ -172,7 +172,7 @@ TEST(CanvasViewMenuProxy, showNormalMenu)
     DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
 
     model.d->fileMap.insert(in1, info1);
-    fmodel.d->fileMap.insert(in1, info1);
+    fmodel.d->fileList.append(in1, info1);
 
     sel.selectedCache.append(model.index(0));
 
@@ -366,8 +366,8 @@ public:
 
         DFMSyncFileInfoPointer info1(new SyncFileInfo(in1));
         DFMSyncFileInfoPointer info2(new SyncFileInfo(in2));
-        fmodel->d->fileMap.insert(in1, info1);
-        fmodel->d->fileMap.insert(in2, info2);
+        fmodel->d->fileList.append(in1, info1);
+        fmodel->d->fileList.append(in2, info2);
         model->d->fileMap.insert(in1, info1);
         model->d->fileMap.insert(in2, info2);
 
@@ -582,7 +582,7 @@ TEST_F(TestCanvasView, indexAt)
     model->d->fileList.append(in3);
 
     DFMSyncFileInfoPointer info3(new SyncFileInfo(in3));
-    fmodel->d->fileMap.insert(in3, info3);
+    fmodel->d->fileList.append(in3, info3);
     model->d->fileMap.insert(in3, info3);
 
     stub_ext::StubExt stub;
@@ -935,13 +935,13 @@ TEST_F(TestCanvasView, moveCursor)
     DFMSyncFileInfoPointer info4(new SyncFileInfo(in4));
     DFMSyncFileInfoPointer info5(new SyncFileInfo(in5));
     DFMSyncFileInfoPointer info6(new SyncFileInfo(in6));
-    fmodel->d->fileMap.insert(in3, info3);
+    fmodel->d->fileList.append(in3, info3);
     model->d->fileMap.insert(in3, info3);
-    fmodel->d->fileMap.insert(in4, info4);
+    fmodel->d->fileList.append(in4, info4);
     model->d->fileMap.insert(in4, info4);
-    fmodel->d->fileMap.insert(in5, info5);
+    fmodel->d->fileList.append(in5, info5);
     model->d->fileMap.insert(in5, info5);
-    fmodel->d->fileMap.insert(in6, info6);
+    fmodel->d->fileList.append(in6, info6);
     model->d->fileMap.insert(in6, info6);
 
     stub_ext::StubExt stub;
@@ -1037,7 +1037,7 @@ TEST_F(TestCanvasView, moveCursor)
     fmodel->d->fileList.append(in7);
     model->d->fileList.append(in7);
     DFMSyncFileInfoPointer info7(new SyncFileInfo(in7));
-    fmodel->d->fileMap.insert(in7, info7);
+    fmodel->d->fileList.append(in7, info7);
     model->d->fileMap.insert(in7, info7);
 
     {
@@ -9,8 +9,13 @@
 #include <dfm-framework/dpf.h>
 
 #include "stubext.h"
+#include "benchmarkext.h"
 #include <gtest/gtest.h>
 
+#include <QTemporaryDir>
+#include <QImageReader>
+#include <QFile>
+
 DFMBASE_USE_NAMESPACE
 DDP_BACKGROUND_USE_NAMESPACE
 DPF_USE_NAMESPACE
@@ -406,33 +411,124 @@ TEST_F(UT_backGroundManager, runUpdate)
    BackgroundBridge::Requestion req;
    req.path = "file:/temp";
    req.screen = "window";
-   req.size = QSize(1,1);
+   req.size = QSize(2,2);
    req.pixmap = QPixmap();
 
    QList<BackgroundBridge::Requestion> reqs;
    reqs.push_back(req);
+   req.screen = "window2";
+   reqs.push_back(req);
 
    BackgroundBridge self(nullptr);
    self.getting = true;
 
-   stub.set_lamda(&QPixmap::width,[&self](){
-       __DBG_STUB_INVOKE__ ;
-       self.getting = false;
-       return 2;
-   });
-   stub.set_lamda(&QPixmap::height,[&self](){
-       __DBG_STUB_INVOKE__
-       self.getting = false;
-       return 2;
-   });
-   stub.set_lamda(&BackgroundBridge::getPixmap,[](){
+   int decoded = 0;
+   stub.set_lamda(&BackgroundBridge::getImage,[&decoded](){
        __DBG_STUB_INVOKE__
-       return QPixmap(2,2);}
+       ++decoded;
+       QImage img(2, 2, QImage::Format_RGB32);
+       img.fill(Qt::red);
+       return img;}
    );
 
+   QList<BackgroundBridge::Requestion> *result = nullptr;
+   stub.set_lamda(&BackgroundBridge::onFinished,[&result](BackgroundBridge *, void *pData){
+       __DBG_STUB_INVOKE__
+       result = reinterpret_cast<QList<BackgroundBridge::Requestion> *>(pData);
+   });
+
    self.runUpdate(&self,reqs);
+   qApp->processEvents();
 
    EXPECT_EQ(self.getting,false);
+   EXPECT_EQ(decoded, 1);
+   ASSERT_NE(result, nullptr);
+   ASSERT_EQ(result->size(), 2);
+   EXPECT_EQ(result->at(0).pixmap.cacheKey(), result->at(1).pixmap.cacheKey());
+   delete result;
+}
+
+TEST(BackgroundBridge, getImage)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QImage src(400, 200, QImage::Format_RGB32);
+    src.fill(Qt::blue);
+    const QString jpg = dir.filePath("wallpaper.png");
+    // the content is jpeg but the suffix is png
+    ASSERT_TRUE(src.save(jpg, "jpg"));
+
+    bool scaled = false;
+    QImage img = BackgroundBridge::getImage(QUrl::fromLocalFile(jpg).toString(), QSize(100, 100), &scaled);
+    EXPECT_EQ(img.size(), QSize(100, 100));
+    EXPECT_TRUE(scaled);
+
+    img = BackgroundBridge::getImage(jpg, QSize(800, 400), &scaled);
+    EXPECT_EQ(img.size(), QSize(800, 400));
+    EXPECT_TRUE(scaled);
+
+    img = BackgroundBridge::getImage(jpg, QSize(400, 200), &scaled);
+    EXPECT_EQ(img.size(), QSize(400, 200));
+    EXPECT_FALSE(scaled);
+
+    EXPECT_TRUE(BackgroundBridge::getImage(dir.filePath("none.jpg"), QSize(100, 100)).isNull());
+    EXPECT_TRUE(BackgroundBridge::getImage(jpg, QSize()).isNull());
+}
+
+TEST(BackgroundBridge, cache)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString src = dir.filePath("wallpaper.jpg");
+    QFile(src).open(QIODevice::WriteOnly);
+
+    const QString cache = BackgroundBridge::cacheFile(src, QSize(100, 100), 1.0);
+    EXPECT_FALSE(cache.isEmpty());
+    EXPECT_EQ(BackgroundBridge::cacheFile(src, QSize(100, 100), 1.0), cache);
+    EXPECT_NE(BackgroundBridge::cacheFile(src, QSize(100, 100), 2.0), cache);
+    EXPECT_NE(BackgroundBridge::cacheFile(src, QSize(200, 100), 1.0), cache);
+    EXPECT_TRUE(BackgroundBridge::cacheFile(dir.filePath("none.jpg"), QSize(100, 100), 1.0).isEmpty());
+
+    const QString file = dir.filePath("cache/test.png");
+    QImage img(10, 10, QImage::Format_RGB32);
+    img.fill(Qt::green);
+    BackgroundBridge::saveCache(file, img);
+    EXPECT_EQ(QImage(file).size(), QSize(10, 10));
+}
+
+DFM_BENCHMARK(BackgroundBridge, peakMemory)
+{
+    using benchmark_ext::peakResidentKb;
+    using benchmark_ext::resetPeakResident;
+
+    // an 8K wallpaper shown on a 4K screen
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("8k.jpg");
+    {
+        QImage src(7680, 4320, QImage::Format_RGB32);
+        src.fill(Qt::darkCyan);
+        ASSERT_TRUE(src.save(path, "jpg"));
+    }
+    const QSize screen(3840, 2160);
+
+    const bool canReset = resetPeakResident();
+    const qint64 base = peakResidentKb();
+    QImage img = BackgroundBridge::getImage(path, screen);
+    const qint64 scaledPeak = peakResidentKb() - base;
+    EXPECT_EQ(img.size(), screen);
+    img = QImage();
+
+    resetPeakResident();
+    const qint64 fullBase = peakResidentKb();
+    img = QImageReader(path).read().scaled(screen, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    const qint64 fullPeak = peakResidentKb() - fullBase;
+    EXPECT_EQ(img.size(), screen);
+
+    benchmark_ext::report() << "wallpaper 7680x4320 to" << screen << "peak rss increase (KiB): scaled decoding" << scaledPeak
+                            << "full decoding" << fullPeak;
+    if (canReset)
+        EXPECT_LT(scaledPeak, fullPeak);
 }
 
 TEST_F(UT_backGroundManager, testBackground)
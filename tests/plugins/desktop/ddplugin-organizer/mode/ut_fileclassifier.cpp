@@ -9,6 +9,7 @@
 #include <dfm-framework/dpf.h>
 
 #include <stubext.h>
+#include <benchmarkext.h>
 
 #include <gtest/gtest.h>
 
@@ -408,3 +409,124 @@ TEST_F(TestFileClassifier2, change)
     EXPECT_EQ(types.first(), QString("1"));
     EXPECT_EQ(types.last(), QString("2"));
 }
+
+TEST_F(TestFileClassifier2, key)
+{
+    initDP();
+    dp->items.append(one1);
+    dp2->items.append(two1);
+
+    EXPECT_EQ(this->key(one1), QString("1"));
+    EXPECT_EQ(this->key(two1), QString("2"));
+    EXPECT_TRUE(this->key(test).isEmpty());
+    EXPECT_TRUE(this->contains("1", one1));
+    EXPECT_FALSE(this->contains("2", one1));
+
+    // items changed directly
+    dp->items.append(one2);
+    EXPECT_EQ(this->key(one2), QString("1"));
+    dp->items.clear();
+    EXPECT_TRUE(this->key(one1).isEmpty());
+    EXPECT_FALSE(this->contains("1", one2));
+
+    this->moveUrls({ two1 }, "1", 0);
+    EXPECT_EQ(this->key(two1), QString("1"));
+}
+
+TEST_F(TestFileClassifier2, prependItems)
+{
+    initDP();
+    this->prependItems({ one1, two1, one2, test });
+
+    ASSERT_EQ(dp->items.size(), 2);
+    EXPECT_EQ(dp->items.first(), one2);
+    EXPECT_EQ(dp->items.last(), one1);
+    ASSERT_EQ(dp2->items.size(), 1);
+    EXPECT_EQ(this->key(two1), QString("2"));
+    EXPECT_EQ(types, QStringList({ "1", "2" }));
+}
+
+TEST_F(TestFileClassifier2, removeItems)
+{
+    initDP();
+    dp->items.append(one1);
+    dp->items.append(one2);
+    dp2->items.append(two1);
+
+    this->removeItems({ one1, test, two1 });
+    EXPECT_EQ(dp->items, QList<QUrl>({ one2 }));
+    EXPECT_TRUE(dp2->items.isEmpty());
+    EXPECT_TRUE(this->key(one1).isEmpty());
+    EXPECT_EQ(this->key(one2), QString("1"));
+    ASSERT_EQ(types.size(), 2);
+    EXPECT_TRUE(types.contains("1"));
+    EXPECT_TRUE(types.contains("2"));
+}
+
+TEST_F(TestFileClassifier2, changeItems)
+{
+    initDP();
+    dp->items.append(one1);
+    dp->items.append(one2);
+
+    stub.set_lamda(VADDR(TestFileClassifier, classify), []() {
+        return QString("2");
+    });
+
+    this->changeItems({ one1, one2, test });
+    EXPECT_TRUE(dp->items.isEmpty());
+    EXPECT_EQ(dp2->items, QList<QUrl>({ one1, one2 }));
+    EXPECT_EQ(types, QStringList({ "1", "2" }));
+}
+
+TEST_F(TestFileClassifier2, reclassify)
+{
+    QList<QUrl> urls;
+    for (int i = 0; i < 10; ++i)
+        urls.append(QUrl::fromLocalFile(QString("/tmp/%0_%1").arg(i % 2 ? "one" : "two").arg(i)));
+    this->reset(urls);
+    EXPECT_EQ(this->collections.value("1")->items.size(), 5);
+
+    // every file moves to the other collection.
+    stub.set_lamda(VADDR(TestFileClassifier, classify), [](TestFileClassifier *self, const QUrl &url) {
+        return self->ids.key(url.fileName().left(3)) == "1" ? QString("2") : QString("1");
+    });
+    this->changeItems(urls);
+    EXPECT_EQ(this->collections.value("1")->items.size(), 5);
+    EXPECT_EQ(this->collections.value("2")->items.size(), 5);
+    EXPECT_TRUE(this->collections.value("1")->items.contains(urls.at(0)));
+
+    this->removeItems(urls);
+    EXPECT_TRUE(this->collections.value("1")->items.isEmpty());
+    EXPECT_TRUE(this->collections.value("2")->items.isEmpty());
+    EXPECT_EQ(types.size(), 4);
+}
+
+DFM_BENCHMARK_F(TestFileClassifier2, reclassify)
+{
+    const int count = benchmark_ext::size(10000);
+
+    QList<QUrl> urls;
+    urls.reserve(count);
+    for (int i = 0; i < count; ++i)
+        urls.append(QUrl::fromLocalFile(QString("/tmp/%0_%1").arg(i % 2 ? "one" : "two").arg(i)));
+
+    const qint64 resetCost = benchmark_ext::elapsedMs([&]() {
+        this->reset(urls);
+    });
+
+    // every file moves to the other collection.
+    stub.set_lamda(VADDR(TestFileClassifier, classify), [](TestFileClassifier *self, const QUrl &url) {
+        return self->ids.key(url.fileName().left(3)) == "1" ? QString("2") : QString("1");
+    });
+
+    const qint64 changeCost = benchmark_ext::elapsedMs([&]() {
+        this->changeItems(urls);
+    });
+    const qint64 removeCost = benchmark_ext::elapsedMs([&]() {
+        this->removeItems(urls);
+    });
+
+    benchmark_ext::report() << "reclassify" << count << "files, reset:" << resetCost
+                            << "ms, change:" << changeCost << "ms, remove:" << removeCost << "ms";
+}
@@ -551,10 +551,10 @@ TEST_F(UT_RootInfo, AddChildrenWithSortInfos)
 
     rootInfoObj->addChildren(infos);
 
-    EXPECT_EQ(rootInfoObj->childrenUrlList.length(), 3);
+    EXPECT_EQ(rootInfoObj->childrenUrlList.count(), 3);
     EXPECT_EQ(rootInfoObj->sourceDataList.length(), 3);
 
-    if (rootInfoObj->childrenUrlList.length() == 3) {
+    if (rootInfoObj->childrenUrlList.count() == 3) {
         EXPECT_EQ(rootInfoObj->childrenUrlList.at(0), url1);
         EXPECT_EQ(rootInfoObj->childrenUrlList.at(1), url2);
         EXPECT_EQ(rootInfoObj->childrenUrlList.at(2), url3);
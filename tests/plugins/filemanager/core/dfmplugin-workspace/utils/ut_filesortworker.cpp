@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "stubext.h"
+#include "benchmarkext.h"
 #include "plugins/filemanager/core/dfmplugin-workspace/utils/filesortworker.h"
 
 #include <dfm-base/base/schemefactory.h>
@@ -13,6 +14,8 @@
 
 #include <QStandardPaths>
 
+#include <random>
+
 DFMBASE_USE_NAMESPACE
 DFMGLOBAL_USE_NAMESPACE
 DPWORKSPACE_USE_NAMESPACE
@@ -39,6 +42,48 @@ protected:
         stub.clear();
     }
 
+    // 生成 count 个文件的排序键后按 role 排序，检查结果有序并返回排序耗时
+    qint64 sortByKeys(int count, ItemRoles role)
+    {
+        const QStringList types { "Text", "Image", "Video", "Audio", "Archive" };
+        QList<QUrl> urls;
+        for (int i = 0; i < count; ++i)
+            urls.append(QUrl::fromLocalFile(url.path() + QString("/file_%1").arg(i)));
+
+        std::mt19937 gen(count);
+        worker->sortAndFilter.reset();
+        worker->isMixDirAndFile = false;
+        worker->sortOrder = Qt::AscendingOrder;
+        worker->orgSortRole = role;
+        worker->sortKeys.clear();
+        for (int i = 0; i < count; ++i) {
+            FileSortWorker::SortKey key;
+            key.isValid = true;
+            key.isDir = i % 10 == 0;
+            key.isNumeric = role == kItemFileLastModifiedRole;
+            key.number = static_cast<qint64>(gen() % 100000);
+            key.displayName = urls.at(i).fileName();
+            if (role == kItemFileMimeTypeRole)
+                key.text = types.at(key.number % types.count());
+            else if (role != kItemFileLastModifiedRole)
+                key.text = role == kItemFileSizeRole ? QString::number(key.number) : key.displayName;
+            worker->sortKeys.insert(worker->urlIds.intern(urls.at(i)), key);
+        }
+
+        QList<QUrl> sortList;
+        const qint64 cost = benchmark_ext::elapsedMs([&]() {
+            sortList = worker->sortTreeFiles(urls);
+        });
+
+        EXPECT_EQ(sortList.count(), count);
+        int disordered = 0;
+        for (int i = 0; i < sortList.count() - 1; ++i)
+            disordered += worker->lessThan(worker->urlIds.find(sortList.at(i + 1)), worker->urlIds.find(sortList.at(i)),
+                                           AbstractSortFilter::SortScenarios::kSortScenariosNormal);
+        EXPECT_EQ(disordered, 0) << "role" << role;
+        return cost;
+    }
+
     QUrl url {};
     QString key {"theKey"};
     FileSortWorker *worker = nullptr;
@@ -70,3 +115,36 @@ TEST_F(UT_FileSortWorker, Bug_199473_handleUpdateFile)
 
     EXPECT_EQ(selectAndEditFile, updateFile);
 }
+
+TEST_F(UT_FileSortWorker, SortByPrecomputedKeys)
+{
+    for (const auto role : { kItemFileDisplayNameRole, kItemFileSizeRole,
+                             kItemFileLastModifiedRole, kItemFileMimeTypeRole })
+        sortByKeys(200, role);
+}
+
+DFM_BENCHMARK_F(UT_FileSortWorker, SortByPrecomputedKeys)
+{
+    const int count = benchmark_ext::size(10000);
+    for (const auto role : { kItemFileDisplayNameRole, kItemFileSizeRole,
+                             kItemFileLastModifiedRole, kItemFileMimeTypeRole })
+        benchmark_ext::report() << "sort" << count << "files by role" << role << "cost" << sortByKeys(count, role) << "ms";
+}
+
+TEST_F(UT_FileSortWorker, ChildDataIgnoresReusedId)
+{
+    const QUrl first = QUrl::fromLocalFile(url.path() + "/first");
+    const QUrl second = QUrl::fromLocalFile(url.path() + "/second");
+
+    const auto id = worker->urlIds.intern(first);
+    worker->childrenDataMap.insert(id, FileItemDataPointer(new FileItemData(first)));
+    worker->visibleChildren.append(id);
+    EXPECT_TRUE(worker->childData(first));
+    EXPECT_EQ(worker->getChildShowIndex(first), 0);
+
+    // id 被回收后分配给 second，first 不应再查到 second 的数据
+    worker->urlIds.release({ id });
+    ASSERT_EQ(worker->urlIds.intern(second), id);
+    EXPECT_FALSE(worker->childData(first));
+    EXPECT_EQ(worker->getChildShowIndex(first), -1);
+}
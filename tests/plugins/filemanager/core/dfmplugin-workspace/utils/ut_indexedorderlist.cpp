@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/filemanager/core/dfmplugin-workspace/utils/indexedorderlist.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+DPWORKSPACE_USE_NAMESPACE
+
+TEST(UT_IndexedOrderList, OperationsMatchQList)
+{
+    IndexedOrderList<int> list;
+    QList<int> ref;
+    std::mt19937 gen(1);
+    int next = 0;
+
+    for (int i = 0; i < 5000; ++i) {
+        switch (gen() % 5) {
+        case 0:
+        case 1: {
+            int index = static_cast<int>(gen() % (ref.count() + 3)) - 1;
+            list.insert(index, next);
+            if (index < 0 || index > ref.count())
+                ref.append(next);
+            else
+                ref.insert(index, next);
+            ++next;
+            break;
+        }
+        case 2:
+            if (!ref.isEmpty()) {
+                int index = static_cast<int>(gen() % ref.count());
+                list.removeAt(index);
+                ref.removeAt(index);
+            }
+            break;
+        case 3: {
+            QList<int> values;
+            for (int j = static_cast<int>(gen() % 5); j > 0; --j)
+                values.append(next++);
+            int start = static_cast<int>(gen() % (ref.count() + 1));
+            int end = qMin(start + static_cast<int>(gen() % 4), ref.count());
+            list.replace(start, end, values);
+            ref = ref.mid(0, start) + values + ref.mid(end);
+            break;
+        }
+        default:
+            if (!ref.isEmpty()) {
+                int value = ref.at(static_cast<int>(gen() % ref.count()));
+                EXPECT_TRUE(list.removeOne(value));
+                ref.removeOne(value);
+            }
+            break;
+        }
+
+        ASSERT_EQ(list.count(), ref.count());
+        if (!ref.isEmpty()) {
+            int index = static_cast<int>(gen() % ref.count());
+            EXPECT_EQ(list.at(index), ref.at(index));
+            EXPECT_EQ(list.indexOf(ref.at(index)), index);
+        }
+    }
+
+    EXPECT_EQ(list.toList(), ref);
+    list.clear();
+    EXPECT_TRUE(list.isEmpty());
+    EXPECT_EQ(list.indexOf(0), -1);
+}
+
+DFM_BENCHMARK(UT_IndexedOrderList, WatcherEventCostAtScale)
+{
+    std::mt19937 gen(2);
+    const int events = 20000;
+    for (int size : { benchmark_ext::size(50000), benchmark_ext::size(500000) }) {
+        IndexedOrderList<QString> list;
+        QList<QString> urls;
+        for (int i = 0; i < size; ++i)
+            urls.append(QString("file:///tmp/bench/file_%1").arg(i));
+        list.reset(urls);
+
+        int missing = 0;
+        const qint64 cost = benchmark_ext::elapsedNs([&]() {
+            for (int i = 0; i < events; ++i) {
+                const QString url = QString("file:///tmp/bench/new_%1").arg(i);
+                list.insert(static_cast<int>(gen() % list.count()), url);
+                missing += list.indexOf(url) < 0;
+                list.removeAt(static_cast<int>(gen() % list.count()));
+            }
+        });
+        benchmark_ext::report() << "entries:" << size << "ns per watcher event:" << cost / events;
+
+        EXPECT_EQ(missing, 0);
+        EXPECT_EQ(list.count(), size);
+    }
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/filemanager/core/dfmplugin-workspace/utils/urlidtable.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+DPWORKSPACE_USE_NAMESPACE
+
+TEST(UT_UrlIdTable, InternAndResolve)
+{
+    UrlIdTable table;
+    const QUrl a = QUrl::fromLocalFile("/tmp/a");
+    const QUrl b = QUrl::fromLocalFile("/tmp/b");
+
+    EXPECT_EQ(table.find(a), UrlIdTable::kInvalidId);
+    const auto idA = table.intern(a);
+    const auto idB = table.intern(b);
+    EXPECT_NE(idA, idB);
+    EXPECT_EQ(table.intern(a), idA);
+    EXPECT_EQ(table.find(b), idB);
+    EXPECT_EQ(table.url(idA), a);
+    EXPECT_EQ(table.url(UrlIdTable::kInvalidId), QUrl());
+    EXPECT_EQ(table.urls(table.intern(QList<QUrl>() << b << a)), QList<QUrl>() << b << a);
+    EXPECT_EQ(table.count(), 2);
+}
+
+TEST(UT_UrlIdTable, ReleaseAndReuse)
+{
+    UrlIdTable table;
+    const QUrl a = QUrl::fromLocalFile("/tmp/a");
+    const QUrl b = QUrl::fromLocalFile("/tmp/b");
+    const QUrl c = QUrl::fromLocalFile("/tmp/c");
+
+    const auto idA = table.intern(a);
+    const auto idB = table.intern(b);
+    table.release({ idA, idA, UrlIdTable::kInvalidId });
+    EXPECT_EQ(table.count(), 1);
+    EXPECT_EQ(table.find(a), UrlIdTable::kInvalidId);
+    EXPECT_EQ(table.url(idA), QUrl());
+
+    // 回收的id分配给新的url
+    EXPECT_EQ(table.intern(c), idA);
+    EXPECT_EQ(table.url(idA), c);
+    EXPECT_EQ(table.find(b), idB);
+
+    table.release({ idA, idB });
+    EXPECT_EQ(table.count(), 0);
+    EXPECT_EQ(table.urlList.count(), 0);
+
+    table.intern(a);
+    table.clear();
+    EXPECT_EQ(table.count(), 0);
+    EXPECT_EQ(table.find(a), UrlIdTable::kInvalidId);
+}
+
+DFM_BENCHMARK(UT_UrlIdTable, MemoryAndThroughput)
+{
+    using benchmark_ext::residentKb;
+    const int count = benchmark_ext::size(200000);
+    QList<QUrl> urls;
+    urls.reserve(count);
+    for (int i = 0; i < count; ++i)
+        urls.append(QUrl::fromLocalFile(QString("/home/user/project/build/output/object_%1.o").arg(i)));
+
+    const qint64 rssBefore = residentKb();
+    UrlIdTable table;
+    QList<quint32> ids;
+    const qint64 internCost = benchmark_ext::elapsedMs([&]() {
+        ids = table.intern(urls);
+    });
+    benchmark_ext::report() << "intern" << count << "urls cost" << internCost << "ms, rss delta" << residentKb() - rssBefore << "kB";
+
+    QHash<QUrl, int> byUrl;
+    QHash<quint32, int> byId;
+    for (int i = 0; i < count; ++i) {
+        byUrl.insert(urls.at(i), i);
+        byId.insert(ids.at(i), i);
+    }
+
+    qint64 sum = 0;
+    const qint64 urlLookup = benchmark_ext::elapsedNs([&]() {
+        for (const auto &url : urls)
+            sum += byUrl.value(url);
+    });
+    const qint64 idLookup = benchmark_ext::elapsedNs([&]() {
+        for (const auto id : ids)
+            sum -= byId.value(id);
+    });
+    benchmark_ext::report() << "lookup ns per item, QUrl key:" << urlLookup / count << "id key:" << idLookup / count;
+
+    EXPECT_EQ(sum, 0);
+}
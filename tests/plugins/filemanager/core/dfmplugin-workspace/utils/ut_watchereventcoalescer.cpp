@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/filemanager/core/dfmplugin-workspace/utils/watchereventcoalescer.h"
+
+#include "benchmarkext.h"
+
+#include <gtest/gtest.h>
+
+#include <QSet>
+
+#include <random>
+
+DPWORKSPACE_USE_NAMESPACE
+
+using Event = QPair<QUrl, WatcherEventCoalescer::EventType>;
+
+namespace {
+// 模拟rsync写入目录时的inotify事件：创建临时文件，多次写入，再重命名为目标文件
+QList<Event> rsyncStorm(int files)
+{
+    QList<Event> events;
+    for (int i = 0; i < files; ++i) {
+        const QUrl tmp = QUrl::fromLocalFile(QString("/tmp/storm/.file_%1.txt.XXXXXX").arg(i));
+        const QUrl target = QUrl::fromLocalFile(QString("/tmp/storm/file_%1.txt").arg(i));
+        events << Event(tmp, WatcherEventCoalescer::kAddFile);
+        for (int j = 0; j < 3; ++j)
+            events << Event(tmp, WatcherEventCoalescer::kUpdateFile);
+        events << Event(tmp, WatcherEventCoalescer::kRmFile);
+        events << Event(target, WatcherEventCoalescer::kAddFile);
+        events << Event(target, WatcherEventCoalescer::kUpdateFile);
+    }
+    return events;
+}
+
+// 模拟git checkout：随机删除、重建和修改已有文件
+QList<Event> checkoutStorm(int files, int count)
+{
+    std::mt19937 gen(3);
+    QList<Event> events;
+    for (int i = 0; i < count; ++i) {
+        const QUrl url = QUrl::fromLocalFile(QString("/tmp/storm/src/file_%1.cpp").arg(gen() % files));
+        events << Event(url, static_cast<WatcherEventCoalescer::EventType>(gen() % 3));
+    }
+    return events;
+}
+
+// 原来RootInfo::doWatcherEvent中基于QList的合并逻辑，作为行为参考
+WatcherEventCoalescer::Batch listCoalesce(const QList<Event> &events)
+{
+    WatcherEventCoalescer::Batch batch;
+    for (const auto &event : events) {
+        const QUrl &fileUrl = event.first;
+        if (event.second == WatcherEventCoalescer::kAddFile) {
+            batch.updates.removeOne(fileUrl);
+            batch.removes.removeOne(fileUrl);
+            if (!batch.adds.contains(fileUrl))
+                batch.adds.append(fileUrl);
+        } else if (event.second == WatcherEventCoalescer::kUpdateFile) {
+            if (!batch.adds.contains(fileUrl) && !batch.removes.contains(fileUrl) && !batch.updates.contains(fileUrl))
+                batch.updates.append(fileUrl);
+        } else {
+            batch.adds.removeOne(fileUrl);
+            batch.updates.removeOne(fileUrl);
+            if (!batch.removes.contains(fileUrl))
+                batch.removes.append(fileUrl);
+        }
+    }
+    return batch;
+}
+
+WatcherEventCoalescer::Batch replay(const QList<Event> &events)
+{
+    WatcherEventCoalescer coalescer;
+    for (const auto &event : events)
+        coalescer.push(event.first, event.second);
+    return coalescer.take();
+}
+
+QSet<QUrl> toSet(const QList<QUrl> &list)
+{
+    QSet<QUrl> set;
+    for (const auto &url : list)
+        set.insert(url);
+    return set;
+}
+
+qint64 replayCost(const QList<Event> &events)
+{
+    WatcherEventCoalescer::Batch batch;
+    const qint64 cost = benchmark_ext::elapsedNs([&]() {
+        batch = replay(events);
+    });
+    EXPECT_FALSE(batch.adds.isEmpty());
+    return cost;
+}
+}
+
+TEST(UT_WatcherEventCoalescer, LastStateWins)
+{
+    const QUrl a = QUrl::fromLocalFile("/tmp/a");
+    const QUrl b = QUrl::fromLocalFile("/tmp/b");
+    const QUrl c = QUrl::fromLocalFile("/tmp/c");
+
+    WatcherEventCoalescer coalescer;
+    EXPECT_TRUE(coalescer.isEmpty());
+    coalescer.push(a, WatcherEventCoalescer::kUpdateFile);
+    coalescer.push(a, WatcherEventCoalescer::kAddFile);
+    coalescer.push(a, WatcherEventCoalescer::kUpdateFile);
+    coalescer.push(b, WatcherEventCoalescer::kAddFile);
+    coalescer.push(b, WatcherEventCoalescer::kRmFile);
+    coalescer.push(b, WatcherEventCoalescer::kUpdateFile);
+    coalescer.push(c, WatcherEventCoalescer::kUpdateFile);
+    coalescer.push(c, WatcherEventCoalescer::kUpdateFile);
+    EXPECT_EQ(coalescer.count(), 3);
+
+    const auto &batch = coalescer.take();
+    EXPECT_EQ(batch.adds, QList<QUrl>() << a);
+    EXPECT_EQ(batch.removes, QList<QUrl>() << b);
+    EXPECT_EQ(batch.updates, QList<QUrl>() << c);
+    EXPECT_TRUE(coalescer.isEmpty());
+}
+
+TEST(UT_WatcherEventCoalescer, AdaptiveBatchWindow)
+{
+    WatcherEventCoalescer coalescer;
+    EXPECT_EQ(coalescer.batchWindow(), WatcherEventCoalescer::kMinBatchWindow);
+
+    const auto &storm = rsyncStorm(1000);
+    for (int round = 0; round < 10; ++round) {
+        for (const auto &event : storm)
+            coalescer.push(event.first, event.second);
+        coalescer.take();
+    }
+    EXPECT_EQ(coalescer.batchWindow(), WatcherEventCoalescer::kMaxBatchWindow);
+
+    coalescer.push(QUrl::fromLocalFile("/tmp/a"), WatcherEventCoalescer::kAddFile);
+    coalescer.take();
+    EXPECT_EQ(coalescer.batchWindow(), WatcherEventCoalescer::kMinBatchWindow);
+}
+
+TEST(UT_WatcherEventCoalescer, StormReplayMatchesListCoalesce)
+{
+    for (const auto &events : { rsyncStorm(500), checkoutStorm(300, 3000) }) {
+        const auto &expect = listCoalesce(events);
+        const auto &batch = replay(events);
+        EXPECT_EQ(toSet(batch.adds), toSet(expect.adds));
+        EXPECT_EQ(toSet(batch.removes), toSet(expect.removes));
+        EXPECT_EQ(toSet(batch.updates), toSet(expect.updates));
+    }
+}
+
+DFM_BENCHMARK(UT_WatcherEventCoalescer, StormReplayScalesLinearly)
+{
+    const int small = benchmark_ext::size(5000);
+    const int large = small * 8;
+
+    // 预热，避免首次分配影响计时
+    replayCost(rsyncStorm(small));
+
+    const qint64 smallCost = replayCost(rsyncStorm(small));
+    const qint64 largeCost = replayCost(rsyncStorm(large));
+    const qint64 checkoutCost = replayCost(checkoutStorm(large, large * 6));
+    benchmark_ext::report() << "rsync storm ns per event," << small * 6 << "events:" << smallCost / (small * 6)
+                            << large * 6 << "events:" << largeCost / (large * 6)
+                            << "checkout storm:" << checkoutCost / (large * 6);
+
+    // 线性时事件数放大8倍耗时约为8倍，平方级会达到64倍
+    EXPECT_LT(largeCost, smallCost * 24);
+}
@@ -4,6 +4,7 @@
 
 #include "searchmanager/searcher/iterator/iteratorsearcher.h"
 #include "stubext.h"
+#include "benchmarkext.h"
 
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/file/local/localdiriterator.h>
@@ -11,6 +12,10 @@
 
 #include <gtest/gtest.h>
 
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
 DPSEARCH_USE_NAMESPACE
 DFMBASE_USE_NAMESPACE
 
@@ -102,3 +107,89 @@ TEST(IteratorSearcherTest, doSearch_2)
     EXPECT_FALSE(search.allResults.isEmpty());
     EXPECT_TRUE(search.searchPathList.isEmpty());
 }
+
+TEST(IteratorSearcherTest, matchName)
+{
+    IteratorSearcher plain(QUrl::fromLocalFile("/home"), "Key");
+    EXPECT_TRUE(plain.literalOnly);
+    EXPECT_TRUE(plain.matchName("a_key_b"));
+    EXPECT_FALSE(plain.matchName("a_ke_b"));
+
+    IteratorSearcher wildcard(QUrl::fromLocalFile("/home"), "rep*t?.txt");
+    EXPECT_FALSE(wildcard.literalOnly);
+    EXPECT_EQ(wildcard.literalKey, QString(".txt"));
+    EXPECT_TRUE(wildcard.matchName("report1.txt"));
+    EXPECT_FALSE(wildcard.matchName("report1.doc"));
+
+    IteratorSearcher charClass(QUrl::fromLocalFile("/home"), "report[12]");
+    EXPECT_FALSE(charClass.literalOnly);
+    EXPECT_TRUE(charClass.literalKey.isEmpty());
+    EXPECT_TRUE(charClass.matchName("report2.txt"));
+    EXPECT_FALSE(charClass.matchName("report[12].txt"));
+}
+
+namespace {
+// 生成 dirCount 个目录，每个目录 filesPerDir 个文件，其中每 50 个文件有一个匹配 "needle"
+void makeSearchTree(const QString &root, int dirCount, int filesPerDir)
+{
+    for (int i = 0; i < dirCount; ++i) {
+        const QString dir = QString("%1/level_%2/dir_%3").arg(root).arg(i % 4).arg(i);
+        QDir().mkpath(dir);
+        for (int j = 0; j < filesPerDir; ++j) {
+            const QString name = j % 50 == 0 ? QString("Needle_%1.txt").arg(j) : QString("file_%1.txt").arg(j);
+            QFile file(dir + "/" + name);
+            file.open(QIODevice::WriteOnly);
+        }
+    }
+    QDir().mkpath(root + "/.hidden");
+    QFile(root + "/.hidden/needle.txt").open(QIODevice::WriteOnly);
+}
+
+// 分别用迭代器遍历和本地多线程遍历搜索，比较结果并返回两者的耗时
+QPair<qint64, qint64> compareSearch(const QString &root, int expectCount)
+{
+    UrlRoute::regScheme("file", "/");
+    DirIteratorFactory::regClass<LocalDirIterator>("file");
+    InfoFactory::regClass<SyncFileInfo>("file");
+
+    IteratorSearcher iteratorSearch(QUrl::fromLocalFile(root), "needle");
+    iteratorSearch.status.storeRelease(AbstractSearcher::kRuning);
+    const qint64 iteratorCost = benchmark_ext::elapsedMs([&]() {
+        iteratorSearch.doSearch();
+    });
+
+    IteratorSearcher localSearch(QUrl::fromLocalFile(root), "needle");
+    localSearch.status.storeRelease(AbstractSearcher::kRuning);
+    const qint64 localCost = benchmark_ext::elapsedMs([&]() {
+        localSearch.doLocalSearch();
+    });
+
+    auto iteratorResults = iteratorSearch.takeAll();
+    auto localResults = localSearch.takeAll();
+    std::sort(iteratorResults.begin(), iteratorResults.end());
+    std::sort(localResults.begin(), localResults.end());
+    EXPECT_EQ(localResults.count(), expectCount);
+    EXPECT_EQ(localResults, iteratorResults);
+    return qMakePair(iteratorCost, localCost);
+}
+}
+
+// 在合成目录树上比较迭代器遍历与本地多线程遍历的结果
+TEST(IteratorSearcherTest, localSearchMatchesIteratorSearch)
+{
+    QTemporaryDir root;
+    makeSearchTree(root.path(), 8, 100);
+    compareSearch(root.path(), 8 * 2);
+}
+
+DFM_BENCHMARK(IteratorSearcherTest, localSearch)
+{
+    const int dirCount = benchmark_ext::size(40);
+    const int filesPerDir = 250;
+    QTemporaryDir root;
+    makeSearchTree(root.path(), dirCount, filesPerDir);
+
+    const auto &cost = compareSearch(root.path(), dirCount * (filesPerDir / 50));
+    benchmark_ext::report() << "search" << dirCount * filesPerDir << "files, iterator:" << cost.first
+                            << "ms, local parallel:" << cost.second << "ms";
+}